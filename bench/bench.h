@@ -0,0 +1,45 @@
+#ifndef _LITESTL_BENCH_H_
+#define _LITESTL_BENCH_H_
+
+// timing helpers of the benchmarks
+// every benchmark prints one line per case: the name and the best wall time
+// of a few runs, so a run on a busy machine is not counted
+
+#include <chrono>
+#include <cstdio>
+
+namespace bench
+{
+
+// best time of runs calls of f(), in seconds
+template <class F>
+double best_of(int runs, F f)
+{
+  double best = 0;
+  for (int i = 0; i < runs; ++i)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    if (i == 0 || t.count() < best) best = t.count();
+  }
+  return best;
+}
+
+inline void report(const char* name, double seconds)
+{
+  std::printf("%-40s %10.2f ms\n", name, seconds * 1e3);
+}
+
+// keep the optimizer from dropping a result
+template <class T>
+void keep(T x)
+{
+  static volatile T sink;
+  sink = x;
+  (void)sink;
+}
+
+} // namespace bench
+
+#endif // !_LITESTL_BENCH_H_
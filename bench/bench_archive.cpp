@@ -0,0 +1,95 @@
+// a 4M-entry flat_map<int64_t, double> in an archive in the temp directory:
+// writing it, rebuilding a flat_map from the file, and opening the file and
+// viewing the section in place, then 1M lookups in the view and in the map
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "archive.h"
+
+#include "bench.h"
+
+namespace
+{
+
+const size_t entries = 4000000;
+const size_t lookups = 1000000;
+const char*  path = "/tmp/litestl_bench_archive.bin";
+
+} // namespace
+
+int main()
+{
+  mystl::flat_map<int64_t, double> m;
+  {
+    std::vector<mystl::pair<int64_t, double>> v(entries);
+    for (size_t i = 0; i < entries; ++i)
+      v[i] = mystl::make_pair(static_cast<int64_t>(i * 5), i * 0.5);
+    m.insert(v.data(), v.data() + v.size());
+  }
+  std::vector<int64_t> keys(lookups);
+  std::mt19937_64 rng(50);
+  for (auto& k : keys) k = static_cast<int64_t>(rng() % (entries * 5));
+  double sum = 0;
+
+  bench::report("write flat_map section", bench::best_of(3, [&]
+  {
+    mystl::archive_writer w;
+    if (!w.open(path) || (w.write(m), !w.close())) std::perror(path);
+  }));
+  bench::report("stream flat_map section", bench::best_of(3, [&]
+  {
+    mystl::archive_writer w;
+    if (!w.open(path)) std::perror(path);
+    w.begin_flat_map<int64_t, double>(entries);
+    for (size_t i = 0; i < entries; ++i)
+      w.push_entry(static_cast<int64_t>(i * 5), i * 0.5);
+    if (!w.close()) std::perror(path);
+  }));
+  bench::report("open + rebuild flat_map + 1 lookup", bench::best_of(3, [&]
+  {
+    mystl::archive_reader r;
+    if (!r.open(path)) return;
+    auto view = r.flat_map_section<int64_t, double>(0);
+    mystl::flat_map<int64_t, double> copy(view.begin(), view.end());
+    sum += copy.find(keys[0]) != copy.end();
+  }));
+  bench::report("open + view + 1 lookup", bench::best_of(3, [&]
+  {
+    mystl::archive_reader r;
+    if (!r.open(path)) return;
+    auto view = r.flat_map_section<int64_t, double>(0);
+    sum += view.contains(keys[0]);
+  }));
+
+  mystl::archive_reader r;
+  if (!r.open(path))
+  {
+    std::perror(path);
+    return 1;
+  }
+  auto view = r.flat_map_section<int64_t, double>(0);
+  bench::report("flat_map 1M lookups", bench::best_of(3, [&]
+  {
+    for (size_t i = 0; i < lookups; ++i)
+    {
+      auto it = m.find(keys[i]);
+      if (it != m.end()) sum += (*it).second;
+    }
+  }));
+  bench::report("view 1M lookups", bench::best_of(3, [&]
+  {
+    for (size_t i = 0; i < lookups; ++i)
+    {
+      auto it = view.find(keys[i]);
+      if (it != view.end()) sum += *it.value;
+    }
+  }));
+
+  bench::keep(sum);
+  r.close();
+  std::remove(path);
+  return 0;
+}
@@ -0,0 +1,89 @@
+// priority queue of 10M entries: push them all, then pop them all
+// binary heap against the 4-ary and 8-ary heaps and std::priority_queue
+// the heaps run twice: with first + 1 on a cache line boundary, so that no
+// group of children straddles two lines, and 12 bytes before one, so that
+// every fourth 16-byte group and every other 32-byte group does
+
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "algo_heap.h"
+
+#include "bench.h"
+
+namespace
+{
+
+const size_t entries = 10000000;
+const size_t line = 64;
+
+// the heap starts at the first element of buf with first + 1 at offset mod
+// line bytes
+template <class Push, class Pop>
+double run(const std::vector<uint32_t>& keys, size_t offset, Push push, Pop pop)
+{
+  std::vector<uint32_t> buf(keys.size() + line);
+  uint32_t* first = buf.data();
+  while (reinterpret_cast<uintptr_t>(first + 1) % line != offset) ++first;
+  uint64_t sum = 0;
+  const double t = bench::best_of(3, [&]
+  {
+    uint32_t* last = first;
+    for (auto k : keys)
+    {
+      *last++ = k;
+      push(first, last);
+    }
+    while (last != first)
+    {
+      sum += *first;
+      pop(first, last);
+      --last;
+    }
+  });
+  bench::keep(sum);
+  return t;
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937 rng(1);
+  std::vector<uint32_t> keys(entries);
+  for (auto& k : keys) k = static_cast<uint32_t>(rng());
+
+  typedef uint32_t* ptr;
+  const size_t offsets[] = { 0, line - 12 };
+  const char* names[] = { "aligned", "straddling" };
+  for (size_t o = 0; o < 2; ++o)
+  {
+    const std::string suffix = std::string(", ") + names[o];
+    bench::report(("push/pop_heap" + suffix).c_str(),
+      run(keys, offsets[o], [](ptr f, ptr l) { mystl::push_heap(f, l); },
+                            [](ptr f, ptr l) { mystl::pop_heap(f, l); }));
+    bench::report(("push/pop_dary_heap<4>" + suffix).c_str(),
+      run(keys, offsets[o], [](ptr f, ptr l) { mystl::push_dary_heap<4>(f, l); },
+                            [](ptr f, ptr l) { mystl::pop_dary_heap<4>(f, l); }));
+    bench::report(("push/pop_dary_heap<8>" + suffix).c_str(),
+      run(keys, offsets[o], [](ptr f, ptr l) { mystl::push_dary_heap<8>(f, l); },
+                            [](ptr f, ptr l) { mystl::pop_dary_heap<8>(f, l); }));
+  }
+
+  uint64_t sum = 0;
+  bench::report("std::priority_queue", bench::best_of(3, [&]
+  {
+    std::priority_queue<uint32_t> pq;
+    for (auto k : keys) pq.push(k);
+    while (!pq.empty())
+    {
+      sum += pq.top();
+      pq.pop();
+    }
+  }));
+  bench::keep(sum);
+  return 0;
+}
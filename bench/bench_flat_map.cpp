@@ -0,0 +1,90 @@
+// 256K int keys: build the table, then 4M lookups that all hit
+// flat_map against std::map; operator new is counted, so the bytes each
+// table holds are printed with the times
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "flat_map.h"
+
+#include "bench.h"
+
+namespace
+{
+
+size_t allocated = 0;
+
+const size_t entries = 256 * 1024;
+const size_t lookups = 4000000;
+
+} // namespace
+
+void* operator new(size_t n)
+{
+  allocated += n;
+  if (void* p = std::malloc(n == 0 ? 1 : n)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  std::free(p);
+}
+
+int main()
+{
+  std::mt19937 rng(1);
+  std::vector<mystl::pair<int, int>> items(entries);
+  for (size_t i = 0; i < entries; ++i)
+    items[i] = mystl::pair<int, int>(static_cast<int>(rng()), static_cast<int>(i));
+  std::vector<int> probes(lookups);
+  for (auto& k : probes) k = items[rng() % entries].first;
+
+  uint64_t sum = 0;
+  mystl::flat_map<int, int> fm;
+  bench::report("flat_map bulk insert", bench::best_of(3, [&]
+  {
+    fm.clear();
+    fm.shrink_to_fit();
+    fm.insert(items.data(), items.data() + items.size());
+    fm.shrink_to_fit();
+  }));
+  const size_t fm_bytes = fm.keys().capacity() * sizeof(int) +
+                          fm.values().capacity() * sizeof(int);
+  bench::report("flat_map find", bench::best_of(3, [&]
+  {
+    for (auto k : probes) sum += static_cast<uint64_t>((*fm.find(k)).second);
+  }));
+
+  std::map<int, int> sm;
+  size_t before = 0;
+  bench::report("std::map insert", bench::best_of(3, [&]
+  {
+    sm.clear();
+    before = allocated;
+    for (const auto& x : items) sm.insert(std::make_pair(x.first, x.second));
+  }));
+  const size_t sm_bytes = allocated - before;
+  bench::report("std::map find", bench::best_of(3, [&]
+  {
+    for (auto k : probes) sum += static_cast<uint64_t>(sm.find(k)->second);
+  }));
+  bench::keep(sum);
+
+  std::printf("%-40s %10.2f bytes per entry\n", "flat_map size",
+              static_cast<double>(fm_bytes) / static_cast<double>(fm.size()));
+  std::printf("%-40s %10.2f bytes per entry (allocated, without malloc headers)\n",
+              "std::map size",
+              static_cast<double>(sm_bytes) / static_cast<double>(sm.size()));
+  return 0;
+}
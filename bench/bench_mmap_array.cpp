@@ -0,0 +1,157 @@
+// a 1 GB file of sorted uint64_t, written to the temp directory:
+// one lower_bound after reading the file into a std::vector against one
+// after mapping it with mmap_array, with the file in the page cache and with
+// its pages dropped first, then 1M random lookups and a full accumulate
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "algobase.h"
+#include "mmap_array.h"
+#include "numeric.h"
+
+#include "bench.h"
+
+namespace
+{
+
+const size_t count = size_t(1) << 27;
+const size_t lookups = 1000000;
+const char*  path = "/tmp/litestl_bench_mmap_array.bin";
+
+bool write_file()
+{
+  std::FILE* f = std::fopen(path, "wb");
+  if (f == nullptr) return false;
+  std::vector<uint64_t> block(1 << 16);
+  bool ok = true;
+  for (size_t i = 0; ok && i < count; i += block.size())
+  {
+    for (size_t j = 0; j < block.size(); ++j) block[j] = (i + j) * 3;
+    ok = std::fwrite(block.data(), sizeof(uint64_t), block.size(), f) == block.size();
+  }
+  return std::fclose(f) == 0 && ok;
+}
+
+// drop the pages of the file from the page cache
+void drop_cache()
+{
+  const int fd = ::open(path, O_RDONLY);
+  if (fd < 0) return;
+  ::fdatasync(fd);
+  ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  ::close(fd);
+}
+
+// best time of runs calls of f(), each after drop_cache(), in seconds
+template <class F>
+double best_cold(int runs, F f)
+{
+  double best = 0;
+  for (int i = 0; i < runs; ++i)
+  {
+    drop_cache();
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    if (i == 0 || t.count() < best) best = t.count();
+  }
+  return best;
+}
+
+uint64_t read_and_find(uint64_t key)
+{
+  std::vector<uint64_t> v(count);
+  std::FILE* f = std::fopen(path, "rb");
+  if (f == nullptr) return 0;
+  const size_t n = std::fread(v.data(), sizeof(uint64_t), count, f);
+  std::fclose(f);
+  return *mystl::lower_bound(v.data(), v.data() + n, key);
+}
+
+uint64_t map_and_find(uint64_t key)
+{
+  mystl::mmap_array<uint64_t> a;
+  if (!a.open(path)) return 0;
+  return *mystl::lower_bound(a.begin(), a.end(), key);
+}
+
+} // namespace
+
+int main()
+{
+  if (!write_file())
+  {
+    std::perror(path);
+    return 1;
+  }
+  const uint64_t key = (count / 3) * 3;
+  uint64_t sum = 0;
+
+  bench::report("read into vector + 1 lookup, cached", bench::best_of(3, [&]
+  {
+    sum += read_and_find(key);
+  }));
+  bench::report("mmap_array open + 1 lookup, cached", bench::best_of(3, [&]
+  {
+    sum += map_and_find(key);
+  }));
+  bench::report("read into vector + 1 lookup, cold", best_cold(3, [&]
+  {
+    sum += read_and_find(key);
+  }));
+  bench::report("mmap_array open + 1 lookup, cold", best_cold(3, [&]
+  {
+    sum += map_and_find(key);
+  }));
+
+  std::vector<uint64_t> keys(lookups);
+  std::mt19937_64 rng(7);
+  for (auto& k : keys) k = rng() % (count * 3);
+
+  std::vector<uint64_t> v(count);
+  std::FILE* f = std::fopen(path, "rb");
+  if (f == nullptr || std::fread(v.data(), sizeof(uint64_t), count, f) != count)
+  {
+    std::perror(path);
+    return 1;
+  }
+  std::fclose(f);
+  mystl::mmap_array<uint64_t> a;
+  if (!a.open(path))
+  {
+    std::perror(path);
+    return 1;
+  }
+
+  bench::report("vector 1M lookups", bench::best_of(3, [&]
+  {
+    for (size_t i = 0; i < lookups; ++i)
+      sum += *mystl::lower_bound(v.data(), v.data() + count, keys[i]);
+  }));
+  bench::report("mmap_array 1M lookups", bench::best_of(3, [&]
+  {
+    for (size_t i = 0; i < lookups; ++i)
+      sum += *mystl::lower_bound(a.begin(), a.end(), keys[i]);
+  }));
+  bench::report("vector accumulate", bench::best_of(3, [&]
+  {
+    sum += mystl::accumulate(v.data(), v.data() + count, uint64_t(0));
+  }));
+  a.advise(mystl::advise_sequential);
+  bench::report("mmap_array accumulate, sequential", bench::best_of(3, [&]
+  {
+    sum += mystl::accumulate(a.begin(), a.end(), uint64_t(0));
+  }));
+
+  bench::keep(sum);
+  a.close();
+  std::remove(path);
+  return 0;
+}
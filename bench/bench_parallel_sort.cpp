@@ -0,0 +1,69 @@
+// parallel_sort and parallel_radix_sort against mystl::sort and std::sort
+// 20M random ints and 20M ints with 16 distinct values; the scheduler uses
+// every hardware thread, so run this on the machine whose scaling is wanted
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "algo_parallel.h"
+#include "algo_radix_sort.h"
+#include "algo_sort.h"
+#include "parallel.h"
+
+#include "bench.h"
+
+namespace
+{
+
+const size_t length = 20000000;
+
+void run(const char* shape, const std::vector<int>& v)
+{
+  char name[80];
+  std::vector<int> a;
+  // the copy is timed with the sort, so time it alone to subtract it
+  const double copy = bench::best_of(3, [&] { a = v; });
+  const auto time = [&](void (*sort)(std::vector<int>&))
+  {
+    return bench::best_of(3, [&]
+    {
+      a = v;
+      sort(a);
+    }) - copy;
+  };
+
+  std::snprintf(name, sizeof(name), "%s std::sort", shape);
+  bench::report(name, time([](std::vector<int>& x) { std::sort(x.begin(), x.end()); }));
+  std::snprintf(name, sizeof(name), "%s mystl::sort", shape);
+  bench::report(name, time([](std::vector<int>& x)
+  {
+    mystl::sort(x.data(), x.data() + x.size());
+  }));
+  std::snprintf(name, sizeof(name), "%s parallel_sort", shape);
+  bench::report(name, time([](std::vector<int>& x)
+  {
+    mystl::parallel_sort(x.data(), x.data() + x.size());
+  }));
+  std::snprintf(name, sizeof(name), "%s parallel_radix_sort", shape);
+  bench::report(name, time([](std::vector<int>& x)
+  {
+    mystl::parallel_radix_sort(x.data(), x.data() + x.size());
+  }));
+}
+
+} // namespace
+
+int main()
+{
+  std::printf("threads: %zu\n", mystl::task_scheduler::instance().concurrency());
+  std::mt19937 rng(1);
+  std::vector<int> v(length);
+  for (auto& x : v) x = static_cast<int>(rng());
+  run("random int", v);
+
+  for (auto& x : v) x = static_cast<int>(rng() % 16);
+  run("16 distinct int", v);
+  return 0;
+}
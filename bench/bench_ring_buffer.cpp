@@ -0,0 +1,210 @@
+// queues between threads: throughput of spsc_ring with single and batched
+// pushes, throughput of mpmc_ring across producer and consumer counts, and the
+// round trip latency of a ping-pong through two rings; a deque guarded by a
+// mutex is the baseline throughout
+// a side that finds the queue full or empty yields, so the numbers stay
+// meaningful when there are fewer cores than threads
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ring_buffer.h"
+
+#include "bench.h"
+
+namespace
+{
+
+const size_t spsc_items = 10000000;
+const size_t mpmc_items = 4000000;
+const size_t round_trips = 100000;
+const size_t capacity = 1024;
+
+// the baseline: a bounded deque behind a mutex
+class locked_queue
+{
+public:
+  bool try_push(uint64_t x)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.size() == capacity) return false;
+    queue_.push_back(x);
+    return true;
+  }
+  bool try_pop(uint64_t& x)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.empty()) return false;
+    x = queue_.front();
+    queue_.pop_front();
+    return true;
+  }
+
+private:
+  std::mutex           mutex_;
+  std::deque<uint64_t> queue_;
+};
+
+template <class Queue>
+void push_wait(Queue& q, uint64_t x)
+{
+  while (!q.try_push(x)) std::this_thread::yield();
+}
+
+template <class Queue>
+uint64_t pop_wait(Queue& q)
+{
+  uint64_t x;
+  while (!q.try_pop(x)) std::this_thread::yield();
+  return x;
+}
+
+// producers push items values in total, consumers pop them all; every value
+// is counted once, so a lost or doubled item shows as a wrong sum
+template <class Queue>
+double throughput(Queue& q, size_t producers, size_t consumers, size_t items)
+{
+  uint64_t expect = 0;
+  for (size_t i = 0; i < items; ++i) expect += i;
+  return bench::best_of(3, [&]
+  {
+    std::atomic<uint64_t> sum(0);
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p)
+    {
+      threads.emplace_back([&q, p, producers, items]
+      {
+        for (size_t i = p; i < items; i += producers) push_wait(q, i);
+      });
+    }
+    for (size_t c = 0; c < consumers; ++c)
+    {
+      threads.emplace_back([&q, &sum, c, consumers, items]
+      {
+        const size_t n = items / consumers + (c < items % consumers ? 1 : 0);
+        uint64_t local = 0;
+        for (size_t i = 0; i < n; ++i) local += pop_wait(q);
+        sum += local;
+      });
+    }
+    for (auto& t : threads) t.join();
+    if (sum != expect) std::printf("lost items\n");
+  });
+}
+
+// the batched producer and consumer move up to 64 items per call
+double spsc_batched(mystl::spsc_ring<uint64_t, capacity>& q, size_t items)
+{
+  return bench::best_of(3, [&]
+  {
+    uint64_t sum = 0;
+    std::thread producer([&q, items]
+    {
+      uint64_t buf[64];
+      for (size_t i = 0; i < items;)
+      {
+        const size_t n = std::min<size_t>(64, items - i);
+        for (size_t k = 0; k < n; ++k) buf[k] = i + k;
+        size_t done = 0;
+        while (done < n)
+        {
+          const size_t pushed = q.push_n(buf + done, n - done);
+          if (pushed == 0) std::this_thread::yield();
+          done += pushed;
+        }
+        i += n;
+      }
+    });
+    uint64_t buf[64];
+    for (size_t i = 0; i < items;)
+    {
+      const size_t n = q.pop_n(buf, 64);
+      if (n == 0) std::this_thread::yield();
+      for (size_t k = 0; k < n; ++k) sum += buf[k];
+      i += n;
+    }
+    producer.join();
+    bench::keep(sum);
+  });
+}
+
+// median and 99th percentile of a round trip: the pinger sends a value through
+// one queue and waits for it to come back through the other
+template <class Queue>
+void latency(const char* name, Queue& ping, Queue& pong)
+{
+  std::vector<double> ns(round_trips);
+  std::thread echo([&ping, &pong]
+  {
+    for (size_t i = 0; i < round_trips; ++i) push_wait(pong, pop_wait(ping));
+  });
+  for (size_t i = 0; i < round_trips; ++i)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    push_wait(ping, i);
+    pop_wait(pong);
+    const std::chrono::duration<double, std::nano> t = std::chrono::steady_clock::now() - start;
+    ns[i] = t.count();
+  }
+  echo.join();
+  std::sort(ns.begin(), ns.end());
+  std::printf("%-40s %10.0f ns median %10.0f ns p99\n", name,
+              ns[round_trips / 2], ns[round_trips * 99 / 100]);
+}
+
+} // namespace
+
+int main()
+{
+  std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+
+  std::printf("1 producer, 1 consumer, %zu items\n", spsc_items);
+  {
+    mystl::spsc_ring<uint64_t, capacity> q;
+    bench::report("spsc_ring try_push / try_pop", throughput(q, 1, 1, spsc_items));
+    bench::report("spsc_ring push_n / pop_n, 64", spsc_batched(q, spsc_items));
+  }
+  {
+    mystl::mpmc_ring<uint64_t> q(capacity);
+    bench::report("mpmc_ring", throughput(q, 1, 1, spsc_items));
+  }
+  {
+    locked_queue q;
+    bench::report("mutex + std::deque", throughput(q, 1, 1, spsc_items));
+  }
+
+  const size_t counts[][2] = { {1, 2}, {2, 1}, {2, 2}, {4, 4} };
+  for (const auto& pc : counts)
+  {
+    std::printf("producers x consumers: %zu x %zu, %zu items\n", pc[0], pc[1], mpmc_items);
+    char name[64];
+    mystl::mpmc_ring<uint64_t> q(capacity);
+    std::snprintf(name, sizeof(name), "mpmc_ring %zux%zu", pc[0], pc[1]);
+    bench::report(name, throughput(q, pc[0], pc[1], mpmc_items));
+    locked_queue lq;
+    std::snprintf(name, sizeof(name), "mutex + std::deque %zux%zu", pc[0], pc[1]);
+    bench::report(name, throughput(lq, pc[0], pc[1], mpmc_items));
+  }
+
+  std::printf("round trip, %zu times\n", round_trips);
+  {
+    mystl::spsc_ring<uint64_t, capacity> ping, pong;
+    latency("spsc_ring", ping, pong);
+  }
+  {
+    mystl::mpmc_ring<uint64_t> ping(capacity), pong(capacity);
+    latency("mpmc_ring", ping, pong);
+  }
+  {
+    locked_queue ping, pong;
+    latency("mutex + std::deque", ping, pong);
+  }
+  return 0;
+}
@@ -0,0 +1,83 @@
+// sequences of up to 8 elements, built and dropped 1M times
+// small_vector<int, 8> against vector<int> and std::vector<int>; operator new
+// is counted, so the allocations per sequence are printed with the times
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "small_vector.h"
+#include "vector.h"
+
+#include "bench.h"
+
+namespace
+{
+
+size_t allocations = 0;
+
+const size_t sequences = 1000000;
+
+template <class Seq>
+void run(const char* name, const std::vector<uint8_t>& lengths)
+{
+  uint64_t sum = 0;
+  size_t count = 0;
+  const double t = bench::best_of(3, [&]
+  {
+    const auto before = allocations;
+    for (auto len : lengths)
+    {
+      Seq seq;
+      for (int i = 0; i < len; ++i) seq.push_back(i);
+      for (auto x : seq) sum += static_cast<uint64_t>(x);
+    }
+    count = allocations - before;
+  });
+  bench::keep(sum);
+  bench::report(name, t);
+  std::printf("%-40s %10.2f allocations per sequence\n", "",
+              static_cast<double>(count) / static_cast<double>(lengths.size()));
+}
+
+} // namespace
+
+void* operator new(size_t n)
+{
+  ++allocations;
+  if (void* p = std::malloc(n == 0 ? 1 : n)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  std::free(p);
+}
+
+int main()
+{
+  std::mt19937 rng(1);
+  std::vector<uint8_t> short_lengths(sequences);
+  std::vector<uint8_t> long_lengths(sequences);
+  for (auto& n : short_lengths) n = static_cast<uint8_t>(1 + rng() % 8);
+  for (auto& n : long_lengths) n = static_cast<uint8_t>(9 + rng() % 8);
+
+  std::printf("1 to 8 elements\n");
+  run<mystl::small_vector<int, 8>>("small_vector<int, 8>", short_lengths);
+  run<mystl::vector<int>>("vector<int>", short_lengths);
+  run<std::vector<int>>("std::vector<int>", short_lengths);
+
+  std::printf("9 to 16 elements\n");
+  run<mystl::small_vector<int, 8>>("small_vector<int, 8>", long_lengths);
+  run<mystl::vector<int>>("vector<int>", long_lengths);
+  run<std::vector<int>>("std::vector<int>", long_lengths);
+  return 0;
+}
@@ -0,0 +1,98 @@
+// 4M rows of {id, price, qty, lot}, 50 passes over one or two int fields:
+// a std::vector of structs against the columns of a soa_vector, summed by a
+// plain loop and by accumulate / inner_product
+// configure with -DCMAKE_CXX_FLAGS=-mavx2 to time the 256-bit kernels
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "numeric.h"
+#include "soa_vector.h"
+
+#include "bench.h"
+
+namespace
+{
+
+const size_t rows = 4000000;
+const int    passes = 50;
+
+struct row
+{
+  int64_t id;
+  double  price;
+  int32_t qty;
+  int32_t lot;
+};
+
+} // namespace
+
+int main()
+{
+  std::mt19937 rng(1);
+  std::vector<row> aos(rows);
+  mystl::soa_vector<int64_t, double, int32_t, int32_t> soa;
+  soa.reserve(rows);
+  for (size_t i = 0; i < rows; ++i)
+  {
+    row& r = aos[i];
+    r.id = static_cast<int64_t>(i);
+    r.price = static_cast<double>(rng() % 10000) / 100;
+    r.qty = static_cast<int32_t>(rng() % 1000);
+    r.lot = static_cast<int32_t>(rng() % 8 + 1);
+    soa.emplace_back(r.id, r.price, r.qty, r.lot);
+  }
+  const int32_t* qty = soa.data<2>();
+  const int32_t* lot = soa.data<3>();
+  int64_t sum = 0;
+
+  bench::report("sum qty: structs, loop", bench::best_of(3, [&]
+  {
+    for (int p = 0; p < passes; ++p)
+    {
+      int64_t s = 0;
+      for (size_t i = 0; i < rows; ++i) s += aos[i].qty;
+      sum += s;
+    }
+  }));
+  bench::report("sum qty: column, loop", bench::best_of(3, [&]
+  {
+    for (int p = 0; p < passes; ++p)
+    {
+      int64_t s = 0;
+      for (size_t i = 0; i < rows; ++i) s += qty[i];
+      sum += s;
+    }
+  }));
+  bench::report("sum qty: column, accumulate", bench::best_of(3, [&]
+  {
+    for (int p = 0; p < passes; ++p) sum += mystl::accumulate(qty, qty + rows, int64_t(0));
+  }));
+
+  bench::report("qty * lot: structs, loop", bench::best_of(3, [&]
+  {
+    for (int p = 0; p < passes; ++p)
+    {
+      int64_t s = 0;
+      for (size_t i = 0; i < rows; ++i) s += aos[i].qty * aos[i].lot;
+      sum += s;
+    }
+  }));
+  bench::report("qty * lot: columns, loop", bench::best_of(3, [&]
+  {
+    for (int p = 0; p < passes; ++p)
+    {
+      int64_t s = 0;
+      for (size_t i = 0; i < rows; ++i) s += qty[i] * lot[i];
+      sum += s;
+    }
+  }));
+  bench::report("qty * lot: columns, inner_product", bench::best_of(3, [&]
+  {
+    for (int p = 0; p < passes; ++p)
+      sum += mystl::inner_product(qty, qty + rows, lot, lot + rows, int64_t(0));
+  }));
+  bench::keep(sum);
+  return 0;
+}
@@ -0,0 +1,81 @@
+// sort and stable_sort against std::sort and std::stable_sort
+// 5M ints in several shapes, 5M doubles and 1M short strings
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "algo_sort.h"
+
+#include "bench.h"
+
+namespace
+{
+
+const size_t length = 5000000;
+
+template <class T>
+void run(const char* shape, const std::vector<T>& v)
+{
+  char name[80];
+  std::vector<T> a;
+  const auto time = [&](void (*sort)(std::vector<T>&))
+  {
+    return bench::best_of(3, [&]
+    {
+      a = v;
+      sort(a);
+    });
+  };
+  // the copy is timed with the sort, so time it alone to subtract it
+  const double copy = bench::best_of(3, [&] { a = v; });
+
+  std::snprintf(name, sizeof(name), "%s std::sort", shape);
+  bench::report(name, time([](std::vector<T>& x) { std::sort(x.begin(), x.end()); }) - copy);
+  std::snprintf(name, sizeof(name), "%s mystl::sort", shape);
+  bench::report(name, time([](std::vector<T>& x)
+  {
+    mystl::sort(x.data(), x.data() + x.size());
+  }) - copy);
+  std::snprintf(name, sizeof(name), "%s std::stable_sort", shape);
+  bench::report(name, time([](std::vector<T>& x)
+  {
+    std::stable_sort(x.begin(), x.end());
+  }) - copy);
+  std::snprintf(name, sizeof(name), "%s mystl::stable_sort", shape);
+  bench::report(name, time([](std::vector<T>& x)
+  {
+    mystl::stable_sort(x.data(), x.data() + x.size());
+  }) - copy);
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937 rng(1);
+  std::vector<int> v(length);
+  for (auto& x : v) x = static_cast<int>(rng());
+  run("random int", v);
+
+  for (auto& x : v) x = static_cast<int>(rng() % 16);
+  run("16 distinct int", v);
+
+  std::sort(v.begin(), v.end());
+  for (size_t i = 0; i < length / 1000; ++i) std::swap(v[rng() % length], v[rng() % length]);
+  run("nearly sorted int", v);
+
+  std::sort(v.begin(), v.end(), std::greater<int>());
+  run("reverse sorted int", v);
+
+  std::vector<double> d(length);
+  for (auto& x : d) x = std::generate_canonical<double, 53>(rng);
+  run("random double", d);
+
+  std::vector<std::string> s(length / 5);
+  for (auto& x : s) x = std::to_string(rng());
+  run("random string", s);
+  return 0;
+}
@@ -0,0 +1,72 @@
+// searches over a 4 MB string that find only matches at the end and rfind
+// only at the start, 50 times each, and 3M short keys built from pieces;
+// string against std::string
+// configure with -DCMAKE_CXX_FLAGS="-mavx2 -msse4.2" to time the wider kernels
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "basic_string.h"
+
+#include "bench.h"
+
+namespace
+{
+
+const size_t text_size = 4 << 20;
+const int    runs = 50;
+const size_t keys = 3000000;
+
+template <class Str>
+void run(const char* name, const std::string& text)
+{
+  const Str s(text.data(), text.size());
+  const Str last("needle!");
+  const Str first("origin#");
+  const Str set("!?");
+  uint64_t sum = 0;
+  std::string line(name);
+
+  bench::report((line + " find").c_str(), bench::best_of(3, [&]
+  {
+    for (int i = 0; i < runs; ++i) sum += s.find(last);
+  }));
+  bench::report((line + " rfind").c_str(), bench::best_of(3, [&]
+  {
+    for (int i = 0; i < runs; ++i) sum += s.rfind(first);
+  }));
+  bench::report((line + " find_first_of").c_str(), bench::best_of(3, [&]
+  {
+    for (int i = 0; i < runs; ++i) sum += s.find_first_of(set);
+  }));
+  bench::report((line + " build 23-char keys").c_str(), bench::best_of(3, [&]
+  {
+    const Str prefix("user:");
+    for (size_t i = 0; i < keys; ++i)
+    {
+      Str key(prefix);
+      key.append(text.data() + i % 1024, 14);
+      key += ':';
+      key.append(3, static_cast<char>('0' + i % 10));
+      sum += key.size();
+    }
+  }));
+  bench::keep(sum);
+}
+
+} // namespace
+
+int main()
+{
+  // letters only, so the patterns and the set match only at the ends
+  std::mt19937 rng(1);
+  std::string text(text_size, ' ');
+  for (auto& c : text) c = static_cast<char>('a' + rng() % 26);
+  text.replace(0, 7, "origin#");
+  text.replace(text_size - 7, 7, "needle!");
+
+  run<mystl::string>("string", text);
+  run<std::string>("std::string", text);
+  return 0;
+}
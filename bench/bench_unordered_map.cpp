@@ -0,0 +1,82 @@
+// 1M inserts, then 4M lookups of which half miss
+// unordered_map against std::unordered_map, on 64-bit and on 32-byte string keys
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "basic_string.h"
+#include "unordered_map.h"
+
+#include "bench.h"
+
+namespace
+{
+
+const size_t inserts = 1000000;
+const size_t lookups = 4000000;
+
+template <class Map, class Key>
+void run(const char* name, const std::vector<Key>& keys, const std::vector<Key>& probes)
+{
+  uint64_t sum = 0;
+  const double t_insert = bench::best_of(3, [&]
+  {
+    Map m;
+    for (size_t i = 0; i < keys.size(); ++i) m[keys[i]] = static_cast<int>(i);
+    sum += m.size();
+  });
+  Map m;
+  for (size_t i = 0; i < keys.size(); ++i) m[keys[i]] = static_cast<int>(i);
+  const double t_find = bench::best_of(3, [&]
+  {
+    for (const auto& k : probes)
+    {
+      auto it = m.find(k);
+      if (it != m.end()) sum += static_cast<uint64_t>(it->second);
+    }
+  });
+  bench::keep(sum);
+  std::string line(name);
+  bench::report((line + " insert").c_str(), t_insert);
+  bench::report((line + " find").c_str(), t_find);
+}
+
+template <class Str>
+std::vector<Str> string_keys(const std::vector<uint64_t>& ints)
+{
+  std::vector<Str> keys;
+  keys.reserve(ints.size());
+  for (auto x : ints)
+  {
+    char buf[32];
+    for (size_t i = 0; i < sizeof(buf); ++i)
+      buf[i] = static_cast<char>('a' + (x >> (i % 16 * 4) & 15));
+    keys.push_back(Str(buf, sizeof(buf)));
+  }
+  return keys;
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937_64 rng(1);
+  std::vector<uint64_t> keys(inserts);
+  for (auto& k : keys) k = rng();
+  // every even probe is a key, every odd one is a miss
+  std::vector<uint64_t> probes(lookups);
+  for (size_t i = 0; i < lookups; ++i)
+    probes[i] = i % 2 ? rng() : keys[rng() % inserts];
+
+  run<mystl::unordered_map<uint64_t, int>>("unordered_map<uint64_t>", keys, probes);
+  run<std::unordered_map<uint64_t, int>>("std::unordered_map<uint64_t>", keys, probes);
+
+  run<mystl::unordered_map<mystl::string, int>>("unordered_map<string>",
+    string_keys<mystl::string>(keys), string_keys<mystl::string>(probes));
+  run<std::unordered_map<std::string, int>>("std::unordered_map<string>",
+    string_keys<std::string>(keys), string_keys<std::string>(probes));
+  return 0;
+}
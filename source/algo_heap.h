@@ -3,8 +3,13 @@
 
 // algorithm for heap
 // make_heap, push_heap, pop_heap, sort_heap
+// make_dary_heap, push_dary_heap, pop_dary_heap, sort_dary_heap
+
+#include <cstddef>
 
 #include "iterator.h"
+#include "functional.h" // mystl::less
+#include "util.h"       // mystl::move
 
 namespace mystl
 {
@@ -12,6 +17,7 @@ namespace mystl
 /********************************************************************************/
 // push_heap
 // insert new element at the end of container, and adjust heap
+// elements are moved along the path, val is moved into the final hole
 /********************************************************************************/
 // ver1: <, max-heap
 template <class RIter, class Distance, class T>
@@ -21,23 +27,24 @@ void push_heap_ad(RIter first, Distance holeIdx, Distance topIdx, T val)
   auto parent = (holeIdx - 1) / 2;
   while (holeIdx > topIdx && *(first + parent) < val)
   {
-    *(first + holeIdx) = *(first + parent);
+    *(first + holeIdx) = mystl::move(*(first + parent));
     holeIdx = parent;
     parent = (holeIdx - 1) / 2;
   }
-  *(first + holeIdx) = value;
+  *(first + holeIdx) = mystl::move(val);
 }
 
 template <class RIter, class Distance>
 void push_heap_aux(RIter first, RIter last, Distance*)
 {
-  mystl::push_heap_ad(first, last - first - 1, static_cast<Distance>(0),
-    *(last - 1));
+  mystl::push_heap_ad(first, static_cast<Distance>(last - first - 1),
+    static_cast<Distance>(0), mystl::move(*(last - 1)));
 }
 
 template <class RIter>
 void push_heap(RIter first, RIter last)
 {
+  if (last - first < 2) return;
   mystl::push_heap_aux(first, last, distance_type(first));
 }
 
@@ -49,29 +56,33 @@ void push_heap_ad(RIter first, Distance holeIdx, Distance topIdx, T val,
   auto parent = (holeIdx - 1) / 2;
   while (holeIdx > topIdx && comp(*(first + parent), val))
   {
-    *(first + holeIdx) = *(first + parent);
+    *(first + holeIdx) = mystl::move(*(first + parent));
     holeIdx = parent;
     parent = (holeIdx - 1) / 2;
   }
-  *(first + holeIdx) = value;
+  *(first + holeIdx) = mystl::move(val);
 }
 
 template <class RIter, class Distance, class Compare>
 void push_heap_aux(RIter first, RIter last, Distance*, Compare comp)
 {
-  mystl::push_heap_ad(first, last - first - 1, static_cast<Distance>(0),
-    *(last - 1), comp);
+  mystl::push_heap_ad(first, static_cast<Distance>(last - first - 1),
+    static_cast<Distance>(0), mystl::move(*(last - 1)), comp);
 }
 
 template <class RIter, class Compare>
 void push_heap(RIter first, RIter last, Compare comp)
 {
+  if (last - first < 2) return;
   mystl::push_heap_aux(first, last, distance_type(first), comp);
 }
 
 /********************************************************************************/
 // pop_heap
 // move element at root to the end of container, and adjust heap
+// bottom-up: the hole at the root sinks to a leaf along the larger children
+// with one comparison per level, then val rises from that leaf; val mostly
+// comes from the bottom of the heap, so it rarely rises far
 /********************************************************************************/
 // ver1: <, max-heap
 template <class RIter, class Distance, class T>
@@ -82,31 +93,34 @@ void pop_heap_ad(RIter first, Distance holeIdx, Distance len, T val)
   auto rchild = 2 * holeIdx + 2;
   while (rchild < len)
   {
-    if (*(first + rchild) < *(first + rchild - 1)) --rchild;
-    *(first + holeIdx) = *(first + rchild);
+    if (*(first + rchild) < *(first + (rchild - 1))) --rchild;
+    *(first + holeIdx) = mystl::move(*(first + rchild));
+    holeIdx = rchild;
     rchild = 2 * rchild + 2;
   }
-  if (rchild == len)
+  if (rchild == len) // if no right child
   {
-    *(first + holeIdx) = *(first + rchild - 1);
+    *(first + holeIdx) = mystl::move(*(first + (rchild - 1)));
     holeIdx = rchild - 1;
   }
   // percolate up
-  mystl::push_heap_ad(first, holeIdx, topIdx, val);
+  mystl::push_heap_ad(first, holeIdx, topIdx, mystl::move(val));
 }
 
 template <class RIter, class Distance, class T>
 void pop_heap_aux(RIter first, RIter last, RIter result, Distance*, T val)
 {
-  *result = *first;
-  mystl::pop_heap_ad(first, static_cast<Distance>(0), last - first, val);
+  *result = mystl::move(*first);
+  mystl::pop_heap_ad(first, static_cast<Distance>(0),
+    static_cast<Distance>(last - first), mystl::move(val));
 }
 
 template <class RIter>
 void pop_heap(RIter first, RIter last)
 {
+  if (last - first < 2) return;
   mystl::pop_heap_aux(first, last - 1, last - 1, distance_type(first),
-    *(last - 1));
+    mystl::move(*(last - 1)));
 }
 
 // ver2: comp
@@ -119,33 +133,35 @@ void pop_heap_ad(RIter first, Distance holeIdx, Distance len, T val,
   auto rchild = 2 * holeIdx + 2;
   while (rchild < len)
   {
-    if (comp(*(first + rchild), *(first + rchild - 1))) --rchild;
-    *(first + holeIdx) = *(first + rchild);
+    if (comp(*(first + rchild), *(first + (rchild - 1)))) --rchild;
+    *(first + holeIdx) = mystl::move(*(first + rchild));
+    holeIdx = rchild;
     rchild = 2 * rchild + 2;
   }
   if (rchild == len) // if no right child
   {
-    *(first + holeIdx) = *(first + rchild - 1);
+    *(first + holeIdx) = mystl::move(*(first + (rchild - 1)));
     holeIdx = rchild - 1;
   }
   // percolate up
-  mystl::push_heap_ad(first, holeIdx, topIdx, val, comp);
+  mystl::push_heap_ad(first, holeIdx, topIdx, mystl::move(val), comp);
 }
 
 template <class RIter, class Distance, class T, class Compare>
 void pop_heap_aux(RIter first, RIter last, RIter result, Distance*, T val,
                   Compare comp)
 {
-  *result = *first;
-  mystl::pop_heap_ad(first, static_cast<Distance>(0), last - first, val,
-    comp);
+  *result = mystl::move(*first);
+  mystl::pop_heap_ad(first, static_cast<Distance>(0),
+    static_cast<Distance>(last - first), mystl::move(val), comp);
 }
 
 template <class RIter, class Compare>
 void pop_heap(RIter first, RIter last, Compare comp)
 {
+  if (last - first < 2) return;
   mystl::pop_heap_aux(first, last - 1, last - 1, distance_type(first),
-    *(last - 1), comp);
+    mystl::move(*(last - 1)), comp);
 }
 
 /********************************************************************************/
@@ -175,17 +191,20 @@ void sort_heap(RIter first, RIter last, Compare comp)
 /********************************************************************************/
 // make_heap
 // make a heap with all elements in container
+// Floyd: sift every internal node down, from the last one to the root,
+// which takes O(n) moves and comparisons in total
 /********************************************************************************/
 // ver1: <, max-heap
 template <class RIter, class Distance>
 void make_heap_aux(RIter first, RIter last, Distance*)
 {
   if (last - first < 2) return;
-  auto len = last - first;
-  auto holeIdx = (len - 1) / 2;
+  auto len = static_cast<Distance>(last - first);
+  auto holeIdx = (len - 2) / 2;
   while (true)
   {
-    mystl::pop_heap_ad(first, holeIdx, len, *(first + holeIdx));
+    auto val = mystl::move(*(first + holeIdx));
+    mystl::pop_heap_ad(first, holeIdx, len, mystl::move(val));
     if (holeIdx == 0) return;
     --holeIdx;
   }
@@ -202,11 +221,12 @@ template <class RIter, class Distance, class Compare>
 void make_heap_aux(RIter first, RIter last, Distance*, Compare comp)
 {
   if (last - first < 2) return;
-  auto len = last - first;
-  auto holeIdx = (len - 1) / 2;
+  auto len = static_cast<Distance>(last - first);
+  auto holeIdx = (len - 2) / 2;
   while (true)
   {
-    mystl::pop_heap_ad(first, holeIdx, len, *(first + holeIdx), comp);
+    auto val = mystl::move(*(first + holeIdx));
+    mystl::pop_heap_ad(first, holeIdx, len, mystl::move(val), comp);
     if (holeIdx == 0) return;
     --holeIdx;
   }
@@ -218,6 +238,167 @@ void make_heap(RIter first, RIter last, Compare comp)
   mystl::make_heap_aux(first, last, distance_type(first), comp);
 }
 
+/********************************************************************************/
+// d-ary heap
+// push_dary_heap, pop_dary_heap, make_dary_heap, sort_dary_heap
+// node i has children D*i+1 ... D*i+D, so the tree has log_D(n) levels and
+// the D children compared at each level sit next to each other
+// every group of children starts at first + 1 + D*i, so when D * sizeof(T)
+// divides the cache line size and first + 1 is on a line boundary, no group
+// straddles two lines; place the root one element before an aligned address
+// to get that layout
+/********************************************************************************/
+// percolate up
+template <size_t D, class RIter, class Distance, class T, class Compare>
+void dary_push_heap_ad(RIter first, Distance holeIdx, Distance topIdx, T val,
+                       Compare comp)
+{
+  auto parent = (holeIdx - 1) / static_cast<Distance>(D);
+  while (holeIdx > topIdx && comp(*(first + parent), val))
+  {
+    *(first + holeIdx) = mystl::move(*(first + parent));
+    holeIdx = parent;
+    parent = (holeIdx - 1) / static_cast<Distance>(D);
+  }
+  *(first + holeIdx) = mystl::move(val);
+}
+
+// percolate the hole at holeIdx down to a leaf along the largest children,
+// then percolate val up from there
+template <size_t D, class RIter, class Distance, class T, class Compare>
+void dary_adjust_heap(RIter first, Distance holeIdx, Distance len, T val,
+                      Compare comp)
+{
+  const auto d = static_cast<Distance>(D);
+  auto topIdx = holeIdx;
+  auto child = d * holeIdx + 1;
+  while (child < len)
+  {
+    auto best = child;
+    const auto last_child = len - child > d ? child + d : len;
+    for (auto i = child + 1; i < last_child; ++i)
+    {
+      if (comp(*(first + best), *(first + i))) best = i;
+    }
+    *(first + holeIdx) = mystl::move(*(first + best));
+    holeIdx = best;
+    child = d * holeIdx + 1;
+  }
+  mystl::dary_push_heap_ad<D>(first, holeIdx, topIdx, mystl::move(val), comp);
+}
+
+// push_dary_heap
+// ver1: <, max-heap
+template <size_t D, class RIter>
+void push_dary_heap(RIter first, RIter last)
+{
+  static_assert(D >= 2, "a heap node needs at least 2 children");
+  typedef typename iterator_traits<RIter>::difference_type Distance;
+  typedef typename iterator_traits<RIter>::value_type      T;
+  if (last - first < 2) return;
+  mystl::dary_push_heap_ad<D>(first, static_cast<Distance>(last - first - 1),
+    static_cast<Distance>(0), mystl::move(*(last - 1)), mystl::less<T>());
+}
+
+// ver2: comp
+template <size_t D, class RIter, class Compare>
+void push_dary_heap(RIter first, RIter last, Compare comp)
+{
+  static_assert(D >= 2, "a heap node needs at least 2 children");
+  typedef typename iterator_traits<RIter>::difference_type Distance;
+  if (last - first < 2) return;
+  mystl::dary_push_heap_ad<D>(first, static_cast<Distance>(last - first - 1),
+    static_cast<Distance>(0), mystl::move(*(last - 1)), comp);
+}
+
+// pop_dary_heap
+// ver1: <, max-heap
+template <size_t D, class RIter>
+void pop_dary_heap(RIter first, RIter last)
+{
+  static_assert(D >= 2, "a heap node needs at least 2 children");
+  typedef typename iterator_traits<RIter>::difference_type Distance;
+  typedef typename iterator_traits<RIter>::value_type      T;
+  if (last - first < 2) return;
+  auto val = mystl::move(*(last - 1));
+  *(last - 1) = mystl::move(*first);
+  mystl::dary_adjust_heap<D>(first, static_cast<Distance>(0),
+    static_cast<Distance>(last - first - 1), mystl::move(val), mystl::less<T>());
+}
+
+// ver2: comp
+template <size_t D, class RIter, class Compare>
+void pop_dary_heap(RIter first, RIter last, Compare comp)
+{
+  static_assert(D >= 2, "a heap node needs at least 2 children");
+  typedef typename iterator_traits<RIter>::difference_type Distance;
+  if (last - first < 2) return;
+  auto val = mystl::move(*(last - 1));
+  *(last - 1) = mystl::move(*first);
+  mystl::dary_adjust_heap<D>(first, static_cast<Distance>(0),
+    static_cast<Distance>(last - first - 1), mystl::move(val), comp);
+}
+
+// sort_dary_heap
+// ver1: <, max-heap
+template <size_t D, class RIter>
+void sort_dary_heap(RIter first, RIter last)
+{
+  while (last - first > 1)
+  {
+    mystl::pop_dary_heap<D>(first, last--);
+  }
+}
+
+// ver2: comp
+template <size_t D, class RIter, class Compare>
+void sort_dary_heap(RIter first, RIter last, Compare comp)
+{
+  while (last - first > 1)
+  {
+    mystl::pop_dary_heap<D>(first, last--, comp);
+  }
+}
+
+// make_dary_heap
+// ver1: <, max-heap
+template <size_t D, class RIter>
+void make_dary_heap(RIter first, RIter last)
+{
+  static_assert(D >= 2, "a heap node needs at least 2 children");
+  typedef typename iterator_traits<RIter>::difference_type Distance;
+  typedef typename iterator_traits<RIter>::value_type      T;
+  const auto len = static_cast<Distance>(last - first);
+  if (len < 2) return;
+  auto holeIdx = (len - 2) / static_cast<Distance>(D);
+  while (true)
+  {
+    auto val = mystl::move(*(first + holeIdx));
+    mystl::dary_adjust_heap<D>(first, holeIdx, len, mystl::move(val),
+                               mystl::less<T>());
+    if (holeIdx == 0) return;
+    --holeIdx;
+  }
+}
+
+// ver2: comp
+template <size_t D, class RIter, class Compare>
+void make_dary_heap(RIter first, RIter last, Compare comp)
+{
+  static_assert(D >= 2, "a heap node needs at least 2 children");
+  typedef typename iterator_traits<RIter>::difference_type Distance;
+  const auto len = static_cast<Distance>(last - first);
+  if (len < 2) return;
+  auto holeIdx = (len - 2) / static_cast<Distance>(D);
+  while (true)
+  {
+    auto val = mystl::move(*(first + holeIdx));
+    mystl::dary_adjust_heap<D>(first, holeIdx, len, mystl::move(val), comp);
+    if (holeIdx == 0) return;
+    --holeIdx;
+  }
+}
+
 } // namespace mystl
 
 #endif // !_LITESTL_ALGO_HEAP_H_
\ No newline at end of file
@@ -0,0 +1,319 @@
+#ifndef _LITESTL_ALGO_MERGE_H_
+#define _LITESTL_ALGO_MERGE_H_
+
+// algorithm for merging sorted ranges
+// merge, loser_tree, multiway_merge, multiway_set_union
+
+#include "iterator.h"
+#include "algobase.h"   // mystl::copy
+#include "allocator.h"
+#include "functional.h" // mystl::less
+#include "util.h"       // mystl::pair
+
+namespace mystl
+{
+
+/********************************************************************************/
+// merge
+// merge sorted [first1, last1) and [first2, last2) into one sorted range
+// equal elements are taken from the first range first, so the merge is stable
+// return an iter pointing to the end of result
+/********************************************************************************/
+template <class IIter1, class IIter2, class OIter, class Compare>
+OIter merge_aux(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2,
+                OIter result, Compare comp)
+{
+  while (first1 != last1 && first2 != last2)
+  {
+    if (comp(*first2, *first1))
+    {
+      *result = *first2;
+      ++first2;
+    }
+    else
+    {
+      *result = *first1;
+      ++first1;
+    }
+    ++result;
+  }
+  return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
+}
+
+// ver1: <
+template <class IIter1, class IIter2, class OIter>
+OIter merge(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2,
+            OIter result)
+{
+  typedef typename iterator_traits<IIter1>::value_type T;
+  return mystl::merge_aux(first1, last1, first2, last2, result, mystl::less<T>());
+}
+
+// ver2: comp
+template <class IIter1, class IIter2, class OIter, class Compare>
+OIter merge(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2,
+            OIter result, Compare comp)
+{
+  return mystl::merge_aux(first1, last1, first2, last2, result, comp);
+}
+
+/********************************************************************************/
+
+// template class: loser_tree
+// tournament tree over k sorted sources, each internal node keeps the loser of
+// the match played there and tree_[0] keeps the overall winner, so replacing
+// the winner costs one path of ceil(log2(k)) comparisons from leaf to root
+// equal elements are taken from the source with the smaller index first
+template <class IIter, class Compare>
+class loser_tree
+{
+public:
+  typedef IIter  iterator;
+  typedef size_t size_type;
+
+private:
+  size_type  n_;     // number of sources
+  size_type  k_;     // number of leaves, n_ rounded up to a power of 2
+  size_type  live_;  // number of sources not yet exhausted
+  size_type* tree_;  // tree_[0]: winner, tree_[1, k_): losers
+  IIter*     cur_;   // current position of each source
+  IIter*     last_;  // end of each source
+  Compare    comp_;
+
+public:
+  // construct from a range of mystl::pair<IIter, IIter>
+  template <class RangeIter>
+  loser_tree(RangeIter first, RangeIter last, Compare comp);
+
+  ~loser_tree();
+
+public:
+  // all sources are exhausted
+  bool empty() const noexcept
+  {
+    return live_ == 0;
+  }
+  size_type live() const noexcept
+  {
+    return live_;
+  }
+
+  // index of the source holding the smallest element
+  size_type top_source() const noexcept
+  {
+    return tree_[0];
+  }
+  // position and end of the source holding the smallest element
+  const IIter& top() const noexcept
+  {
+    return cur_[tree_[0]];
+  }
+  const IIter& top_last() const noexcept
+  {
+    return last_[tree_[0]];
+  }
+
+  // consume the smallest element and replay its path
+  void pop();
+
+private:
+  bool done(size_type i) const
+  {
+    return i >= n_ || cur_[i] == last_[i];
+  }
+  // source a should be taken before source b
+  bool beats(size_type a, size_type b) const
+  {
+    if (done(a)) return false;
+    if (done(b)) return true;
+    return a < b ? !comp_(*cur_[b], *cur_[a]) : comp_(*cur_[a], *cur_[b]);
+  }
+
+  size_type build(size_type node);
+  void      replay(size_type winner);
+
+private:
+  loser_tree(const loser_tree&);
+
+  void operator=(const loser_tree&);
+};
+
+// construct
+template <class IIter, class Compare>
+template <class RangeIter>
+loser_tree<IIter, Compare>::loser_tree(RangeIter first, RangeIter last,
+                                       Compare comp)
+  :n_(0), k_(1), live_(0), tree_(nullptr), cur_(nullptr), last_(nullptr),
+  comp_(comp)
+{
+  n_ = static_cast<size_type>(mystl::distance(first, last));
+  while (k_ < n_) k_ <<= 1;
+  tree_ = mystl::allocator<size_type>::allocate(k_);
+  if (n_ != 0)
+  {
+    cur_ = mystl::allocator<IIter>::allocate(n_);
+    last_ = mystl::allocator<IIter>::allocate(n_);
+  }
+  for (size_type i = 0; i < n_; ++i, ++first)
+  {
+    mystl::construct(cur_ + i, (*first).first);
+    mystl::construct(last_ + i, (*first).second);
+    if (cur_[i] != last_[i]) ++live_;
+  }
+  tree_[0] = build(1);
+}
+
+template <class IIter, class Compare>
+loser_tree<IIter, Compare>::~loser_tree()
+{
+  mystl::destroy(cur_, cur_ + n_);
+  mystl::destroy(last_, last_ + n_);
+  mystl::allocator<IIter>::deallocate(cur_, n_);
+  mystl::allocator<IIter>::deallocate(last_, n_);
+  mystl::allocator<size_type>::deallocate(tree_, k_);
+}
+
+// play all matches below node, record losers and return the winner
+template <class IIter, class Compare>
+typename loser_tree<IIter, Compare>::size_type
+loser_tree<IIter, Compare>::build(size_type node)
+{
+  if (node >= k_) return node - k_;
+  auto lhs = build(2 * node);
+  auto rhs = build(2 * node + 1);
+  if (beats(lhs, rhs))
+  {
+    tree_[node] = rhs;
+    return lhs;
+  }
+  tree_[node] = lhs;
+  return rhs;
+}
+
+// replay matches from the leaf of winner up to the root
+template <class IIter, class Compare>
+void loser_tree<IIter, Compare>::replay(size_type winner)
+{
+  for (auto node = (winner + k_) >> 1; node > 0; node >>= 1)
+  {
+    if (beats(tree_[node], winner)) mystl::swap(tree_[node], winner);
+  }
+  tree_[0] = winner;
+}
+
+template <class IIter, class Compare>
+void loser_tree<IIter, Compare>::pop()
+{
+  auto winner = tree_[0];
+  if (++cur_[winner] == last_[winner]) --live_;
+  replay(winner);
+}
+
+/********************************************************************************/
+// multiway_merge
+// merge sorted ranges [first->first, first->second) ... into one sorted range
+// equal elements keep the order of their ranges, so the merge is stable
+// return an iter pointing to the end of result
+/********************************************************************************/
+template <class RangeIter, class OIter, class Compare>
+OIter multiway_merge_aux(RangeIter first, RangeIter last, OIter result,
+                         Compare comp)
+{
+  typedef typename iterator_traits<RangeIter>::value_type::first_type IIter;
+  mystl::loser_tree<IIter, Compare> tree(first, last, comp);
+  while (tree.live() > 1)
+  {
+    *result = *tree.top();
+    ++result;
+    tree.pop();
+  }
+  // only one source left, no more matches to play
+  if (!tree.empty()) result = mystl::copy(tree.top(), tree.top_last(), result);
+  return result;
+}
+
+// ver1: <
+template <class RangeIter, class OIter>
+OIter multiway_merge(RangeIter first, RangeIter last, OIter result)
+{
+  typedef typename iterator_traits<RangeIter>::value_type::first_type IIter;
+  typedef typename iterator_traits<IIter>::value_type                 T;
+  return mystl::multiway_merge_aux(first, last, result, mystl::less<T>());
+}
+
+// ver2: comp
+template <class RangeIter, class OIter, class Compare>
+OIter multiway_merge(RangeIter first, RangeIter last, OIter result,
+                     Compare comp)
+{
+  return mystl::multiway_merge_aux(first, last, result, comp);
+}
+
+/********************************************************************************/
+// multiway_set_union
+// S1+S2+...+Sn
+// an element appearing m_i times in S_i appears max(m_i) times in result,
+// taken from the first ranges that hold it, like set_union does for 2 ranges
+// return an iter pointing to the end of result
+/********************************************************************************/
+template <class RangeIter, class OIter, class Compare>
+OIter multiway_set_union_aux(RangeIter first, RangeIter last, OIter result,
+                             Compare comp)
+{
+  typedef typename iterator_traits<RangeIter>::value_type::first_type FIter;
+  mystl::loser_tree<FIter, Compare> tree(first, last, comp);
+  while (tree.live() > 1)
+  {
+    // the first source holding the smallest key emits its whole run
+    const auto src = tree.top_source();
+    const FIter run = tree.top();
+    size_t emitted = 0;
+    do
+    {
+      *result = *tree.top();
+      ++result; ++emitted;
+      tree.pop();
+    } while (!tree.empty() && tree.top_source() == src &&
+             !comp(*run, *tree.top()));
+    // other sources only emit the copies beyond the longest run so far
+    while (!tree.empty() && !comp(*run, *tree.top()))
+    {
+      const auto other = tree.top_source();
+      size_t count = 0;
+      do
+      {
+        if (count++ >= emitted)
+        {
+          *result = *tree.top();
+          ++result;
+        }
+        tree.pop();
+      } while (!tree.empty() && tree.top_source() == other &&
+               !comp(*run, *tree.top()));
+      if (count > emitted) emitted = count;
+    }
+  }
+  if (!tree.empty()) result = mystl::copy(tree.top(), tree.top_last(), result);
+  return result;
+}
+
+// ver1: <
+template <class RangeIter, class OIter>
+OIter multiway_set_union(RangeIter first, RangeIter last, OIter result)
+{
+  typedef typename iterator_traits<RangeIter>::value_type::first_type FIter;
+  typedef typename iterator_traits<FIter>::value_type                 T;
+  return mystl::multiway_set_union_aux(first, last, result, mystl::less<T>());
+}
+
+// ver2: comp
+template <class RangeIter, class OIter, class Compare>
+OIter multiway_set_union(RangeIter first, RangeIter last, OIter result,
+                         Compare comp)
+{
+  return mystl::multiway_set_union_aux(first, last, result, comp);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_ALGO_MERGE_H_
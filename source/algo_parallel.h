@@ -0,0 +1,491 @@
+#ifndef _LITESTL_ALGO_PARALLEL_H_
+#define _LITESTL_ALGO_PARALLEL_H_
+
+// parallel algorithm for random access ranges
+// parallel_set_union, parallel_set_intersection, parallel_set_difference,
+// parallel_set_symmetric_difference, parallel_merge, parallel_sort
+
+#include <cstddef>
+
+#include "iterator.h"
+#include "algobase.h"   // mystl::lower_bound
+#include "algo_merge.h" // mystl::merge
+#include "algo_set.h"
+#include "algo_sort.h"  // mystl::sort
+#include "functional.h" // mystl::less
+#include "memory.h"     // mystl::scratch_buffer
+#include "parallel.h"
+#include "util.h"       // mystl::pair
+
+namespace mystl
+{
+
+// minimum number of input elements handled by one thread
+const size_t parallel_set_grain = 1 << 16;
+
+/********************************************************************************/
+// merge_path_split
+// co-rank of diag in the merge of sorted [first1, first1 + n1) and
+// [first2, first2 + n2): return how many of the first diag elements of the
+// stable merge come from S1, S1 winning ties
+/********************************************************************************/
+template <class RIter1, class RIter2, class Compare>
+ptrdiff_t merge_path_split(RIter1 first1, ptrdiff_t n1, RIter2 first2,
+                           ptrdiff_t n2, ptrdiff_t diag, Compare comp)
+{
+  auto lo = diag > n2 ? diag - n2 : static_cast<ptrdiff_t>(0);
+  auto hi = diag < n1 ? diag : n1;
+  while (lo < hi)
+  {
+    auto mid = lo + (hi - lo) / 2;
+    if (comp(*(first2 + (diag - mid - 1)), *(first1 + mid))) hi = mid;
+    else lo = mid + 1;
+  }
+  return lo;
+}
+
+/********************************************************************************/
+// set_split_point
+// co-rank of diag in the merge of sorted [first1, first1 + n1) and
+// [first2, first2 + n2): return (i, j), i + j <= diag, such that the first i
+// elements of S1 and the first j elements of S2 are all less than the rest
+// the split is moved back to the start of a run of equal elements, so every
+// key of both ranges falls into exactly one slice
+/********************************************************************************/
+template <class RIter1, class RIter2, class Compare>
+mystl::pair<ptrdiff_t, ptrdiff_t>
+set_split_point(RIter1 first1, ptrdiff_t n1, RIter2 first2, ptrdiff_t n2,
+                ptrdiff_t diag, Compare comp)
+{
+  auto i = mystl::merge_path_split(first1, n1, first2, n2, diag, comp);
+  auto j = diag - i;
+  if (i == n1 && j == n2) return mystl::pair<ptrdiff_t, ptrdiff_t>(i, j);
+  // split in front of the smaller of the two next elements
+  if (i == n1 || (j < n2 && comp(*(first2 + j), *(first1 + i))))
+  {
+    const auto& key = *(first2 + j);
+    i = mystl::lower_bound(first1, first1 + i, key, comp) - first1;
+    j = mystl::lower_bound(first2, first2 + j, key, comp) - first2;
+  }
+  else
+  {
+    const auto& key = *(first1 + i);
+    i = mystl::lower_bound(first1, first1 + i, key, comp) - first1;
+    j = mystl::lower_bound(first2, first2 + j, key, comp) - first2;
+  }
+  return mystl::pair<ptrdiff_t, ptrdiff_t>(i, j);
+}
+
+/********************************************************************************/
+// parallel_set_operation
+// split both ranges at co-ranked positions, count the output of every slice,
+// turn the counts into offsets with a prefix sum and let every thread write
+// its slice of the result independently
+/********************************************************************************/
+template <class RIter1, class RIter2, class RIter3, class Compare, class SetOp>
+RIter3 parallel_set_operation(RIter1 first1, RIter1 last1, RIter2 first2,
+                              RIter2 last2, RIter3 result, Compare comp,
+                              SetOp op)
+{
+  const ptrdiff_t n1 = last1 - first1;
+  const ptrdiff_t n2 = last2 - first2;
+  const size_t parts = mystl::parallel_degree(
+    static_cast<size_t>(n1 + n2), parallel_set_grain);
+  if (parts <= 1) return op(first1, last1, first2, last2, result, comp);
+
+  mystl::scratch_buffer<ptrdiff_t> split1_buf(parts + 1, default_init);
+  mystl::scratch_buffer<ptrdiff_t> split2_buf(parts + 1, default_init);
+  mystl::scratch_buffer<ptrdiff_t> offset_buf(parts + 1, default_init);
+  ptrdiff_t* const split1 = split1_buf.begin();
+  ptrdiff_t* const split2 = split2_buf.begin();
+  ptrdiff_t* const offset = offset_buf.begin();
+  split1[0] = 0; split2[0] = 0;
+  split1[parts] = n1; split2[parts] = n2;
+  for (size_t t = 1; t < parts; ++t)
+  {
+    const auto diag = static_cast<ptrdiff_t>((n1 + n2) * t / parts);
+    const auto p = mystl::set_split_point(first1, n1, first2, n2, diag, comp);
+    split1[t] = p.first;
+    split2[t] = p.second;
+  }
+
+  // count
+  mystl::parallel_invoke_n(parts, [&](size_t t)
+  {
+    offset[t + 1] = static_cast<ptrdiff_t>(
+      op.size(first1 + split1[t], first1 + split1[t + 1],
+              first2 + split2[t], first2 + split2[t + 1], comp));
+  });
+  // prefix sum
+  offset[0] = 0;
+  for (size_t t = 1; t <= parts; ++t) offset[t] += offset[t - 1];
+  // write
+  mystl::parallel_invoke_n(parts, [&](size_t t)
+  {
+    op(first1 + split1[t], first1 + split1[t + 1],
+       first2 + split2[t], first2 + split2[t + 1],
+       result + offset[t], comp);
+  });
+
+  return result + offset[parts];
+}
+
+// sequential set algorithms and their counting versions as function objects
+
+struct set_union_op
+{
+  template <class IIter1, class IIter2, class OIter, class Compare>
+  OIter operator()(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2,
+                   OIter result, Compare comp) const
+  {
+    return mystl::set_union(first1, last1, first2, last2, result, comp);
+  }
+
+  template <class IIter1, class IIter2, class Compare>
+  size_t size(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2,
+              Compare comp) const
+  {
+    return mystl::set_union_size(first1, last1, first2, last2, comp);
+  }
+};
+
+struct set_intersection_op
+{
+  template <class IIter1, class IIter2, class OIter, class Compare>
+  OIter operator()(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2,
+                   OIter result, Compare comp) const
+  {
+    return mystl::set_intersection(first1, last1, first2, last2, result, comp);
+  }
+
+  template <class IIter1, class IIter2, class Compare>
+  size_t size(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2,
+              Compare comp) const
+  {
+    return mystl::set_intersection_size(first1, last1, first2, last2, comp);
+  }
+};
+
+struct set_difference_op
+{
+  template <class IIter1, class IIter2, class OIter, class Compare>
+  OIter operator()(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2,
+                   OIter result, Compare comp) const
+  {
+    return mystl::set_difference(first1, last1, first2, last2, result, comp);
+  }
+
+  template <class IIter1, class IIter2, class Compare>
+  size_t size(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2,
+              Compare comp) const
+  {
+    return mystl::set_difference_size(first1, last1, first2, last2, comp);
+  }
+};
+
+struct set_symmetric_difference_op
+{
+  template <class IIter1, class IIter2, class OIter, class Compare>
+  OIter operator()(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2,
+                   OIter result, Compare comp) const
+  {
+    return mystl::set_symmetric_difference(first1, last1, first2, last2,
+                                           result, comp);
+  }
+
+  template <class IIter1, class IIter2, class Compare>
+  size_t size(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2,
+              Compare comp) const
+  {
+    return mystl::set_symmetric_difference_size(first1, last1, first2, last2, comp);
+  }
+};
+
+/********************************************************************************/
+// parallel_set_union
+// S1+S2, same result as set_union
+/********************************************************************************/
+// ver1: <
+template <class RIter1, class RIter2, class RIter3>
+RIter3 parallel_set_union(RIter1 first1, RIter1 last1, RIter2 first2,
+                          RIter2 last2, RIter3 result)
+{
+  typedef typename iterator_traits<RIter1>::value_type T;
+  return mystl::parallel_set_operation(first1, last1, first2, last2, result,
+                                       mystl::less<T>(),
+                                       mystl::set_union_op());
+}
+
+// ver2: comp
+template <class RIter1, class RIter2, class RIter3, class Compare>
+RIter3 parallel_set_union(RIter1 first1, RIter1 last1, RIter2 first2,
+                          RIter2 last2, RIter3 result, Compare comp)
+{
+  return mystl::parallel_set_operation(first1, last1, first2, last2, result,
+                                       comp, mystl::set_union_op());
+}
+
+/********************************************************************************/
+// parallel_set_intersection
+// S1*S2, same result as set_intersection
+/********************************************************************************/
+// ver1: <
+template <class RIter1, class RIter2, class RIter3>
+RIter3 parallel_set_intersection(RIter1 first1, RIter1 last1, RIter2 first2,
+                                 RIter2 last2, RIter3 result)
+{
+  typedef typename iterator_traits<RIter1>::value_type T;
+  return mystl::parallel_set_operation(first1, last1, first2, last2, result,
+                                       mystl::less<T>(),
+                                       mystl::set_intersection_op());
+}
+
+// ver2: comp
+template <class RIter1, class RIter2, class RIter3, class Compare>
+RIter3 parallel_set_intersection(RIter1 first1, RIter1 last1, RIter2 first2,
+                                 RIter2 last2, RIter3 result, Compare comp)
+{
+  return mystl::parallel_set_operation(first1, last1, first2, last2, result,
+                                       comp, mystl::set_intersection_op());
+}
+
+/********************************************************************************/
+// parallel_set_difference
+// S1-S2, same result as set_difference
+/********************************************************************************/
+// ver1: <
+template <class RIter1, class RIter2, class RIter3>
+RIter3 parallel_set_difference(RIter1 first1, RIter1 last1, RIter2 first2,
+                               RIter2 last2, RIter3 result)
+{
+  typedef typename iterator_traits<RIter1>::value_type T;
+  return mystl::parallel_set_operation(first1, last1, first2, last2, result,
+                                       mystl::less<T>(),
+                                       mystl::set_difference_op());
+}
+
+// ver2: comp
+template <class RIter1, class RIter2, class RIter3, class Compare>
+RIter3 parallel_set_difference(RIter1 first1, RIter1 last1, RIter2 first2,
+                               RIter2 last2, RIter3 result, Compare comp)
+{
+  return mystl::parallel_set_operation(first1, last1, first2, last2, result,
+                                       comp, mystl::set_difference_op());
+}
+
+/********************************************************************************/
+// parallel_set_symmetric_difference
+// (S1-S2)+(S2-S1), same result as set_symmetric_difference
+/********************************************************************************/
+// ver1: <
+template <class RIter1, class RIter2, class RIter3>
+RIter3 parallel_set_symmetric_difference(RIter1 first1, RIter1 last1,
+                                         RIter2 first2, RIter2 last2,
+                                         RIter3 result)
+{
+  typedef typename iterator_traits<RIter1>::value_type T;
+  return mystl::parallel_set_operation(first1, last1, first2, last2, result,
+                                       mystl::less<T>(),
+                                       mystl::set_symmetric_difference_op());
+}
+
+// ver2: comp
+template <class RIter1, class RIter2, class RIter3, class Compare>
+RIter3 parallel_set_symmetric_difference(RIter1 first1, RIter1 last1,
+                                         RIter2 first2, RIter2 last2,
+                                         RIter3 result, Compare comp)
+{
+  return mystl::parallel_set_operation(first1, last1, first2, last2, result,
+                                       comp,
+                                       mystl::set_symmetric_difference_op());
+}
+
+/********************************************************************************/
+// parallel_merge
+// same result as merge: the output is cut into one slice per thread and the
+// inputs are split at the co-ranks of the slice boundaries, so every thread
+// merges its own parts into its own slice
+/********************************************************************************/
+const size_t parallel_merge_grain = 1 << 16;
+
+template <class RIter1, class RIter2, class RIter3, class Compare>
+RIter3 parallel_merge_aux(RIter1 first1, RIter1 last1, RIter2 first2,
+                          RIter2 last2, RIter3 result, Compare comp)
+{
+  const ptrdiff_t n1 = last1 - first1;
+  const ptrdiff_t n2 = last2 - first2;
+  const size_t parts = mystl::parallel_degree(
+    static_cast<size_t>(n1 + n2), parallel_merge_grain);
+  if (parts <= 1) return mystl::merge(first1, last1, first2, last2, result, comp);
+  mystl::parallel_invoke_n(parts, [&](size_t t)
+  {
+    const auto lo = static_cast<ptrdiff_t>((n1 + n2) * t / parts);
+    const auto hi = static_cast<ptrdiff_t>((n1 + n2) * (t + 1) / parts);
+    const auto i_lo = mystl::merge_path_split(first1, n1, first2, n2, lo, comp);
+    const auto i_hi = mystl::merge_path_split(first1, n1, first2, n2, hi, comp);
+    mystl::merge(first1 + i_lo, first1 + i_hi,
+                 first2 + (lo - i_lo), first2 + (hi - i_hi),
+                 result + lo, comp);
+  });
+  return result + (n1 + n2);
+}
+
+// ver1: <
+template <class RIter1, class RIter2, class RIter3>
+RIter3 parallel_merge(RIter1 first1, RIter1 last1, RIter2 first2, RIter2 last2,
+                      RIter3 result)
+{
+  typedef typename iterator_traits<RIter1>::value_type T;
+  return mystl::parallel_merge_aux(first1, last1, first2, last2, result,
+                                   mystl::less<T>());
+}
+
+// ver2: comp
+template <class RIter1, class RIter2, class RIter3, class Compare>
+RIter3 parallel_merge(RIter1 first1, RIter1 last1, RIter2 first2, RIter2 last2,
+                      RIter3 result, Compare comp)
+{
+  return mystl::parallel_merge_aux(first1, last1, first2, last2, result, comp);
+}
+
+/********************************************************************************/
+// parallel_sort
+// samplesort: splitters are picked from a sorted sample, every thread counts
+// how many elements of its chunk fall into each bucket, then moves them to
+// a scratch_buffer at offsets given by a prefix sum of the counts, and the
+// buckets are moved back and sorted as independent tasks; a bucket still
+// too long is sorted by a nested parallel_sort
+// every splitter has a bucket of its own for the elements equal to it, which
+// needs no sorting, so heavy duplicates do not make one bucket huge
+// not stable; the elements need a default constructor; throws std::bad_alloc
+// if the buffer of n elements cannot be allocated, and an exception from
+// comp or from a nested sort reaches the caller after all tasks are done
+/********************************************************************************/
+const size_t parallel_sort_grain      = 1 << 14;
+const size_t parallel_sort_oversample = 16;
+const size_t parallel_sort_buckets    = 256;
+
+// bucket of val: 2b for the elements between splitter b - 1 and b, 2b + 1 for
+// the elements equal to splitter b
+template <class T, class Compare>
+size_t parallel_sort_bucket(const T* split, size_t nsplit, const T& val,
+                            Compare comp)
+{
+  const auto b = static_cast<size_t>(
+    mystl::upper_bound(split, split + nsplit, val, comp) - split);
+  return (b > 0 && !comp(split[b - 1], val)) ? 2 * b - 1 : 2 * b;
+}
+
+template <class RIter, class Compare>
+void parallel_sort_aux(RIter first, RIter last, Compare comp)
+{
+  typedef typename iterator_traits<RIter>::value_type T;
+  const auto len = last - first;
+  const size_t parts = mystl::parallel_degree(
+    len > 0 ? static_cast<size_t>(len) : 0, parallel_sort_grain);
+  if (parts < 2)
+  {
+    mystl::sort(first, last, comp);
+    return;
+  }
+  const auto n = static_cast<size_t>(len);
+  mystl::scratch_buffer<T> buf(n, default_init);
+  T* const tmp = buf.begin();
+
+  // sample one element from each of nsample strides, at a pseudo random place
+  size_t nbuckets = parts * 4;
+  if (nbuckets > parallel_sort_buckets) nbuckets = parallel_sort_buckets;
+  mystl::scratch_buffer<T> split_buf(nbuckets - 1, default_init);
+  T* const split = split_buf.begin();
+  size_t nsplit = 0;
+  {
+    const size_t nsample = nbuckets * parallel_sort_oversample;
+    const size_t stride = n / nsample;
+    mystl::scratch_buffer<T> sample_buf(nsample, default_init);
+    T* const sample = sample_buf.begin();
+    size_t seed = n;
+    for (size_t i = 0; i < nsample; ++i)
+    {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      sample[i] = *(first + (i * stride + (seed >> 33) % stride));
+    }
+    mystl::sort(sample, sample + nsample, comp);
+    for (size_t i = 1; i < nbuckets; ++i)
+    {
+      const T& s = sample[i * parallel_sort_oversample];
+      if (nsplit == 0 || comp(split[nsplit - 1], s))
+      {
+        split[nsplit++] = s;
+      }
+    }
+  }
+
+  // distribute
+  const size_t nb = 2 * nsplit + 1;
+  mystl::scratch_buffer<size_t> count_buf(parts * nb, default_init);
+  mystl::scratch_buffer<size_t> start_buf(nb + 1, default_init);
+  size_t* const count = count_buf.begin();
+  size_t* const start = start_buf.begin();
+  mystl::parallel_invoke_n(parts, [&](size_t t)
+  {
+    size_t* c = count + t * nb;
+    for (size_t b = 0; b < nb; ++b) c[b] = 0;
+    const auto chunk_last = first + n * (t + 1) / parts;
+    for (auto i = first + n * t / parts; i != chunk_last; ++i)
+    {
+      ++c[mystl::parallel_sort_bucket(split, nsplit, *i, comp)];
+    }
+  });
+  size_t sum = 0;
+  for (size_t b = 0; b < nb; ++b)
+  {
+    start[b] = sum;
+    for (size_t t = 0; t < parts; ++t)
+    {
+      const auto c = count[t * nb + b];
+      count[t * nb + b] = sum;
+      sum += c;
+    }
+  }
+  start[nb] = n;
+  mystl::parallel_invoke_n(parts, [&](size_t t)
+  {
+    size_t* offset = count + t * nb;
+    const auto chunk_last = first + n * (t + 1) / parts;
+    for (auto i = first + n * t / parts; i != chunk_last; ++i)
+    {
+      tmp[offset[mystl::parallel_sort_bucket(split, nsplit, *i, comp)]++] =
+        mystl::move(*i);
+    }
+  });
+
+  // move back and sort the buckets
+  mystl::parallel_invoke_n(nb, [&](size_t b)
+  {
+    const auto size = start[b + 1] - start[b];
+    auto out = first + start[b];
+    mystl::move(tmp + start[b], tmp + start[b + 1], out);
+    if (b % 2 == 1 || size < 2) return;
+    if (size < n) mystl::parallel_sort_aux(out, out + size, comp);
+    else          mystl::sort(out, out + size, comp);
+  });
+}
+
+// ver1: <
+template <class RIter>
+void parallel_sort(RIter first, RIter last)
+{
+  typedef typename iterator_traits<RIter>::value_type T;
+  mystl::parallel_sort_aux(first, last, mystl::less<T>());
+}
+
+// ver2: comp
+template <class RIter, class Compare>
+void parallel_sort(RIter first, RIter last, Compare comp)
+{
+  mystl::parallel_sort_aux(first, last, comp);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_ALGO_PARALLEL_H_
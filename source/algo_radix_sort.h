@@ -0,0 +1,429 @@
+#ifndef _LITESTL_ALGO_RADIX_SORT_H_
+#define _LITESTL_ALGO_RADIX_SORT_H_
+
+// radix sort for integer, floating point and byte string keys
+// radix_sort, parallel_radix_sort, msd_radix_sort
+// all of them are stable, the key of an element is given by a key extractor
+// such as mystl::select_first, or is the element itself
+// the buffer the elements are distributed into is default-initialized, so
+// it costs no pass over memory for trivial elements, and the elements need a
+// default constructor but are never copied
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "iterator.h"
+#include "algobase.h"   // mystl::move
+#include "algo_sort.h"  // mystl::insertion_sort
+#include "functional.h" // mystl::identity
+#include "memory.h"     // mystl::scratch_buffer
+#include "parallel.h"
+#include "util.h"       // mystl::default_init
+
+namespace mystl
+{
+
+// below this many elements a comparison sort is faster
+const ptrdiff_t radix_sort_threshold = 64;
+const ptrdiff_t radix_msd_threshold  = 32;
+
+// minimum number of elements handled by one thread
+const size_t radix_parallel_grain = 1 << 16;
+
+/********************************************************************************/
+// radix_key_traits
+// map a key to an unsigned integer of the same size whose order as unsigned
+// is the order of the keys
+// signed integers get the sign bit flipped; floating point values get all
+// bits flipped if negative, else the sign bit set, so -0.0 sorts before 0.0
+// and NaNs go to the ends depending on their sign
+/********************************************************************************/
+template <class T, bool = std::is_integral<T>::value,
+  bool = std::is_floating_point<T>::value>
+struct radix_key_traits {};
+
+template <class T>
+struct radix_key_traits<T, true, false>
+{
+  typedef typename std::make_unsigned<T>::type type;
+
+  static type encode(T x) noexcept
+  {
+    return std::is_signed<T>::value
+      ? static_cast<type>(static_cast<type>(x) ^
+                          (static_cast<type>(1) << (sizeof(type) * CHAR_BIT - 1)))
+      : static_cast<type>(x);
+  }
+};
+
+template <class T>
+struct radix_key_traits<T, false, true>
+{
+  typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type type;
+  static_assert(sizeof(T) == sizeof(type), "radix sort needs float or double keys");
+
+  static type encode(T x) noexcept
+  {
+    type u;
+    std::memcpy(&u, &x, sizeof(u));
+    const type sign = static_cast<type>(1) << (sizeof(type) * CHAR_BIT - 1);
+    return (u & sign) ? static_cast<type>(~u) : static_cast<type>(u | sign);
+  }
+};
+
+// order of the elements by the encoded keys, for the short ranges
+template <class KeyOf, class Traits>
+struct radix_key_less
+{
+  KeyOf key;
+
+  explicit radix_key_less(KeyOf k) :key(k) {}
+
+  template <class T>
+  bool operator()(const T& lhs, const T& rhs) const
+  {
+    return Traits::encode(key(lhs)) < Traits::encode(key(rhs));
+  }
+};
+
+// move every element of [first, last) to result + offset[digit], in order
+// the offsets are copied to a local array, which the stores cannot alias
+template <class Traits, class SrcIter, class DstIter, class KeyOf>
+void radix_scatter(SrcIter first, SrcIter last, DstIter result,
+                   const size_t* offset, size_t shift, KeyOf key)
+{
+  size_t pos[256];
+  for (size_t d = 0; d < 256; ++d) pos[d] = offset[d];
+  for (; first != last; ++first)
+  {
+    const auto digit = static_cast<size_t>((Traits::encode(key(*first)) >> shift) & 0xff);
+    *(result + pos[digit]++) = mystl::move(*first);
+  }
+}
+
+/********************************************************************************/
+// radix_sort
+// least significant digit first, one byte per pass, between the range and a
+// scratch_buffer of the same size
+// the histograms of all passes are counted in a single read, and a pass is
+// skipped if all keys have the same byte there, so small keys stored in a
+// wide type cost only the passes they need
+// throws std::bad_alloc if the buffer cannot be allocated
+/********************************************************************************/
+// with key extractor
+template <class RIter, class KeyOf>
+void radix_sort(RIter first, RIter last, KeyOf key)
+{
+  typedef typename iterator_traits<RIter>::value_type           T;
+  typedef typename std::decay<decltype(key(*first))>::type      Key;
+  typedef radix_key_traits<Key>                                 Traits;
+  typedef typename Traits::type                                 U;
+
+  const auto len = last - first;
+  if (len < radix_sort_threshold)
+  {
+    mystl::insertion_sort(first, last, radix_key_less<KeyOf, Traits>(key));
+    return;
+  }
+  const auto n = static_cast<size_t>(len);
+  mystl::scratch_buffer<T> buf(n, default_init);
+
+  size_t count[sizeof(U)][256] = {};
+  for (auto i = first; i != last; ++i)
+  {
+    const U u = Traits::encode(key(*i));
+    for (size_t p = 0; p < sizeof(U); ++p)
+    {
+      ++count[p][static_cast<size_t>((u >> (p * 8)) & 0xff)];
+    }
+  }
+
+  const U u0 = Traits::encode(key(*first));
+  bool in_buf = false;
+  for (size_t p = 0; p < sizeof(U); ++p)
+  {
+    if (count[p][static_cast<size_t>((u0 >> (p * 8)) & 0xff)] == n) continue;
+    size_t sum = 0;
+    for (size_t d = 0; d < 256; ++d)
+    {
+      const auto c = count[p][d];
+      count[p][d] = sum;
+      sum += c;
+    }
+    if (in_buf)
+    {
+      mystl::radix_scatter<Traits>(buf.begin(), buf.begin() + n, first,
+                                   count[p], p * 8, key);
+    }
+    else
+    {
+      mystl::radix_scatter<Traits>(first, last, buf.begin(), count[p], p * 8,
+                                   key);
+    }
+    in_buf = !in_buf;
+  }
+  if (in_buf)
+  {
+    mystl::move(buf.begin(), buf.begin() + n, first);
+  }
+}
+
+// sort the elements by their own value
+template <class RIter>
+void radix_sort(RIter first, RIter last)
+{
+  typedef typename iterator_traits<RIter>::value_type T;
+  mystl::radix_sort(first, last, mystl::identity<T>());
+}
+
+/********************************************************************************/
+// parallel_radix_sort
+// radix_sort with the range cut into one chunk per thread; in every pass each
+// thread counts the bytes of its chunk, the counts are summed in digit major,
+// chunk minor order, and each thread scatters its chunk to its own offsets,
+// which keeps the sort stable
+// the passes to skip are found first from the bits that differ between keys
+// throws std::bad_alloc if the buffer cannot be allocated
+/********************************************************************************/
+template <class Traits, class SrcIter, class DstIter, class KeyOf>
+void parallel_radix_pass(SrcIter src, DstIter dst, size_t n, size_t parts,
+                         size_t* count, size_t shift, KeyOf key)
+{
+  mystl::parallel_invoke_n(parts, [&](size_t t)
+  {
+    size_t* c = count + t * 256;
+    for (size_t d = 0; d < 256; ++d) c[d] = 0;
+    const auto last = src + n * (t + 1) / parts;
+    for (auto i = src + n * t / parts; i != last; ++i)
+    {
+      ++c[static_cast<size_t>((Traits::encode(key(*i)) >> shift) & 0xff)];
+    }
+  });
+  size_t sum = 0;
+  for (size_t d = 0; d < 256; ++d)
+  {
+    for (size_t t = 0; t < parts; ++t)
+    {
+      const auto c = count[t * 256 + d];
+      count[t * 256 + d] = sum;
+      sum += c;
+    }
+  }
+  mystl::parallel_invoke_n(parts, [&](size_t t)
+  {
+    mystl::radix_scatter<Traits>(src + n * t / parts, src + n * (t + 1) / parts,
+                                 dst, count + t * 256, shift, key);
+  });
+}
+
+// with key extractor
+template <class RIter, class KeyOf>
+void parallel_radix_sort(RIter first, RIter last, KeyOf key)
+{
+  typedef typename iterator_traits<RIter>::value_type           T;
+  typedef typename std::decay<decltype(key(*first))>::type      Key;
+  typedef radix_key_traits<Key>                                 Traits;
+  typedef typename Traits::type                                 U;
+
+  const auto len = last - first;
+  const auto parts = mystl::parallel_degree(
+    len > 0 ? static_cast<size_t>(len) : 0, radix_parallel_grain);
+  if (parts < 2)
+  {
+    mystl::radix_sort(first, last, key);
+    return;
+  }
+  const auto n = static_cast<size_t>(len);
+  mystl::scratch_buffer<T> buf(n, default_init);
+  T* const tmp = buf.begin();
+
+  // bits in which some key differs from the first one
+  const U u0 = Traits::encode(key(*first));
+  mystl::scratch_buffer<U> diff_buf(parts, default_init);
+  U* const diff = diff_buf.begin();
+  mystl::parallel_invoke_n(parts, [&](size_t t)
+  {
+    U d = 0;
+    const auto chunk_last = first + n * (t + 1) / parts;
+    for (auto i = first + n * t / parts; i != chunk_last; ++i)
+    {
+      d |= static_cast<U>(Traits::encode(key(*i)) ^ u0);
+    }
+    diff[t] = d;
+  });
+  U mask = 0;
+  for (size_t t = 0; t < parts; ++t) mask |= diff[t];
+
+  mystl::scratch_buffer<size_t> count_buf(parts * 256, default_init);
+  size_t* const count = count_buf.begin();
+  bool in_buf = false;
+  for (size_t p = 0; p < sizeof(U); ++p)
+  {
+    if (((mask >> (p * 8)) & 0xff) == 0) continue;
+    if (in_buf)
+    {
+      mystl::parallel_radix_pass<Traits>(tmp, first, n, parts, count, p * 8, key);
+    }
+    else
+    {
+      mystl::parallel_radix_pass<Traits>(first, tmp, n, parts, count, p * 8, key);
+    }
+    in_buf = !in_buf;
+  }
+  if (in_buf)
+  {
+    mystl::parallel_invoke_n(parts, [&](size_t t)
+    {
+      mystl::move(tmp + n * t / parts, tmp + n * (t + 1) / parts,
+                  first + n * t / parts);
+    });
+  }
+}
+
+// sort the elements by their own value
+template <class RIter>
+void parallel_radix_sort(RIter first, RIter last)
+{
+  typedef typename iterator_traits<RIter>::value_type T;
+  mystl::parallel_radix_sort(first, last, mystl::identity<T>());
+}
+
+/********************************************************************************/
+// msd_radix_sort
+// sort byte strings in lexicographical order of their unsigned bytes, the key
+// is a C string or has size() and operator[], like std::string
+// most significant byte first: elements are distributed on byte d into 257
+// buckets, the end of the string first, and every bucket but the first is
+// sorted on byte d + 1; short buckets are insertion sorted from byte d
+// a scratch_buffer of the range size holds the distributed elements, and
+// std::bad_alloc is thrown if it cannot be allocated
+/********************************************************************************/
+// byte d of a key: 0 past its end, 1 + the byte before it
+template <class String>
+size_t radix_string_byte(const String& s, size_t d)
+{
+  return d < static_cast<size_t>(s.size())
+    ? 1 + static_cast<size_t>(static_cast<unsigned char>(s[d]))
+    : 0;
+}
+
+// a C string is only read at d after its first d bytes were seen not to be
+// the terminator
+inline size_t radix_string_byte(const char* s, size_t d)
+{
+  const auto c = static_cast<unsigned char>(s[d]);
+  return c == 0 ? 0 : 1 + static_cast<size_t>(c);
+}
+
+inline size_t radix_string_byte(char* s, size_t d)
+{
+  return mystl::radix_string_byte(static_cast<const char*>(s), d);
+}
+
+// order of the keys from byte depth on, the bytes before being equal
+template <class KeyOf>
+struct radix_string_less
+{
+  KeyOf  key;
+  size_t depth;
+
+  radix_string_less(KeyOf k, size_t d) :key(k), depth(d) {}
+
+  template <class T>
+  bool operator()(const T& lhs, const T& rhs) const
+  {
+    const auto& a = key(lhs);
+    const auto& b = key(rhs);
+    for (size_t d = depth; ; ++d)
+    {
+      const auto ca = mystl::radix_string_byte(a, d);
+      const auto cb = mystl::radix_string_byte(b, d);
+      if (ca != cb) return ca < cb;
+      if (ca == 0)  return false;
+    }
+  }
+};
+
+template <class RIter, class T, class KeyOf>
+void msd_radix_sort_aux(RIter first, RIter last, T* buf, size_t depth,
+                        KeyOf key)
+{
+  size_t count[257];
+  while (true)
+  {
+    const auto len = last - first;
+    if (len < radix_msd_threshold)
+    {
+      mystl::insertion_sort(first, last,
+                            radix_string_less<KeyOf>(key, depth));
+      return;
+    }
+    const auto n = static_cast<size_t>(len);
+    for (size_t b = 0; b < 257; ++b) count[b] = 0;
+    for (auto i = first; i != last; ++i)
+    {
+      ++count[mystl::radix_string_byte(key(*i), depth)];
+    }
+    // one bucket: nothing to move, look at the next byte
+    const auto b0 = mystl::radix_string_byte(key(*first), depth);
+    if (count[b0] == n)
+    {
+      if (b0 == 0) return;
+      ++depth;
+      continue;
+    }
+    size_t offset[257];
+    size_t sum = 0;
+    for (size_t b = 0; b < 257; ++b)
+    {
+      offset[b] = sum;
+      sum += count[b];
+    }
+    for (auto i = first; i != last; ++i)
+    {
+      buf[offset[mystl::radix_string_byte(key(*i), depth)]++] = mystl::move(*i);
+    }
+    mystl::move(buf, buf + n, first);
+    // offset[b] is now the end of bucket b
+    for (size_t b = 1; b < 257; ++b)
+    {
+      if (count[b] > 1)
+      {
+        mystl::msd_radix_sort_aux(first + (offset[b] - count[b]),
+                                  first + offset[b], buf, depth + 1, key);
+      }
+    }
+    return;
+  }
+}
+
+// with key extractor
+template <class RIter, class KeyOf>
+void msd_radix_sort(RIter first, RIter last, KeyOf key)
+{
+  typedef typename iterator_traits<RIter>::value_type T;
+  const auto len = last - first;
+  if (len < 2) return;
+  if (len < radix_msd_threshold)
+  {
+    mystl::insertion_sort(first, last, radix_string_less<KeyOf>(key, 0));
+    return;
+  }
+  mystl::scratch_buffer<T> buf(static_cast<size_t>(len), default_init);
+  mystl::msd_radix_sort_aux(first, last, buf.begin(), 0, key);
+}
+
+// sort the strings themselves
+template <class RIter>
+void msd_radix_sort(RIter first, RIter last)
+{
+  typedef typename iterator_traits<RIter>::value_type T;
+  mystl::msd_radix_sort(first, last, mystl::identity<T>());
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_ALGO_RADIX_SORT_H_
@@ -3,9 +3,14 @@
 
 // algorithm for set
 // set_union, set_intersection, set_difference, set_symmetric_difference
+// set_union_size, set_intersection_size, set_difference_size,
+// set_symmetric_difference_size, set_intersects
+
+#include <cstddef>
 
 #include "iterator.h"
-#include "algobase.h" // mystl::copy
+#include "algobase.h"   // mystl::copy, mystl::lower_bound
+#include "functional.h" // mystl::less
 
 namespace mystl
 {
@@ -64,37 +69,106 @@ OIter set_union(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2,
 }
 
 /********************************************************************************/
-// set_intersection
-// S1*S2
-// return an iter pointing to the end of result
+// galloping intersection core
+// shared by set_intersection and the counting set algorithms
 /********************************************************************************/
-// ver1: <
-template <class IIter1, class IIter2, class OIter>
-OIter set_intersection(IIter1 first1, IIter1 last1, IIter2 first2,
-                       IIter2 last2, OIter result)
+
+// if one range is this many times longer, search it by galloping
+const size_t set_gallop_ratio = 16;
+
+// gallop_lower_bound
+// lower_bound in [first, last) probing first + 1, first + 3, first + 7, ...
+// so the cost is logarithmic in the distance to the result, not in the range
+template <class RIter, class T, class Compare>
+RIter gallop_lower_bound(RIter first, RIter last, const T& val, Compare comp)
 {
-  while (first1 != last1 && first2 != last2)
+  const auto len = last - first;
+  decltype(last - first) lo = 0, step = 1;
+  while (step <= len && comp(*(first + (step - 1)), val))
   {
-    if (*first1 < *first2)
-    {
-      ++first1;
-    }
-    else if (*first2 < *first1)
+    lo = step;
+    step = 2 * step + 1;
+  }
+  const auto hi = step <= len ? step - 1 : len;
+  return mystl::lower_bound(first + lo, first + hi, val, comp);
+}
+
+// for every element of the short range, gallop in the long one and hand each
+// matching position of the first range to emit
+// the ranges are never swapped, so comp sees the elements of each range in the
+// same argument position as in the merge loop, which mixed-type comps rely on
+template <class RIter1, class RIter2, class Compare, class Emit>
+void set_intersection_gallop(RIter1 first1, RIter1 last1,
+                             RIter2 first2, RIter2 last2, Compare comp,
+                             Emit& emit)
+{
+  if (last1 - first1 <= last2 - first2)
+  {
+    for (; first1 != last1 && first2 != last2; ++first1)
     {
-      ++first2;
+      first2 = mystl::gallop_lower_bound(first2, last2, *first1, comp);
+      if (first2 != last2 && !comp(*first1, *first2))
+      {
+        emit(first1); ++first2;
+      }
     }
-    else
+  }
+  else
+  {
+    for (; first2 != last2 && first1 != last1; ++first2)
     {
-      *result = *first1; ++first1; ++first2; ++result;
+      first1 = mystl::gallop_lower_bound(first1, last1, *first2, comp);
+      if (first1 != last1 && !comp(*first2, *first1))
+      {
+        emit(first1); ++first1;
+      }
     }
   }
-  return result;
 }
 
-// ver2: comp
+// emit for set_intersection: copy the element of the first range to result
+template <class OIter>
+struct set_copy_emit
+{
+  OIter result;
+
+  explicit set_copy_emit(OIter r) :result(r) {}
+
+  template <class Iter>
+  void operator()(Iter it)
+  {
+    *result = *it; ++result;
+  }
+};
+
+// emit for the counting algorithms
+struct set_count_emit
+{
+  size_t n;
+
+  set_count_emit() :n(0) {}
+
+  template <class Iter>
+  void operator()(Iter)
+  {
+    ++n;
+  }
+};
+
+// true if one range is long enough against the other to gallop in it
+inline bool set_should_gallop(size_t n1, size_t n2)
+{
+  return n1 * set_gallop_ratio < n2 || n2 * set_gallop_ratio < n1;
+}
+
+/********************************************************************************/
+// set_intersection
+// S1*S2
+// return an iter pointing to the end of result
+/********************************************************************************/
 template <class IIter1, class IIter2, class OIter, class Compare>
-OIter set_intersection(IIter1 first1, IIter1 last1, IIter2 first2,
-                       IIter2 last2, OIter result, Compare comp)
+OIter set_intersection_merge(IIter1 first1, IIter1 last1, IIter2 first2,
+                             IIter2 last2, OIter result, Compare comp)
 {
   while (first1 != last1 && first2 != last2)
   {
@@ -114,6 +188,56 @@ OIter set_intersection(IIter1 first1, IIter1 last1, IIter2 first2,
   return result;
 }
 
+// random_access_iterator_tag
+template <class RIter1, class RIter2, class OIter, class Compare>
+OIter set_intersection_aux(RIter1 first1, RIter1 last1, RIter2 first2,
+                           RIter2 last2, OIter result, Compare comp,
+                           random_access_iterator_tag,
+                           random_access_iterator_tag)
+{
+  if (mystl::set_should_gallop(static_cast<size_t>(last1 - first1),
+                               static_cast<size_t>(last2 - first2)))
+  {
+    set_copy_emit<OIter> emit(result);
+    mystl::set_intersection_gallop(first1, last1, first2, last2, comp, emit);
+    return emit.result;
+  }
+  return mystl::set_intersection_merge(first1, last1, first2, last2, result,
+                                       comp);
+}
+
+// input_iterator_tag
+template <class IIter1, class IIter2, class OIter, class Compare>
+OIter set_intersection_aux(IIter1 first1, IIter1 last1, IIter2 first2,
+                           IIter2 last2, OIter result, Compare comp,
+                           input_iterator_tag, input_iterator_tag)
+{
+  return mystl::set_intersection_merge(first1, last1, first2, last2, result,
+                                       comp);
+}
+
+// ver1: <
+template <class IIter1, class IIter2, class OIter>
+OIter set_intersection(IIter1 first1, IIter1 last1, IIter2 first2,
+                       IIter2 last2, OIter result)
+{
+  typedef typename iterator_traits<IIter1>::value_type T;
+  return mystl::set_intersection_aux(first1, last1, first2, last2, result,
+                                     mystl::less<T>(),
+                                     iterator_category(first1),
+                                     iterator_category(first2));
+}
+
+// ver2: comp
+template <class IIter1, class IIter2, class OIter, class Compare>
+OIter set_intersection(IIter1 first1, IIter1 last1, IIter2 first2,
+                       IIter2 last2, OIter result, Compare comp)
+{
+  return mystl::set_intersection_aux(first1, last1, first2, last2, result,
+                                     comp, iterator_category(first1),
+                                     iterator_category(first2));
+}
+
 /********************************************************************************/
 // set_difference
 // S1-S2
@@ -187,7 +311,7 @@ OIter set_symmetric_difference(IIter1 first1, IIter1 last1, IIter2 first2,
     }
     else
     {
-      *result = *first1; ++first1; ++first2;
+      ++first1; ++first2;
     }
   }
   return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
@@ -210,12 +334,411 @@ OIter set_symmetric_difference(IIter1 first1, IIter1 last1, IIter2 first2,
     }
     else
     {
-      *result = *first1; ++first1; ++first2;
+      ++first1; ++first2;
     }
   }
   return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
 }
 
+/********************************************************************************/
+// counting set algorithms
+// compute the size of the result without writing it anywhere
+/********************************************************************************/
+
+// arithmetic elements: advance both ranges without branches
+template <class RIter1, class RIter2, class Compare>
+size_t set_intersection_size_merge(RIter1 first1, RIter1 last1,
+                                   RIter2 first2, RIter2 last2, Compare comp,
+                                   std::true_type)
+{
+  size_t n = 0;
+  while (first1 != last1 && first2 != last2)
+  {
+    const auto a = *first1;
+    const auto b = *first2;
+    const bool lt = comp(a, b);
+    const bool gt = comp(b, a);
+    n += !lt & !gt;
+    first1 += !gt;
+    first2 += !lt;
+  }
+  return n;
+}
+
+template <class RIter1, class RIter2, class Compare>
+size_t set_intersection_size_merge(RIter1 first1, RIter1 last1,
+                                   RIter2 first2, RIter2 last2, Compare comp,
+                                   std::false_type)
+{
+  size_t n = 0;
+  while (first1 != last1 && first2 != last2)
+  {
+    if (comp(*first1, *first2))
+    {
+      ++first1;
+    }
+    else if (comp(*first2, *first1))
+    {
+      ++first2;
+    }
+    else
+    {
+      ++n; ++first1; ++first2;
+    }
+  }
+  return n;
+}
+
+// random_access_iterator_tag
+template <class RIter1, class RIter2, class Compare>
+size_t set_intersection_size_aux(RIter1 first1, RIter1 last1, RIter2 first2,
+                                 RIter2 last2, Compare comp,
+                                 random_access_iterator_tag,
+                                 random_access_iterator_tag)
+{
+  if (mystl::set_should_gallop(static_cast<size_t>(last1 - first1),
+                               static_cast<size_t>(last2 - first2)))
+  {
+    set_count_emit emit;
+    mystl::set_intersection_gallop(first1, last1, first2, last2, comp, emit);
+    return emit.n;
+  }
+  return mystl::set_intersection_size_merge(first1, last1, first2, last2, comp,
+    std::integral_constant<bool,
+    std::is_arithmetic<typename iterator_traits<RIter1>::value_type>::value &&
+    std::is_arithmetic<typename iterator_traits<RIter2>::value_type>::value>());
+}
+
+// input_iterator_tag
+template <class IIter1, class IIter2, class Compare>
+size_t set_intersection_size_aux(IIter1 first1, IIter1 last1, IIter2 first2,
+                                 IIter2 last2, Compare comp,
+                                 input_iterator_tag, input_iterator_tag)
+{
+  return mystl::set_intersection_size_merge(first1, last1, first2, last2, comp,
+                                            std::false_type());
+}
+
+/********************************************************************************/
+// set_intersection_size
+// |S1*S2|
+/********************************************************************************/
+// ver1: <
+template <class IIter1, class IIter2>
+size_t set_intersection_size(IIter1 first1, IIter1 last1, IIter2 first2,
+                             IIter2 last2)
+{
+  typedef typename iterator_traits<IIter1>::value_type T;
+  return mystl::set_intersection_size_aux(first1, last1, first2, last2,
+                                          mystl::less<T>(),
+                                          iterator_category(first1),
+                                          iterator_category(first2));
+}
+
+// ver2: comp
+template <class IIter1, class IIter2, class Compare>
+size_t set_intersection_size(IIter1 first1, IIter1 last1, IIter2 first2,
+                             IIter2 last2, Compare comp)
+{
+  return mystl::set_intersection_size_aux(first1, last1, first2, last2, comp,
+                                          iterator_category(first1),
+                                          iterator_category(first2));
+}
+
+/********************************************************************************/
+// set_union_size
+// |S1+S2|
+/********************************************************************************/
+// random_access_iterator_tag
+template <class RIter1, class RIter2, class Compare>
+size_t set_union_size_aux(RIter1 first1, RIter1 last1, RIter2 first2,
+                          RIter2 last2, Compare comp,
+                          random_access_iterator_tag,
+                          random_access_iterator_tag)
+{
+  return static_cast<size_t>((last1 - first1) + (last2 - first2)) -
+    mystl::set_intersection_size(first1, last1, first2, last2, comp);
+}
+
+// input_iterator_tag
+template <class IIter1, class IIter2, class Compare>
+size_t set_union_size_aux(IIter1 first1, IIter1 last1, IIter2 first2,
+                          IIter2 last2, Compare comp,
+                          input_iterator_tag, input_iterator_tag)
+{
+  size_t n = 0;
+  while (first1 != last1 && first2 != last2)
+  {
+    if (comp(*first1, *first2))
+    {
+      ++first1;
+    }
+    else if (comp(*first2, *first1))
+    {
+      ++first2;
+    }
+    else
+    {
+      ++first1; ++first2;
+    }
+    ++n;
+  }
+  for (; first1 != last1; ++first1) ++n;
+  for (; first2 != last2; ++first2) ++n;
+  return n;
+}
+
+// ver1: <
+template <class IIter1, class IIter2>
+size_t set_union_size(IIter1 first1, IIter1 last1, IIter2 first2,
+                      IIter2 last2)
+{
+  typedef typename iterator_traits<IIter1>::value_type T;
+  return mystl::set_union_size_aux(first1, last1, first2, last2,
+                                   mystl::less<T>(),
+                                   iterator_category(first1),
+                                   iterator_category(first2));
+}
+
+// ver2: comp
+template <class IIter1, class IIter2, class Compare>
+size_t set_union_size(IIter1 first1, IIter1 last1, IIter2 first2,
+                      IIter2 last2, Compare comp)
+{
+  return mystl::set_union_size_aux(first1, last1, first2, last2, comp,
+                                   iterator_category(first1),
+                                   iterator_category(first2));
+}
+
+/********************************************************************************/
+// set_difference_size
+// |S1-S2|
+/********************************************************************************/
+// random_access_iterator_tag
+template <class RIter1, class RIter2, class Compare>
+size_t set_difference_size_aux(RIter1 first1, RIter1 last1, RIter2 first2,
+                               RIter2 last2, Compare comp,
+                               random_access_iterator_tag,
+                               random_access_iterator_tag)
+{
+  return static_cast<size_t>(last1 - first1) -
+    mystl::set_intersection_size(first1, last1, first2, last2, comp);
+}
+
+// input_iterator_tag
+template <class IIter1, class IIter2, class Compare>
+size_t set_difference_size_aux(IIter1 first1, IIter1 last1, IIter2 first2,
+                               IIter2 last2, Compare comp,
+                               input_iterator_tag, input_iterator_tag)
+{
+  size_t n = 0;
+  while (first1 != last1 && first2 != last2)
+  {
+    if (comp(*first1, *first2))
+    {
+      ++n; ++first1;
+    }
+    else if (comp(*first2, *first1))
+    {
+      ++first2;
+    }
+    else
+    {
+      ++first1; ++first2;
+    }
+  }
+  for (; first1 != last1; ++first1) ++n;
+  return n;
+}
+
+// ver1: <
+template <class IIter1, class IIter2>
+size_t set_difference_size(IIter1 first1, IIter1 last1, IIter2 first2,
+                           IIter2 last2)
+{
+  typedef typename iterator_traits<IIter1>::value_type T;
+  return mystl::set_difference_size_aux(first1, last1, first2, last2,
+                                        mystl::less<T>(),
+                                        iterator_category(first1),
+                                        iterator_category(first2));
+}
+
+// ver2: comp
+template <class IIter1, class IIter2, class Compare>
+size_t set_difference_size(IIter1 first1, IIter1 last1, IIter2 first2,
+                           IIter2 last2, Compare comp)
+{
+  return mystl::set_difference_size_aux(first1, last1, first2, last2, comp,
+                                        iterator_category(first1),
+                                        iterator_category(first2));
+}
+
+/********************************************************************************/
+// set_symmetric_difference_size
+// |(S1-S2)+(S2-S1)|
+/********************************************************************************/
+// random_access_iterator_tag
+template <class RIter1, class RIter2, class Compare>
+size_t set_symmetric_difference_size_aux(RIter1 first1, RIter1 last1,
+                                         RIter2 first2, RIter2 last2,
+                                         Compare comp,
+                                         random_access_iterator_tag,
+                                         random_access_iterator_tag)
+{
+  return static_cast<size_t>((last1 - first1) + (last2 - first2)) -
+    2 * mystl::set_intersection_size(first1, last1, first2, last2, comp);
+}
+
+// input_iterator_tag
+template <class IIter1, class IIter2, class Compare>
+size_t set_symmetric_difference_size_aux(IIter1 first1, IIter1 last1,
+                                         IIter2 first2, IIter2 last2,
+                                         Compare comp,
+                                         input_iterator_tag,
+                                         input_iterator_tag)
+{
+  size_t n = 0;
+  while (first1 != last1 && first2 != last2)
+  {
+    if (comp(*first1, *first2))
+    {
+      ++n; ++first1;
+    }
+    else if (comp(*first2, *first1))
+    {
+      ++n; ++first2;
+    }
+    else
+    {
+      ++first1; ++first2;
+    }
+  }
+  for (; first1 != last1; ++first1) ++n;
+  for (; first2 != last2; ++first2) ++n;
+  return n;
+}
+
+// ver1: <
+template <class IIter1, class IIter2>
+size_t set_symmetric_difference_size(IIter1 first1, IIter1 last1,
+                                     IIter2 first2, IIter2 last2)
+{
+  typedef typename iterator_traits<IIter1>::value_type T;
+  return mystl::set_symmetric_difference_size_aux(first1, last1, first2, last2,
+                                                  mystl::less<T>(),
+                                                  iterator_category(first1),
+                                                  iterator_category(first2));
+}
+
+// ver2: comp
+template <class IIter1, class IIter2, class Compare>
+size_t set_symmetric_difference_size(IIter1 first1, IIter1 last1,
+                                     IIter2 first2, IIter2 last2, Compare comp)
+{
+  return mystl::set_symmetric_difference_size_aux(first1, last1, first2, last2,
+                                                  comp,
+                                                  iterator_category(first1),
+                                                  iterator_category(first2));
+}
+
+/********************************************************************************/
+// set_intersects
+// S1*S2 is not empty, stop at the first common element
+/********************************************************************************/
+// random_access_iterator_tag
+template <class RIter1, class RIter2, class Compare>
+bool set_intersects_aux(RIter1 first1, RIter1 last1, RIter2 first2,
+                        RIter2 last2, Compare comp,
+                        random_access_iterator_tag, random_access_iterator_tag)
+{
+  if (mystl::set_should_gallop(static_cast<size_t>(last1 - first1),
+                               static_cast<size_t>(last2 - first2)))
+  {
+    // gallop in the long range for every element of the short one, keeping
+    // the argument order of comp as in the merge loop
+    if (last1 - first1 <= last2 - first2)
+    {
+      for (; first1 != last1; ++first1)
+      {
+        first2 = mystl::gallop_lower_bound(first2, last2, *first1, comp);
+        if (first2 == last2) return false;
+        if (!comp(*first1, *first2)) return true;
+      }
+    }
+    else
+    {
+      for (; first2 != last2; ++first2)
+      {
+        first1 = mystl::gallop_lower_bound(first1, last1, *first2, comp);
+        if (first1 == last1) return false;
+        if (!comp(*first2, *first1)) return true;
+      }
+    }
+    return false;
+  }
+  while (first1 != last1 && first2 != last2)
+  {
+    if (comp(*first1, *first2))
+    {
+      ++first1;
+    }
+    else if (comp(*first2, *first1))
+    {
+      ++first2;
+    }
+    else
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// input_iterator_tag
+template <class IIter1, class IIter2, class Compare>
+bool set_intersects_aux(IIter1 first1, IIter1 last1, IIter2 first2,
+                        IIter2 last2, Compare comp,
+                        input_iterator_tag, input_iterator_tag)
+{
+  while (first1 != last1 && first2 != last2)
+  {
+    if (comp(*first1, *first2))
+    {
+      ++first1;
+    }
+    else if (comp(*first2, *first1))
+    {
+      ++first2;
+    }
+    else
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// ver1: <
+template <class IIter1, class IIter2>
+bool set_intersects(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2)
+{
+  typedef typename iterator_traits<IIter1>::value_type T;
+  return mystl::set_intersects_aux(first1, last1, first2, last2,
+                                   mystl::less<T>(),
+                                   iterator_category(first1),
+                                   iterator_category(first2));
+}
+
+// ver2: comp
+template <class IIter1, class IIter2, class Compare>
+bool set_intersects(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2,
+                    Compare comp)
+{
+  return mystl::set_intersects_aux(first1, last1, first2, last2, comp,
+                                   iterator_category(first1),
+                                   iterator_category(first2));
+}
+
 } // namespace mystl
 
 #endif // !_LITESTL_ALGO_SET_H_
\ No newline at end of file
@@ -0,0 +1,984 @@
+#ifndef _LITESTL_ALGO_SORT_H_
+#define _LITESTL_ALGO_SORT_H_
+
+// algorithm for sorting
+// partial_sort, partial_sort_copy, nth_element, top_k, sort, stable_sort
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include "iterator.h"
+#include "algobase.h"   // mystl::move_backward, mystl::iter_swap
+#include "algo_heap.h"
+#include "allocator.h"
+#include "functional.h" // mystl::less
+#include "memory.h"     // mystl::scratch_buffer
+#include "util.h"
+
+namespace mystl
+{
+
+/********************************************************************************/
+// helpers shared by the sorting algorithms
+/********************************************************************************/
+
+// floor(log2(n)), bound of the recursion depth of quick select / sort
+template <class Size>
+Size sort_log2(Size n)
+{
+  Size k = 0;
+  for (; n > 1; n >>= 1) ++k;
+  return k;
+}
+
+// insert val into sorted [first, last), there is an element not greater
+// than val before last, so no bound check is needed
+template <class RIter, class T, class Compare>
+void unguarded_linear_insert(RIter last, T val, Compare comp)
+{
+  auto next = last;
+  --next;
+  while (comp(val, *next))
+  {
+    *last = mystl::move(*next);
+    last = next;
+    --next;
+  }
+  *last = mystl::move(val);
+}
+
+// insertion sort for short ranges
+template <class RIter, class Compare>
+void insertion_sort(RIter first, RIter last, Compare comp)
+{
+  if (first == last) return;
+  for (auto i = first + 1; i != last; ++i)
+  {
+    auto val = mystl::move(*i);
+    if (comp(val, *first))
+    {
+      mystl::move_backward(first, i, i + 1);
+      *first = mystl::move(val);
+    }
+    else
+    {
+      mystl::unguarded_linear_insert(i, mystl::move(val), comp);
+    }
+  }
+}
+
+// swap the median of *a, *b, *c into *result
+template <class RIter, class Compare>
+void move_median_to_first(RIter result, RIter a, RIter b, RIter c,
+                          Compare comp)
+{
+  if (comp(*a, *b))
+  {
+    if (comp(*b, *c))      mystl::iter_swap(result, b);
+    else if (comp(*a, *c)) mystl::iter_swap(result, c);
+    else                   mystl::iter_swap(result, a);
+  }
+  else if (comp(*a, *c))   mystl::iter_swap(result, a);
+  else if (comp(*b, *c))   mystl::iter_swap(result, c);
+  else                     mystl::iter_swap(result, b);
+}
+
+// Hoare partition of [first, last) around *pivot, which lies outside it
+// both scans are stopped by elements equal to the pivot, which keeps runs of
+// equal elements balanced; return the start of the right part
+template <class RIter, class Compare>
+RIter unguarded_partition(RIter first, RIter last, RIter pivot, Compare comp)
+{
+  while (true)
+  {
+    while (comp(*first, *pivot)) ++first;
+    --last;
+    while (comp(*pivot, *last)) --last;
+    if (!(first < last)) return first;
+    mystl::iter_swap(first, last);
+    ++first;
+  }
+}
+
+// median of first + 1, middle and last - 1 as pivot, moved to *first
+template <class RIter, class Compare>
+RIter unguarded_partition_pivot(RIter first, RIter last, Compare comp)
+{
+  auto mid = first + (last - first) / 2;
+  mystl::move_median_to_first(first, first + 1, mid, last - 1, comp);
+  return mystl::unguarded_partition(first + 1, last, first, comp);
+}
+
+// keep the (middle - first) smallest elements of [first, last) as a heap in
+// [first, middle), the largest of them on top
+template <class RIter, class Compare>
+void heap_select(RIter first, RIter middle, RIter last, Compare comp)
+{
+  typedef typename iterator_traits<RIter>::difference_type Distance;
+  mystl::make_heap(first, middle, comp);
+  const auto len = static_cast<Distance>(middle - first);
+  for (auto i = middle; i < last; ++i)
+  {
+    if (comp(*i, *first))
+    {
+      // replace the top by *i and put the old top at *i
+      auto val = mystl::move(*i);
+      *i = mystl::move(*first);
+      mystl::pop_heap_ad(first, static_cast<Distance>(0), len, mystl::move(val),
+                         comp);
+    }
+  }
+}
+
+/********************************************************************************/
+// partial_sort
+// sort the (middle - first) smallest elements of [first, last) into
+// [first, middle), the rest of the elements are left in unspecified order
+/********************************************************************************/
+template <class RIter, class Compare>
+void partial_sort_aux(RIter first, RIter middle, RIter last, Compare comp)
+{
+  if (first == middle) return;
+  mystl::heap_select(first, middle, last, comp);
+  mystl::sort_heap(first, middle, comp);
+}
+
+// ver1: <
+template <class RIter>
+void partial_sort(RIter first, RIter middle, RIter last)
+{
+  typedef typename iterator_traits<RIter>::value_type T;
+  mystl::partial_sort_aux(first, middle, last, mystl::less<T>());
+}
+
+// ver2: comp
+template <class RIter, class Compare>
+void partial_sort(RIter first, RIter middle, RIter last, Compare comp)
+{
+  mystl::partial_sort_aux(first, middle, last, comp);
+}
+
+/********************************************************************************/
+// partial_sort_copy
+// copy the min(last - first, result_last - result_first) smallest elements of
+// [first, last) into [result_first, ...) in sorted order, the input is read
+// once, so it may be a single pass input range
+// return an iter pointing to the end of result
+/********************************************************************************/
+template <class IIter, class RIter, class Compare>
+RIter partial_sort_copy_aux(IIter first, IIter last, RIter result_first,
+                            RIter result_last, Compare comp)
+{
+  typedef typename iterator_traits<RIter>::difference_type Distance;
+  typedef typename iterator_traits<RIter>::value_type      T;
+  if (result_first == result_last) return result_last;
+  auto result_real_last = result_first;
+  for (; first != last && result_real_last != result_last; ++first)
+  {
+    *result_real_last = *first;
+    ++result_real_last;
+  }
+  mystl::make_heap(result_first, result_real_last, comp);
+  const auto len = static_cast<Distance>(result_real_last - result_first);
+  for (; first != last; ++first)
+  {
+    if (comp(*first, *result_first))
+    {
+      mystl::pop_heap_ad(result_first, static_cast<Distance>(0), len,
+                         T(*first), comp);
+    }
+  }
+  mystl::sort_heap(result_first, result_real_last, comp);
+  return result_real_last;
+}
+
+// ver1: <
+template <class IIter, class RIter>
+RIter partial_sort_copy(IIter first, IIter last, RIter result_first,
+                        RIter result_last)
+{
+  typedef typename iterator_traits<RIter>::value_type T;
+  return mystl::partial_sort_copy_aux(first, last, result_first, result_last,
+                                      mystl::less<T>());
+}
+
+// ver2: comp
+template <class IIter, class RIter, class Compare>
+RIter partial_sort_copy(IIter first, IIter last, RIter result_first,
+                        RIter result_last, Compare comp)
+{
+  return mystl::partial_sort_copy_aux(first, last, result_first, result_last,
+                                      comp);
+}
+
+/********************************************************************************/
+// nth_element
+// rearrange [first, last) so that *nth is the element that would be there if
+// the range was sorted, no element of [first, nth) is greater than it and no
+// element of [nth, last) is less than it
+// introselect: quick select on a median-of-3 pivot, falling back to heap
+// select once the depth passes 2*log2(n), so the worst case is O(n log n)
+/********************************************************************************/
+template <class RIter, class Compare>
+void nth_element_aux(RIter first, RIter nth, RIter last, Compare comp)
+{
+  if (first == last || nth == last) return;
+  auto depth_limit = 2 * mystl::sort_log2(last - first);
+  while (last - first > 3)
+  {
+    if (depth_limit-- == 0)
+    {
+      mystl::heap_select(first, nth + 1, last, comp);
+      mystl::iter_swap(first, nth);
+      return;
+    }
+    auto cut = mystl::unguarded_partition_pivot(first, last, comp);
+    if (cut <= nth) first = cut;
+    else last = cut;
+  }
+  mystl::insertion_sort(first, last, comp);
+}
+
+// ver1: <
+template <class RIter>
+void nth_element(RIter first, RIter nth, RIter last)
+{
+  typedef typename iterator_traits<RIter>::value_type T;
+  mystl::nth_element_aux(first, nth, last, mystl::less<T>());
+}
+
+// ver2: comp
+template <class RIter, class Compare>
+void nth_element(RIter first, RIter nth, RIter last, Compare comp)
+{
+  mystl::nth_element_aux(first, nth, last, comp);
+}
+
+/********************************************************************************/
+// top_k
+// write the k smallest elements of [first, last) to result in sorted order,
+// with mystl::greater the k largest; the input is read in one pass and only
+// a heap of k elements is kept, most elements cost a single comparison
+// return an iter pointing to the end of result
+/********************************************************************************/
+template <class IIter, class OIter, class Compare>
+OIter top_k_aux(IIter first, IIter last, size_t k, OIter result, Compare comp)
+{
+  typedef typename iterator_traits<IIter>::value_type T;
+  if (k == 0) return result;
+  T* buf = mystl::allocator<T>::allocate(k);
+  ptrdiff_t n = 0;
+  for (; first != last && n != static_cast<ptrdiff_t>(k); ++first, ++n)
+  {
+    mystl::construct(buf + n, *first);
+  }
+  mystl::make_heap(buf, buf + n, comp);
+  for (; first != last; ++first)
+  {
+    if (comp(*first, *buf))
+    {
+      mystl::pop_heap_ad(buf, static_cast<ptrdiff_t>(0), n, T(*first), comp);
+    }
+  }
+  mystl::sort_heap(buf, buf + n, comp);
+  for (ptrdiff_t i = 0; i < n; ++i, ++result)
+  {
+    *result = mystl::move(buf[i]);
+  }
+  mystl::destroy(buf, buf + n);
+  mystl::allocator<T>::deallocate(buf, k);
+  return result;
+}
+
+// ver1: <
+template <class IIter, class OIter>
+OIter top_k(IIter first, IIter last, size_t k, OIter result)
+{
+  typedef typename iterator_traits<IIter>::value_type T;
+  return mystl::top_k_aux(first, last, k, result, mystl::less<T>());
+}
+
+// ver2: comp
+template <class IIter, class OIter, class Compare>
+OIter top_k(IIter first, IIter last, size_t k, OIter result, Compare comp)
+{
+  return mystl::top_k_aux(first, last, k, result, comp);
+}
+
+/********************************************************************************/
+// sort
+// pattern-defeating quicksort: median-of-3 (ninther for long ranges) pivot,
+// insertion sort for short partitions, and a heap sort once too many
+// partitions came out unbalanced, so the worst case is O(n log n)
+// sorted and reverse sorted runs are finished by a bounded insertion sort,
+// runs of equal elements are split off in one pass by partitioning left
+// for arithmetic values under mystl::less / mystl::greater the partition is
+// done in blocks: the comparisons only record offsets, and the swaps are done
+// afterwards, so there is no branch depending on the data
+/********************************************************************************/
+const ptrdiff_t sort_insertion_threshold = 24;
+const ptrdiff_t sort_ninther_threshold   = 128;
+const size_t    sort_partial_limit       = 8;
+const size_t    sort_block_size          = 64;
+
+// tell if the comparisons of Compare on T compile to a single instruction
+template <class T, class Compare>
+struct sort_is_branchless :public std::false_type {};
+
+template <class T>
+struct sort_is_branchless<T, mystl::less<T>>
+  :public std::integral_constant<bool, std::is_arithmetic<T>::value> {};
+
+template <class T>
+struct sort_is_branchless<T, mystl::greater<T>>
+  :public std::integral_constant<bool, std::is_arithmetic<T>::value> {};
+
+// insertion sort for a range that has an element not greater than any of
+// its elements just before first
+template <class RIter, class Compare>
+void unguarded_insertion_sort(RIter first, RIter last, Compare comp)
+{
+  if (first == last) return;
+  for (auto i = first + 1; i != last; ++i)
+  {
+    if (comp(*i, *(i - 1)))
+    {
+      mystl::unguarded_linear_insert(i, mystl::move(*i), comp);
+    }
+  }
+}
+
+// insertion sort that gives up after moving sort_partial_limit elements
+// return true if [first, last) has been sorted
+template <class RIter, class Compare>
+bool partial_insertion_sort(RIter first, RIter last, Compare comp)
+{
+  if (first == last) return true;
+  size_t moved = 0;
+  for (auto i = first + 1; i != last; ++i)
+  {
+    if (comp(*i, *(i - 1)))
+    {
+      auto val = mystl::move(*i);
+      auto hole = i;
+      do
+      {
+        *hole = mystl::move(*(hole - 1));
+        --hole;
+      } while (hole != first && comp(val, *(hole - 1)));
+      *hole = mystl::move(val);
+      moved += static_cast<size_t>(i - hole);
+      if (moved > sort_partial_limit) return false;
+    }
+  }
+  return true;
+}
+
+// sort *a, *b, *c
+template <class RIter, class Compare>
+void sort3(RIter a, RIter b, RIter c, Compare comp)
+{
+  if (comp(*b, *a)) mystl::iter_swap(a, b);
+  if (comp(*c, *b)) mystl::iter_swap(b, c);
+  if (comp(*b, *a)) mystl::iter_swap(a, b);
+}
+
+// partition [first + 1, last) around the pivot *first, elements equal to the
+// pivot go to the right; the pivot ends up between the parts
+// return the position of the pivot, and whether no element had to be swapped
+template <class RIter, class Compare>
+mystl::pair<RIter, bool>
+pdq_partition_right(RIter first, RIter last, Compare comp, std::false_type)
+{
+  auto pivot = mystl::move(*first);
+  auto l = first;
+  auto r = last;
+  // the median-of-3 left an element not less than the pivot on the right,
+  // which stops the first scan
+  while (comp(*++l, pivot));
+  if (l - 1 == first)
+  {
+    while (l < r && !comp(*--r, pivot));
+  }
+  else
+  {
+    while (!comp(*--r, pivot));
+  }
+  const bool already_partitioned = l >= r;
+  while (l < r)
+  {
+    mystl::iter_swap(l, r);
+    while (comp(*++l, pivot));
+    while (!comp(*--r, pivot));
+  }
+  auto pivot_pos = l - 1;
+  *first = mystl::move(*pivot_pos);
+  *pivot_pos = mystl::move(pivot);
+  return mystl::pair<RIter, bool>(pivot_pos, already_partitioned);
+}
+
+// exchange num pairs of elements given by the offsets, with a cyclic
+// permutation when the two blocks are not of the same size
+template <class RIter>
+void pdq_swap_offsets(RIter first, RIter last, const unsigned char* offsets_l,
+                      const unsigned char* offsets_r, size_t num,
+                      bool use_swaps)
+{
+  if (use_swaps)
+  {
+    for (size_t i = 0; i < num; ++i)
+    {
+      mystl::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+    }
+  }
+  else if (num > 0)
+  {
+    auto l = first + offsets_l[0];
+    auto r = last - offsets_r[0];
+    auto tmp = mystl::move(*l);
+    *l = mystl::move(*r);
+    for (size_t i = 1; i < num; ++i)
+    {
+      l = first + offsets_l[i];
+      *r = mystl::move(*l);
+      r = last - offsets_r[i];
+      *l = mystl::move(*r);
+    }
+    *r = mystl::move(tmp);
+  }
+}
+
+// block partition of the unknown elements [l, r) around pivot
+// return the start of the elements not less than pivot
+template <class RIter, class T, class Compare>
+RIter pdq_block_partition(RIter l, RIter r, const T& pivot, Compare comp)
+{
+  // offsets_l: elements of the left block not less than the pivot, counted
+  // from l; offsets_r: elements of the right block less than the pivot,
+  // counted back from r
+  alignas(64) unsigned char offsets_l[sort_block_size];
+  alignas(64) unsigned char offsets_r[sort_block_size];
+  size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+  const auto block = static_cast<ptrdiff_t>(sort_block_size);
+  while (r - l > 2 * block)
+  {
+    if (num_l == 0)
+    {
+      start_l = 0;
+      auto it = l;
+      for (size_t i = 0; i < sort_block_size; ++i, ++it)
+      {
+        offsets_l[num_l] = static_cast<unsigned char>(i);
+        num_l += !comp(*it, pivot);
+      }
+    }
+    if (num_r == 0)
+    {
+      start_r = 0;
+      auto it = r;
+      for (size_t i = 0; i < sort_block_size; ++i)
+      {
+        offsets_r[num_r] = static_cast<unsigned char>(i + 1);
+        num_r += comp(*--it, pivot);
+      }
+    }
+    const auto num = num_l < num_r ? num_l : num_r;
+    mystl::pdq_swap_offsets(l, r, offsets_l + start_l, offsets_r + start_r,
+                            num, num_l == num_r);
+    num_l -= num;
+    num_r -= num;
+    start_l += num;
+    start_r += num;
+    if (num_l == 0) l += block;
+    if (num_r == 0) r -= block;
+  }
+
+  // the rest: one block may still be pending, the unknown elements left are
+  // split between the two sides
+  size_t l_size = 0, r_size = 0;
+  const size_t unknown = static_cast<size_t>(r - l) -
+    ((num_r != 0 || num_l != 0) ? sort_block_size : 0);
+  if (num_r != 0)
+  {
+    l_size = unknown;
+    r_size = sort_block_size;
+  }
+  else if (num_l != 0)
+  {
+    l_size = sort_block_size;
+    r_size = unknown;
+  }
+  else
+  {
+    l_size = unknown / 2;
+    r_size = unknown - l_size;
+  }
+  if (unknown != 0 && num_l == 0)
+  {
+    start_l = 0;
+    auto it = l;
+    for (size_t i = 0; i < l_size; ++i, ++it)
+    {
+      offsets_l[num_l] = static_cast<unsigned char>(i);
+      num_l += !comp(*it, pivot);
+    }
+  }
+  if (unknown != 0 && num_r == 0)
+  {
+    start_r = 0;
+    auto it = r;
+    for (size_t i = 0; i < r_size; ++i)
+    {
+      offsets_r[num_r] = static_cast<unsigned char>(i + 1);
+      num_r += comp(*--it, pivot);
+    }
+  }
+  const auto num = num_l < num_r ? num_l : num_r;
+  mystl::pdq_swap_offsets(l, r, offsets_l + start_l, offsets_r + start_r,
+                          num, num_l == num_r);
+  num_l -= num;
+  num_r -= num;
+  start_l += num;
+  start_r += num;
+  if (num_l == 0) l += l_size;
+  if (num_r == 0) r -= r_size;
+
+  // one side has been used up, move the misplaced elements of the other
+  if (num_l != 0)
+  {
+    while (num_l-- != 0)
+    {
+      mystl::iter_swap(l + offsets_l[start_l + num_l], --r);
+    }
+    l = r;
+  }
+  if (num_r != 0)
+  {
+    while (num_r-- != 0)
+    {
+      mystl::iter_swap(r - offsets_r[start_r + num_r], l);
+      ++l;
+    }
+  }
+  return l;
+}
+
+// block partition, same result as above
+template <class RIter, class Compare>
+mystl::pair<RIter, bool>
+pdq_partition_right(RIter first, RIter last, Compare comp, std::true_type)
+{
+  auto pivot = mystl::move(*first);
+  auto l = first;
+  auto r = last;
+  while (comp(*++l, pivot));
+  if (l - 1 == first)
+  {
+    while (l < r && !comp(*--r, pivot));
+  }
+  else
+  {
+    while (!comp(*--r, pivot));
+  }
+  const bool already_partitioned = l >= r;
+  if (!already_partitioned)
+  {
+    mystl::iter_swap(l, r);
+    l = mystl::pdq_block_partition(l + 1, r, pivot, comp);
+  }
+  auto pivot_pos = l - 1;
+  *first = mystl::move(*pivot_pos);
+  *pivot_pos = mystl::move(pivot);
+  return mystl::pair<RIter, bool>(pivot_pos, already_partitioned);
+}
+
+// partition [first + 1, last) around the pivot *first, elements equal to the
+// pivot go to the left; used when the pivot equals the element before first,
+// then the left part is all equal and is done
+// return the position of the pivot
+template <class RIter, class Compare>
+RIter pdq_partition_left(RIter first, RIter last, Compare comp)
+{
+  auto pivot = mystl::move(*first);
+  auto l = first;
+  auto r = last;
+  while (comp(pivot, *--r));
+  if (r + 1 == last)
+  {
+    while (l < r && !comp(pivot, *++l));
+  }
+  else
+  {
+    while (!comp(pivot, *++l));
+  }
+  while (l < r)
+  {
+    mystl::iter_swap(l, r);
+    while (comp(pivot, *--r));
+    while (!comp(pivot, *++l));
+  }
+  *first = mystl::move(*r);
+  *r = mystl::move(pivot);
+  return r;
+}
+
+// the left part is sorted by recursion, the right one by the loop
+// bad_allowed: number of unbalanced partitions left before heap sort
+// leftmost: false if the element before first is not greater than any of
+// [first, last), so the insertion sort needs no bound check
+template <class RIter, class Compare, class Branchless>
+void pdq_sort_loop(RIter first, RIter last, Compare comp, size_t bad_allowed,
+                   bool leftmost, Branchless branchless)
+{
+  while (true)
+  {
+    const auto len = last - first;
+    if (len < sort_insertion_threshold)
+    {
+      if (leftmost) mystl::insertion_sort(first, last, comp);
+      else          mystl::unguarded_insertion_sort(first, last, comp);
+      return;
+    }
+
+    // pivot to *first
+    const auto half = len / 2;
+    if (len > sort_ninther_threshold)
+    {
+      mystl::sort3(first, first + half, last - 1, comp);
+      mystl::sort3(first + 1, first + (half - 1), last - 2, comp);
+      mystl::sort3(first + 2, first + (half + 1), last - 3, comp);
+      mystl::sort3(first + (half - 1), first + half, first + (half + 1), comp);
+      mystl::iter_swap(first, first + half);
+    }
+    else
+    {
+      mystl::sort3(first + half, first, last - 1, comp);
+    }
+
+    // the pivot equals the element before the range: everything equal to it
+    // is put on the left and needs no more work
+    if (!leftmost && !comp(*(first - 1), *first))
+    {
+      first = mystl::pdq_partition_left(first, last, comp) + 1;
+      continue;
+    }
+
+    const auto part = mystl::pdq_partition_right(first, last, comp, branchless);
+    const auto pivot_pos = part.first;
+    const auto l_len = pivot_pos - first;
+    const auto r_len = last - (pivot_pos + 1);
+
+    if (l_len < len / 8 || r_len < len / 8)
+    {
+      if (--bad_allowed == 0)
+      {
+        mystl::make_heap(first, last, comp);
+        mystl::sort_heap(first, last, comp);
+        return;
+      }
+      // break the pattern that led to the bad pivot
+      if (l_len >= sort_insertion_threshold)
+      {
+        mystl::iter_swap(first, first + l_len / 4);
+        mystl::iter_swap(pivot_pos - 1, pivot_pos - l_len / 4);
+        if (l_len > sort_ninther_threshold)
+        {
+          mystl::iter_swap(first + 1, first + (l_len / 4 + 1));
+          mystl::iter_swap(first + 2, first + (l_len / 4 + 2));
+          mystl::iter_swap(pivot_pos - 2, pivot_pos - (l_len / 4 + 1));
+          mystl::iter_swap(pivot_pos - 3, pivot_pos - (l_len / 4 + 2));
+        }
+      }
+      if (r_len >= sort_insertion_threshold)
+      {
+        mystl::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_len / 4));
+        mystl::iter_swap(last - 1, last - r_len / 4);
+        if (r_len > sort_ninther_threshold)
+        {
+          mystl::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_len / 4));
+          mystl::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_len / 4));
+          mystl::iter_swap(last - 2, last - (1 + r_len / 4));
+          mystl::iter_swap(last - 3, last - (2 + r_len / 4));
+        }
+      }
+    }
+    else if (part.second &&
+             mystl::partial_insertion_sort(first, pivot_pos, comp) &&
+             mystl::partial_insertion_sort(pivot_pos + 1, last, comp))
+    {
+      // a good pivot that moved nothing: the range was probably sorted
+      return;
+    }
+
+    mystl::pdq_sort_loop(first, pivot_pos, comp, bad_allowed, leftmost,
+                         branchless);
+    first = pivot_pos + 1;
+    leftmost = false;
+  }
+}
+
+// ver1: <
+template <class RIter>
+void sort(RIter first, RIter last)
+{
+  typedef typename iterator_traits<RIter>::value_type T;
+  if (last - first < 2) return;
+  mystl::pdq_sort_loop(first, last, mystl::less<T>(),
+                       mystl::sort_log2(static_cast<size_t>(last - first)),
+                       true, sort_is_branchless<T, mystl::less<T>>());
+}
+
+// ver2: comp
+template <class RIter, class Compare>
+void sort(RIter first, RIter last, Compare comp)
+{
+  typedef typename iterator_traits<RIter>::value_type T;
+  if (last - first < 2) return;
+  mystl::pdq_sort_loop(first, last, comp,
+                       mystl::sort_log2(static_cast<size_t>(last - first)),
+                       true, sort_is_branchless<T, Compare>());
+}
+
+/********************************************************************************/
+// stable_sort
+// top-down merge sort that keeps the order of equal elements, runs shorter
+// than sort_stable_threshold are insertion sorted
+// a raw buffer of half the length lets every merge move one half out and
+// merge back in place; if it cannot be allocated, the merges are split by
+// binary search and rotation instead, O(n log^2 n) at worst
+// adjacent halves already in order are not merged, so sorted input is O(n)
+// for arithmetic values under mystl::less / mystl::greater the merge picks
+// the next element without a branch, and every sort_stable_run steps checks
+// whether the next sort_stable_run elements all come from one side, moving
+// them at once: the long runs of nearly sorted input or of few distinct
+// values are not paid element by element
+/********************************************************************************/
+const ptrdiff_t sort_stable_threshold = 16;
+const ptrdiff_t sort_stable_run       = 16;
+
+// destroys the elements moved into the buffer when a merge is done with them
+template <class T>
+struct stable_buffer_guard
+{
+  T* first;
+  T* last;
+
+  stable_buffer_guard(T* f, T* l) :first(f), last(l) {}
+  ~stable_buffer_guard() { mystl::destroy(first, last); }
+};
+
+// merge buf [bfirst, blast) holding the moved out left half with the right
+// half [middle, last), into [result, last)
+template <class T, class RIter, class Compare>
+void stable_merge_forward(T* bfirst, T* blast, RIter middle, RIter last,
+                          RIter result, Compare comp, std::false_type)
+{
+  while (bfirst != blast && middle != last)
+  {
+    if (comp(*middle, *bfirst))
+    {
+      *result = mystl::move(*middle);
+      ++middle;
+    }
+    else
+    {
+      *result = mystl::move(*bfirst);
+      ++bfirst;
+    }
+    ++result;
+  }
+  mystl::move(bfirst, blast, result);
+}
+
+template <class T, class RIter, class Compare>
+void stable_merge_forward(T* bfirst, T* blast, RIter middle, RIter last,
+                          RIter result, Compare comp, std::true_type)
+{
+  const auto run = sort_stable_run;
+  while (bfirst != blast && middle != last)
+  {
+    if (blast - bfirst >= run && !comp(*middle, *(bfirst + (run - 1))))
+    {
+      result = mystl::move(bfirst, bfirst + run, result);
+      bfirst += run;
+      continue;
+    }
+    if (last - middle >= run && comp(*(middle + (run - 1)), *bfirst))
+    {
+      result = mystl::move(middle, middle + run, result);
+      middle += run;
+      continue;
+    }
+    for (auto k = run; k != 0 && bfirst != blast && middle != last; --k)
+    {
+      const bool take_right = comp(*middle, *bfirst);
+      *result = take_right ? *middle : *bfirst;
+      middle += take_right;
+      bfirst += !take_right;
+      ++result;
+    }
+  }
+  mystl::move(bfirst, blast, result);
+}
+
+// merge the left half [first, middle) with buf [bfirst, blast) holding the
+// moved out right half, backward into [first, result)
+template <class RIter, class T, class Compare>
+void stable_merge_backward(RIter first, RIter middle, T* bfirst, T* blast,
+                           RIter result, Compare comp, std::false_type)
+{
+  while (first != middle && bfirst != blast)
+  {
+    if (comp(*(blast - 1), *(middle - 1)))
+    {
+      *--result = mystl::move(*--middle);
+    }
+    else
+    {
+      *--result = mystl::move(*--blast);
+    }
+  }
+  mystl::move_backward(bfirst, blast, result);
+}
+
+template <class RIter, class T, class Compare>
+void stable_merge_backward(RIter first, RIter middle, T* bfirst, T* blast,
+                           RIter result, Compare comp, std::true_type)
+{
+  const auto run = sort_stable_run;
+  while (first != middle && bfirst != blast)
+  {
+    if (middle - first >= run && comp(*(blast - 1), *(middle - run)))
+    {
+      result = mystl::move_backward(middle - run, middle, result);
+      middle -= run;
+      continue;
+    }
+    if (blast - bfirst >= run && !comp(*(blast - run), *(middle - 1)))
+    {
+      result = mystl::move_backward(blast - run, blast, result);
+      blast -= run;
+      continue;
+    }
+    for (auto k = run; k != 0 && first != middle && bfirst != blast; --k)
+    {
+      const bool take_left = comp(*(blast - 1), *(middle - 1));
+      *--result = take_left ? *(middle - 1) : *(blast - 1);
+      middle -= take_left;
+      blast -= !take_left;
+    }
+  }
+  mystl::move_backward(bfirst, blast, result);
+}
+
+// merge sorted [first, middle) and [middle, last), of len1 and len2 elements
+template <class RIter, class Distance, class T, class Compare, class Branchless>
+void stable_merge_adaptive(RIter first, RIter middle, RIter last,
+                           Distance len1, Distance len2, T* buf,
+                           Distance buf_size, Compare comp,
+                           Branchless branchless)
+{
+  if (len1 == 0 || len2 == 0) return;
+  if (!comp(*middle, *(middle - 1))) return;
+  if (len1 + len2 == 2)
+  {
+    mystl::iter_swap(first, middle);
+    return;
+  }
+  if (buf_size != 0 && len1 <= buf_size)
+  {
+    auto blast = mystl::uninitialized_move(first, middle, buf);
+    stable_buffer_guard<T> guard(buf, blast);
+    mystl::stable_merge_forward(buf, blast, middle, last, first, comp,
+                                branchless);
+  }
+  else if (buf_size != 0 && len2 <= buf_size)
+  {
+    auto blast = mystl::uninitialized_move(middle, last, buf);
+    stable_buffer_guard<T> guard(buf, blast);
+    mystl::stable_merge_backward(first, middle, buf, blast, last, comp,
+                                 branchless);
+  }
+  else
+  {
+    // cut the longer half in two, find where its middle element goes in the
+    // other one, and rotate so that two independent merges are left
+    RIter cut1, cut2;
+    Distance len11, len22;
+    if (len1 > len2)
+    {
+      len11 = len1 / 2;
+      cut1 = first + len11;
+      cut2 = mystl::lower_bound(middle, last, *cut1, comp);
+      len22 = static_cast<Distance>(cut2 - middle);
+    }
+    else
+    {
+      len22 = len2 / 2;
+      cut2 = middle + len22;
+      cut1 = mystl::upper_bound(first, middle, *cut2, comp);
+      len11 = static_cast<Distance>(cut1 - first);
+    }
+    auto new_middle = mystl::rotate(cut1, middle, cut2);
+    mystl::stable_merge_adaptive(first, cut1, new_middle, len11, len22,
+                                 buf, buf_size, comp, branchless);
+    mystl::stable_merge_adaptive(new_middle, cut2, last, len1 - len11,
+                                 len2 - len22, buf, buf_size, comp, branchless);
+  }
+}
+
+template <class RIter, class Distance, class T, class Compare, class Branchless>
+void stable_sort_aux(RIter first, RIter last, T* buf, Distance buf_size,
+                     Compare comp, Branchless branchless)
+{
+  const auto len = static_cast<Distance>(last - first);
+  if (len <= sort_stable_threshold)
+  {
+    mystl::insertion_sort(first, last, comp);
+    return;
+  }
+  const auto len1 = len / 2;
+  auto middle = first + len1;
+  mystl::stable_sort_aux(first, middle, buf, buf_size, comp, branchless);
+  mystl::stable_sort_aux(middle, last, buf, buf_size, comp, branchless);
+  mystl::stable_merge_adaptive(first, middle, last, len1, len - len1, buf,
+                               buf_size, comp, branchless);
+}
+
+// sort with a raw buffer of half the length, or, if that cannot be allocated,
+// with the merges done by rotation; nothing is copied into the buffer and
+// an exception from the elements or comp is never taken for a failed
+// allocation
+template <class RIter, class Compare>
+void stable_sort_buffered(RIter first, RIter last, Compare comp)
+{
+  typedef typename iterator_traits<RIter>::value_type      T;
+  typedef typename iterator_traits<RIter>::difference_type Distance;
+  if (last - first < 2) return;
+  mystl::scratch_buffer<T> buf(static_cast<size_t>(last - first + 1) / 2,
+                               std::nothrow);
+  mystl::stable_sort_aux(first, last, buf.begin(),
+                         static_cast<Distance>(buf.size()), comp,
+                         sort_is_branchless<T, Compare>());
+}
+
+// ver1: <
+template <class RIter>
+void stable_sort(RIter first, RIter last)
+{
+  typedef typename iterator_traits<RIter>::value_type T;
+  mystl::stable_sort_buffered(first, last, mystl::less<T>());
+}
+
+// ver2: comp
+template <class RIter, class Compare>
+void stable_sort(RIter first, RIter last, Compare comp)
+{
+  mystl::stable_sort_buffered(first, last, comp);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_ALGO_SORT_H_
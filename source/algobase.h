@@ -51,10 +51,74 @@ unchecked_copy(T* first, T* last, U* result)
   return result + n;
 }
 
+// a segmented range is copied one segment at a time, so every piece between
+// contiguous storage takes the pointer fast path above
+template <class IIter, class OIter>
+OIter copy(IIter first, IIter last, OIter result);
+
+// segmented input
+template <class SIter, class OIter, class OutSegmented>
+OIter copy_segmented(SIter first, SIter last, OIter result, m_true_type, OutSegmented)
+{
+  typedef segmented_iterator_traits<SIter> traits;
+  auto seg = traits::segment(first);
+  const auto last_seg = traits::segment(last);
+  if (seg == last_seg)
+    return mystl::copy(traits::local(first), traits::local(last), result);
+  result = mystl::copy(traits::local(first), traits::end(seg), result);
+  for (++seg; seg != last_seg; ++seg)
+    result = mystl::copy(traits::begin(seg), traits::end(seg), result);
+  return mystl::copy(traits::begin(last_seg), traits::local(last), result);
+}
+
+// segmented output, the input is cut at the segment ends of result
+template <class RIter, class SIter>
+SIter copy_to_segments(RIter first, RIter last, SIter result,
+  mystl::random_access_iterator_tag)
+{
+  typedef segmented_iterator_traits<SIter> traits;
+  auto seg = traits::segment(result);
+  auto pos = traits::local(result);
+  auto n = last - first;
+  if (n == 0) return result;
+  while (true)
+  {
+    const auto room = traits::end(seg) - pos;
+    const auto k = n < room ? n : room;
+    pos = mystl::copy(first, first + k, pos);
+    first += k;
+    n -= k;
+    if (n == 0) return traits::compose(seg, pos);
+    ++seg;
+    pos = traits::begin(seg);
+  }
+}
+
+template <class IIter, class SIter>
+SIter copy_to_segments(IIter first, IIter last, SIter result,
+  mystl::input_iterator_tag)
+{
+  return unchecked_copy(first, last, result);
+}
+
+template <class IIter, class OIter>
+OIter copy_segmented(IIter first, IIter last, OIter result, m_false_type, m_true_type)
+{
+  return copy_to_segments(first, last, result, iterator_category(first));
+}
+
+template <class IIter, class OIter>
+OIter copy_segmented(IIter first, IIter last, OIter result, m_false_type, m_false_type)
+{
+  return unchecked_copy(first, last, result);
+}
+
 template <class IIter, class OIter>
 OIter copy(IIter first, IIter last, OIter result)
 {
-  return unchecked_copy(first, last, result, iterator_category(first));
+  return copy_segmented(first, last, result,
+    typename segmented_iterator_traits<IIter>::is_segmented_iterator(),
+    typename segmented_iterator_traits<OIter>::is_segmented_iterator());
 }
 
 /********************************************************************************/
@@ -171,10 +235,73 @@ unchecked_move(T* first, T* last, U* result)
   return result + n;
 }
 
+// a segmented range is moved one segment at a time, see copy
+template <class IIter, class OIter>
+OIter move(IIter first, IIter last, OIter result);
+
+// segmented input
+template <class SIter, class OIter, class OutSegmented>
+OIter move_segmented(SIter first, SIter last, OIter result, m_true_type, OutSegmented)
+{
+  typedef segmented_iterator_traits<SIter> traits;
+  auto seg = traits::segment(first);
+  const auto last_seg = traits::segment(last);
+  if (seg == last_seg)
+    return mystl::move(traits::local(first), traits::local(last), result);
+  result = mystl::move(traits::local(first), traits::end(seg), result);
+  for (++seg; seg != last_seg; ++seg)
+    result = mystl::move(traits::begin(seg), traits::end(seg), result);
+  return mystl::move(traits::begin(last_seg), traits::local(last), result);
+}
+
+// segmented output, the input is cut at the segment ends of result
+template <class RIter, class SIter>
+SIter move_to_segments(RIter first, RIter last, SIter result,
+  mystl::random_access_iterator_tag)
+{
+  typedef segmented_iterator_traits<SIter> traits;
+  auto seg = traits::segment(result);
+  auto pos = traits::local(result);
+  auto n = last - first;
+  if (n == 0) return result;
+  while (true)
+  {
+    const auto room = traits::end(seg) - pos;
+    const auto k = n < room ? n : room;
+    pos = mystl::move(first, first + k, pos);
+    first += k;
+    n -= k;
+    if (n == 0) return traits::compose(seg, pos);
+    ++seg;
+    pos = traits::begin(seg);
+  }
+}
+
+template <class IIter, class SIter>
+SIter move_to_segments(IIter first, IIter last, SIter result,
+  mystl::input_iterator_tag)
+{
+  return unchecked_move(first, last, result);
+}
+
+template <class IIter, class OIter>
+OIter move_segmented(IIter first, IIter last, OIter result, m_false_type, m_true_type)
+{
+  return move_to_segments(first, last, result, iterator_category(first));
+}
+
+template <class IIter, class OIter>
+OIter move_segmented(IIter first, IIter last, OIter result, m_false_type, m_false_type)
+{
+  return unchecked_move(first, last, result);
+}
+
 template <class IIter, class OIter>
 OIter move(IIter first, IIter last, OIter result)
 {
-  return unchecked_move(first, last, result, iterator_category(first));
+  return move_segmented(first, last, result,
+    typename segmented_iterator_traits<IIter>::is_segmented_iterator(),
+    typename segmented_iterator_traits<OIter>::is_segmented_iterator());
 }
 
 /********************************************************************************/
@@ -240,16 +367,46 @@ typename std::enable_if<std::is_integral<T>::value && sizeof(T) == 1 &&
   std::is_integral<U>::value && sizeof(U) == 1, T*>::type
 unchecked_fill_n(T* first, Size n, U val)
 {
-  if (n > 0) std::memset(first, (usigned char)val, (size_t)(n));
+  if (n > 0) std::memset(first, (unsigned char)val, (size_t)(n));
   return first + n;
 }
 
 template <class OIter, class Size, class T>
-OIter fill_n(OIter first, Size n, const T& val)
+OIter fill_n_segmented(OIter first, Size n, const T& val, m_false_type)
 {
   return unchecked_fill_n(first, n, val);
 }
 
+// a segmented range is filled one segment at a time
+template <class SIter, class Size, class T>
+SIter fill_n_segmented(SIter first, Size n, const T& val, m_true_type)
+{
+  if (n <= 0) return first;
+  typedef segmented_iterator_traits<SIter> traits;
+  auto seg = traits::segment(first);
+  auto pos = traits::local(first);
+  while (n > 0)
+  {
+    const auto room = static_cast<Size>(traits::end(seg) - pos);
+    const auto k = n < room ? n : room;
+    pos = unchecked_fill_n(pos, k, val);
+    n -= k;
+    if (n > 0)
+    {
+      ++seg;
+      pos = traits::begin(seg);
+    }
+  }
+  return traits::compose(seg, pos);
+}
+
+template <class OIter, class Size, class T>
+OIter fill_n(OIter first, Size n, const T& val)
+{
+  return fill_n_segmented(first, n, val,
+    typename segmented_iterator_traits<OIter>::is_segmented_iterator());
+}
+
 /********************************************************************************/
 // fill
 // fill new elements in [first, last)
@@ -259,7 +416,7 @@ template <class FIter, class T>
 void fill_aux(FIter first, FIter last, const T& val,
   forward_iterator_tag)
 {
-  for (first != last; ++first) *first = val;
+  for (; first != last; ++first) *first = val;
 }
 
 // random_access_iterator_tag
@@ -267,7 +424,38 @@ template <class RIter, class T>
 void fill_aux(RIter first, RIter last, const T& val,
   random_access_iterator_tag)
 {
-  fill_n(first, last - first, val);
+  mystl::fill_n(first, last - first, val);
+}
+
+template <class FIter, class T>
+void fill_segmented(FIter first, FIter last, const T& val, m_false_type)
+{
+  fill_aux(first, last, val, iterator_category(first));
+}
+
+// a segmented range is filled one segment at a time
+template <class SIter, class T>
+void fill_segmented(SIter first, SIter last, const T& val, m_true_type)
+{
+  typedef segmented_iterator_traits<SIter> traits;
+  auto seg = traits::segment(first);
+  const auto last_seg = traits::segment(last);
+  if (seg == last_seg)
+  {
+    fill_aux(traits::local(first), traits::local(last), val, random_access_iterator_tag());
+    return;
+  }
+  fill_aux(traits::local(first), traits::end(seg), val, random_access_iterator_tag());
+  for (++seg; seg != last_seg; ++seg)
+    fill_aux(traits::begin(seg), traits::end(seg), val, random_access_iterator_tag());
+  fill_aux(traits::begin(last_seg), traits::local(last), val, random_access_iterator_tag());
+}
+
+template <class FIter, class T>
+void fill(FIter first, FIter last, const T& val)
+{
+  fill_segmented(first, last, val,
+    typename segmented_iterator_traits<FIter>::is_segmented_iterator());
 }
 
 /********************************************************************************/
@@ -292,14 +480,14 @@ const T& max(const T& lhs, const T& rhs, Compare comp)
 /********************************************************************************/
 // ver1: <
 template <class T>
-const T& max(const T& lhs, const T& rhs)
+const T& min(const T& lhs, const T& rhs)
 {
   return rhs < lhs ? rhs : lhs;
 }
 
 // ver2: comp
 template <class T, class Compare>
-const T& max(const T& lhs, const T& rhs, Compare comp)
+const T& min(const T& lhs, const T& rhs, Compare comp)
 {
   return comp(rhs, lhs) ? rhs : lhs;
 }
@@ -313,11 +501,23 @@ bool equal(IIter1 first1, IIter1 last1, IIter2 first2)
 {
   for (; first1 != last1; ++first1, ++first2)
   {
-    if (*first1 != *first2) return false;
+    if (!(*first1 == *first2)) return false;
   }
   return true;
 }
 
+// integers and pointers are equal exactly when their bytes are, so contiguous
+// ranges of them are compared with memcmp
+template <class T, class U>
+typename std::enable_if<
+  std::is_same<typename std::remove_const<T>::type, typename std::remove_const<U>::type>::value &&
+  (std::is_integral<T>::value || std::is_pointer<T>::value), bool>::type
+equal(T* first1, T* last1, U* first2)
+{
+  const auto n = static_cast<size_t>(last1 - first1);
+  return n == 0 || std::memcmp(first1, first2, n * sizeof(T)) == 0;
+}
+
 // ver2: comp
 template <class IIter1, class IIter2, class Compare>
 bool equal(IIter1 first1, IIter1 last1, IIter2 first2, Compare comp)
@@ -363,7 +563,7 @@ mismatch(IIter1 first1, IIter1 last1, IIter2 first2, Compare comp)
 template <class IIter1, class IIter2>
 bool lexicographical_compare(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2)
 {
-  for (; first1 != last1 && first2 != last2; ++first1, first2)
+  for (; first1 != last1 && first2 != last2; ++first1, ++first2)
   {
     if (*first1 < *first2) return true;
     if (*first2 < *first1) return false;
@@ -376,7 +576,7 @@ template <class IIter1, class IIter2, class Compare>
 bool lexicographical_compare(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2,
   Compare comp)
 {
-  for (; first1 != last1 && first2 != last2; ++first1, first2)
+  for (; first1 != last1 && first2 != last2; ++first1, ++first2)
   {
     if (comp(*first1, *first2)) return true;
     if (comp(*first2, *first1)) return false;
@@ -384,6 +584,24 @@ bool lexicographical_compare(IIter1 first1, IIter1 last1, IIter2 first2, IIter2
   return first1 == last1 && first2 != last2;
 }
 
+// unsigned bytes order like memcmp, which compares many of them per step
+inline bool lexicographical_compare(const unsigned char* first1, const unsigned char* last1,
+                                    const unsigned char* first2, const unsigned char* last2)
+{
+  const auto len1 = static_cast<size_t>(last1 - first1);
+  const auto len2 = static_cast<size_t>(last2 - first2);
+  const auto r = std::memcmp(first1, first2, len1 < len2 ? len1 : len2);
+  return r != 0 ? r < 0 : len1 < len2;
+}
+
+inline bool lexicographical_compare(unsigned char* first1, unsigned char* last1,
+                                    unsigned char* first2, unsigned char* last2)
+{
+  return mystl::lexicographical_compare(
+    static_cast<const unsigned char*>(first1), static_cast<const unsigned char*>(last1),
+    static_cast<const unsigned char*>(first2), static_cast<const unsigned char*>(last2));
+}
+
 /*****************************************************************************************/
 // iter_swap
 /*****************************************************************************************/
@@ -393,6 +611,216 @@ void iter_swap(FIter1 lhs, FIter2 rhs)
   mystl::swap(*lhs, *rhs);
 }
 
+/*****************************************************************************************/
+// lower_bound
+// return the first position in sorted [first, last) not less than val
+/*****************************************************************************************/
+// ver1: <
+template <class FIter, class T>
+FIter lower_bound(FIter first, FIter last, const T& val)
+{
+  auto len = mystl::distance(first, last);
+  while (len > 0)
+  {
+    auto half = len / 2;
+    auto mid = first;
+    mystl::advance(mid, half);
+    if (*mid < val)
+    {
+      first = ++mid;
+      len -= half + 1;
+    }
+    else
+    {
+      len = half;
+    }
+  }
+  return first;
+}
+
+// ver2: comp
+template <class FIter, class T, class Compare>
+FIter lower_bound(FIter first, FIter last, const T& val, Compare comp)
+{
+  auto len = mystl::distance(first, last);
+  while (len > 0)
+  {
+    auto half = len / 2;
+    auto mid = first;
+    mystl::advance(mid, half);
+    if (comp(*mid, val))
+    {
+      first = ++mid;
+      len -= half + 1;
+    }
+    else
+    {
+      len = half;
+    }
+  }
+  return first;
+}
+
+/*****************************************************************************************/
+// branchless_lower_bound
+// lower_bound for random access ranges: the loop halves the range a fixed
+// number of times and picks the half with a conditional move, so there is no
+// branch to mispredict on the comparison result
+/*****************************************************************************************/
+// ver1: <
+template <class RIter, class T>
+RIter branchless_lower_bound(RIter first, RIter last, const T& val)
+{
+  auto len = last - first;
+  if (len == 0) return first;
+  while (len > 1)
+  {
+    const auto half = len / 2;
+    first = first[half] < val ? first + half : first;
+    len -= half;
+  }
+  return *first < val ? first + 1 : first;
+}
+
+// ver2: comp
+template <class RIter, class T, class Compare>
+RIter branchless_lower_bound(RIter first, RIter last, const T& val, Compare comp)
+{
+  auto len = last - first;
+  if (len == 0) return first;
+  while (len > 1)
+  {
+    const auto half = len / 2;
+    first = comp(first[half], val) ? first + half : first;
+    len -= half;
+  }
+  return comp(*first, val) ? first + 1 : first;
+}
+
+/*****************************************************************************************/
+// branchless_upper_bound
+// upper_bound for random access ranges, see branchless_lower_bound
+/*****************************************************************************************/
+// ver1: <
+template <class RIter, class T>
+RIter branchless_upper_bound(RIter first, RIter last, const T& val)
+{
+  auto len = last - first;
+  if (len == 0) return first;
+  while (len > 1)
+  {
+    const auto half = len / 2;
+    first = val < first[half] ? first : first + half;
+    len -= half;
+  }
+  return val < *first ? first : first + 1;
+}
+
+// ver2: comp
+template <class RIter, class T, class Compare>
+RIter branchless_upper_bound(RIter first, RIter last, const T& val, Compare comp)
+{
+  auto len = last - first;
+  if (len == 0) return first;
+  while (len > 1)
+  {
+    const auto half = len / 2;
+    first = comp(val, first[half]) ? first : first + half;
+    len -= half;
+  }
+  return comp(val, *first) ? first : first + 1;
+}
+
+/*****************************************************************************************/
+// upper_bound
+// return the first position in sorted [first, last) greater than val
+/*****************************************************************************************/
+// ver1: <
+template <class FIter, class T>
+FIter upper_bound(FIter first, FIter last, const T& val)
+{
+  auto len = mystl::distance(first, last);
+  while (len > 0)
+  {
+    auto half = len / 2;
+    auto mid = first;
+    mystl::advance(mid, half);
+    if (val < *mid)
+    {
+      len = half;
+    }
+    else
+    {
+      first = ++mid;
+      len -= half + 1;
+    }
+  }
+  return first;
+}
+
+// ver2: comp
+template <class FIter, class T, class Compare>
+FIter upper_bound(FIter first, FIter last, const T& val, Compare comp)
+{
+  auto len = mystl::distance(first, last);
+  while (len > 0)
+  {
+    auto half = len / 2;
+    auto mid = first;
+    mystl::advance(mid, half);
+    if (comp(val, *mid))
+    {
+      len = half;
+    }
+    else
+    {
+      first = ++mid;
+      len -= half + 1;
+    }
+  }
+  return first;
+}
+
+/*****************************************************************************************/
+// reverse
+// reverse the order of the elements in [first, last)
+/*****************************************************************************************/
+template <class BIter>
+void reverse(BIter first, BIter last)
+{
+  while (first != last && first != --last)
+  {
+    mystl::iter_swap(first, last);
+    ++first;
+  }
+}
+
+/*****************************************************************************************/
+// rotate
+// exchange [first, middle) and [middle, last) by three reversals
+// return the new position of the element that was at first
+/*****************************************************************************************/
+template <class BIter>
+BIter rotate(BIter first, BIter middle, BIter last)
+{
+  if (first == middle) return last;
+  if (middle == last)  return first;
+  mystl::reverse(first, middle);
+  mystl::reverse(middle, last);
+  while (first != middle && middle != last)
+  {
+    mystl::iter_swap(first, --last);
+    ++first;
+  }
+  if (first == middle)
+  {
+    mystl::reverse(middle, last);
+    return last;
+  }
+  mystl::reverse(first, middle);
+  return first;
+}
+
 } // namespace mystl
 
 #endif // !_LITESTL_ALGOBASE_H_
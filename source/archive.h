@@ -0,0 +1,936 @@
+#ifndef _LITESTL_ARCHIVE_H_
+#define _LITESTL_ARCHIVE_H_
+
+// binary archive of containers, loaded without deserialization
+// an archive is a header followed by sections, one per container; every
+// array is stored in native byte order and layout at an offset aligned to
+// archive_alignment, so a reader maps the file and views the arrays in
+// place: a vector section is a span, a flat_map section a sorted key array
+// beside a mapped array, a bitmap_set section its roaring containers
+// the writer streams: elements are buffered and written as they come, a
+// bitmap_set section only keeps one chunk and its directory in memory
+// this header uses the POSIX file and mmap interfaces
+//
+// layout, all offsets in a section are from the start of the section:
+//   archive_header        at 0
+//   archive_section       at the start of every section
+//   vector                offset[0]: T[count]
+//   flat_map              offset[0]: Key[count], offset[1]: T[count]
+//   bitmap_set            offset[0]: uint16_t[count] chunk keys, increasing
+//                         offset[1]: archive_chunk[count]
+//                         offset[2]: container data, 8-byte aligned each
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "algobase.h"   // mystl::branchless_lower_bound
+#include "allocator.h"
+#include "bitmap_set.h"
+#include "flat_map.h"
+#include "functional.h"
+#include "mmap_array.h"
+#include "vector.h"
+
+namespace mystl
+{
+
+static const uint32_t archive_version   = 1;
+static const uint32_t archive_endian    = 0x01020304;
+static const size_t   archive_alignment = 64;
+static const char     archive_magic[8]  = { 'M', 'Y', 'S', 'T', 'L', 'A', 'R', '\0' };
+
+enum archive_kind
+{
+  archive_vector     = 1,
+  archive_flat_map   = 2,
+  archive_bitmap_set = 3
+};
+
+struct archive_header
+{
+  char          magic[8];
+  uint32_t      version;
+  uint32_t      endian;     // archive_endian as written by the writer
+  uint32_t      alignment;
+  uint32_t      sections;
+  uint64_t      size;       // bytes of the whole archive
+  unsigned char reserved[32];
+};
+
+struct archive_section
+{
+  uint32_t kind;
+  uint32_t key_size;    // sizeof the element or key
+  uint32_t value_size;  // sizeof the mapped value, 0 if none
+  uint32_t reserved;
+  uint64_t count;       // elements, entries or chunks
+  uint64_t size;        // bytes of the section, header included
+  uint64_t offset[4];   // arrays of the section
+};
+
+// directory entry of a bitmap_set chunk
+struct archive_chunk
+{
+  uint64_t offset;  // of the container data
+  uint32_t card;    // number of values
+  uint16_t kind;    // bitmap_container::kind
+  uint16_t runs;    // intervals of a run container
+};
+
+static_assert(sizeof(archive_header) == archive_alignment, "archive_header size");
+static_assert(sizeof(archive_section) == archive_alignment, "archive_section size");
+static_assert(sizeof(archive_chunk) == 16, "archive_chunk size");
+
+inline uint64_t archive_round_up(uint64_t n, uint64_t align) noexcept
+{
+  return (n + align - 1) / align * align;
+}
+
+/********************************************************************************/
+// archive_writer
+/********************************************************************************/
+
+// class: archive_writer
+// writes the sections one after another; a section is begun, fed, and ended
+// by the next begin or by close; write() does all three for a container
+// I/O errors are remembered and reported by close
+class archive_writer
+{
+private:
+  static const size_t buffer_size = 1 << 16;
+
+  // bytes waiting to be written at file offset pos
+  struct stream
+  {
+    uint64_t       pos;
+    unsigned char* buf;
+    size_t         used;
+  };
+
+  int             fd_;
+  bool            failed_;
+  bool            in_section_;
+  uint32_t        sections_;
+  uint64_t        end_;       // end of the last finished section
+  archive_section sec_;
+  uint64_t        reserved_;  // entries of the flat_map section
+  stream          first_;     // elements, keys or container data
+  stream          second_;    // mapped values
+
+  // flat_map section: the bytes of the last key
+  mystl::vector<unsigned char> last_key_;
+
+  // bitmap_set section: the chunk being filled and the directory
+  mystl::vector<uint16_t>      chunk_;
+  uint32_t                     chunk_key_;
+  uint64_t                     last_value_;
+  uint64_t                     data_end_;
+  mystl::vector<uint16_t>      dir_keys_;
+  mystl::vector<archive_chunk> dir_;
+
+public:
+  archive_writer() noexcept
+    :fd_(-1), failed_(false), in_section_(false), sections_(0), end_(0), sec_(),
+    reserved_(0), first_(), second_(), last_key_(), chunk_(), chunk_key_(0), last_value_(0),
+    data_end_(0), dir_keys_(), dir_() {}
+
+  ~archive_writer()
+  {
+    close();
+    mystl::allocator<unsigned char>::deallocate(first_.buf);
+    mystl::allocator<unsigned char>::deallocate(second_.buf);
+  }
+
+public:
+  // create or truncate the file at path; return false if it cannot be opened
+  bool open(const char* path)
+  {
+    close();
+    fd_ = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) return false;
+    if (first_.buf == nullptr)
+    {
+      first_.buf = mystl::allocator<unsigned char>::allocate(buffer_size);
+      second_.buf = mystl::allocator<unsigned char>::allocate(buffer_size);
+    }
+    failed_ = false;
+    sections_ = 0;
+    end_ = sizeof(archive_header);
+    return true;
+  }
+
+  // end the open section and write the header
+  // return false if anything failed to reach the file
+  bool close()
+  {
+    if (fd_ < 0) return false;
+    end_section();
+    archive_header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, archive_magic, sizeof(h.magic));
+    h.version = archive_version;
+    h.endian = archive_endian;
+    h.alignment = static_cast<uint32_t>(archive_alignment);
+    h.sections = sections_;
+    h.size = end_;
+    write_at(0, &h, sizeof(h));
+    if (::ftruncate(fd_, static_cast<off_t>(end_)) != 0) failed_ = true;
+    if (::close(fd_) != 0) failed_ = true;
+    fd_ = -1;
+    return !failed_;
+  }
+
+  bool is_open() const noexcept { return fd_ >= 0; }
+  bool good()    const noexcept { return !failed_; }
+
+  // vector section, fed by push_element
+  template <class T>
+  void begin_vector()
+  {
+    check_type<T>();
+    begin_section(archive_vector, sizeof(T), 0);
+    sec_.offset[0] = archive_alignment;
+    seek(first_, sec_.offset[0]);
+  }
+
+  template <class T>
+  void push_element(const T& value)
+  {
+    push_elements(&value, 1);
+  }
+
+  template <class T>
+  void push_elements(const T* p, size_t n)
+  {
+    expect(archive_vector, sizeof(T), 0);
+    put(first_, p, n * sizeof(T));
+    sec_.count += n;
+  }
+
+  // flat_map section of at most n entries, fed by push_entry in increasing
+  // key order
+  template <class Key, class T>
+  void begin_flat_map(size_t n)
+  {
+    check_type<Key>();
+    check_type<T>();
+    begin_section(archive_flat_map, sizeof(Key), sizeof(T));
+    sec_.offset[0] = archive_alignment;
+    sec_.offset[1] = archive_round_up(sec_.offset[0] + n * sizeof(Key), archive_alignment);
+    reserved_ = n;
+    last_key_.resize(sizeof(Key));
+    seek(first_, sec_.offset[0]);
+    seek(second_, sec_.offset[1]);
+  }
+
+  template <class Key, class T, class Compare = mystl::less<Key>>
+  void push_entry(const Key& key, const T& value, const Compare& comp = Compare())
+  {
+    expect(archive_flat_map, sizeof(Key), sizeof(T));
+    if (sec_.count == reserved_)
+      throw std::logic_error("archive_writer: more entries than begin_flat_map reserved");
+    if (sec_.count != 0)
+    {
+      typename std::aligned_storage<sizeof(Key), alignof(Key)>::type last;
+      std::memcpy(&last, last_key_.data(), sizeof(Key));
+      if (!comp(*reinterpret_cast<const Key*>(&last), key))
+        throw std::logic_error("archive_writer: flat_map keys must increase");
+    }
+    std::memcpy(last_key_.data(), &key, sizeof(Key));
+    put(first_, &key, sizeof(Key));
+    put(second_, &value, sizeof(T));
+    ++sec_.count;
+  }
+
+  // bitmap_set section, fed by push_value in increasing order
+  void begin_bitmap_set()
+  {
+    begin_section(archive_bitmap_set, sizeof(uint16_t), 0);
+    sec_.offset[2] = archive_alignment;
+    seek(first_, sec_.offset[2]);
+    chunk_.clear();
+    dir_keys_.clear();
+    dir_.clear();
+    last_value_ = static_cast<uint64_t>(-1);
+    data_end_ = sec_.offset[2];
+  }
+
+  void push_value(uint32_t x)
+  {
+    expect(archive_bitmap_set, sizeof(uint16_t), 0);
+    if (last_value_ != static_cast<uint64_t>(-1) && x <= last_value_)
+      throw std::logic_error("archive_writer: bitmap_set values must increase");
+    if (!chunk_.empty() && (x >> 16) != chunk_key_) emit_chunk();
+    chunk_key_ = x >> 16;
+    chunk_.push_back(static_cast<uint16_t>(x & 0xffff));
+    last_value_ = x;
+  }
+
+  void end_section()
+  {
+    if (!in_section_) return;
+    in_section_ = false;
+    switch (sec_.kind)
+    {
+      case archive_vector:
+        flush(first_);
+        sec_.size = sec_.offset[0] + sec_.count * sec_.key_size;
+        break;
+      case archive_flat_map:
+        flush(first_);
+        flush(second_);
+        sec_.size = sec_.offset[1] + sec_.count * sec_.value_size;
+        break;
+      default:
+        end_bitmap_set();
+        break;
+    }
+    sec_.size = archive_round_up(sec_.size, archive_alignment);
+    write_at(end_, &sec_, sizeof(sec_));
+    end_ += sec_.size;
+    ++sections_;
+  }
+
+  // whole containers, one section each
+  template <class T>
+  void write(const T* p, size_t n)
+  {
+    begin_vector<T>();
+    push_elements(p, n);
+    end_section();
+  }
+
+  template <class T, class Alloc, class Growth>
+  void write(const mystl::vector<T, Alloc, Growth>& v)
+  {
+    write(v.data(), v.size());
+  }
+
+  template <class Key, class T, class Compare>
+  void write(const mystl::flat_map<Key, T, Compare>& m)
+  {
+    begin_flat_map<Key, T>(m.size());
+    for (size_t i = 0; i < m.size(); ++i)
+      push_entry(m.keys()[i], m.values()[i], m.key_comp());
+    end_section();
+  }
+
+  void write(const mystl::bitmap_set& s)
+  {
+    begin_bitmap_set();
+    for (auto x : s) push_value(x);
+    end_section();
+  }
+
+private:
+  template <class T>
+  static void check_type()
+  {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "archive elements must be trivially copyable");
+    static_assert(alignof(T) <= archive_alignment, "archive element is over-aligned");
+  }
+
+  void begin_section(archive_kind kind, size_t key_size, size_t value_size)
+  {
+    if (fd_ < 0) throw std::logic_error("archive_writer: not open");
+    end_section();
+    std::memset(&sec_, 0, sizeof(sec_));
+    sec_.kind = kind;
+    sec_.key_size = static_cast<uint32_t>(key_size);
+    sec_.value_size = static_cast<uint32_t>(value_size);
+    in_section_ = true;
+  }
+
+  void expect(archive_kind kind, size_t key_size, size_t value_size) const
+  {
+    if (!in_section_ || sec_.kind != static_cast<uint32_t>(kind) ||
+        sec_.key_size != key_size || sec_.value_size != value_size)
+      throw std::logic_error("archive_writer: value does not match the open section");
+  }
+
+  void write_at(uint64_t pos, const void* p, size_t n)
+  {
+    auto s = static_cast<const unsigned char*>(p);
+    while (n != 0 && !failed_)
+    {
+      const auto w = ::pwrite(fd_, s, n, static_cast<off_t>(pos));
+      if (w <= 0)
+      {
+        failed_ = true;
+        break;
+      }
+      s += w;
+      pos += static_cast<uint64_t>(w);
+      n -= static_cast<size_t>(w);
+    }
+  }
+
+  void flush(stream& s)
+  {
+    write_at(s.pos, s.buf, s.used);
+    s.pos += s.used;
+    s.used = 0;
+  }
+
+  // continue s at offset of the current section
+  void seek(stream& s, uint64_t offset)
+  {
+    flush(s);
+    s.pos = end_ + offset;
+  }
+
+  void put(stream& s, const void* p, size_t n)
+  {
+    if (n == 0) return;
+    if (s.used + n > buffer_size) flush(s);
+    if (n >= buffer_size)
+    {
+      write_at(s.pos, p, n);
+      s.pos += n;
+    }
+    else
+    {
+      std::memcpy(s.buf + s.used, p, n);
+      s.used += n;
+    }
+  }
+
+  // write the filled chunk in the smallest container
+  void emit_chunk()
+  {
+    const auto card = static_cast<uint32_t>(chunk_.size());
+    uint32_t runs = 0;
+    for (uint32_t i = 0; i < card; ++i)
+    {
+      if (i == 0 || chunk_[i] != chunk_[i - 1] + 1) ++runs;
+    }
+    const size_t array_bytes = card <= bitmap_container::array_max
+      ? card * sizeof(uint16_t) : static_cast<size_t>(-1);
+    const size_t bitmap_bytes = bitmap_container::words * sizeof(uint64_t);
+    const size_t run_bytes = runs * 2 * sizeof(uint16_t);
+
+    archive_chunk c;
+    c.card = card;
+    c.runs = 0;
+    const uint64_t start = archive_round_up(data_end_, sizeof(uint64_t));
+    put(first_, "\0\0\0\0\0\0\0", static_cast<size_t>(start - data_end_));
+    c.offset = start;
+    if (run_bytes < array_bytes && run_bytes < bitmap_bytes)
+    {
+      c.kind = bitmap_container::run_kind;
+      c.runs = static_cast<uint16_t>(runs);
+      for (uint32_t i = 0; i < card; )
+      {
+        uint32_t j = i + 1;
+        while (j < card && chunk_[j] == chunk_[j - 1] + 1) ++j;
+        const uint16_t run[2] = { chunk_[i], static_cast<uint16_t>(j - i - 1) };
+        put(first_, run, sizeof(run));
+        i = j;
+      }
+      data_end_ = start + run_bytes;
+    }
+    else if (array_bytes <= bitmap_bytes)
+    {
+      c.kind = bitmap_container::array_kind;
+      put(first_, chunk_.data(), array_bytes);
+      data_end_ = start + array_bytes;
+    }
+    else
+    {
+      c.kind = bitmap_container::bitmap_kind;
+      uint64_t words[bitmap_container::words];
+      std::memset(words, 0, sizeof(words));
+      for (auto low : chunk_) words[low >> 6] |= uint64_t(1) << (low & 63);
+      put(first_, words, sizeof(words));
+      data_end_ = start + bitmap_bytes;
+    }
+    dir_keys_.push_back(static_cast<uint16_t>(chunk_key_));
+    dir_.push_back(c);
+    chunk_.clear();
+  }
+
+  void end_bitmap_set()
+  {
+    if (!chunk_.empty()) emit_chunk();
+    const size_t n = dir_.size();
+    sec_.count = n;
+    sec_.offset[0] = archive_round_up(data_end_, archive_alignment);
+    sec_.offset[1] = archive_round_up(sec_.offset[0] + n * sizeof(uint16_t), archive_alignment);
+    seek(first_, sec_.offset[0]);
+    put(first_, dir_keys_.data(), n * sizeof(uint16_t));
+    seek(first_, sec_.offset[1]);
+    put(first_, dir_.data(), n * sizeof(archive_chunk));
+    flush(first_);
+    sec_.size = sec_.offset[1] + n * sizeof(archive_chunk);
+  }
+
+  archive_writer(const archive_writer&);
+
+  void operator=(const archive_writer&);
+};
+
+/********************************************************************************/
+// views
+/********************************************************************************/
+
+// template class: flat_map_view
+// a read-only flat_map over arrays it does not own; the iterators are those
+// of flat_map
+template <class Key, class T, class Compare = mystl::less<Key>>
+class flat_map_view
+{
+public:
+  typedef Key                                   key_type;
+  typedef T                                     mapped_type;
+  typedef Compare                               key_compare;
+  typedef flat_map_iterator<Key, const T>       iterator;
+  typedef flat_map_iterator<Key, const T>       const_iterator;
+  typedef size_t                                size_type;
+
+private:
+  mapped_span<Key> keys_;
+  mapped_span<T>   values_;
+  Compare          comp_;
+
+public:
+  flat_map_view() :keys_(), values_(), comp_() {}
+
+  flat_map_view(mapped_span<Key> keys, mapped_span<T> values,
+                const Compare& comp = Compare())
+    :keys_(keys), values_(values), comp_(comp) {}
+
+  const_iterator begin() const noexcept { return const_iterator(keys_.begin(), values_.begin()); }
+  const_iterator end()   const noexcept { return const_iterator(keys_.end(), values_.end()); }
+
+  mapped_span<Key> keys()   const noexcept { return keys_; }
+  mapped_span<T>   values() const noexcept { return values_; }
+
+  bool      empty() const noexcept { return keys_.empty(); }
+  size_type size()  const noexcept { return keys_.size(); }
+
+  const_iterator lower_bound(const key_type& key) const
+  {
+    auto k = mystl::branchless_lower_bound(keys_.begin(), keys_.end(), key, comp_);
+    return begin() + (k - keys_.begin());
+  }
+
+  const_iterator find(const key_type& key) const
+  {
+    auto it = lower_bound(key);
+    return it == end() || comp_(key, *it.key) ? end() : it;
+  }
+
+  bool      contains(const key_type& key) const { return find(key) != end(); }
+  size_type count(const key_type& key)    const { return contains(key) ? 1 : 0; }
+
+  const mapped_type& at(const key_type& key) const
+  {
+    auto it = find(key);
+    if (it == end()) throw std::out_of_range("flat_map_view<Key, T> no such element exists");
+    return *it.value;
+  }
+};
+
+class bitmap_set_view;
+
+// iterator of bitmap_set_view, values in increasing order
+class bitmap_set_view_iterator
+{
+public:
+  typedef forward_iterator_tag iterator_category;
+  typedef uint32_t             value_type;
+  typedef ptrdiff_t            difference_type;
+  typedef const uint32_t*      pointer;
+  typedef const uint32_t&      reference;
+
+private:
+  const bitmap_set_view* view_;
+  size_t                 chunk_;
+  uint32_t               pos_;
+  uint32_t               low_;
+  uint32_t               value_;
+
+public:
+  bitmap_set_view_iterator()
+    :view_(nullptr), chunk_(0), pos_(0), low_(0), value_(0) {}
+
+  bitmap_set_view_iterator(const bitmap_set_view* v, size_t chunk)
+    :view_(v), chunk_(chunk), pos_(0), low_(0), value_(0)
+  {
+    load();
+  }
+
+  reference operator*()  const { return value_; }
+  pointer   operator->() const { return &value_; }
+
+  bitmap_set_view_iterator& operator++();
+  bitmap_set_view_iterator operator++(int)
+  {
+    auto temp = *this;
+    ++*this;
+    return temp;
+  }
+
+  bool operator==(const bitmap_set_view_iterator& rhs) const
+  {
+    return chunk_ == rhs.chunk_ && low_ == rhs.low_;
+  }
+  bool operator!=(const bitmap_set_view_iterator& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+private:
+  void load();
+};
+
+// class: bitmap_set_view
+// a read-only bitmap_set over mapped containers
+// a bitmap_set is built from it with bitmap_set(view.begin(), view.end())
+class bitmap_set_view
+{
+public:
+  typedef uint32_t                 value_type;
+  typedef size_t                   size_type;
+  typedef bitmap_set_view_iterator iterator;
+  typedef bitmap_set_view_iterator const_iterator;
+
+private:
+  const unsigned char* base_;   // start of the section
+  const uint16_t*      keys_;
+  const archive_chunk* chunks_;
+  size_type            count_;  // number of chunks
+
+public:
+  bitmap_set_view() noexcept
+    :base_(nullptr), keys_(nullptr), chunks_(nullptr), count_(0) {}
+
+  bitmap_set_view(const unsigned char* base, const uint16_t* keys,
+                  const archive_chunk* chunks, size_type n) noexcept
+    :base_(base), keys_(keys), chunks_(chunks), count_(n) {}
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end()   const { return const_iterator(this, count_); }
+
+  bool      empty()       const noexcept { return count_ == 0; }
+  size_type chunk_count() const noexcept { return count_; }
+
+  size_type size() const noexcept
+  {
+    size_type n = 0;
+    for (size_type i = 0; i < count_; ++i) n += chunks_[i].card;
+    return n;
+  }
+
+  bool contains(uint32_t x) const
+  {
+    const auto high = static_cast<uint16_t>(x >> 16);
+    const auto low = static_cast<uint16_t>(x & 0xffff);
+    const auto k = mystl::branchless_lower_bound(keys_, keys_ + count_, high);
+    if (k == keys_ + count_ || *k != high) return false;
+    const archive_chunk& c = chunks_[k - keys_];
+    const uint16_t* vals = values(c);
+    switch (c.kind)
+    {
+      case bitmap_container::array_kind:
+      {
+        const auto p = mystl::branchless_lower_bound(vals, vals + c.card, low);
+        return p != vals + c.card && *p == low;
+      }
+      case bitmap_container::bitmap_kind:
+        return (words(c)[low >> 6] >> (low & 63)) & 1;
+      default:
+      {
+        // last run starting at or before low
+        uint32_t lo = 0, hi = c.runs;
+        while (lo < hi)
+        {
+          const uint32_t mid = (lo + hi) / 2;
+          if (vals[2 * mid] <= low) lo = mid + 1;
+          else                      hi = mid;
+        }
+        return lo != 0 && low - vals[2 * (lo - 1)] <= vals[2 * (lo - 1) + 1];
+      }
+    }
+  }
+
+  size_type count(uint32_t x) const { return contains(x) ? 1 : 0; }
+
+private:
+  friend class bitmap_set_view_iterator;
+
+  const uint16_t* values(const archive_chunk& c) const noexcept
+  {
+    return reinterpret_cast<const uint16_t*>(base_ + c.offset);
+  }
+  const uint64_t* words(const archive_chunk& c) const noexcept
+  {
+    return reinterpret_cast<const uint64_t*>(base_ + c.offset);
+  }
+
+  // first value of chunk i, and the value after low; pos is a cursor
+  bool first(size_type i, uint32_t& pos, uint32_t& low) const
+  {
+    const archive_chunk& c = chunks_[i];
+    if (c.card == 0) return false;
+    pos = 0;
+    if (c.kind == bitmap_container::bitmap_kind)
+    {
+      low = 0;
+      return (words(c)[0] & 1) || next(i, pos, low);
+    }
+    low = values(c)[0];
+    return true;
+  }
+
+  bool next(size_type i, uint32_t& pos, uint32_t& low) const
+  {
+    const archive_chunk& c = chunks_[i];
+    switch (c.kind)
+    {
+      case bitmap_container::array_kind:
+        if (++pos >= c.card) return false;
+        low = values(c)[pos];
+        return true;
+      case bitmap_container::bitmap_kind:
+      {
+        const uint64_t* w = words(c);
+        uint32_t bit = low + 1;
+        if (bit >= 65536) return false;
+        uint32_t word = bit >> 6;
+        uint64_t rest = w[word] & (~uint64_t(0) << (bit & 63));
+        while (rest == 0)
+        {
+          if (++word == bitmap_container::words) return false;
+          rest = w[word];
+        }
+        low = (word << 6) + static_cast<uint32_t>(__builtin_ctzll(rest));
+        return true;
+      }
+      default:
+      {
+        const uint16_t* vals = values(c);
+        if (low < static_cast<uint32_t>(vals[2 * pos]) + vals[2 * pos + 1])
+        {
+          ++low;
+          return true;
+        }
+        if (++pos >= c.runs) return false;
+        low = vals[2 * pos];
+        return true;
+      }
+    }
+  }
+};
+
+inline void bitmap_set_view_iterator::load()
+{
+  while (chunk_ < view_->count_)
+  {
+    if (view_->first(chunk_, pos_, low_))
+    {
+      value_ = (static_cast<uint32_t>(view_->keys_[chunk_]) << 16) | low_;
+      return;
+    }
+    ++chunk_;
+  }
+  pos_ = low_ = 0;
+}
+
+inline bitmap_set_view_iterator& bitmap_set_view_iterator::operator++()
+{
+  if (view_->next(chunk_, pos_, low_))
+  {
+    value_ = (static_cast<uint32_t>(view_->keys_[chunk_]) << 16) | low_;
+  }
+  else
+  {
+    ++chunk_;
+    load();
+  }
+  return *this;
+}
+
+/********************************************************************************/
+// archive_reader
+/********************************************************************************/
+
+// class: archive_reader
+// maps an archive and hands out views of its sections; open checks the
+// header and that every section lies inside the file, the views only read
+// the mapping, nothing is copied
+class archive_reader
+{
+private:
+  mapped_file                           file_;
+  mystl::vector<const archive_section*> sections_;
+
+public:
+  archive_reader() :file_(), sections_() {}
+
+  // return false if the file cannot be mapped, is not an archive, or was
+  // written by another version or byte order
+  bool open(const char* path, map_mode mode = map_read)
+  {
+    close();
+    if (!file_.open(path, mode)) return false;
+    if (!check())
+    {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  void close()
+  {
+    file_.close();
+    sections_.clear();
+  }
+
+  bool   is_open()       const noexcept { return file_.is_open(); }
+  size_t section_count() const noexcept { return sections_.size(); }
+
+  archive_kind kind(size_t i) const
+  {
+    return static_cast<archive_kind>(section(i).kind);
+  }
+
+  template <class T>
+  mapped_span<T> vector_section(size_t i) const
+  {
+    const archive_section& s = expect(i, archive_vector, sizeof(T), 0);
+    return mapped_span<T>(array<T>(s, 0), static_cast<size_t>(s.count));
+  }
+
+  template <class Key, class T, class Compare = mystl::less<Key>>
+  flat_map_view<Key, T, Compare> flat_map_section(size_t i,
+                                                  const Compare& comp = Compare()) const
+  {
+    const archive_section& s = expect(i, archive_flat_map, sizeof(Key), sizeof(T));
+    const auto n = static_cast<size_t>(s.count);
+    return flat_map_view<Key, T, Compare>(mapped_span<Key>(array<Key>(s, 0), n),
+                                          mapped_span<T>(array<T>(s, 1), n), comp);
+  }
+
+  // the chunk directory is checked here, it is small next to the containers
+  bitmap_set_view bitmap_set_section(size_t i) const
+  {
+    const archive_section& s = expect(i, archive_bitmap_set, sizeof(uint16_t), 0);
+    const auto n = static_cast<size_t>(s.count);
+    const archive_chunk* chunks = array<archive_chunk>(s, 1);
+    for (size_t k = 0; k < n; ++k)
+    {
+      const archive_chunk& c = chunks[k];
+      uint64_t bytes = 0;
+      if (c.kind == bitmap_container::array_kind && c.card <= bitmap_container::array_max)
+        bytes = c.card * sizeof(uint16_t);
+      else if (c.kind == bitmap_container::bitmap_kind)
+        bytes = bitmap_container::words * sizeof(uint64_t);
+      else if (c.kind == bitmap_container::run_kind)
+        bytes = c.runs * 2 * sizeof(uint16_t);
+      else
+        throw std::runtime_error("archive_reader: bad bitmap_set chunk");
+      if (c.offset % sizeof(uint64_t) != 0 || c.offset > s.size || bytes > s.size - c.offset)
+        throw std::runtime_error("archive_reader: bad bitmap_set chunk");
+    }
+    return bitmap_set_view(reinterpret_cast<const unsigned char*>(&s),
+                           array<uint16_t>(s, 0), chunks, n);
+  }
+
+  // hint how the whole archive will be used
+  bool advise(map_advice advice) const noexcept { return file_.advise(advice); }
+
+  const mapped_file& file() const noexcept { return file_; }
+
+private:
+  const archive_section& section(size_t i) const
+  {
+    if (i >= sections_.size())
+      throw std::out_of_range("archive_reader section subscript out of range");
+    return *sections_[i];
+  }
+
+  const archive_section& expect(size_t i, archive_kind kind,
+                                size_t key_size, size_t value_size) const
+  {
+    const archive_section& s = section(i);
+    if (s.kind != static_cast<uint32_t>(kind) || s.key_size != key_size ||
+        s.value_size != value_size)
+      throw std::logic_error("archive_reader: section does not hold this type");
+    return s;
+  }
+
+  template <class T>
+  static const T* array(const archive_section& s, size_t k) noexcept
+  {
+    return reinterpret_cast<const T*>(reinterpret_cast<const unsigned char*>(&s) + s.offset[k]);
+  }
+
+  // n elements of elem bytes at offset fit in section s
+  static bool fits(const archive_section& s, uint64_t offset, uint64_t n, uint64_t elem) noexcept
+  {
+    return offset >= sizeof(archive_section) && offset % archive_alignment == 0 &&
+      offset <= s.size && n <= (s.size - offset) / elem;
+  }
+
+  bool check()
+  {
+    const auto size = static_cast<uint64_t>(file_.size());
+    if (size < sizeof(archive_header)) return false;
+    const auto* h = reinterpret_cast<const archive_header*>(file_.data());
+    if (std::memcmp(h->magic, archive_magic, sizeof(h->magic)) != 0 ||
+        h->version != archive_version || h->endian != archive_endian ||
+        h->alignment != archive_alignment || h->size > size ||
+        h->sections > h->size / sizeof(archive_section))
+      return false;
+    uint64_t pos = sizeof(archive_header);
+    sections_.reserve(h->sections);
+    for (uint32_t i = 0; i < h->sections; ++i)
+    {
+      if (pos > h->size || h->size - pos < sizeof(archive_section)) return false;
+      const auto* s = reinterpret_cast<const archive_section*>(file_.data() + pos);
+      if (s->size < sizeof(archive_section) || s->size % archive_alignment != 0 ||
+          s->size > h->size - pos)
+        return false;
+      bool ok = false;
+      switch (s->kind)
+      {
+        case archive_vector:
+          ok = s->key_size != 0 && fits(*s, s->offset[0], s->count, s->key_size);
+          break;
+        case archive_flat_map:
+          ok = s->key_size != 0 && s->value_size != 0 &&
+            fits(*s, s->offset[0], s->count, s->key_size) &&
+            fits(*s, s->offset[1], s->count, s->value_size);
+          break;
+        case archive_bitmap_set:
+          ok = s->key_size == sizeof(uint16_t) &&
+            fits(*s, s->offset[0], s->count, sizeof(uint16_t)) &&
+            fits(*s, s->offset[1], s->count, sizeof(archive_chunk));
+          break;
+        default:
+          break;
+      }
+      if (!ok) return false;
+      sections_.push_back(s);
+      pos += s->size;
+    }
+    return true;
+  }
+
+  archive_reader(const archive_reader&);
+
+  void operator=(const archive_reader&);
+};
+
+} // namespace mystl
+
+#endif // !_LITESTL_ARCHIVE_H_
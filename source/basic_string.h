@@ -0,0 +1,1133 @@
+#ifndef _LITESTL_BASIC_STRING_H_
+#define _LITESTL_BASIC_STRING_H_
+
+// string with the characters of short strings stored inside the object
+// a basic_string<char> is 24 bytes and holds up to 23 characters without
+// touching the heap
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+
+#include "iterator.h"
+#include "allocator.h"
+#include "char_traits.h"
+#include "functional.h"  // mystl::hash, mystl::hash_bytes
+#include "string_view.h"
+#include "util.h"
+#include "vector.h"      // mystl::geometric_growth
+
+namespace mystl
+{
+
+/********************************************************************************/
+// template class: basic_string
+// CharT: character type, Traits: character operations, Alloc: allocator
+// the object is 24 bytes, either the characters themselves (short) or a
+// pointer, a size and a capacity (long); the last byte tells which:
+// a short string keeps sso_capacity - size in its last character, which is
+// 0, the terminator, once the buffer is full, and a long string sets the top
+// bit of that byte, which is the top byte of its capacity
+// a long string grows like vector, through Alloc, and never goes back to
+// short unless shrink_to_fit is called
+/********************************************************************************/
+template <class CharT, class Traits = mystl::char_traits<CharT>,
+  class Alloc = mystl::allocator<CharT>>
+class basic_string
+{
+  static_assert(std::is_trivial<CharT>::value, "basic_string needs a trivial character type");
+  static_assert(24 % sizeof(CharT) == 0, "basic_string character size must divide 24");
+
+public:
+  typedef Traits                    traits_type;
+  typedef Alloc                     allocator_type;
+  typedef Alloc                     data_allocator;
+
+  typedef CharT                     value_type;
+  typedef CharT*                    pointer;
+  typedef const CharT*              const_pointer;
+  typedef CharT&                    reference;
+  typedef const CharT&              const_reference;
+  typedef size_t                    size_type;
+  typedef ptrdiff_t                 difference_type;
+
+  typedef value_type*               iterator;
+  typedef const value_type*         const_iterator;
+
+  static const size_type npos = static_cast<size_type>(-1);
+  static const size_type sso_capacity = 24 / sizeof(CharT) - 1;
+
+  allocator_type get_allocator() { return data_allocator(); }
+
+private:
+  typedef mystl::geometric_growth<> growth_policy;
+
+  struct long_rep
+  {
+    pointer   data;
+    size_type size;
+    size_type cap;
+  };
+
+  union rep
+  {
+    long_rep   l;
+    value_type s[sso_capacity + 1];
+  };
+
+  static_assert(sizeof(rep) == 24, "basic_string must be 24 bytes");
+
+  // on a 64-bit target cap ends at the last byte, and gives up that byte to
+  // the flag: on little endian it is the top byte, on big endian the lowest
+  static const bool cap_holds_flag = sizeof(long_rep) == sizeof(rep);
+
+  rep rep_;
+
+public:
+  // construct, copy, move and destroy
+  basic_string() noexcept
+    :rep_()
+  {
+    set_small_size(0);
+  }
+
+  basic_string(size_type n, value_type c)
+  {
+    init_fill(n, c);
+  }
+
+  basic_string(const_pointer s)
+  {
+    init(s, traits_type::length(s));
+  }
+
+  basic_string(const_pointer s, size_type n)
+  {
+    init(s, n);
+  }
+
+  basic_string(const basic_string& rhs, size_type pos, size_type n = npos)
+  {
+    rhs.check_pos(pos);
+    init(rhs.data() + pos, rhs.clamp(pos, n));
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  basic_string(Iter first, Iter last)
+    :rep_()
+  {
+    set_small_size(0);
+    append_range(first, last, iterator_category(first));
+  }
+
+  basic_string(std::initializer_list<value_type> ilist)
+  {
+    init(ilist.begin(), ilist.size());
+  }
+
+  explicit basic_string(basic_string_view<CharT, Traits> v)
+  {
+    init(v.data(), v.size());
+  }
+
+  basic_string(const basic_string& rhs)
+  {
+    if (rhs.is_long())
+      init(rhs.rep_.l.data, rhs.rep_.l.size);
+    else
+      rep_ = rhs.rep_;
+  }
+
+  basic_string(basic_string&& rhs) noexcept
+  {
+    take(rhs);
+  }
+
+  basic_string& operator=(const basic_string& rhs)
+  {
+    if (this != &rhs) assign(rhs.data(), rhs.size());
+    return *this;
+  }
+
+  basic_string& operator=(basic_string&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      free_heap();
+      take(rhs);
+    }
+    return *this;
+  }
+
+  basic_string& operator=(const_pointer s)                      { return assign(s); }
+  basic_string& operator=(value_type c)                         { return assign(1, c); }
+  basic_string& operator=(std::initializer_list<value_type> il) { return assign(il); }
+
+  ~basic_string()
+  {
+    free_heap();
+  }
+
+public:
+  // iterators
+  iterator       begin()        noexcept { return data_ptr(); }
+  const_iterator begin()  const noexcept { return data_ptr(); }
+  iterator       end()          noexcept { return data_ptr() + size(); }
+  const_iterator end()    const noexcept { return data_ptr() + size(); }
+
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend()   const noexcept { return end(); }
+
+  // capacity
+  bool      empty()    const noexcept { return size() == 0; }
+  size_type size()     const noexcept
+  {
+    return is_long() ? rep_.l.size : sso_capacity - static_cast<size_type>(rep_.s[sso_capacity]);
+  }
+  size_type length()   const noexcept { return size(); }
+  size_type capacity() const noexcept
+  {
+    return is_long() ? decode_cap(rep_.l.cap) : sso_capacity;
+  }
+  size_type max_size() const noexcept
+  {
+    return (cap_holds_flag ? npos >> 8 : npos >> 1) / sizeof(value_type) - 1;
+  }
+
+  void reserve(size_type n);
+  void shrink_to_fit();
+
+  // access
+  reference       operator[](size_type n)       { return data_ptr()[n]; }
+  const_reference operator[](size_type n) const { return data_ptr()[n]; }
+
+  reference at(size_type n)
+  {
+    if (n >= size()) throw std::out_of_range("basic_string<CharT>::at() subscript out of range");
+    return data_ptr()[n];
+  }
+  const_reference at(size_type n) const
+  {
+    if (n >= size()) throw std::out_of_range("basic_string<CharT>::at() subscript out of range");
+    return data_ptr()[n];
+  }
+
+  reference       front()       { return data_ptr()[0]; }
+  const_reference front() const { return data_ptr()[0]; }
+  reference       back()        { return data_ptr()[size() - 1]; }
+  const_reference back()  const { return data_ptr()[size() - 1]; }
+
+  pointer       data()        noexcept { return data_ptr(); }
+  const_pointer data()  const noexcept { return data_ptr(); }
+  const_pointer c_str() const noexcept { return data_ptr(); }
+
+  operator basic_string_view<CharT, Traits>() const noexcept
+  {
+    return basic_string_view<CharT, Traits>(data_ptr(), size());
+  }
+
+  // modify
+  void clear() noexcept { set_size(0); }
+
+  void push_back(value_type c)
+  {
+    const size_type n = size();
+    if (n == capacity()) reallocate(next_capacity(1));
+    data_ptr()[n] = c;
+    set_size(n + 1);
+  }
+
+  void pop_back() noexcept { set_size(size() - 1); }
+
+  // assign
+  basic_string& assign(const basic_string& str)
+  { return assign(str.data(), str.size()); }
+  basic_string& assign(basic_string&& str) noexcept
+  { return *this = mystl::move(str); }
+  basic_string& assign(const basic_string& str, size_type pos, size_type n = npos)
+  {
+    str.check_pos(pos);
+    return assign(str.data() + pos, str.clamp(pos, n));
+  }
+  basic_string& assign(const_pointer s, size_type n)
+  { return replace_aux(0, size(), s, n); }
+  basic_string& assign(const_pointer s)
+  { return assign(s, traits_type::length(s)); }
+  basic_string& assign(size_type n, value_type c)
+  { return replace_fill(0, size(), n, c); }
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  basic_string& assign(Iter first, Iter last)
+  {
+    const basic_string tmp(first, last);
+    return assign(tmp.data(), tmp.size());
+  }
+  basic_string& assign(std::initializer_list<value_type> ilist)
+  { return assign(ilist.begin(), ilist.size()); }
+
+  // append
+  basic_string& append(const basic_string& str)
+  { return append(str.data(), str.size()); }
+  basic_string& append(const basic_string& str, size_type pos, size_type n = npos)
+  {
+    str.check_pos(pos);
+    return append(str.data() + pos, str.clamp(pos, n));
+  }
+  basic_string& append(const_pointer s, size_type n);
+  basic_string& append(const_pointer s)
+  { return append(s, traits_type::length(s)); }
+  basic_string& append(size_type n, value_type c);
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  basic_string& append(Iter first, Iter last)
+  {
+    const basic_string tmp(first, last);
+    return append(tmp.data(), tmp.size());
+  }
+  basic_string& append(std::initializer_list<value_type> ilist)
+  { return append(ilist.begin(), ilist.size()); }
+  basic_string& append(basic_string_view<CharT, Traits> v)
+  { return append(v.data(), v.size()); }
+
+  basic_string& operator+=(const basic_string& str)              { return append(str); }
+  basic_string& operator+=(const_pointer s)                      { return append(s); }
+  basic_string& operator+=(value_type c)                         { push_back(c); return *this; }
+  basic_string& operator+=(std::initializer_list<value_type> il) { return append(il); }
+  basic_string& operator+=(basic_string_view<CharT, Traits> v)   { return append(v); }
+
+  // insert
+  basic_string& insert(size_type pos, const basic_string& str)
+  { return insert(pos, str.data(), str.size()); }
+  basic_string& insert(size_type pos, const basic_string& str, size_type pos2,
+                       size_type n = npos)
+  {
+    str.check_pos(pos2);
+    return insert(pos, str.data() + pos2, str.clamp(pos2, n));
+  }
+  basic_string& insert(size_type pos, const_pointer s, size_type n)
+  {
+    check_pos(pos);
+    return replace_aux(pos, 0, s, n);
+  }
+  basic_string& insert(size_type pos, const_pointer s)
+  { return insert(pos, s, traits_type::length(s)); }
+  basic_string& insert(size_type pos, size_type n, value_type c)
+  {
+    check_pos(pos);
+    return replace_fill(pos, 0, n, c);
+  }
+
+  iterator insert(const_iterator it, value_type c)
+  { return insert(it, 1, c); }
+  iterator insert(const_iterator it, size_type n, value_type c)
+  {
+    const auto pos = static_cast<size_type>(it - cbegin());
+    replace_fill(pos, 0, n, c);
+    return begin() + pos;
+  }
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  iterator insert(const_iterator it, Iter first, Iter last)
+  {
+    const auto pos = static_cast<size_type>(it - cbegin());
+    const basic_string tmp(first, last);
+    replace_aux(pos, 0, tmp.data(), tmp.size());
+    return begin() + pos;
+  }
+  iterator insert(const_iterator it, std::initializer_list<value_type> ilist)
+  {
+    const auto pos = static_cast<size_type>(it - cbegin());
+    replace_aux(pos, 0, ilist.begin(), ilist.size());
+    return begin() + pos;
+  }
+
+  // erase
+  basic_string& erase(size_type pos = 0, size_type n = npos)
+  {
+    check_pos(pos);
+    erase_aux(pos, clamp(pos, n));
+    return *this;
+  }
+  iterator erase(const_iterator it)
+  {
+    const auto pos = static_cast<size_type>(it - cbegin());
+    erase_aux(pos, 1);
+    return begin() + pos;
+  }
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    const auto pos = static_cast<size_type>(first - cbegin());
+    erase_aux(pos, static_cast<size_type>(last - first));
+    return begin() + pos;
+  }
+
+  // replace
+  basic_string& replace(size_type pos, size_type n1, const basic_string& str)
+  { return replace(pos, n1, str.data(), str.size()); }
+  basic_string& replace(size_type pos, size_type n1, const_pointer s, size_type n2)
+  {
+    check_pos(pos);
+    return replace_aux(pos, clamp(pos, n1), s, n2);
+  }
+  basic_string& replace(size_type pos, size_type n1, const_pointer s)
+  { return replace(pos, n1, s, traits_type::length(s)); }
+  basic_string& replace(size_type pos, size_type n1, size_type n2, value_type c)
+  {
+    check_pos(pos);
+    return replace_fill(pos, clamp(pos, n1), n2, c);
+  }
+  basic_string& replace(const_iterator first, const_iterator last, const basic_string& str)
+  { return replace(first, last, str.data(), str.size()); }
+  basic_string& replace(const_iterator first, const_iterator last, const_pointer s, size_type n)
+  {
+    return replace_aux(static_cast<size_type>(first - cbegin()),
+                       static_cast<size_type>(last - first), s, n);
+  }
+  basic_string& replace(const_iterator first, const_iterator last, const_pointer s)
+  { return replace(first, last, s, traits_type::length(s)); }
+  basic_string& replace(const_iterator first, const_iterator last, size_type n, value_type c)
+  {
+    return replace_fill(static_cast<size_type>(first - cbegin()),
+                        static_cast<size_type>(last - first), n, c);
+  }
+
+  void resize(size_type n) { resize(n, value_type()); }
+  void resize(size_type n, value_type c)
+  {
+    const size_type old_size = size();
+    if (n > old_size)
+      append(n - old_size, c);
+    else
+      set_size(n);
+  }
+
+  void swap(basic_string& rhs) noexcept
+  {
+    const rep tmp = rep_;
+    rep_ = rhs.rep_;
+    rhs.rep_ = tmp;
+  }
+
+  size_type copy(pointer dst, size_type n, size_type pos = 0) const
+  {
+    check_pos(pos);
+    n = clamp(pos, n);
+    traits_type::copy(dst, data_ptr() + pos, n);
+    return n;
+  }
+
+  basic_string substr(size_type pos = 0, size_type n = npos) const
+  {
+    return basic_string(*this, pos, n);
+  }
+
+  // search
+  size_type find(const basic_string& str, size_type pos = 0) const noexcept
+  { return find(str.data(), pos, str.size()); }
+  size_type find(const_pointer s, size_type pos, size_type n) const noexcept;
+  size_type find(const_pointer s, size_type pos = 0) const noexcept
+  { return find(s, pos, traits_type::length(s)); }
+  size_type find(value_type c, size_type pos = 0) const noexcept;
+
+  size_type rfind(const basic_string& str, size_type pos = npos) const noexcept
+  { return rfind(str.data(), pos, str.size()); }
+  size_type rfind(const_pointer s, size_type pos, size_type n) const noexcept;
+  size_type rfind(const_pointer s, size_type pos = npos) const noexcept
+  { return rfind(s, pos, traits_type::length(s)); }
+  size_type rfind(value_type c, size_type pos = npos) const noexcept
+  { return rfind(&c, pos, 1); }
+
+  size_type find_first_of(const basic_string& str, size_type pos = 0) const noexcept
+  { return find_first_of(str.data(), pos, str.size()); }
+  size_type find_first_of(const_pointer s, size_type pos, size_type n) const noexcept
+  { return find_in(s, pos, n, true); }
+  size_type find_first_of(const_pointer s, size_type pos = 0) const noexcept
+  { return find_first_of(s, pos, traits_type::length(s)); }
+  size_type find_first_of(value_type c, size_type pos = 0) const noexcept
+  { return find(c, pos); }
+
+  size_type find_last_of(const basic_string& str, size_type pos = npos) const noexcept
+  { return find_last_of(str.data(), pos, str.size()); }
+  size_type find_last_of(const_pointer s, size_type pos, size_type n) const noexcept
+  { return rfind_in(s, pos, n, true); }
+  size_type find_last_of(const_pointer s, size_type pos = npos) const noexcept
+  { return find_last_of(s, pos, traits_type::length(s)); }
+  size_type find_last_of(value_type c, size_type pos = npos) const noexcept
+  { return rfind(&c, pos, 1); }
+
+  size_type find_first_not_of(const basic_string& str, size_type pos = 0) const noexcept
+  { return find_first_not_of(str.data(), pos, str.size()); }
+  size_type find_first_not_of(const_pointer s, size_type pos, size_type n) const noexcept
+  { return find_in(s, pos, n, false); }
+  size_type find_first_not_of(const_pointer s, size_type pos = 0) const noexcept
+  { return find_first_not_of(s, pos, traits_type::length(s)); }
+  size_type find_first_not_of(value_type c, size_type pos = 0) const noexcept
+  { return find_in(&c, pos, 1, false); }
+
+  size_type find_last_not_of(const basic_string& str, size_type pos = npos) const noexcept
+  { return find_last_not_of(str.data(), pos, str.size()); }
+  size_type find_last_not_of(const_pointer s, size_type pos, size_type n) const noexcept
+  { return rfind_in(s, pos, n, false); }
+  size_type find_last_not_of(const_pointer s, size_type pos = npos) const noexcept
+  { return find_last_not_of(s, pos, traits_type::length(s)); }
+  size_type find_last_not_of(value_type c, size_type pos = npos) const noexcept
+  { return rfind_in(&c, pos, 1, false); }
+
+  // compare
+  int compare(const basic_string& str) const noexcept
+  { return compare_aux(data_ptr(), size(), str.data(), str.size()); }
+  int compare(size_type pos, size_type n, const basic_string& str) const
+  { return compare(pos, n, str.data(), str.size()); }
+  int compare(size_type pos, size_type n1, const basic_string& str,
+              size_type pos2, size_type n2 = npos) const
+  {
+    str.check_pos(pos2);
+    return compare(pos, n1, str.data() + pos2, str.clamp(pos2, n2));
+  }
+  int compare(const_pointer s) const noexcept
+  { return compare_aux(data_ptr(), size(), s, traits_type::length(s)); }
+  int compare(size_type pos, size_type n1, const_pointer s) const
+  { return compare(pos, n1, s, traits_type::length(s)); }
+  int compare(size_type pos, size_type n1, const_pointer s, size_type n2) const
+  {
+    check_pos(pos);
+    return compare_aux(data_ptr() + pos, clamp(pos, n1), s, n2);
+  }
+
+  static int compare_aux(const_pointer s1, size_type n1, const_pointer s2, size_type n2) noexcept
+  {
+    const int r = traits_type::compare(s1, s2, n1 < n2 ? n1 : n2);
+    if (r != 0) return r;
+    return n1 < n2 ? -1 : (n1 > n2 ? 1 : 0);
+  }
+
+private:
+  // helper functions
+
+  // representation
+  bool is_long() const noexcept
+  {
+    return (reinterpret_cast<const unsigned char*>(&rep_)[sizeof(rep) - 1] & 0x80) != 0;
+  }
+
+  pointer data_ptr() noexcept
+  { return is_long() ? rep_.l.data : rep_.s; }
+  const_pointer data_ptr() const noexcept
+  { return is_long() ? rep_.l.data : rep_.s; }
+
+  static size_type encode_cap(size_type cap) noexcept;
+  static size_type decode_cap(size_type word) noexcept;
+
+  void set_small_size(size_type n) noexcept
+  {
+    rep_.s[sso_capacity] = static_cast<value_type>(sso_capacity - n);
+    rep_.s[n] = value_type();
+  }
+
+  void set_long(pointer p, size_type n, size_type cap) noexcept
+  {
+    rep_.l.data = p;
+    rep_.l.size = n;
+    rep_.l.cap = encode_cap(cap);
+    reinterpret_cast<unsigned char*>(&rep_)[sizeof(rep) - 1] |= 0x80;
+    p[n] = value_type();
+  }
+
+  void set_size(size_type n) noexcept
+  {
+    if (is_long())
+    {
+      rep_.l.size = n;
+      rep_.l.data[n] = value_type();
+    }
+    else
+    {
+      set_small_size(n);
+    }
+  }
+
+  // storage
+  void init(const_pointer s, size_type n);
+  void init_fill(size_type n, value_type c);
+  void free_heap() noexcept
+  {
+    if (is_long()) data_allocator::deallocate(rep_.l.data, decode_cap(rep_.l.cap) + 1);
+  }
+  void take(basic_string& rhs) noexcept
+  {
+    rep_ = rhs.rep_;
+    rhs.set_small_size(0);
+  }
+  size_type next_capacity(size_type add) const;
+  void      reallocate(size_type new_cap);
+
+  template <class IIter>
+  void append_range(IIter first, IIter last, input_iterator_tag);
+  template <class FIter>
+  void append_range(FIter first, FIter last, forward_iterator_tag);
+
+  // positions
+  void check_pos(size_type pos) const
+  {
+    if (pos > size()) throw std::out_of_range("basic_string<CharT>'s position out of range");
+  }
+  size_type clamp(size_type pos, size_type n) const noexcept
+  {
+    const size_type rest = size() - pos;
+    return n < rest ? n : rest;
+  }
+  bool aliases(const_pointer s) const noexcept
+  {
+    const auto p = reinterpret_cast<uintptr_t>(data_ptr());
+    const auto x = reinterpret_cast<uintptr_t>(s);
+    return x >= p && x <= p + size() * sizeof(value_type);
+  }
+
+  // modify
+  basic_string& replace_aux(size_type pos, size_type n1, const_pointer s, size_type n2);
+  basic_string& replace_fill(size_type pos, size_type n1, size_type n2, value_type c);
+  void          erase_aux(size_type pos, size_type n) noexcept;
+
+  // search
+  size_type find_in(const_pointer s, size_type pos, size_type n, bool member) const noexcept;
+  size_type rfind_in(const_pointer s, size_type pos, size_type n, bool member) const noexcept;
+};
+
+template <class CharT, class Traits, class Alloc>
+const typename basic_string<CharT, Traits, Alloc>::size_type
+basic_string<CharT, Traits, Alloc>::npos;
+
+template <class CharT, class Traits, class Alloc>
+const typename basic_string<CharT, Traits, Alloc>::size_type
+basic_string<CharT, Traits, Alloc>::sso_capacity;
+
+/*****************************************************************************************/
+
+// reserve room for n characters
+template <class CharT, class Traits, class Alloc>
+void basic_string<CharT, Traits, Alloc>::reserve(size_type n)
+{
+  if (n <= capacity()) return;
+  if (n > max_size()) throw std::length_error("basic_string<CharT>'s size too big");
+  reallocate(n);
+}
+
+// give back the unused capacity, a string that fits goes back inside the object
+template <class CharT, class Traits, class Alloc>
+void basic_string<CharT, Traits, Alloc>::shrink_to_fit()
+{
+  if (!is_long()) return;
+  const pointer   p = rep_.l.data;
+  const size_type n = rep_.l.size;
+  const size_type cap = decode_cap(rep_.l.cap);
+  if (n == cap) return;
+  if (n <= sso_capacity)
+  {
+    traits_type::copy(rep_.s, p, n);
+    set_small_size(n);
+    data_allocator::deallocate(p, cap + 1);
+  }
+  else
+  {
+    reallocate(n);
+  }
+}
+
+template <class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>&
+basic_string<CharT, Traits, Alloc>::append(const_pointer s, size_type n)
+{
+  const size_type old_size = size();
+  if (n <= capacity() - old_size)
+  {
+    // the source may be this string, it ends before the characters written
+    traits_type::copy(data_ptr() + old_size, s, n);
+    set_size(old_size + n);
+    return *this;
+  }
+  return replace_aux(old_size, 0, s, n);
+}
+
+template <class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>&
+basic_string<CharT, Traits, Alloc>::append(size_type n, value_type c)
+{
+  const size_type old_size = size();
+  if (n <= capacity() - old_size)
+  {
+    traits_type::assign(data_ptr() + old_size, n, c);
+    set_size(old_size + n);
+    return *this;
+  }
+  return replace_fill(old_size, 0, n, c);
+}
+
+template <class CharT, class Traits, class Alloc>
+typename basic_string<CharT, Traits, Alloc>::size_type
+basic_string<CharT, Traits, Alloc>::find(const_pointer s, size_type pos, size_type n) const noexcept
+{
+  const size_type len = size();
+  if (pos > len) return npos;
+  const_pointer p = data_ptr();
+  const_pointer r = mystl::string_find(p + pos, len - pos, s, n, traits_type());
+  return r == nullptr ? npos : static_cast<size_type>(r - p);
+}
+
+template <class CharT, class Traits, class Alloc>
+typename basic_string<CharT, Traits, Alloc>::size_type
+basic_string<CharT, Traits, Alloc>::find(value_type c, size_type pos) const noexcept
+{
+  const size_type len = size();
+  if (pos >= len) return npos;
+  const_pointer p = data_ptr();
+  const_pointer r = traits_type::find(p + pos, len - pos, c);
+  return r == nullptr ? npos : static_cast<size_type>(r - p);
+}
+
+// the match starts at pos or before
+template <class CharT, class Traits, class Alloc>
+typename basic_string<CharT, Traits, Alloc>::size_type
+basic_string<CharT, Traits, Alloc>::rfind(const_pointer s, size_type pos, size_type n) const noexcept
+{
+  const size_type len = size();
+  if (n > len) return npos;
+  const size_type start = pos < len - n ? pos : len - n;
+  const_pointer p = data_ptr();
+  const_pointer r = mystl::string_rfind(p, start + n, s, n, traits_type());
+  return r == nullptr ? npos : static_cast<size_type>(r - p);
+}
+
+/*****************************************************************************************/
+// helper function
+
+// the last byte of cap is the flag byte
+template <class CharT, class Traits, class Alloc>
+typename basic_string<CharT, Traits, Alloc>::size_type
+basic_string<CharT, Traits, Alloc>::encode_cap(size_type cap) noexcept
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return cap_holds_flag ? cap << 8 : cap;
+#else
+  return cap;
+#endif
+}
+
+template <class CharT, class Traits, class Alloc>
+typename basic_string<CharT, Traits, Alloc>::size_type
+basic_string<CharT, Traits, Alloc>::decode_cap(size_type word) noexcept
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return cap_holds_flag ? word >> 8 : word;
+#else
+  return cap_holds_flag ? word & (npos >> 8) : word;
+#endif
+}
+
+template <class CharT, class Traits, class Alloc>
+void basic_string<CharT, Traits, Alloc>::init(const_pointer s, size_type n)
+{
+  if (n <= sso_capacity)
+  {
+    traits_type::copy(rep_.s, s, n);
+    set_small_size(n);
+    return;
+  }
+  if (n > max_size()) throw std::length_error("basic_string<CharT>'s size too big");
+  pointer p = data_allocator::allocate(n + 1);
+  traits_type::copy(p, s, n);
+  set_long(p, n, n);
+}
+
+template <class CharT, class Traits, class Alloc>
+void basic_string<CharT, Traits, Alloc>::init_fill(size_type n, value_type c)
+{
+  if (n <= sso_capacity)
+  {
+    traits_type::assign(rep_.s, n, c);
+    set_small_size(n);
+    return;
+  }
+  if (n > max_size()) throw std::length_error("basic_string<CharT>'s size too big");
+  pointer p = data_allocator::allocate(n + 1);
+  traits_type::assign(p, n, c);
+  set_long(p, n, n);
+}
+
+// capacity to hold add more characters
+template <class CharT, class Traits, class Alloc>
+typename basic_string<CharT, Traits, Alloc>::size_type
+basic_string<CharT, Traits, Alloc>::next_capacity(size_type add) const
+{
+  const size_type old_size = size();
+  if (max_size() - old_size < add)
+  {
+    throw std::length_error("basic_string<CharT>'s size too big");
+  }
+  return growth_policy::next_capacity(capacity(), old_size + add, max_size());
+}
+
+// move the characters to heap storage of new_cap characters
+template <class CharT, class Traits, class Alloc>
+void basic_string<CharT, Traits, Alloc>::reallocate(size_type new_cap)
+{
+  const size_type n = size();
+  pointer p = data_allocator::allocate(new_cap + 1);
+  traits_type::copy(p, data_ptr(), n);
+  free_heap();
+  set_long(p, n, new_cap);
+}
+
+template <class CharT, class Traits, class Alloc>
+template <class IIter>
+void basic_string<CharT, Traits, Alloc>::
+append_range(IIter first, IIter last, input_iterator_tag)
+{
+  for (; first != last; ++first) push_back(*first);
+}
+
+template <class CharT, class Traits, class Alloc>
+template <class FIter>
+void basic_string<CharT, Traits, Alloc>::
+append_range(FIter first, FIter last, forward_iterator_tag)
+{
+  const auto n = static_cast<size_type>(mystl::distance(first, last));
+  const size_type old_size = size();
+  reserve(old_size + n);
+  pointer p = data_ptr() + old_size;
+  for (; first != last; ++first, ++p) *p = *first;
+  set_size(old_size + n);
+}
+
+// replace n1 characters at pos with s[0, n2)
+template <class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>&
+basic_string<CharT, Traits, Alloc>::
+replace_aux(size_type pos, size_type n1, const_pointer s, size_type n2)
+{
+  const size_type old_size = size();
+  if (max_size() - (old_size - n1) < n2)
+  {
+    throw std::length_error("basic_string<CharT>'s size too big");
+  }
+  const size_type new_size = old_size - n1 + n2;
+  if (new_size <= capacity())
+  {
+    if (n2 != 0 && aliases(s))
+    {
+      // the source is part of this string and would shift under the copy
+      const basic_string tmp(s, n2);
+      return replace_aux(pos, n1, tmp.data(), n2);
+    }
+    pointer p = data_ptr();
+    if (n1 != n2) traits_type::move(p + pos + n2, p + pos + n1, old_size - pos - n1);
+    traits_type::copy(p + pos, s, n2);
+    set_size(new_size);
+  }
+  else
+  {
+    // the old characters are still there while s is copied
+    const size_type new_cap = growth_policy::next_capacity(capacity(), new_size, max_size());
+    pointer np = data_allocator::allocate(new_cap + 1);
+    const_pointer p = data_ptr();
+    traits_type::copy(np, p, pos);
+    traits_type::copy(np + pos, s, n2);
+    traits_type::copy(np + pos + n2, p + pos + n1, old_size - pos - n1);
+    free_heap();
+    set_long(np, new_size, new_cap);
+  }
+  return *this;
+}
+
+// replace n1 characters at pos with n2 copies of c
+template <class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>&
+basic_string<CharT, Traits, Alloc>::
+replace_fill(size_type pos, size_type n1, size_type n2, value_type c)
+{
+  const size_type old_size = size();
+  if (max_size() - (old_size - n1) < n2)
+  {
+    throw std::length_error("basic_string<CharT>'s size too big");
+  }
+  const size_type new_size = old_size - n1 + n2;
+  if (new_size <= capacity())
+  {
+    pointer p = data_ptr();
+    if (n1 != n2) traits_type::move(p + pos + n2, p + pos + n1, old_size - pos - n1);
+    traits_type::assign(p + pos, n2, c);
+    set_size(new_size);
+  }
+  else
+  {
+    const size_type new_cap = growth_policy::next_capacity(capacity(), new_size, max_size());
+    pointer np = data_allocator::allocate(new_cap + 1);
+    const_pointer p = data_ptr();
+    traits_type::copy(np, p, pos);
+    traits_type::assign(np + pos, n2, c);
+    traits_type::copy(np + pos + n2, p + pos + n1, old_size - pos - n1);
+    free_heap();
+    set_long(np, new_size, new_cap);
+  }
+  return *this;
+}
+
+template <class CharT, class Traits, class Alloc>
+void basic_string<CharT, Traits, Alloc>::erase_aux(size_type pos, size_type n) noexcept
+{
+  if (n == 0) return;
+  const size_type old_size = size();
+  pointer p = data_ptr();
+  traits_type::move(p + pos, p + pos + n, old_size - pos - n);
+  set_size(old_size - n);
+}
+
+template <class CharT, class Traits, class Alloc>
+typename basic_string<CharT, Traits, Alloc>::size_type
+basic_string<CharT, Traits, Alloc>::
+find_in(const_pointer s, size_type pos, size_type n, bool member) const noexcept
+{
+  const size_type len = size();
+  if (pos >= len) return npos;
+  const_pointer p = data_ptr();
+  const_pointer r = mystl::string_find_in(p + pos, len - pos, s, n, member, traits_type());
+  return r == nullptr ? npos : static_cast<size_type>(r - p);
+}
+
+template <class CharT, class Traits, class Alloc>
+typename basic_string<CharT, Traits, Alloc>::size_type
+basic_string<CharT, Traits, Alloc>::
+rfind_in(const_pointer s, size_type pos, size_type n, bool member) const noexcept
+{
+  const size_type len = size();
+  if (len == 0) return npos;
+  const size_type last = pos < len - 1 ? pos : len - 1;
+  const_pointer p = data_ptr();
+  const_pointer r = mystl::string_rfind_in(p, last + 1, s, n, member, traits_type());
+  return r == nullptr ? npos : static_cast<size_type>(r - p);
+}
+
+/*****************************************************************************************/
+// concatenation
+template <class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>
+operator+(const basic_string<CharT, Traits, Alloc>& lhs,
+          const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  basic_string<CharT, Traits, Alloc> r;
+  r.reserve(lhs.size() + rhs.size());
+  r.append(lhs).append(rhs);
+  return r;
+}
+
+template <class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>
+operator+(const basic_string<CharT, Traits, Alloc>& lhs, const CharT* rhs)
+{
+  const auto n = Traits::length(rhs);
+  basic_string<CharT, Traits, Alloc> r;
+  r.reserve(lhs.size() + n);
+  r.append(lhs).append(rhs, n);
+  return r;
+}
+
+template <class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>
+operator+(const CharT* lhs, const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  const auto n = Traits::length(lhs);
+  basic_string<CharT, Traits, Alloc> r;
+  r.reserve(n + rhs.size());
+  r.append(lhs, n).append(rhs);
+  return r;
+}
+
+template <class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>
+operator+(const basic_string<CharT, Traits, Alloc>& lhs, CharT rhs)
+{
+  basic_string<CharT, Traits, Alloc> r;
+  r.reserve(lhs.size() + 1);
+  r.append(lhs).push_back(rhs);
+  return r;
+}
+
+template <class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>
+operator+(CharT lhs, const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  basic_string<CharT, Traits, Alloc> r;
+  r.reserve(1 + rhs.size());
+  r.push_back(lhs);
+  r.append(rhs);
+  return r;
+}
+
+// a temporary on the left is appended to in place
+template <class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>
+operator+(basic_string<CharT, Traits, Alloc>&& lhs,
+          const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  return mystl::move(lhs.append(rhs));
+}
+
+template <class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>
+operator+(basic_string<CharT, Traits, Alloc>&& lhs, const CharT* rhs)
+{
+  return mystl::move(lhs.append(rhs));
+}
+
+template <class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>
+operator+(basic_string<CharT, Traits, Alloc>&& lhs, CharT rhs)
+{
+  lhs.push_back(rhs);
+  return mystl::move(lhs);
+}
+
+// compare
+template <class CharT, class Traits, class Alloc>
+bool operator==(const basic_string<CharT, Traits, Alloc>& lhs,
+                const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  return lhs.size() == rhs.size() &&
+         Traits::compare(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator!=(const basic_string<CharT, Traits, Alloc>& lhs,
+                const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator<(const basic_string<CharT, Traits, Alloc>& lhs,
+               const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  return lhs.compare(rhs) < 0;
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator>(const basic_string<CharT, Traits, Alloc>& lhs,
+               const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator<=(const basic_string<CharT, Traits, Alloc>& lhs,
+                const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator>=(const basic_string<CharT, Traits, Alloc>& lhs,
+                const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator==(const basic_string<CharT, Traits, Alloc>& lhs, const CharT* rhs)
+{
+  return lhs.compare(rhs) == 0;
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator==(const CharT* lhs, const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  return rhs.compare(lhs) == 0;
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator!=(const basic_string<CharT, Traits, Alloc>& lhs, const CharT* rhs)
+{
+  return lhs.compare(rhs) != 0;
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator!=(const CharT* lhs, const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  return rhs.compare(lhs) != 0;
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator<(const basic_string<CharT, Traits, Alloc>& lhs, const CharT* rhs)
+{
+  return lhs.compare(rhs) < 0;
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator<(const CharT* lhs, const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  return rhs.compare(lhs) > 0;
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator>(const basic_string<CharT, Traits, Alloc>& lhs, const CharT* rhs)
+{
+  return lhs.compare(rhs) > 0;
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator>(const CharT* lhs, const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  return rhs.compare(lhs) < 0;
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator<=(const basic_string<CharT, Traits, Alloc>& lhs, const CharT* rhs)
+{
+  return lhs.compare(rhs) <= 0;
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator<=(const CharT* lhs, const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  return rhs.compare(lhs) >= 0;
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator>=(const basic_string<CharT, Traits, Alloc>& lhs, const CharT* rhs)
+{
+  return lhs.compare(rhs) >= 0;
+}
+
+template <class CharT, class Traits, class Alloc>
+bool operator>=(const CharT* lhs, const basic_string<CharT, Traits, Alloc>& rhs)
+{
+  return rhs.compare(lhs) <= 0;
+}
+
+// overload mystl::swap
+template <class CharT, class Traits, class Alloc>
+void swap(basic_string<CharT, Traits, Alloc>& lhs,
+          basic_string<CharT, Traits, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+// hash of the characters
+template <class CharT, class Traits, class Alloc>
+struct hash<basic_string<CharT, Traits, Alloc>>
+{
+  size_t operator()(const basic_string<CharT, Traits, Alloc>& s) const noexcept
+  {
+    return mystl::hash_bytes(s.data(), s.size() * sizeof(CharT));
+  }
+};
+
+typedef basic_string<char>     string;
+typedef basic_string<wchar_t>  wstring;
+typedef basic_string<char16_t> u16string;
+typedef basic_string<char32_t> u32string;
+
+} // namespace mystl
+
+#endif // !_LITESTL_BASIC_STRING_H_
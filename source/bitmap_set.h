@@ -0,0 +1,1158 @@
+#ifndef _LITESTL_BITMAP_SET_H_
+#define _LITESTL_BITMAP_SET_H_
+
+// compressed set of 32-bit unsigned integers (roaring bitmap)
+// the value space is cut into 2^16 chunks by the high 16 bits, every chunk
+// keeps its low 16 bits in the smallest of three containers:
+//   array  : sorted uint16_t values, while there are at most 4096 of them
+//   bitmap : 2^16 bits in 1024 uint64_t words
+//   run    : sorted intervals stored as (start, length - 1) pairs
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "iterator.h"
+#include "algobase.h"   // mystl::lower_bound
+#include "algo_set.h"
+#include "allocator.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// count / find set bits of a word
+inline uint32_t popcount64(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<uint32_t>(__builtin_popcountll(x));
+#else
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return static_cast<uint32_t>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// index of the lowest set bit, x must not be 0
+inline uint32_t countr_zero64(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<uint32_t>(__builtin_ctzll(x));
+#else
+  return mystl::popcount64((x & (0 - x)) - 1);
+#endif
+}
+
+// word operations shared by scalar and SSE2 bitmap loops
+struct bitmap_or
+{
+  uint64_t operator()(uint64_t a, uint64_t b) const { return a | b; }
+#if defined(__SSE2__)
+  __m128i operator()(__m128i a, __m128i b) const { return _mm_or_si128(a, b); }
+#endif
+};
+
+struct bitmap_and
+{
+  uint64_t operator()(uint64_t a, uint64_t b) const { return a & b; }
+#if defined(__SSE2__)
+  __m128i operator()(__m128i a, __m128i b) const { return _mm_and_si128(a, b); }
+#endif
+};
+
+struct bitmap_andnot
+{
+  uint64_t operator()(uint64_t a, uint64_t b) const { return a & ~b; }
+#if defined(__SSE2__)
+  __m128i operator()(__m128i a, __m128i b) const { return _mm_andnot_si128(b, a); }
+#endif
+};
+
+struct bitmap_xor
+{
+  uint64_t operator()(uint64_t a, uint64_t b) const { return a ^ b; }
+#if defined(__SSE2__)
+  __m128i operator()(__m128i a, __m128i b) const { return _mm_xor_si128(a, b); }
+#endif
+};
+
+// result[i] = op(a[i], b[i]) for n words, return number of set bits of result
+template <class WordOp>
+uint32_t bitmap_word_op(const uint64_t* a, const uint64_t* b, uint64_t* result,
+                        size_t n, WordOp op)
+{
+  size_t i = 0;
+#if defined(__SSE2__)
+  for (; i + 2 <= n; i += 2)
+  {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), op(x, y));
+  }
+#endif
+  for (; i < n; ++i) result[i] = op(a[i], b[i]);
+  uint32_t count = 0;
+  for (i = 0; i < n; ++i) count += mystl::popcount64(result[i]);
+  return count;
+}
+
+// number of set bits of op(a[i], b[i]) without storing the words
+template <class WordOp>
+uint32_t bitmap_word_op_count(const uint64_t* a, const uint64_t* b, size_t n,
+                              WordOp op)
+{
+  uint32_t count = 0;
+  for (size_t i = 0; i < n; ++i) count += mystl::popcount64(op(a[i], b[i]));
+  return count;
+}
+
+/********************************************************************************/
+
+// class: bitmap_container
+// low 16 bits of the values of one chunk
+class bitmap_container
+{
+public:
+  enum kind { array_kind, bitmap_kind, run_kind };
+
+  static const uint32_t array_max = 4096; // largest array container
+  static const uint32_t words = 1024;     // uint64_t words of a bitmap
+
+  enum op_kind { op_or, op_and, op_andnot, op_xor };
+
+private:
+  kind      type_;
+  uint32_t  card_;  // number of values
+  uint32_t  size_;  // used slots of vals_: values, or 2 per run
+  uint32_t  cap_;   // allocated slots of vals_
+  uint16_t* vals_;  // array values, or runs as (start, length - 1)
+  uint64_t* words_; // bitmap words
+
+public:
+  // construct, copy, move and destroy
+  bitmap_container() noexcept
+    :type_(array_kind), card_(0), size_(0), cap_(0),
+    vals_(nullptr), words_(nullptr) {}
+
+  bitmap_container(const bitmap_container& rhs)
+    :type_(rhs.type_), card_(rhs.card_), size_(rhs.size_), cap_(rhs.size_),
+    vals_(nullptr), words_(nullptr)
+  {
+    if (rhs.words_ != nullptr)
+    {
+      words_ = mystl::allocator<uint64_t>::allocate(words);
+      std::memcpy(words_, rhs.words_, words * sizeof(uint64_t));
+    }
+    if (size_ != 0)
+    {
+      vals_ = mystl::allocator<uint16_t>::allocate(cap_);
+      std::memcpy(vals_, rhs.vals_, size_ * sizeof(uint16_t));
+    }
+  }
+
+  bitmap_container(bitmap_container&& rhs) noexcept
+    :type_(rhs.type_), card_(rhs.card_), size_(rhs.size_), cap_(rhs.cap_),
+    vals_(rhs.vals_), words_(rhs.words_)
+  {
+    rhs.reset();
+  }
+
+  bitmap_container& operator=(bitmap_container rhs) noexcept
+  {
+    swap(rhs);
+    return *this;
+  }
+
+  ~bitmap_container()
+  {
+    release();
+  }
+
+  void swap(bitmap_container& rhs) noexcept
+  {
+    mystl::swap(type_, rhs.type_);
+    mystl::swap(card_, rhs.card_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(cap_, rhs.cap_);
+    mystl::swap(vals_, rhs.vals_);
+    mystl::swap(words_, rhs.words_);
+  }
+
+public:
+  kind     type()        const noexcept { return type_; }
+  uint32_t cardinality() const noexcept { return card_; }
+
+  // heap memory used by the container
+  size_t bytes() const noexcept
+  {
+    return cap_ * sizeof(uint16_t) + (words_ ? words * sizeof(uint64_t) : 0);
+  }
+
+  bool contains(uint16_t low) const;
+  bool insert(uint16_t low);
+  bool erase(uint16_t low);
+
+  // first value, and the value after low; pos is a cursor kept by the caller
+  bool first(uint32_t& pos, uint32_t& low) const;
+  bool next(uint32_t& pos, uint32_t& low) const;
+
+  // change representation
+  void to_array();
+  void to_bitmap();
+  void to_plain();
+  void run_optimize();
+
+  // op(a, b), the cardinality of a * b, and whether a * b is not empty
+  static bitmap_container combine(const bitmap_container& a,
+                                  const bitmap_container& b, op_kind op);
+  static uint32_t intersection_size(const bitmap_container& a,
+                                    const bitmap_container& b);
+  static bool     intersects(const bitmap_container& a,
+                             const bitmap_container& b);
+
+private:
+  void reset() noexcept
+  {
+    type_ = array_kind;
+    card_ = size_ = cap_ = 0;
+    vals_ = nullptr;
+    words_ = nullptr;
+  }
+  void release() noexcept
+  {
+    mystl::allocator<uint16_t>::deallocate(vals_, cap_);
+    mystl::allocator<uint64_t>::deallocate(words_, words);
+    reset();
+  }
+
+  void     reserve_vals(uint32_t n);
+  uint32_t run_count() const;
+  uint32_t find_run(uint16_t low) const;
+  void     set_bits_of(const bitmap_container& rhs);
+
+  static const bitmap_container& plain(const bitmap_container& c,
+                                       bitmap_container& temp);
+  template <class WordOp>
+  static bitmap_container combine_bitmaps(const bitmap_container& a,
+                                          const bitmap_container& b,
+                                          WordOp op);
+};
+
+// grow vals_ to hold at least n slots
+inline void bitmap_container::reserve_vals(uint32_t n)
+{
+  if (n <= cap_) return;
+  uint32_t new_cap = cap_ == 0 ? 4 : cap_ * 2;
+  if (new_cap < n) new_cap = n;
+  uint16_t* temp = mystl::allocator<uint16_t>::allocate(new_cap);
+  if (size_ != 0) std::memcpy(temp, vals_, size_ * sizeof(uint16_t));
+  mystl::allocator<uint16_t>::deallocate(vals_, cap_);
+  vals_ = temp;
+  cap_ = new_cap;
+}
+
+// index of the last run starting at or before low, or size_ / 2 if none
+inline uint32_t bitmap_container::find_run(uint16_t low) const
+{
+  uint32_t lo = 0, hi = size_ / 2;
+  while (lo < hi)
+  {
+    const auto mid = (lo + hi) / 2;
+    if (vals_[2 * mid] <= low) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo == 0 ? size_ / 2 : lo - 1;
+}
+
+inline bool bitmap_container::contains(uint16_t low) const
+{
+  switch (type_)
+  {
+  case bitmap_kind:
+    return (words_[low >> 6] >> (low & 63)) & 1;
+  case run_kind:
+  {
+    const auto r = find_run(low);
+    return r != size_ / 2 &&
+      static_cast<uint32_t>(low) <= static_cast<uint32_t>(vals_[2 * r]) + vals_[2 * r + 1];
+  }
+  default:
+  {
+    const auto p = mystl::lower_bound(vals_, vals_ + size_, low);
+    return p != vals_ + size_ && *p == low;
+  }
+  }
+}
+
+inline bool bitmap_container::insert(uint16_t low)
+{
+  if (type_ == run_kind) to_plain();
+  if (type_ == bitmap_kind)
+  {
+    uint64_t& w = words_[low >> 6];
+    const uint64_t bit = static_cast<uint64_t>(1) << (low & 63);
+    if (w & bit) return false;
+    w |= bit;
+    ++card_;
+    return true;
+  }
+  const auto p = mystl::lower_bound(vals_, vals_ + size_, low);
+  if (p != vals_ + size_ && *p == low) return false;
+  if (card_ == array_max)
+  {
+    to_bitmap();
+    return insert(low);
+  }
+  const auto idx = static_cast<uint32_t>(p - vals_);
+  reserve_vals(size_ + 1);
+  std::memmove(vals_ + idx + 1, vals_ + idx, (size_ - idx) * sizeof(uint16_t));
+  vals_[idx] = low;
+  ++size_; ++card_;
+  return true;
+}
+
+inline bool bitmap_container::erase(uint16_t low)
+{
+  if (type_ == run_kind) to_plain();
+  if (type_ == bitmap_kind)
+  {
+    uint64_t& w = words_[low >> 6];
+    const uint64_t bit = static_cast<uint64_t>(1) << (low & 63);
+    if (!(w & bit)) return false;
+    w &= ~bit;
+    if (--card_ <= array_max) to_array();
+    return true;
+  }
+  const auto p = mystl::lower_bound(vals_, vals_ + size_, low);
+  if (p == vals_ + size_ || *p != low) return false;
+  const auto idx = static_cast<uint32_t>(p - vals_);
+  std::memmove(vals_ + idx, vals_ + idx + 1, (size_ - idx - 1) * sizeof(uint16_t));
+  --size_; --card_;
+  return true;
+}
+
+inline bool bitmap_container::first(uint32_t& pos, uint32_t& low) const
+{
+  if (card_ == 0) return false;
+  pos = 0;
+  if (type_ != bitmap_kind)
+  {
+    low = vals_[0];
+    return true;
+  }
+  while (words_[pos] == 0) ++pos;
+  low = pos * 64 + mystl::countr_zero64(words_[pos]);
+  return true;
+}
+
+inline bool bitmap_container::next(uint32_t& pos, uint32_t& low) const
+{
+  switch (type_)
+  {
+  case bitmap_kind:
+  {
+    if (low == 0xffff) return false;
+    uint32_t w = (low + 1) >> 6;
+    uint64_t bits = words_[w] & (~static_cast<uint64_t>(0) << ((low + 1) & 63));
+    while (bits == 0)
+    {
+      if (++w == words) return false;
+      bits = words_[w];
+    }
+    low = w * 64 + mystl::countr_zero64(bits);
+    return true;
+  }
+  case run_kind:
+    if (low < static_cast<uint32_t>(vals_[2 * pos]) + vals_[2 * pos + 1])
+    {
+      ++low;
+      return true;
+    }
+    if (2 * ++pos == size_) return false;
+    low = vals_[2 * pos];
+    return true;
+  default:
+    if (++pos == size_) return false;
+    low = vals_[pos];
+    return true;
+  }
+}
+
+inline void bitmap_container::to_bitmap()
+{
+  if (type_ == bitmap_kind) return;
+  uint64_t* w = mystl::allocator<uint64_t>::allocate(words);
+  std::memset(w, 0, words * sizeof(uint64_t));
+  uint32_t pos = 0, low = 0;
+  for (bool more = first(pos, low); more; more = next(pos, low))
+  {
+    w[low >> 6] |= static_cast<uint64_t>(1) << (low & 63);
+  }
+  const auto card = card_;
+  release();
+  type_ = bitmap_kind;
+  card_ = card;
+  words_ = w;
+}
+
+inline void bitmap_container::to_array()
+{
+  if (type_ == array_kind) return;
+  const auto card = card_;
+  uint16_t* v = mystl::allocator<uint16_t>::allocate(card);
+  uint32_t pos = 0, low = 0, n = 0;
+  for (bool more = first(pos, low); more; more = next(pos, low))
+  {
+    v[n++] = static_cast<uint16_t>(low);
+  }
+  release();
+  card_ = size_ = cap_ = card;
+  vals_ = v;
+}
+
+// leave the run representation, which is kept for read-mostly chunks
+inline void bitmap_container::to_plain()
+{
+  if (type_ != run_kind) return;
+  if (card_ <= array_max) to_array();
+  else to_bitmap();
+}
+
+// number of maximal intervals of consecutive values
+inline uint32_t bitmap_container::run_count() const
+{
+  if (type_ == run_kind) return size_ / 2;
+  uint32_t runs = 0;
+  if (type_ == bitmap_kind)
+  {
+    uint64_t carry = 0; // top bit of the previous word
+    for (uint32_t i = 0; i < words; ++i)
+    {
+      const uint64_t w = words_[i];
+      runs += mystl::popcount64(w & ~((w << 1) | carry));
+      carry = w >> 63;
+    }
+    return runs;
+  }
+  for (uint32_t i = 0; i < size_; ++i)
+  {
+    if (i == 0 || vals_[i] != vals_[i - 1] + 1) ++runs;
+  }
+  return runs;
+}
+
+// switch to runs when they take less memory, or back when they do not
+inline void bitmap_container::run_optimize()
+{
+  if (card_ == 0) return;
+  const size_t runs = run_count();
+  const size_t run_bytes = runs * 2 * sizeof(uint16_t);
+  const size_t plain_bytes = card_ <= array_max
+    ? card_ * sizeof(uint16_t) : words * sizeof(uint64_t);
+  if (run_bytes >= plain_bytes)
+  {
+    to_plain();
+    return;
+  }
+  if (type_ == run_kind) return;
+  uint16_t* v = mystl::allocator<uint16_t>::allocate(2 * runs);
+  uint32_t pos = 0, low = 0, n = 0, prev = 0;
+  for (bool more = first(pos, low); more; more = next(pos, low))
+  {
+    if (n != 0 && low == prev + 1)
+    {
+      ++v[n - 1];
+    }
+    else
+    {
+      v[n++] = static_cast<uint16_t>(low);
+      v[n++] = 0;
+    }
+    prev = low;
+  }
+  const auto card = card_;
+  release();
+  type_ = run_kind;
+  card_ = card;
+  size_ = cap_ = n;
+  vals_ = v;
+}
+
+// set the bits of every value of rhs, *this is a bitmap
+inline void bitmap_container::set_bits_of(const bitmap_container& rhs)
+{
+  for (uint32_t i = 0; i < rhs.size_; ++i)
+  {
+    uint64_t& w = words_[rhs.vals_[i] >> 6];
+    const uint64_t bit = static_cast<uint64_t>(1) << (rhs.vals_[i] & 63);
+    card_ += !(w & bit);
+    w |= bit;
+  }
+}
+
+// c itself if it is not a run container, otherwise a plain copy in temp
+inline const bitmap_container&
+bitmap_container::plain(const bitmap_container& c, bitmap_container& temp)
+{
+  if (c.type_ != run_kind) return c;
+  temp = c;
+  temp.to_plain();
+  return temp;
+}
+
+template <class WordOp>
+bitmap_container bitmap_container::combine_bitmaps(const bitmap_container& a,
+                                                   const bitmap_container& b,
+                                                   WordOp op)
+{
+  bitmap_container r;
+  r.type_ = bitmap_kind;
+  r.words_ = mystl::allocator<uint64_t>::allocate(words);
+  r.card_ = mystl::bitmap_word_op(a.words_, b.words_, r.words_, words, op);
+  if (r.card_ <= array_max) r.to_array();
+  return r;
+}
+
+inline bitmap_container
+bitmap_container::combine(const bitmap_container& lhs,
+                          const bitmap_container& rhs, op_kind op)
+{
+  bitmap_container ta, tb;
+  const bitmap_container& a = plain(lhs, ta);
+  const bitmap_container& b = plain(rhs, tb);
+  bitmap_container r;
+
+  if (a.type_ == array_kind && b.type_ == array_kind)
+  {
+    // merge the sorted arrays with the set algorithms
+    r.reserve_vals(a.size_ + b.size_);
+    const uint16_t* a1 = a.vals_;
+    const uint16_t* a2 = a.vals_ + a.size_;
+    const uint16_t* b1 = b.vals_;
+    const uint16_t* b2 = b.vals_ + b.size_;
+    uint16_t* end = r.vals_;
+    switch (op)
+    {
+    case op_or:     end = mystl::set_union(a1, a2, b1, b2, r.vals_); break;
+    case op_and:    end = mystl::set_intersection(a1, a2, b1, b2, r.vals_); break;
+    case op_andnot: end = mystl::set_difference(a1, a2, b1, b2, r.vals_); break;
+    case op_xor:    end = mystl::set_symmetric_difference(a1, a2, b1, b2, r.vals_); break;
+    }
+    r.card_ = r.size_ = static_cast<uint32_t>(end - r.vals_);
+    if (r.card_ > array_max) r.to_bitmap();
+    return r;
+  }
+
+  if (a.type_ == bitmap_kind && b.type_ == bitmap_kind)
+  {
+    switch (op)
+    {
+    case op_or:     return combine_bitmaps(a, b, mystl::bitmap_or());
+    case op_and:    return combine_bitmaps(a, b, mystl::bitmap_and());
+    case op_andnot: return combine_bitmaps(a, b, mystl::bitmap_andnot());
+    case op_xor:    return combine_bitmaps(a, b, mystl::bitmap_xor());
+    }
+  }
+
+  // one array and one bitmap
+  const bitmap_container& arr = a.type_ == array_kind ? a : b;
+  const bitmap_container& bmp = a.type_ == array_kind ? b : a;
+  if (op == op_and || (op == op_andnot && a.type_ == array_kind))
+  {
+    // keep the array values found (and) or not found (andnot) in the bitmap
+    const bool keep = op == op_and;
+    r.reserve_vals(arr.size_);
+    for (uint32_t i = 0; i < arr.size_; ++i)
+    {
+      if (bmp.contains(arr.vals_[i]) == keep) r.vals_[r.size_++] = arr.vals_[i];
+    }
+    r.card_ = r.size_;
+    return r;
+  }
+  r = bmp;
+  switch (op)
+  {
+  case op_or:
+    r.set_bits_of(arr);
+    break;
+  case op_andnot: // bitmap - array
+    for (uint32_t i = 0; i < arr.size_; ++i) r.erase(arr.vals_[i]);
+    break;
+  default:        // xor
+    for (uint32_t i = 0; i < arr.size_; ++i)
+    {
+      const uint16_t v = arr.vals_[i];
+      uint64_t& w = r.words_[v >> 6];
+      const uint64_t bit = static_cast<uint64_t>(1) << (v & 63);
+      r.card_ = (w & bit) ? r.card_ - 1 : r.card_ + 1;
+      w ^= bit;
+    }
+    if (r.card_ <= array_max) r.to_array();
+    break;
+  }
+  return r;
+}
+
+inline uint32_t
+bitmap_container::intersection_size(const bitmap_container& lhs,
+                                    const bitmap_container& rhs)
+{
+  bitmap_container ta, tb;
+  const bitmap_container& a = plain(lhs, ta);
+  const bitmap_container& b = plain(rhs, tb);
+  if (a.type_ == array_kind && b.type_ == array_kind)
+  {
+    return static_cast<uint32_t>(mystl::set_intersection_size(
+      a.vals_, a.vals_ + a.size_, b.vals_, b.vals_ + b.size_));
+  }
+  if (a.type_ == bitmap_kind && b.type_ == bitmap_kind)
+  {
+    return mystl::bitmap_word_op_count(a.words_, b.words_, words,
+                                       mystl::bitmap_and());
+  }
+  const bitmap_container& arr = a.type_ == array_kind ? a : b;
+  const bitmap_container& bmp = a.type_ == array_kind ? b : a;
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < arr.size_; ++i) n += bmp.contains(arr.vals_[i]);
+  return n;
+}
+
+// same cases as intersection_size, returning at the first common value
+inline bool bitmap_container::intersects(const bitmap_container& lhs,
+                                         const bitmap_container& rhs)
+{
+  if (lhs.card_ == 0 || rhs.card_ == 0) return false;
+  bitmap_container ta, tb;
+  const bitmap_container& a = plain(lhs, ta);
+  const bitmap_container& b = plain(rhs, tb);
+  if (a.type_ == array_kind && b.type_ == array_kind)
+  {
+    return mystl::set_intersects(a.vals_, a.vals_ + a.size_,
+                                 b.vals_, b.vals_ + b.size_);
+  }
+  if (a.type_ == bitmap_kind && b.type_ == bitmap_kind)
+  {
+    for (uint32_t i = 0; i < words; ++i)
+    {
+      if ((a.words_[i] & b.words_[i]) != 0) return true;
+    }
+    return false;
+  }
+  const bitmap_container& arr = a.type_ == array_kind ? a : b;
+  const bitmap_container& bmp = a.type_ == array_kind ? b : a;
+  for (uint32_t i = 0; i < arr.size_; ++i)
+  {
+    if (bmp.contains(arr.vals_[i])) return true;
+  }
+  return false;
+}
+
+/********************************************************************************/
+
+class bitmap_set;
+
+// class: bitmap_set_iterator
+// visit the values of a bitmap_set in increasing order
+class bitmap_set_iterator
+{
+public:
+  typedef forward_iterator_tag iterator_category;
+  typedef uint32_t             value_type;
+  typedef ptrdiff_t            difference_type;
+  typedef const uint32_t*      pointer;
+  typedef const uint32_t&      reference;
+
+private:
+  const bitmap_set* set_;
+  size_t            chunk_;
+  uint32_t          pos_;
+  uint32_t          low_;
+  uint32_t          value_;
+
+  friend class bitmap_set;
+
+public:
+  bitmap_set_iterator()
+    :set_(nullptr), chunk_(0), pos_(0), low_(0), value_(0) {}
+
+  bitmap_set_iterator(const bitmap_set* s, size_t chunk)
+    :set_(s), chunk_(chunk), pos_(0), low_(0), value_(0)
+  {
+    load();
+  }
+
+  reference operator*()  const { return value_; }
+  pointer   operator->() const { return &value_; }
+
+  bitmap_set_iterator& operator++();
+  bitmap_set_iterator operator++(int)
+  {
+    auto temp = *this;
+    ++*this;
+    return temp;
+  }
+
+  bool operator==(const bitmap_set_iterator& rhs) const
+  {
+    return chunk_ == rhs.chunk_ && low_ == rhs.low_;
+  }
+  bool operator!=(const bitmap_set_iterator& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+private:
+  void load();
+};
+
+/********************************************************************************/
+
+// class: bitmap_set
+// sorted set of uint32_t, with set algebra and cardinality on whole chunks
+class bitmap_set
+{
+public:
+  typedef uint32_t            value_type;
+  typedef uint32_t            key_type;
+  typedef size_t              size_type;
+  typedef bitmap_set_iterator iterator;
+  typedef bitmap_set_iterator const_iterator;
+
+  friend class bitmap_set_iterator;
+
+private:
+  uint16_t*         keys_;  // high 16 bits of every chunk, increasing
+  bitmap_container* conts_; // containers of the chunks
+  size_type         size_;  // number of chunks
+  size_type         cap_;
+
+public:
+  // construct, copy, move and destroy
+  bitmap_set() noexcept
+    :keys_(nullptr), conts_(nullptr), size_(0), cap_(0) {}
+
+  template <class IIter>
+  bitmap_set(IIter first, IIter last)
+    :keys_(nullptr), conts_(nullptr), size_(0), cap_(0)
+  {
+    for (; first != last; ++first) insert(static_cast<uint32_t>(*first));
+  }
+
+  bitmap_set(const bitmap_set& rhs)
+    :keys_(nullptr), conts_(nullptr), size_(0), cap_(0)
+  {
+    reserve_chunks(rhs.size_);
+    for (size_type i = 0; i < rhs.size_; ++i)
+    {
+      push_chunk(rhs.keys_[i], rhs.conts_[i]);
+    }
+  }
+
+  bitmap_set(bitmap_set&& rhs) noexcept
+    :keys_(rhs.keys_), conts_(rhs.conts_), size_(rhs.size_), cap_(rhs.cap_)
+  {
+    rhs.keys_ = nullptr;
+    rhs.conts_ = nullptr;
+    rhs.size_ = rhs.cap_ = 0;
+  }
+
+  bitmap_set& operator=(bitmap_set rhs) noexcept
+  {
+    swap(rhs);
+    return *this;
+  }
+
+  ~bitmap_set()
+  {
+    clear();
+    mystl::allocator<uint16_t>::deallocate(keys_, cap_);
+    mystl::allocator<bitmap_container>::deallocate(conts_, cap_);
+  }
+
+  void swap(bitmap_set& rhs) noexcept
+  {
+    mystl::swap(keys_, rhs.keys_);
+    mystl::swap(conts_, rhs.conts_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(cap_, rhs.cap_);
+  }
+
+public:
+  // iterator
+  const_iterator begin()  const { return const_iterator(this, 0); }
+  const_iterator end()    const { return const_iterator(this, size_); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend()   const { return end(); }
+
+  // capacity
+  bool empty() const noexcept { return size_ == 0; }
+
+  // number of values, summed from the container cardinalities
+  size_type size() const noexcept
+  {
+    size_type n = 0;
+    for (size_type i = 0; i < size_; ++i) n += conts_[i].cardinality();
+    return n;
+  }
+
+  // heap memory used by the set
+  size_type bytes() const noexcept
+  {
+    size_type n = cap_ * (sizeof(uint16_t) + sizeof(bitmap_container));
+    for (size_type i = 0; i < size_; ++i) n += conts_[i].bytes();
+    return n;
+  }
+
+  // lookup
+  bool contains(uint32_t x) const
+  {
+    const auto i = find_chunk(high(x));
+    return i != size_ && keys_[i] == high(x) && conts_[i].contains(low(x));
+  }
+  size_type count(uint32_t x) const { return contains(x) ? 1 : 0; }
+
+  // modify, return whether the set changed
+  bool insert(uint32_t x);
+  bool erase(uint32_t x);
+
+  void clear() noexcept
+  {
+    mystl::destroy(conts_, conts_ + size_);
+    size_ = 0;
+  }
+
+  // store chunks as runs where that is smaller
+  void run_optimize()
+  {
+    for (size_type i = 0; i < size_; ++i) conts_[i].run_optimize();
+  }
+
+  // set algebra on whole containers
+  bitmap_set& operator|=(const bitmap_set& rhs)
+  {
+    combine(*this, rhs, bitmap_container::op_or).swap(*this);
+    return *this;
+  }
+  bitmap_set& operator&=(const bitmap_set& rhs)
+  {
+    combine(*this, rhs, bitmap_container::op_and).swap(*this);
+    return *this;
+  }
+  bitmap_set& operator-=(const bitmap_set& rhs)
+  {
+    combine(*this, rhs, bitmap_container::op_andnot).swap(*this);
+    return *this;
+  }
+  bitmap_set& operator^=(const bitmap_set& rhs)
+  {
+    combine(*this, rhs, bitmap_container::op_xor).swap(*this);
+    return *this;
+  }
+
+  static bitmap_set combine(const bitmap_set& a, const bitmap_set& b,
+                            bitmap_container::op_kind op);
+  static size_type  intersection_size(const bitmap_set& a,
+                                      const bitmap_set& b);
+  static bool       intersects(const bitmap_set& a, const bitmap_set& b);
+
+private:
+  static uint16_t high(uint32_t x) { return static_cast<uint16_t>(x >> 16); }
+  static uint16_t low(uint32_t x)  { return static_cast<uint16_t>(x & 0xffff); }
+
+  // first chunk with key not less than key
+  size_type find_chunk(uint16_t key) const
+  {
+    // values usually arrive in increasing order, try the last chunk first
+    if (size_ != 0 && keys_[size_ - 1] <= key)
+    {
+      return keys_[size_ - 1] == key ? size_ - 1 : size_;
+    }
+    return static_cast<size_type>(
+      mystl::lower_bound(keys_, keys_ + size_, key) - keys_);
+  }
+
+  void reserve_chunks(size_type n);
+  void insert_chunk(size_type idx, uint16_t key);
+  void erase_chunk(size_type idx);
+
+  void push_chunk(uint16_t key, const bitmap_container& c)
+  {
+    reserve_chunks(size_ + 1);
+    keys_[size_] = key;
+    mystl::construct(conts_ + size_, c);
+    ++size_;
+  }
+  void push_chunk(uint16_t key, bitmap_container&& c)
+  {
+    reserve_chunks(size_ + 1);
+    keys_[size_] = key;
+    mystl::construct(conts_ + size_, mystl::move(c));
+    ++size_;
+  }
+};
+
+inline void bitmap_set::reserve_chunks(size_type n)
+{
+  if (n <= cap_) return;
+  size_type new_cap = cap_ == 0 ? 4 : cap_ * 2;
+  if (new_cap < n) new_cap = n;
+  uint16_t* keys = mystl::allocator<uint16_t>::allocate(new_cap);
+  bitmap_container* conts = mystl::allocator<bitmap_container>::allocate(new_cap);
+  for (size_type i = 0; i < size_; ++i)
+  {
+    keys[i] = keys_[i];
+    mystl::construct(conts + i, mystl::move(conts_[i]));
+  }
+  mystl::destroy(conts_, conts_ + size_);
+  mystl::allocator<uint16_t>::deallocate(keys_, cap_);
+  mystl::allocator<bitmap_container>::deallocate(conts_, cap_);
+  keys_ = keys;
+  conts_ = conts;
+  cap_ = new_cap;
+}
+
+// insert an empty container for key at idx
+inline void bitmap_set::insert_chunk(size_type idx, uint16_t key)
+{
+  reserve_chunks(size_ + 1);
+  mystl::construct(conts_ + size_);
+  for (size_type i = size_; i > idx; --i)
+  {
+    keys_[i] = keys_[i - 1];
+    conts_[i].swap(conts_[i - 1]);
+  }
+  keys_[idx] = key;
+  ++size_;
+}
+
+inline void bitmap_set::erase_chunk(size_type idx)
+{
+  for (size_type i = idx; i + 1 < size_; ++i)
+  {
+    keys_[i] = keys_[i + 1];
+    conts_[i].swap(conts_[i + 1]);
+  }
+  mystl::destroy(conts_ + --size_);
+}
+
+inline bool bitmap_set::insert(uint32_t x)
+{
+  const auto i = find_chunk(high(x));
+  if (i == size_ || keys_[i] != high(x)) insert_chunk(i, high(x));
+  return conts_[i].insert(low(x));
+}
+
+inline bool bitmap_set::erase(uint32_t x)
+{
+  const auto i = find_chunk(high(x));
+  if (i == size_ || keys_[i] != high(x)) return false;
+  if (!conts_[i].erase(low(x))) return false;
+  if (conts_[i].cardinality() == 0) erase_chunk(i);
+  return true;
+}
+
+// merge the chunks of a and b by key and combine the containers of equal keys
+inline bitmap_set bitmap_set::combine(const bitmap_set& a, const bitmap_set& b,
+                                      bitmap_container::op_kind op)
+{
+  const bool keep_a = op != bitmap_container::op_and;
+  const bool keep_b = op == bitmap_container::op_or ||
+                      op == bitmap_container::op_xor;
+  bitmap_set r;
+  size_type i = 0, j = 0;
+  while (i < a.size_ && j < b.size_)
+  {
+    if (a.keys_[i] < b.keys_[j])
+    {
+      if (keep_a) r.push_chunk(a.keys_[i], a.conts_[i]);
+      ++i;
+    }
+    else if (b.keys_[j] < a.keys_[i])
+    {
+      if (keep_b) r.push_chunk(b.keys_[j], b.conts_[j]);
+      ++j;
+    }
+    else
+    {
+      auto c = bitmap_container::combine(a.conts_[i], b.conts_[j], op);
+      if (c.cardinality() != 0) r.push_chunk(a.keys_[i], mystl::move(c));
+      ++i; ++j;
+    }
+  }
+  for (; keep_a && i < a.size_; ++i) r.push_chunk(a.keys_[i], a.conts_[i]);
+  for (; keep_b && j < b.size_; ++j) r.push_chunk(b.keys_[j], b.conts_[j]);
+  return r;
+}
+
+inline bitmap_set::size_type
+bitmap_set::intersection_size(const bitmap_set& a, const bitmap_set& b)
+{
+  size_type n = 0, i = 0, j = 0;
+  while (i < a.size_ && j < b.size_)
+  {
+    if (a.keys_[i] < b.keys_[j])
+    {
+      ++i;
+    }
+    else if (b.keys_[j] < a.keys_[i])
+    {
+      ++j;
+    }
+    else
+    {
+      n += bitmap_container::intersection_size(a.conts_[i], b.conts_[j]);
+      ++i; ++j;
+    }
+  }
+  return n;
+}
+
+inline bool bitmap_set::intersects(const bitmap_set& a, const bitmap_set& b)
+{
+  size_type i = 0, j = 0;
+  while (i < a.size_ && j < b.size_)
+  {
+    if (a.keys_[i] < b.keys_[j])
+    {
+      ++i;
+    }
+    else if (b.keys_[j] < a.keys_[i])
+    {
+      ++j;
+    }
+    else
+    {
+      if (bitmap_container::intersects(a.conts_[i], b.conts_[j])) return true;
+      ++i; ++j;
+    }
+  }
+  return false;
+}
+
+/********************************************************************************/
+// bitmap_set_iterator
+
+inline void bitmap_set_iterator::load()
+{
+  for (; chunk_ < set_->size_; ++chunk_)
+  {
+    if (set_->conts_[chunk_].first(pos_, low_))
+    {
+      value_ = (static_cast<uint32_t>(set_->keys_[chunk_]) << 16) | low_;
+      return;
+    }
+  }
+  pos_ = low_ = 0;
+}
+
+inline bitmap_set_iterator& bitmap_set_iterator::operator++()
+{
+  if (set_->conts_[chunk_].next(pos_, low_))
+  {
+    value_ = (static_cast<uint32_t>(set_->keys_[chunk_]) << 16) | low_;
+  }
+  else
+  {
+    ++chunk_;
+    load();
+  }
+  return *this;
+}
+
+/********************************************************************************/
+// set algebra and cardinality of bitmap_set, mirroring algo_set.h
+/********************************************************************************/
+
+// S1+S2
+inline bitmap_set set_union(const bitmap_set& lhs, const bitmap_set& rhs)
+{
+  return bitmap_set::combine(lhs, rhs, bitmap_container::op_or);
+}
+
+// S1*S2
+inline bitmap_set set_intersection(const bitmap_set& lhs, const bitmap_set& rhs)
+{
+  return bitmap_set::combine(lhs, rhs, bitmap_container::op_and);
+}
+
+// S1-S2
+inline bitmap_set set_difference(const bitmap_set& lhs, const bitmap_set& rhs)
+{
+  return bitmap_set::combine(lhs, rhs, bitmap_container::op_andnot);
+}
+
+// (S1-S2)+(S2-S1)
+inline bitmap_set set_symmetric_difference(const bitmap_set& lhs,
+                                           const bitmap_set& rhs)
+{
+  return bitmap_set::combine(lhs, rhs, bitmap_container::op_xor);
+}
+
+inline bitmap_set operator|(const bitmap_set& lhs, const bitmap_set& rhs)
+{
+  return mystl::set_union(lhs, rhs);
+}
+inline bitmap_set operator&(const bitmap_set& lhs, const bitmap_set& rhs)
+{
+  return mystl::set_intersection(lhs, rhs);
+}
+inline bitmap_set operator-(const bitmap_set& lhs, const bitmap_set& rhs)
+{
+  return mystl::set_difference(lhs, rhs);
+}
+inline bitmap_set operator^(const bitmap_set& lhs, const bitmap_set& rhs)
+{
+  return mystl::set_symmetric_difference(lhs, rhs);
+}
+
+// |S1*S2|, |S1+S2|, |S1-S2|, |(S1-S2)+(S2-S1)|
+inline size_t set_intersection_size(const bitmap_set& lhs, const bitmap_set& rhs)
+{
+  return bitmap_set::intersection_size(lhs, rhs);
+}
+
+inline size_t set_union_size(const bitmap_set& lhs, const bitmap_set& rhs)
+{
+  return lhs.size() + rhs.size() - bitmap_set::intersection_size(lhs, rhs);
+}
+
+inline size_t set_difference_size(const bitmap_set& lhs, const bitmap_set& rhs)
+{
+  return lhs.size() - bitmap_set::intersection_size(lhs, rhs);
+}
+
+inline size_t set_symmetric_difference_size(const bitmap_set& lhs,
+                                            const bitmap_set& rhs)
+{
+  return lhs.size() + rhs.size() - 2 * bitmap_set::intersection_size(lhs, rhs);
+}
+
+inline bool set_intersects(const bitmap_set& lhs, const bitmap_set& rhs)
+{
+  return bitmap_set::intersects(lhs, rhs);
+}
+
+inline bool operator==(const bitmap_set& lhs, const bitmap_set& rhs)
+{
+  return lhs.size() == rhs.size() &&
+    bitmap_set::intersection_size(lhs, rhs) == lhs.size();
+}
+
+inline bool operator!=(const bitmap_set& lhs, const bitmap_set& rhs)
+{
+  return !(lhs == rhs);
+}
+
+inline void swap(bitmap_set& lhs, bitmap_set& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_BITMAP_SET_H_
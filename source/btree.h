@@ -0,0 +1,1300 @@
+#ifndef _LITESTL_BTREE_H_
+#define _LITESTL_BTREE_H_
+
+// B+ tree, the base of btree_map and btree_set
+// every element sits in a leaf, leaves hold their keys in one array and the
+// mapped values in another, and are chained in key order, so a scan reads
+// whole arrays; inner nodes only route the search
+// node sizes are set in bytes: a few cache lines by default, a page for
+// trees much larger than the cache
+// erase keeps every node but the root at least half full by borrowing from
+// or merging with a neighbor, so heavy erasing does not leave a sparse tree;
+// inserts in ascending order may leave the last nodes of a level sparser,
+// until they fill up or are erased from
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+#include "iterator.h"
+#include "algobase.h"   // mystl::branchless_lower_bound
+#include "algo_sort.h"  // mystl::stable_sort
+#include "allocator.h"
+#include "construct.h"
+#include "functional.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl
+{
+
+/*****************************************************************************************/
+// in-node search
+// a node is searched by a branchless binary search down to at most 16 keys,
+// then arithmetic keys ordered by mystl::less count the keys that are less
+// than the target with SSE2
+/*****************************************************************************************/
+
+// number of keys in [keys, keys + n) that are less than key
+template <class Key, class Compare>
+size_t btree_count_less(const Key* keys, size_t n, const Key& key, Compare comp)
+{
+  size_t count = 0;
+  for (size_t i = 0; i < n; ++i) count += comp(keys[i], key) ? 1 : 0;
+  return count;
+}
+
+#if defined(__SSE2__)
+// sum of the 32-bit lanes of v
+inline size_t btree_sum_epi32(__m128i v)
+{
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return static_cast<size_t>(_mm_cvtsi128_si32(v));
+}
+
+// sum of the 64-bit lanes of v
+inline size_t btree_sum_epi64(__m128i v)
+{
+  v = _mm_add_epi64(v, _mm_unpackhi_epi64(v, v));
+  int64_t sum;
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(&sum), v);
+  return static_cast<size_t>(sum);
+}
+
+// a lane of a compare result is all ones, so subtracting it counts one
+inline size_t btree_count_less(const int* keys, size_t n, const int& key, mystl::less<int>)
+{
+  const __m128i k = _mm_set1_epi32(key);
+  __m128i count = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+    count = _mm_sub_epi32(count, _mm_cmplt_epi32(v, k));
+  }
+  size_t result = btree_sum_epi32(count);
+  for (; i < n; ++i) result += keys[i] < key ? 1 : 0;
+  return result;
+}
+
+// unsigned order is the signed order of the values with the top bit flipped
+inline size_t btree_count_less(const unsigned* keys, size_t n, const unsigned& key,
+                               mystl::less<unsigned>)
+{
+  const __m128i flip = _mm_set1_epi32(static_cast<int>(0x80000000u));
+  const __m128i k = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(key)), flip);
+  __m128i count = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+    count = _mm_sub_epi32(count, _mm_cmplt_epi32(_mm_xor_si128(v, flip), k));
+  }
+  size_t result = btree_sum_epi32(count);
+  for (; i < n; ++i) result += keys[i] < key ? 1 : 0;
+  return result;
+}
+
+inline size_t btree_count_less(const float* keys, size_t n, const float& key,
+                               mystl::less<float>)
+{
+  const __m128 k = _mm_set1_ps(key);
+  __m128i count = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m128 v = _mm_loadu_ps(keys + i);
+    count = _mm_sub_epi32(count, _mm_castps_si128(_mm_cmplt_ps(v, k)));
+  }
+  size_t result = btree_sum_epi32(count);
+  for (; i < n; ++i) result += keys[i] < key ? 1 : 0;
+  return result;
+}
+
+inline size_t btree_count_less(const double* keys, size_t n, const double& key,
+                               mystl::less<double>)
+{
+  const __m128d k = _mm_set1_pd(key);
+  __m128i count = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+  {
+    const __m128d v = _mm_loadu_pd(keys + i);
+    count = _mm_sub_epi64(count, _mm_castpd_si128(_mm_cmplt_pd(v, k)));
+  }
+  size_t result = btree_sum_epi64(count);
+  for (; i < n; ++i) result += keys[i] < key ? 1 : 0;
+  return result;
+}
+
+#if defined(__SSE4_2__)
+// 64-bit integer compare needs SSE4.2
+inline size_t btree_count_less(const int64_t* keys, size_t n, const int64_t& key,
+                               mystl::less<int64_t>)
+{
+  const __m128i k = _mm_set1_epi64x(key);
+  __m128i count = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+    count = _mm_sub_epi64(count, _mm_cmpgt_epi64(k, v));
+  }
+  size_t result = btree_sum_epi64(count);
+  for (; i < n; ++i) result += keys[i] < key ? 1 : 0;
+  return result;
+}
+
+inline size_t btree_count_less(const uint64_t* keys, size_t n, const uint64_t& key,
+                               mystl::less<uint64_t>)
+{
+  const __m128i flip = _mm_set1_epi64x(static_cast<int64_t>(0x8000000000000000ULL));
+  const __m128i k = _mm_xor_si128(_mm_set1_epi64x(static_cast<int64_t>(key)), flip);
+  __m128i count = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+    count = _mm_sub_epi64(count, _mm_cmpgt_epi64(k, _mm_xor_si128(v, flip)));
+  }
+  size_t result = btree_sum_epi64(count);
+  for (; i < n; ++i) result += keys[i] < key ? 1 : 0;
+  return result;
+}
+#endif // __SSE4_2__
+#endif // __SSE2__
+
+// whether btree_count_less has a SIMD kernel for Key and Compare
+template <class Key, class Compare>
+struct btree_simd_key :public std::false_type {};
+
+#if defined(__SSE2__)
+template <> struct btree_simd_key<int, mystl::less<int>>           :public std::true_type {};
+template <> struct btree_simd_key<unsigned, mystl::less<unsigned>> :public std::true_type {};
+template <> struct btree_simd_key<float, mystl::less<float>>       :public std::true_type {};
+template <> struct btree_simd_key<double, mystl::less<double>>     :public std::true_type {};
+#if defined(__SSE4_2__)
+template <> struct btree_simd_key<int64_t, mystl::less<int64_t>>   :public std::true_type {};
+template <> struct btree_simd_key<uint64_t, mystl::less<uint64_t>> :public std::true_type {};
+#endif
+#endif
+
+// index of the first key in [keys, keys + n) not less than key
+template <class Key, class Compare>
+size_t btree_lower_index(const Key* keys, size_t n, const Key& key, Compare comp,
+                         std::false_type)
+{
+  return static_cast<size_t>(mystl::branchless_lower_bound(keys, keys + n, key, comp) - keys);
+}
+
+template <class Key, class Compare>
+size_t btree_lower_index(const Key* keys, size_t n, const Key& key, Compare comp,
+                         std::true_type)
+{
+  // the answer stays in [base, base + n]
+  size_t base = 0;
+  while (n > 16)
+  {
+    const size_t half = n / 2;
+    base = comp(keys[base + half], key) ? base + half : base;
+    n -= half;
+  }
+  return base + mystl::btree_count_less(keys + base, n, key, comp);
+}
+
+/*****************************************************************************************/
+// nodes
+/*****************************************************************************************/
+
+struct btree_node_base
+{
+  uint16_t count;  // keys in the node
+  bool     leaf;
+};
+
+// raw room for n objects of T
+template <class T, size_t N>
+struct btree_slots_of
+{
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type buf[N];
+
+  T*       data()       noexcept { return reinterpret_cast<T*>(buf); }
+  const T* data() const noexcept { return reinterpret_cast<const T*>(buf); }
+};
+
+// mapped values of a leaf, nothing for a set
+template <class Mapped, size_t N>
+struct btree_leaf_values
+{
+  btree_slots_of<Mapped, N> vals;
+
+  Mapped*       values()       noexcept { return vals.data(); }
+  const Mapped* values() const noexcept { return vals.data(); }
+};
+
+template <size_t N>
+struct btree_leaf_values<void, N> {};
+
+template <class Key, class Mapped, size_t N>
+struct btree_leaf :public btree_node_base, public btree_leaf_values<Mapped, N>
+{
+  btree_leaf*            prev;
+  btree_leaf*            next;
+  btree_slots_of<Key, N> key_slots;
+
+  Key*       keys()       noexcept { return key_slots.data(); }
+  const Key* keys() const noexcept { return key_slots.data(); }
+};
+
+// keys[i] is not less than any key under children[i] and less than every key
+// under children[i + 1]
+template <class Key, size_t N>
+struct btree_inner :public btree_node_base
+{
+  btree_slots_of<Key, N> key_slots;
+  btree_node_base*       children[N + 1];
+
+  Key*       keys()       noexcept { return key_slots.data(); }
+  const Key* keys() const noexcept { return key_slots.data(); }
+};
+
+template <class Mapped>
+struct btree_mapped_size :public std::integral_constant<size_t, sizeof(Mapped)> {};
+
+template <>
+struct btree_mapped_size<void> :public std::integral_constant<size_t, 0> {};
+
+// slots that fit a node of Bytes bytes, between 4 and the limit of count
+template <size_t Bytes, size_t Header, size_t Slot>
+struct btree_node_slots
+{
+  static const size_t fit = Bytes > Header ? (Bytes - Header) / Slot : 0;
+  static const size_t value = fit < 4 ? 4 : fit > 65535 ? 65535 : fit;
+};
+
+/*****************************************************************************************/
+// iterator
+/*****************************************************************************************/
+
+// reference of a map element: a pair of references into the two arrays
+template <class Key, class Mapped, bool Const>
+struct btree_element
+{
+  typedef typename std::conditional<Const, const Mapped, Mapped>::type mapped_type;
+  typedef mystl::pair<Key, Mapped>                  value_type;
+  typedef mystl::pair<const Key&, mapped_type&>     reference;
+
+  struct pointer
+  {
+    reference ref;
+    const reference* operator->() const { return &ref; }
+  };
+
+  template <class Leaf>
+  static reference get(Leaf* leaf, size_t i)
+  {
+    return reference(leaf->keys()[i], leaf->values()[i]);
+  }
+};
+
+// reference of a set element: the key, never modifiable
+template <class Key, bool Const>
+struct btree_element<Key, void, Const>
+{
+  typedef Key        value_type;
+  typedef const Key& reference;
+  typedef const Key* pointer;
+
+  template <class Leaf>
+  static reference get(Leaf* leaf, size_t i)
+  {
+    return leaf->keys()[i];
+  }
+};
+
+// the end iterator points past the last element of the last leaf
+template <class Leaf, class Key, class Mapped, bool Const>
+struct btree_iterator
+{
+  typedef btree_element<Key, Mapped, Const>   element;
+  typedef bidirectional_iterator_tag          iterator_category;
+  typedef typename element::value_type        value_type;
+  typedef ptrdiff_t                           difference_type;
+  typedef typename element::reference         reference;
+  typedef typename element::pointer           pointer;
+
+  Leaf*  leaf;
+  size_t index;
+
+  btree_iterator() noexcept :leaf(nullptr), index(0) {}
+  btree_iterator(Leaf* l, size_t i) noexcept :leaf(l), index(i) {}
+
+  // iterator to const_iterator
+  template <bool C, typename std::enable_if<Const && !C, int>::type = 0>
+  btree_iterator(const btree_iterator<Leaf, Key, Mapped, C>& rhs) noexcept
+    :leaf(rhs.leaf), index(rhs.index) {}
+
+  reference operator*()  const { return element::get(leaf, index); }
+  pointer   operator->() const { return arrow(std::is_void<Mapped>()); }
+
+  // empty leaves are freed, except an empty root
+  btree_iterator& operator++()
+  {
+    if (++index == leaf->count && leaf->next != nullptr)
+    {
+      leaf = leaf->next;
+      index = 0;
+    }
+    return *this;
+  }
+  btree_iterator& operator--()
+  {
+    if (index == 0)
+    {
+      leaf = leaf->prev;
+      index = leaf->count;
+    }
+    --index;
+    return *this;
+  }
+  btree_iterator operator++(int) { btree_iterator tmp = *this; ++*this; return tmp; }
+  btree_iterator operator--(int) { btree_iterator tmp = *this; --*this; return tmp; }
+
+  bool operator==(const btree_iterator& rhs) const
+  {
+    return leaf == rhs.leaf && index == rhs.index;
+  }
+  bool operator!=(const btree_iterator& rhs) const { return !(*this == rhs); }
+
+private:
+  pointer arrow(std::true_type)  const { return &**this; }
+  pointer arrow(std::false_type) const { return pointer{ **this }; }
+};
+
+/*****************************************************************************************/
+// template class: btree
+// Key: key type, Mapped: mapped type or void for a set
+// NodeAlloc: a class template with the interface of mystl::allocator, nodes
+//            are allocated one at a time from NodeAlloc<node type>
+// NodeBytes: target size of a node
+// moving or copying a Key or a Mapped must not throw
+/*****************************************************************************************/
+template <class Key, class Mapped, class Compare,
+          template <class> class NodeAlloc, size_t NodeBytes>
+class btree
+{
+public:
+  typedef Key                                     key_type;
+  typedef Mapped                                  mapped_type;
+  typedef Compare                                 key_compare;
+  typedef size_t                                  size_type;
+  typedef ptrdiff_t                               difference_type;
+
+  static const size_type leaf_slots = btree_node_slots<NodeBytes,
+    sizeof(btree_node_base) + 2 * sizeof(void*),
+    sizeof(Key) + btree_mapped_size<Mapped>::value>::value;
+  static const size_type inner_slots = btree_node_slots<NodeBytes,
+    sizeof(btree_node_base) + sizeof(void*),
+    sizeof(Key) + sizeof(void*)>::value;
+
+  // a node below these counts borrows from or merges with a neighbor on erase
+  static const size_type min_leaf = leaf_slots / 2;
+  static const size_type min_inner = inner_slots / 2;
+
+  typedef btree_node_base                         node;
+  typedef btree_leaf<Key, Mapped, leaf_slots>     leaf_node;
+  typedef btree_inner<Key, inner_slots>           inner_node;
+  typedef NodeAlloc<leaf_node>                    leaf_allocator;
+  typedef NodeAlloc<inner_node>                   inner_allocator;
+
+  typedef btree_iterator<leaf_node, Key, Mapped, false> iterator;
+  typedef btree_iterator<leaf_node, Key, Mapped, true>  const_iterator;
+  typedef typename iterator::value_type           value_type;
+
+private:
+  typedef std::is_void<Mapped> is_set;
+  typedef typename btree_simd_key<Key, Compare>::type simd_search;
+
+  // a path from the root: the inner nodes and the child taken in each
+  static const size_type max_height = 64;
+  struct path_type
+  {
+    inner_node* nodes[max_height];
+    size_type   index[max_height];
+    size_type   depth;
+  };
+
+  node*       root_;
+  leaf_node*  leftmost_;
+  leaf_node*  rightmost_;
+  size_type   size_;
+  key_compare comp_;
+
+public:
+  // construct, copy, move and destroy
+  explicit btree(const key_compare& comp = key_compare())
+    :root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), size_(0), comp_(comp) {}
+
+  btree(const btree& rhs)
+    :root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), size_(0), comp_(rhs.comp_)
+  {
+    bulk_load(rhs.begin(), rhs.size());
+  }
+
+  btree(btree&& rhs) noexcept
+    :root_(rhs.root_), leftmost_(rhs.leftmost_), rightmost_(rhs.rightmost_),
+    size_(rhs.size_), comp_(mystl::move(rhs.comp_))
+  {
+    rhs.root_ = nullptr;
+    rhs.leftmost_ = nullptr;
+    rhs.rightmost_ = nullptr;
+    rhs.size_ = 0;
+  }
+
+  btree& operator=(const btree& rhs)
+  {
+    if (this != &rhs)
+    {
+      btree tmp(rhs);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  btree& operator=(btree&& rhs) noexcept
+  {
+    btree tmp(mystl::move(rhs));
+    swap(tmp);
+    return *this;
+  }
+
+  ~btree() { clear(); }
+
+public:
+  // iterators
+  iterator       begin()       noexcept { return iterator(leftmost_, 0); }
+  const_iterator begin() const noexcept { return const_iterator(leftmost_, 0); }
+  iterator       end()         noexcept { return iterator(rightmost_, last_count()); }
+  const_iterator end()   const noexcept { return const_iterator(rightmost_, last_count()); }
+
+  // capacity
+  bool      empty()    const noexcept { return size_ == 0; }
+  size_type size()     const noexcept { return size_; }
+  size_type max_size() const noexcept { return static_cast<size_type>(-1) / 2; }
+
+  // lookup
+  iterator       lower_bound(const key_type& key)       { return lower_bound_aux(key); }
+  const_iterator lower_bound(const key_type& key) const { return lower_bound_aux(key); }
+
+  iterator upper_bound(const key_type& key)
+  {
+    auto it = lower_bound_aux(key);
+    if (it != end() && !comp_(key, *key_of(it))) ++it;
+    return it;
+  }
+  const_iterator upper_bound(const key_type& key) const
+  {
+    const_iterator it = lower_bound_aux(key);
+    if (it != end() && !comp_(key, *key_of(it))) ++it;
+    return it;
+  }
+
+  iterator find(const key_type& key)
+  {
+    auto it = lower_bound_aux(key);
+    return it != end() && !comp_(key, *key_of(it)) ? it : end();
+  }
+  const_iterator find(const key_type& key) const
+  {
+    const_iterator it = lower_bound_aux(key);
+    return it != end() && !comp_(key, *key_of(it)) ? it : end();
+  }
+
+  // modify
+  template <class K, class... Args>
+  mystl::pair<iterator, bool> emplace_unique(K&& key, Args&&... args);
+
+  template <class Iter>
+  void insert_unique(Iter first, Iter last);
+
+  iterator  erase(const_iterator pos);
+  iterator  erase(const_iterator first, const_iterator last);
+  size_type erase(const key_type& key);
+
+  void clear();
+
+  void swap(btree& rhs) noexcept
+  {
+    mystl::swap(root_, rhs.root_);
+    mystl::swap(leftmost_, rhs.leftmost_);
+    mystl::swap(rightmost_, rhs.rightmost_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(comp_, rhs.comp_);
+  }
+
+  key_compare key_comp() const { return comp_; }
+
+private:
+  // helper functions
+  size_type last_count() const noexcept
+  {
+    return rightmost_ == nullptr ? 0 : rightmost_->count;
+  }
+
+  template <class It>
+  static const key_type* key_of(const It& it)
+  {
+    return it.leaf->keys() + it.index;
+  }
+
+  size_type lower_index(const key_type* keys, size_type n, const key_type& key) const
+  {
+    return mystl::btree_lower_index(keys, n, key, comp_, simd_search());
+  }
+
+  // the leaf that holds key if any, and the path to it
+  leaf_node* descend(const key_type& key, path_type& path) const;
+  iterator   lower_bound_aux(const key_type& key) const;
+
+  // raw moves of n objects, the ranges may overlap
+  template <class T>
+  static void relocate(T* first, size_type n, T* result, std::true_type)
+  {
+    if (n != 0) std::memmove(static_cast<void*>(result), first, n * sizeof(T));
+  }
+  template <class T>
+  static void relocate(T* first, size_type n, T* result, std::false_type)
+  {
+    if (result < first)
+    {
+      for (size_type i = 0; i < n; ++i)
+      {
+        mystl::construct(result + i, mystl::move(first[i]));
+        mystl::destroy(first + i);
+      }
+    }
+    else
+    {
+      for (size_type i = n; i > 0; --i)
+      {
+        mystl::construct(result + i - 1, mystl::move(first[i - 1]));
+        mystl::destroy(first + i - 1);
+      }
+    }
+  }
+  template <class T>
+  static void relocate(T* first, size_type n, T* result)
+  {
+    relocate(first, n, result, typename std::is_trivially_copyable<T>::type());
+  }
+
+  // move n elements of leaf from, starting at i, to leaf to at j
+  static void relocate_elements(leaf_node* from, size_type i, leaf_node* to,
+                                size_type j, size_type n)
+  {
+    relocate(from->keys() + i, n, to->keys() + j);
+    relocate_values(from, i, to, j, n, is_set());
+  }
+  static void relocate_values(leaf_node* from, size_type i, leaf_node* to,
+                              size_type j, size_type n, std::false_type)
+  {
+    relocate(from->values() + i, n, to->values() + j);
+  }
+  static void relocate_values(leaf_node*, size_type, leaf_node*, size_type,
+                              size_type, std::true_type) {}
+
+  static void destroy_element(leaf_node* leaf, size_type i, std::false_type)
+  {
+    mystl::destroy(leaf->keys() + i);
+    mystl::destroy(leaf->values() + i);
+  }
+  static void destroy_element(leaf_node* leaf, size_type i, std::true_type)
+  {
+    mystl::destroy(leaf->keys() + i);
+  }
+
+  // construct the element at slot i from a key and the mapped arguments
+  template <class K, class... Args>
+  static void construct_element(leaf_node* leaf, size_type i, std::false_type,
+                                K&& key, Args&&... args)
+  {
+    mystl::construct(leaf->values() + i, mystl::forward<Args>(args)...);
+    mystl::construct(leaf->keys() + i, mystl::forward<K>(key));
+  }
+  template <class K>
+  static void construct_element(leaf_node* leaf, size_type i, std::true_type, K&& key)
+  {
+    mystl::construct(leaf->keys() + i, mystl::forward<K>(key));
+  }
+
+  // construct the element at slot i from a value_type or a map reference
+  template <class E>
+  static void construct_from(leaf_node* leaf, size_type i, E&& e, std::false_type)
+  {
+    construct_element(leaf, i, is_set(), mystl::forward<E>(e).first,
+                      mystl::forward<E>(e).second);
+  }
+  template <class E>
+  static void construct_from(leaf_node* leaf, size_type i, E&& e, std::true_type)
+  {
+    construct_element(leaf, i, is_set(), mystl::forward<E>(e));
+  }
+
+  template <class E>
+  void insert_value(E&& e, std::false_type)
+  {
+    emplace_unique(mystl::forward<E>(e).first, mystl::forward<E>(e).second);
+  }
+  template <class E>
+  void insert_value(E&& e, std::true_type)
+  {
+    emplace_unique(mystl::forward<E>(e));
+  }
+
+  static const key_type& value_key(const value_type& v, std::false_type) { return v.first; }
+  static const key_type& value_key(const value_type& v, std::true_type)  { return v; }
+
+  leaf_node*  new_leaf();
+  inner_node* new_inner();
+  void        free_leaf(leaf_node* leaf);
+  void        free_inner(inner_node* inner);
+  void        free_subtree(node* x);
+
+  void link_after(leaf_node* leaf, leaf_node* next);
+  void unlink(leaf_node* leaf);
+
+  template <class K, class... Args>
+  void emplace_in_leaf(leaf_node* leaf, size_type i, K&& key, Args&&... args);
+
+  void insert_in_inner(inner_node* inner, size_type i, key_type* key, node* right);
+  void push_up(path_type& path, key_type* key, node* right, bool append,
+               inner_node** spare);
+  void rebalance_leaf(path_type& path, leaf_node*& leaf, size_type& i);
+  void rebalance_inner(path_type& path, size_type d);
+  void remove_key(inner_node* inner, size_type k);
+
+  template <class Iter>
+  void bulk_load(Iter first, size_type n);
+};
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+const size_t btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::leaf_slots;
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+const size_t btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::inner_slots;
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+const size_t btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::min_leaf;
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+const size_t btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::min_inner;
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+const size_t btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::max_height;
+
+/*****************************************************************************************/
+
+// insert an element with key unless the key is there, the mapped value is
+// constructed from args
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+template <class K, class... Args>
+mystl::pair<typename btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::iterator, bool>
+btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::
+emplace_unique(K&& key, Args&&... args)
+{
+  if (root_ == nullptr)
+  {
+    leaf_node* leaf = new_leaf();
+    root_ = leftmost_ = rightmost_ = leaf;
+  }
+  path_type path;
+  leaf_node* leaf = descend(key, path);
+  const size_type i = lower_index(leaf->keys(), leaf->count, key);
+  if (i < leaf->count && !comp_(key, leaf->keys()[i]))
+  {
+    return mystl::make_pair(iterator(leaf, i), false);
+  }
+  if (leaf->count < leaf_slots)
+  {
+    emplace_in_leaf(leaf, i, mystl::forward<K>(key), mystl::forward<Args>(args)...);
+    return mystl::make_pair(iterator(leaf, i), true);
+  }
+
+  // split the leaf, take every node needed before changing anything
+  size_type need = 0;
+  size_type d = path.depth;
+  for (; d > 0 && path.nodes[d - 1]->count == inner_slots; --d) ++need;
+  if (d == 0) ++need;  // a new root
+  inner_node* spare[max_height + 1];
+  size_type taken = 0;
+  leaf_node* right = nullptr;
+  try
+  {
+    for (; taken < need; ++taken) spare[taken] = new_inner();
+    right = new_leaf();
+  }
+  catch (...)
+  {
+    while (taken > 0) free_inner(spare[--taken]);
+    throw;
+  }
+
+  // appending to the last leaf leaves it full and starts a new one, so
+  // ascending inserts fill every node
+  const bool append = leaf == rightmost_ && i == leaf->count;
+  leaf_node* target;
+  size_type  pos;
+  if (append)
+  {
+    try
+    {
+      emplace_in_leaf(right, 0, mystl::forward<K>(key), mystl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      free_leaf(right);
+      while (taken > 0) free_inner(spare[--taken]);
+      throw;
+    }
+    target = right;
+    pos = 0;
+  }
+  else
+  {
+    const size_type half = leaf->count / 2;
+    relocate_elements(leaf, half, right, 0, leaf->count - half);
+    right->count = static_cast<uint16_t>(leaf->count - half);
+    leaf->count = static_cast<uint16_t>(half);
+    target = i < half ? leaf : right;
+    pos = i < half ? i : i - half;
+  }
+  link_after(leaf, right);
+  key_type separator(leaf->keys()[leaf->count - 1]);
+  push_up(path, &separator, right, append, spare);
+  if (!append)
+  {
+    emplace_in_leaf(target, pos, mystl::forward<K>(key), mystl::forward<Args>(args)...);
+  }
+  return mystl::make_pair(iterator(target, pos), true);
+}
+
+// an empty tree is bulk loaded from the sorted, deduplicated range
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+template <class Iter>
+void btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::
+insert_unique(Iter first, Iter last)
+{
+  if (!empty())
+  {
+    for (; first != last; ++first) insert_value(*first, is_set());
+    return;
+  }
+  mystl::vector<value_type> buf(first, last);
+  if (buf.empty()) return;
+  auto vcomp = [this](const value_type& a, const value_type& b)
+  {
+    return comp_(value_key(a, is_set()), value_key(b, is_set()));
+  };
+  mystl::stable_sort(buf.begin(), buf.end(), vcomp);
+  auto buf_end = buf.begin() + 1;
+  for (auto it = buf.begin() + 1; it != buf.end(); ++it)
+  {
+    if (!vcomp(*(buf_end - 1), *it)) continue;
+    if (buf_end != it) *buf_end = mystl::move(*it);
+    ++buf_end;
+  }
+  bulk_load(mystl::make_move_iterator(buf.begin()), static_cast<size_type>(buf_end - buf.begin()));
+}
+
+// erase the element at pos, return the element after it
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+typename btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::iterator
+btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::erase(const_iterator pos)
+{
+  path_type path;
+  leaf_node* leaf = descend(*key_of(pos), path);
+  size_type i = pos.index;
+  destroy_element(leaf, i, is_set());
+  relocate_elements(leaf, i + 1, leaf, i, leaf->count - i - 1);
+  --leaf->count;
+  --size_;
+  // (leaf, i) follows the element after the erased one while nodes move
+  if (path.depth != 0 && leaf->count < min_leaf) rebalance_leaf(path, leaf, i);
+  if (i < leaf->count || leaf->next == nullptr) return iterator(leaf, i);
+  return iterator(leaf->next, 0);
+}
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+typename btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::iterator
+btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::
+erase(const_iterator first, const_iterator last)
+{
+  if (first == begin() && last == end())
+  {
+    clear();
+    return end();
+  }
+  // erasing moves the elements after the erased one, so count them first
+  auto n = mystl::distance(first, last);
+  iterator it(first.leaf, first.index);
+  for (; n > 0; --n) it = erase(it);
+  return it;
+}
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+typename btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::size_type
+btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::erase(const key_type& key)
+{
+  auto it = find(key);
+  if (it == end()) return 0;
+  erase(it);
+  return 1;
+}
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+void btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::clear()
+{
+  if (root_ != nullptr) free_subtree(root_);
+  root_ = nullptr;
+  leftmost_ = nullptr;
+  rightmost_ = nullptr;
+  size_ = 0;
+}
+
+/*****************************************************************************************/
+// helper function
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+typename btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::leaf_node*
+btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::
+descend(const key_type& key, path_type& path) const
+{
+  path.depth = 0;
+  node* x = root_;
+  while (!x->leaf)
+  {
+    inner_node* inner = static_cast<inner_node*>(x);
+    const size_type i = lower_index(inner->keys(), inner->count, key);
+    path.nodes[path.depth] = inner;
+    path.index[path.depth] = i;
+    ++path.depth;
+    x = inner->children[i];
+  }
+  return static_cast<leaf_node*>(x);
+}
+
+// every key of a leaf is at most the separator on its right, so when key is
+// past the end of its leaf the answer is the first element of the next one
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+typename btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::iterator
+btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::
+lower_bound_aux(const key_type& key) const
+{
+  if (root_ == nullptr) return iterator(nullptr, 0);
+  node* x = root_;
+  while (!x->leaf)
+  {
+    inner_node* inner = static_cast<inner_node*>(x);
+    x = inner->children[lower_index(inner->keys(), inner->count, key)];
+  }
+  leaf_node* leaf = static_cast<leaf_node*>(x);
+  const size_type i = lower_index(leaf->keys(), leaf->count, key);
+  if (i == leaf->count && leaf->next != nullptr) return iterator(leaf->next, 0);
+  return iterator(leaf, i);
+}
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+typename btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::leaf_node*
+btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::new_leaf()
+{
+  leaf_node* leaf = leaf_allocator::allocate(1);
+  leaf->count = 0;
+  leaf->leaf = true;
+  leaf->prev = nullptr;
+  leaf->next = nullptr;
+  return leaf;
+}
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+typename btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::inner_node*
+btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::new_inner()
+{
+  inner_node* inner = inner_allocator::allocate(1);
+  inner->count = 0;
+  inner->leaf = false;
+  return inner;
+}
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+void btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::free_leaf(leaf_node* leaf)
+{
+  for (size_type i = 0; i < leaf->count; ++i) destroy_element(leaf, i, is_set());
+  leaf_allocator::deallocate(leaf, 1);
+}
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+void btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::free_inner(inner_node* inner)
+{
+  mystl::destroy(inner->keys(), inner->keys() + inner->count);
+  inner_allocator::deallocate(inner, 1);
+}
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+void btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::free_subtree(node* x)
+{
+  if (x->leaf)
+  {
+    free_leaf(static_cast<leaf_node*>(x));
+    return;
+  }
+  inner_node* inner = static_cast<inner_node*>(x);
+  for (size_type i = 0; i <= inner->count; ++i) free_subtree(inner->children[i]);
+  free_inner(inner);
+}
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+void btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::
+link_after(leaf_node* leaf, leaf_node* next)
+{
+  next->prev = leaf;
+  next->next = leaf->next;
+  if (leaf->next != nullptr) leaf->next->prev = next;
+  else                       rightmost_ = next;
+  leaf->next = next;
+}
+
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+void btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::unlink(leaf_node* leaf)
+{
+  if (leaf->prev != nullptr) leaf->prev->next = leaf->next;
+  else                       leftmost_ = leaf->next;
+  if (leaf->next != nullptr) leaf->next->prev = leaf->prev;
+  else                       rightmost_ = leaf->prev;
+}
+
+// open slot i of a leaf with room and construct the element there
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+template <class K, class... Args>
+void btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::
+emplace_in_leaf(leaf_node* leaf, size_type i, K&& key, Args&&... args)
+{
+  relocate_elements(leaf, i, leaf, i + 1, leaf->count - i);
+  try
+  {
+    construct_element(leaf, i, is_set(), mystl::forward<K>(key), mystl::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    relocate_elements(leaf, i + 1, leaf, i, leaf->count - i);
+    throw;
+  }
+  ++leaf->count;
+  ++size_;
+}
+
+// insert key at i and right as child i + 1 of an inner node with room
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+void btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::
+insert_in_inner(inner_node* inner, size_type i, key_type* key, node* right)
+{
+  relocate(inner->keys() + i, inner->count - i, inner->keys() + i + 1);
+  mystl::construct(inner->keys() + i, mystl::move(*key));
+  relocate(inner->children + i + 1, inner->count - i, inner->children + i + 2);
+  inner->children[i + 1] = right;
+  ++inner->count;
+}
+
+// hand key and the new node right to the parent of the split node, splitting
+// full inner nodes on the way up with the nodes in spare
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+void btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::
+push_up(path_type& path, key_type* key, node* right, bool append, inner_node** spare)
+{
+  typename std::aligned_storage<sizeof(key_type), alignof(key_type)>::type up_buf;
+  key_type* up = reinterpret_cast<key_type*>(&up_buf);
+  for (size_type d = path.depth; d > 0; --d)
+  {
+    inner_node* inner = path.nodes[d - 1];
+    const size_type i = path.index[d - 1];
+    if (inner->count < inner_slots)
+    {
+      insert_in_inner(inner, i, key, right);
+      return;
+    }
+    // keys[mid] moves up, the keys after it and their children move right
+    const size_type count = inner->count;
+    const size_type mid = append && i == count ? count - 1 : count / 2;
+    inner_node* sibling = *spare++;
+    relocate(inner->keys() + mid + 1, count - mid - 1, sibling->keys());
+    relocate(inner->children + mid + 1, count - mid, sibling->children);
+    sibling->count = static_cast<uint16_t>(count - mid - 1);
+    mystl::construct(up, mystl::move(inner->keys()[mid]));
+    mystl::destroy(inner->keys() + mid);
+    inner->count = static_cast<uint16_t>(mid);
+    if (i <= mid) insert_in_inner(inner, i, key, right);
+    else          insert_in_inner(sibling, i - mid - 1, key, right);
+    mystl::destroy(key);
+    mystl::construct(key, mystl::move(*up));
+    mystl::destroy(up);
+    right = sibling;
+  }
+  inner_node* root = *spare;
+  mystl::construct(root->keys(), mystl::move(*key));
+  root->children[0] = root_;
+  root->children[1] = right;
+  root->count = 1;
+  root_ = root;
+}
+
+// the leaf at the end of path is below min_leaf: merge it with a neighbor if
+// both fit in one leaf, else move elements over until they hold half each;
+// slot i of leaf is moved along with its element
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+void btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::
+rebalance_leaf(path_type& path, leaf_node*& leaf, size_type& i)
+{
+  inner_node* parent = path.nodes[path.depth - 1];
+  const size_type c = path.index[path.depth - 1];
+  // the neighbor under the same parent, keys[k] separates the two
+  const size_type k = c < parent->count ? c : c - 1;
+  leaf_node* left = static_cast<leaf_node*>(parent->children[k]);
+  leaf_node* right = static_cast<leaf_node*>(parent->children[k + 1]);
+  const size_type nl = left->count;
+  const size_type nr = right->count;
+
+  if (nl + nr <= leaf_slots)
+  {
+    relocate_elements(right, 0, left, nl, nr);
+    left->count = static_cast<uint16_t>(nl + nr);
+    right->count = 0;
+    if (leaf == right)
+    {
+      leaf = left;
+      i += nl;
+    }
+    unlink(right);
+    free_leaf(right);
+    remove_key(parent, k);
+    rebalance_inner(path, path.depth - 1);
+    return;
+  }
+
+  const size_type half = (nl + nr) / 2;
+  if (nl < half)
+  {
+    // the first elements of right go to the end of left
+    const size_type m = half - nl;
+    relocate_elements(right, 0, left, nl, m);
+    relocate_elements(right, m, right, 0, nr - m);
+    left->count = static_cast<uint16_t>(half);
+    right->count = static_cast<uint16_t>(nr - m);
+    if (leaf == right)
+    {
+      if (i < m)
+      {
+        leaf = left;
+        i += nl;
+      }
+      else
+      {
+        i -= m;
+      }
+    }
+  }
+  else
+  {
+    // the last elements of left go to the front of right
+    const size_type m = nl - half;
+    relocate_elements(right, 0, right, m, nr);
+    relocate_elements(left, half, right, 0, m);
+    left->count = static_cast<uint16_t>(half);
+    right->count = static_cast<uint16_t>(nr + m);
+    if (leaf == right)
+    {
+      i += m;
+    }
+    else if (i >= half)
+    {
+      leaf = right;
+      i -= half;
+    }
+  }
+  mystl::destroy(parent->keys() + k);
+  mystl::construct(parent->keys() + k, left->keys()[half - 1]);
+}
+
+// path.nodes[d] lost a key: while an inner node is below min_inner, merge it
+// with a neighbor through the key between them, or rotate keys through the
+// parent until both hold half; then drop roots left with one child
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+void btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::
+rebalance_inner(path_type& path, size_type d)
+{
+  for (; d > 0 && path.nodes[d]->count < min_inner; --d)
+  {
+    inner_node* parent = path.nodes[d - 1];
+    const size_type c = path.index[d - 1];
+    const size_type k = c < parent->count ? c : c - 1;
+    inner_node* left = static_cast<inner_node*>(parent->children[k]);
+    inner_node* right = static_cast<inner_node*>(parent->children[k + 1]);
+    const size_type nl = left->count;
+    const size_type nr = right->count;
+
+    if (nl + nr + 1 <= inner_slots)
+    {
+      mystl::construct(left->keys() + nl, mystl::move(parent->keys()[k]));
+      relocate(right->keys(), nr, left->keys() + nl + 1);
+      relocate(right->children, nr + 1, left->children + nl + 1);
+      left->count = static_cast<uint16_t>(nl + nr + 1);
+      right->count = 0;
+      free_inner(right);
+      remove_key(parent, k);
+      continue;
+    }
+
+    const size_type half = (nl + nr) / 2;
+    if (nl < half)
+    {
+      // keys[k] comes down to left, right's first keys follow it, and the
+      // key before right's new first child goes up
+      const size_type m = half - nl;
+      mystl::construct(left->keys() + nl, mystl::move(parent->keys()[k]));
+      relocate(right->keys(), m - 1, left->keys() + nl + 1);
+      relocate(right->children, m, left->children + nl + 1);
+      mystl::destroy(parent->keys() + k);
+      mystl::construct(parent->keys() + k, mystl::move(right->keys()[m - 1]));
+      mystl::destroy(right->keys() + m - 1);
+      relocate(right->keys() + m, nr - m, right->keys());
+      relocate(right->children + m, nr - m + 1, right->children);
+      left->count = static_cast<uint16_t>(half);
+      right->count = static_cast<uint16_t>(nr - m);
+    }
+    else
+    {
+      const size_type m = nl - half;
+      relocate(right->keys(), nr, right->keys() + m);
+      relocate(right->children, nr + 1, right->children + m);
+      mystl::construct(right->keys() + m - 1, mystl::move(parent->keys()[k]));
+      relocate(left->keys() + half + 1, m - 1, right->keys());
+      relocate(left->children + half + 1, m, right->children);
+      mystl::destroy(parent->keys() + k);
+      mystl::construct(parent->keys() + k, mystl::move(left->keys()[half]));
+      mystl::destroy(left->keys() + half);
+      left->count = static_cast<uint16_t>(half);
+      right->count = static_cast<uint16_t>(nr + m);
+    }
+    break;
+  }
+  while (!root_->leaf && static_cast<inner_node*>(root_)->count == 0)
+  {
+    inner_node* old = static_cast<inner_node*>(root_);
+    root_ = old->children[0];
+    free_inner(old);
+  }
+}
+
+// remove keys[k] and children[k + 1] of an inner node
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+void btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::
+remove_key(inner_node* inner, size_type k)
+{
+  mystl::destroy(inner->keys() + k);
+  relocate(inner->keys() + k + 1, inner->count - k - 1, inner->keys() + k);
+  relocate(inner->children + k + 2, inner->count - k - 1, inner->children + k + 1);
+  --inner->count;
+}
+
+// build the tree bottom up from n sorted unique elements, every node full
+// except that the last ones of a level share their elements evenly
+template <class Key, class Mapped, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+template <class Iter>
+void btree<Key, Mapped, Compare, NodeAlloc, NodeBytes>::bulk_load(Iter first, size_type n)
+{
+  if (n == 0) return;
+  mystl::vector<node*>    level;
+  mystl::vector<key_type> separators;
+  mystl::vector<node*>    inners;  // to free them on failure
+  try
+  {
+    const size_type leaves = (n + leaf_slots - 1) / leaf_slots;
+    level.reserve(leaves);
+    separators.reserve(leaves);
+    for (size_type j = 0; j < leaves; ++j)
+    {
+      leaf_node* leaf = new_leaf();
+      if (rightmost_ == nullptr) leftmost_ = leaf;
+      else                       link_after(rightmost_, leaf);
+      rightmost_ = leaf;
+      const size_type count = n / leaves + (j < n % leaves ? 1 : 0);
+      for (; leaf->count < count; ++first)
+      {
+        construct_from(leaf, leaf->count, *first, is_set());
+        ++leaf->count;
+        ++size_;
+      }
+      level.push_back(leaf);
+      separators.push_back(leaf->keys()[count - 1]);
+    }
+
+    while (level.size() > 1)
+    {
+      const size_type m = level.size();
+      const size_type groups = (m + inner_slots) / (inner_slots + 1);
+      mystl::vector<node*>    up;
+      mystl::vector<key_type> up_separators;
+      up.reserve(groups);
+      up_separators.reserve(groups);
+      size_type pos = 0;
+      for (size_type g = 0; g < groups; ++g)
+      {
+        const size_type children = m / groups + (g < m % groups ? 1 : 0);
+        inner_node* inner = new_inner();
+        inners.push_back(inner);
+        for (size_type k = 0; k < children; ++k)
+        {
+          inner->children[k] = level[pos + k];
+        }
+        for (; inner->count + 1u < children; ++inner->count)
+        {
+          mystl::construct(inner->keys() + inner->count,
+                           mystl::move(separators[pos + inner->count]));
+        }
+        up.push_back(inner);
+        up_separators.push_back(mystl::move(separators[pos + children - 1]));
+        pos += children;
+      }
+      level.swap(up);
+      separators.swap(up_separators);
+    }
+  }
+  catch (...)
+  {
+    for (auto it = inners.begin(); it != inners.end(); ++it)
+    {
+      free_inner(static_cast<inner_node*>(*it));
+    }
+    for (leaf_node* leaf = leftmost_; leaf != nullptr;)
+    {
+      leaf_node* next = leaf->next;
+      free_leaf(leaf);
+      leaf = next;
+    }
+    leftmost_ = rightmost_ = nullptr;
+    size_ = 0;
+    throw;
+  }
+  root_ = level.front();
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_BTREE_H_
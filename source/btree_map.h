@@ -0,0 +1,265 @@
+#ifndef _LITESTL_BTREE_MAP_H_
+#define _LITESTL_BTREE_MAP_H_
+
+// ordered map on a B+ tree
+// keys and mapped values sit in separate arrays of the leaves, so a lookup
+// reads keys only and a range scan walks the leaf chain; see btree.h
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "btree.h"
+
+namespace mystl
+{
+
+// template class: btree_map
+// keys are unique, the first of several equal keys in a bulk insert wins and
+// keys already in the map are never replaced
+// NodeAlloc supplies the nodes, NodeBytes sets their size: the default fits
+// eight cache lines, 4096 gives page sized nodes for trees far beyond the cache
+// inserting or erasing invalidates every iterator
+template <class Key, class T, class Compare = mystl::less<Key>,
+          template <class> class NodeAlloc = mystl::allocator, size_t NodeBytes = 512>
+class btree_map
+{
+private:
+  typedef mystl::btree<Key, T, Compare, NodeAlloc, NodeBytes> base_type;
+
+public:
+  typedef Key                                   key_type;
+  typedef T                                     mapped_type;
+  typedef mystl::pair<Key, T>                   value_type;
+  typedef Compare                               key_compare;
+
+  typedef typename base_type::iterator          iterator;
+  typedef typename base_type::const_iterator    const_iterator;
+  typedef typename iterator::reference          reference;
+  typedef typename const_iterator::reference    const_reference;
+  typedef size_t                                size_type;
+  typedef ptrdiff_t                             difference_type;
+
+private:
+  base_type tree_;
+
+public:
+  // construct, copy, move and destroy
+  btree_map() :tree_() {}
+
+  explicit btree_map(const key_compare& comp) :tree_(comp) {}
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  btree_map(Iter first, Iter last, const key_compare& comp = key_compare())
+    :tree_(comp)
+  {
+    tree_.insert_unique(first, last);
+  }
+
+  btree_map(std::initializer_list<value_type> ilist,
+            const key_compare& comp = key_compare())
+    :tree_(comp)
+  {
+    tree_.insert_unique(ilist.begin(), ilist.end());
+  }
+
+  btree_map(const btree_map& rhs) = default;
+  btree_map(btree_map&& rhs) = default;
+
+  btree_map& operator=(const btree_map& rhs) = default;
+  btree_map& operator=(btree_map&& rhs) = default;
+
+  btree_map& operator=(std::initializer_list<value_type> ilist)
+  {
+    tree_.clear();
+    tree_.insert_unique(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~btree_map() = default;
+
+public:
+  // iterators
+  iterator       begin()        noexcept { return tree_.begin(); }
+  const_iterator begin()  const noexcept { return tree_.begin(); }
+  iterator       end()          noexcept { return tree_.end(); }
+  const_iterator end()    const noexcept { return tree_.end(); }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend()   const noexcept { return end(); }
+
+  // capacity
+  bool      empty()    const noexcept { return tree_.empty(); }
+  size_type size()     const noexcept { return tree_.size(); }
+  size_type max_size() const noexcept { return tree_.max_size(); }
+
+  // element access
+  mapped_type& operator[](const key_type& key)
+  {
+    return try_emplace(key).first->second;
+  }
+  mapped_type& operator[](key_type&& key)
+  {
+    return try_emplace(mystl::move(key)).first->second;
+  }
+
+  mapped_type& at(const key_type& key)
+  {
+    auto it = find(key);
+    if (it == end()) throw std::out_of_range("btree_map<Key, T> no such element exists");
+    return it->second;
+  }
+  const mapped_type& at(const key_type& key) const
+  {
+    auto it = find(key);
+    if (it == end()) throw std::out_of_range("btree_map<Key, T> no such element exists");
+    return it->second;
+  }
+
+  // lookup
+  iterator       lower_bound(const key_type& key)       { return tree_.lower_bound(key); }
+  const_iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+  iterator       upper_bound(const key_type& key)       { return tree_.upper_bound(key); }
+  const_iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+  iterator       find(const key_type& key)              { return tree_.find(key); }
+  const_iterator find(const key_type& key) const        { return tree_.find(key); }
+
+  size_type count(const key_type& key) const
+  {
+    return find(key) == end() ? 0 : 1;
+  }
+
+  mystl::pair<iterator, iterator> equal_range(const key_type& key)
+  {
+    auto it = find(key);
+    auto last = it;
+    return mystl::pair<iterator, iterator>(it, it == end() ? last : ++last);
+  }
+  mystl::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+  {
+    auto it = find(key);
+    auto last = it;
+    return mystl::pair<const_iterator, const_iterator>(it, it == end() ? last : ++last);
+  }
+
+  // modify
+  template <class... Args>
+  mystl::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+  {
+    return tree_.emplace_unique(key, mystl::forward<Args>(args)...);
+  }
+  template <class... Args>
+  mystl::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+  {
+    return tree_.emplace_unique(mystl::move(key), mystl::forward<Args>(args)...);
+  }
+
+  template <class... Args>
+  mystl::pair<iterator, bool> emplace(Args&&... args)
+  {
+    value_type value(mystl::forward<Args>(args)...);
+    return tree_.emplace_unique(mystl::move(value.first), mystl::move(value.second));
+  }
+
+  mystl::pair<iterator, bool> insert(const value_type& value)
+  {
+    return tree_.emplace_unique(value.first, value.second);
+  }
+  mystl::pair<iterator, bool> insert(value_type&& value)
+  {
+    return tree_.emplace_unique(mystl::move(value.first), mystl::move(value.second));
+  }
+
+  // an empty map is bulk loaded, sorted input builds full nodes bottom up
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void insert(Iter first, Iter last)
+  {
+    tree_.insert_unique(first, last);
+  }
+
+  void insert(std::initializer_list<value_type> ilist)
+  {
+    tree_.insert_unique(ilist.begin(), ilist.end());
+  }
+
+  iterator  erase(const_iterator pos)                        { return tree_.erase(pos); }
+  iterator  erase(const_iterator first, const_iterator last) { return tree_.erase(first, last); }
+  size_type erase(const key_type& key)                       { return tree_.erase(key); }
+
+  void clear() noexcept { tree_.clear(); }
+
+  void swap(btree_map& rhs) noexcept { tree_.swap(rhs.tree_); }
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+};
+
+/*****************************************************************************************/
+// overload comparison operators
+
+template <class Key, class T, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+bool operator==(const btree_map<Key, T, Compare, NodeAlloc, NodeBytes>& lhs,
+                const btree_map<Key, T, Compare, NodeAlloc, NodeBytes>& rhs)
+{
+  if (lhs.size() != rhs.size()) return false;
+  for (auto i = lhs.begin(), j = rhs.begin(); i != lhs.end(); ++i, ++j)
+  {
+    if (!(i->first == j->first) || !(i->second == j->second)) return false;
+  }
+  return true;
+}
+
+template <class Key, class T, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+bool operator<(const btree_map<Key, T, Compare, NodeAlloc, NodeBytes>& lhs,
+               const btree_map<Key, T, Compare, NodeAlloc, NodeBytes>& rhs)
+{
+  auto i = lhs.begin(), j = rhs.begin();
+  for (; i != lhs.end() && j != rhs.end(); ++i, ++j)
+  {
+    if (i->first < j->first) return true;
+    if (j->first < i->first) return false;
+    if (i->second < j->second) return true;
+    if (j->second < i->second) return false;
+  }
+  return i == lhs.end() && j != rhs.end();
+}
+
+template <class Key, class T, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+bool operator!=(const btree_map<Key, T, Compare, NodeAlloc, NodeBytes>& lhs,
+                const btree_map<Key, T, Compare, NodeAlloc, NodeBytes>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class Key, class T, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+bool operator>(const btree_map<Key, T, Compare, NodeAlloc, NodeBytes>& lhs,
+               const btree_map<Key, T, Compare, NodeAlloc, NodeBytes>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class Key, class T, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+bool operator<=(const btree_map<Key, T, Compare, NodeAlloc, NodeBytes>& lhs,
+                const btree_map<Key, T, Compare, NodeAlloc, NodeBytes>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class Key, class T, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+bool operator>=(const btree_map<Key, T, Compare, NodeAlloc, NodeBytes>& lhs,
+                const btree_map<Key, T, Compare, NodeAlloc, NodeBytes>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// overload mystl::swap
+template <class Key, class T, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+void swap(btree_map<Key, T, Compare, NodeAlloc, NodeBytes>& lhs,
+          btree_map<Key, T, Compare, NodeAlloc, NodeBytes>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_BTREE_MAP_H_
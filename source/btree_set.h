@@ -0,0 +1,219 @@
+#ifndef _LITESTL_BTREE_SET_H_
+#define _LITESTL_BTREE_SET_H_
+
+// ordered set on a B+ tree
+// the leaves hold nothing but keys, so a range scan reads dense key arrays
+// along the leaf chain; see btree.h
+
+#include <cstddef>
+#include <initializer_list>
+
+#include "btree.h"
+
+namespace mystl
+{
+
+// template class: btree_set
+// keys are unique, the first of several equal keys in a bulk insert wins and
+// keys already in the set are never replaced
+// NodeAlloc supplies the nodes, NodeBytes sets their size: the default fits
+// eight cache lines, 4096 gives page sized nodes for trees far beyond the cache
+// inserting or erasing invalidates every iterator
+template <class Key, class Compare = mystl::less<Key>,
+          template <class> class NodeAlloc = mystl::allocator, size_t NodeBytes = 512>
+class btree_set
+{
+private:
+  typedef mystl::btree<Key, void, Compare, NodeAlloc, NodeBytes> base_type;
+
+public:
+  typedef Key                                   key_type;
+  typedef Key                                   value_type;
+  typedef Compare                               key_compare;
+  typedef Compare                               value_compare;
+
+  // keys cannot be modified in place, that would break the order
+  typedef typename base_type::const_iterator    iterator;
+  typedef typename base_type::const_iterator    const_iterator;
+  typedef const Key&                            reference;
+  typedef const Key&                            const_reference;
+  typedef size_t                                size_type;
+  typedef ptrdiff_t                             difference_type;
+
+private:
+  base_type tree_;
+
+public:
+  // construct, copy, move and destroy
+  btree_set() :tree_() {}
+
+  explicit btree_set(const key_compare& comp) :tree_(comp) {}
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  btree_set(Iter first, Iter last, const key_compare& comp = key_compare())
+    :tree_(comp)
+  {
+    tree_.insert_unique(first, last);
+  }
+
+  btree_set(std::initializer_list<value_type> ilist,
+            const key_compare& comp = key_compare())
+    :tree_(comp)
+  {
+    tree_.insert_unique(ilist.begin(), ilist.end());
+  }
+
+  btree_set(const btree_set& rhs) = default;
+  btree_set(btree_set&& rhs) = default;
+
+  btree_set& operator=(const btree_set& rhs) = default;
+  btree_set& operator=(btree_set&& rhs) = default;
+
+  btree_set& operator=(std::initializer_list<value_type> ilist)
+  {
+    tree_.clear();
+    tree_.insert_unique(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~btree_set() = default;
+
+public:
+  // iterators
+  iterator begin()  const noexcept { return tree_.begin(); }
+  iterator end()    const noexcept { return tree_.end(); }
+  iterator cbegin() const noexcept { return tree_.begin(); }
+  iterator cend()   const noexcept { return tree_.end(); }
+
+  // capacity
+  bool      empty()    const noexcept { return tree_.empty(); }
+  size_type size()     const noexcept { return tree_.size(); }
+  size_type max_size() const noexcept { return tree_.max_size(); }
+
+  // lookup
+  iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+  iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+  iterator find(const key_type& key)        const { return tree_.find(key); }
+
+  size_type count(const key_type& key) const
+  {
+    return find(key) == end() ? 0 : 1;
+  }
+
+  mystl::pair<iterator, iterator> equal_range(const key_type& key) const
+  {
+    auto it = find(key);
+    auto last = it;
+    return mystl::pair<iterator, iterator>(it, it == end() ? last : ++last);
+  }
+
+  // modify
+  template <class... Args>
+  mystl::pair<iterator, bool> emplace(Args&&... args)
+  {
+    value_type value(mystl::forward<Args>(args)...);
+    return tree_.emplace_unique(mystl::move(value));
+  }
+
+  mystl::pair<iterator, bool> insert(const value_type& value)
+  {
+    return tree_.emplace_unique(value);
+  }
+  mystl::pair<iterator, bool> insert(value_type&& value)
+  {
+    return tree_.emplace_unique(mystl::move(value));
+  }
+
+  // an empty set is bulk loaded, sorted input builds full nodes bottom up
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void insert(Iter first, Iter last)
+  {
+    tree_.insert_unique(first, last);
+  }
+
+  void insert(std::initializer_list<value_type> ilist)
+  {
+    tree_.insert_unique(ilist.begin(), ilist.end());
+  }
+
+  iterator  erase(const_iterator pos)                        { return tree_.erase(pos); }
+  iterator  erase(const_iterator first, const_iterator last) { return tree_.erase(first, last); }
+  size_type erase(const key_type& key)                       { return tree_.erase(key); }
+
+  void clear() noexcept { tree_.clear(); }
+
+  void swap(btree_set& rhs) noexcept { tree_.swap(rhs.tree_); }
+
+  key_compare   key_comp()   const { return tree_.key_comp(); }
+  value_compare value_comp() const { return tree_.key_comp(); }
+};
+
+/*****************************************************************************************/
+// overload comparison operators
+
+template <class Key, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+bool operator==(const btree_set<Key, Compare, NodeAlloc, NodeBytes>& lhs,
+                const btree_set<Key, Compare, NodeAlloc, NodeBytes>& rhs)
+{
+  if (lhs.size() != rhs.size()) return false;
+  for (auto i = lhs.begin(), j = rhs.begin(); i != lhs.end(); ++i, ++j)
+  {
+    if (!(*i == *j)) return false;
+  }
+  return true;
+}
+
+template <class Key, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+bool operator<(const btree_set<Key, Compare, NodeAlloc, NodeBytes>& lhs,
+               const btree_set<Key, Compare, NodeAlloc, NodeBytes>& rhs)
+{
+  auto i = lhs.begin(), j = rhs.begin();
+  for (; i != lhs.end() && j != rhs.end(); ++i, ++j)
+  {
+    if (*i < *j) return true;
+    if (*j < *i) return false;
+  }
+  return i == lhs.end() && j != rhs.end();
+}
+
+template <class Key, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+bool operator!=(const btree_set<Key, Compare, NodeAlloc, NodeBytes>& lhs,
+                const btree_set<Key, Compare, NodeAlloc, NodeBytes>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class Key, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+bool operator>(const btree_set<Key, Compare, NodeAlloc, NodeBytes>& lhs,
+               const btree_set<Key, Compare, NodeAlloc, NodeBytes>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class Key, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+bool operator<=(const btree_set<Key, Compare, NodeAlloc, NodeBytes>& lhs,
+                const btree_set<Key, Compare, NodeAlloc, NodeBytes>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class Key, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+bool operator>=(const btree_set<Key, Compare, NodeAlloc, NodeBytes>& lhs,
+                const btree_set<Key, Compare, NodeAlloc, NodeBytes>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// overload mystl::swap
+template <class Key, class Compare, template <class> class NodeAlloc, size_t NodeBytes>
+void swap(btree_set<Key, Compare, NodeAlloc, NodeBytes>& lhs,
+          btree_set<Key, Compare, NodeAlloc, NodeBytes>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_BTREE_SET_H_
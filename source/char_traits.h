@@ -0,0 +1,395 @@
+#ifndef _LITESTL_CHAR_TRAITS_H_
+#define _LITESTL_CHAR_TRAITS_H_
+
+// character operations and the search kernels shared by basic_string and
+// basic_string_view
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace mystl
+{
+
+/********************************************************************************/
+// char_traits
+// the character operations basic_string and basic_string_view are written in
+/********************************************************************************/
+template <class CharT>
+struct char_traits
+{
+  typedef CharT char_type;
+
+  static bool eq(char_type a, char_type b) noexcept { return a == b; }
+  static bool lt(char_type a, char_type b) noexcept { return a < b; }
+
+  static size_t length(const char_type* s) noexcept
+  {
+    size_t n = 0;
+    for (; !eq(s[n], char_type()); ++n) {}
+    return n;
+  }
+
+  static int compare(const char_type* s1, const char_type* s2, size_t n) noexcept
+  {
+    for (; n != 0; --n, ++s1, ++s2)
+    {
+      if (lt(*s1, *s2)) return -1;
+      if (lt(*s2, *s1)) return 1;
+    }
+    return 0;
+  }
+
+  static const char_type* find(const char_type* s, size_t n, char_type c) noexcept
+  {
+    for (; n != 0; --n, ++s)
+    {
+      if (eq(*s, c)) return s;
+    }
+    return nullptr;
+  }
+
+  static char_type* copy(char_type* dst, const char_type* src, size_t n) noexcept
+  {
+    if (n != 0) std::memcpy(dst, src, n * sizeof(char_type));
+    return dst;
+  }
+
+  static char_type* move(char_type* dst, const char_type* src, size_t n) noexcept
+  {
+    if (n != 0) std::memmove(dst, src, n * sizeof(char_type));
+    return dst;
+  }
+
+  static char_type* assign(char_type* dst, size_t n, char_type c) noexcept
+  {
+    for (size_t i = 0; i != n; ++i) dst[i] = c;
+    return dst;
+  }
+};
+
+// char compares as unsigned char, the same order memcmp uses
+template <>
+struct char_traits<char>
+{
+  typedef char char_type;
+
+  static bool eq(char_type a, char_type b) noexcept { return a == b; }
+  static bool lt(char_type a, char_type b) noexcept
+  {
+    return static_cast<unsigned char>(a) < static_cast<unsigned char>(b);
+  }
+
+  static size_t length(const char_type* s) noexcept { return std::strlen(s); }
+
+  static int compare(const char_type* s1, const char_type* s2, size_t n) noexcept
+  {
+    return n == 0 ? 0 : std::memcmp(s1, s2, n);
+  }
+
+  static const char_type* find(const char_type* s, size_t n, char_type c) noexcept
+  {
+    return n == 0 ? nullptr : static_cast<const char_type*>(std::memchr(s, c, n));
+  }
+
+  static char_type* copy(char_type* dst, const char_type* src, size_t n) noexcept
+  {
+    if (n != 0) std::memcpy(dst, src, n);
+    return dst;
+  }
+
+  static char_type* move(char_type* dst, const char_type* src, size_t n) noexcept
+  {
+    if (n != 0) std::memmove(dst, src, n);
+    return dst;
+  }
+
+  static char_type* assign(char_type* dst, size_t n, char_type c) noexcept
+  {
+    if (n != 0) std::memset(dst, c, n);
+    return dst;
+  }
+};
+
+/********************************************************************************/
+// string search
+// each function returns a pointer to what it found in [s, s + n), or nullptr
+// the templates work for any character type through Traits; the overloads
+// for char_traits<char> search 16 or 32 bytes per step: a substring is
+// looked for by matching its first and its last byte against a block of
+// text at once and checking only the positions where both match, and a set
+// of up to 16 bytes is matched with one pcmpestri per block
+/********************************************************************************/
+// first position of p[0, m)
+template <class CharT, class Traits>
+const CharT* string_find(const CharT* s, size_t n, const CharT* p, size_t m, Traits)
+{
+  if (m == 0) return s;
+  if (m > n) return nullptr;
+  const CharT* const last = s + (n - m) + 1;
+  while (s != last)
+  {
+    s = Traits::find(s, static_cast<size_t>(last - s), p[0]);
+    if (s == nullptr) return nullptr;
+    if (Traits::compare(s + 1, p + 1, m - 1) == 0) return s;
+    ++s;
+  }
+  return nullptr;
+}
+
+// last position of p[0, m)
+template <class CharT, class Traits>
+const CharT* string_rfind(const CharT* s, size_t n, const CharT* p, size_t m, Traits)
+{
+  if (m == 0) return s + n;
+  if (m > n) return nullptr;
+  for (size_t i = n - m + 1; i != 0; --i)
+  {
+    if (Traits::compare(s + i - 1, p, m) == 0) return s + i - 1;
+  }
+  return nullptr;
+}
+
+// first character that is (member) or is not (!member) in set[0, m)
+template <class CharT, class Traits>
+const CharT* string_find_in(const CharT* s, size_t n, const CharT* set, size_t m,
+                            bool member, Traits)
+{
+  for (; n != 0; --n, ++s)
+  {
+    if ((Traits::find(set, m, *s) != nullptr) == member) return s;
+  }
+  return nullptr;
+}
+
+// last character that is (member) or is not (!member) in set[0, m)
+template <class CharT, class Traits>
+const CharT* string_rfind_in(const CharT* s, size_t n, const CharT* set, size_t m,
+                             bool member, Traits)
+{
+  while (n != 0)
+  {
+    --n;
+    if ((Traits::find(set, m, s[n]) != nullptr) == member) return s + n;
+  }
+  return nullptr;
+}
+
+#if defined(__AVX2__)
+typedef __m256i string_block;
+static const size_t string_block_size = 32;
+
+inline string_block string_block_splat(char c) noexcept
+{
+  return _mm256_set1_epi8(c);
+}
+
+// bit i is set when s[i] == c
+inline uint32_t string_block_match(const char* s, string_block c) noexcept
+{
+  const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, c)));
+}
+#elif defined(__SSE2__)
+typedef __m128i string_block;
+static const size_t string_block_size = 16;
+
+inline string_block string_block_splat(char c) noexcept
+{
+  return _mm_set1_epi8(c);
+}
+
+inline uint32_t string_block_match(const char* s, string_block c) noexcept
+{
+  const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(b, c)));
+}
+#endif
+
+inline const char* string_rfind_char(const char* s, size_t n, char c) noexcept
+{
+#if defined(__SSE2__)
+  const string_block v = mystl::string_block_splat(c);
+  while (n >= string_block_size)
+  {
+    n -= string_block_size;
+    const uint32_t mask = mystl::string_block_match(s + n, v);
+    if (mask != 0) return s + n + (31 - __builtin_clz(mask));
+  }
+#endif
+  while (n != 0)
+  {
+    --n;
+    if (s[n] == c) return s + n;
+  }
+  return nullptr;
+}
+
+inline const char* string_find(const char* s, size_t n, const char* p, size_t m,
+                               mystl::char_traits<char>) noexcept
+{
+  if (m == 0) return s;
+  if (m > n) return nullptr;
+  if (m == 1) return static_cast<const char*>(std::memchr(s, p[0], n));
+  const size_t starts = n - m + 1;
+  size_t i = 0;
+#if defined(__SSE2__)
+  const string_block head = mystl::string_block_splat(p[0]);
+  const string_block tail = mystl::string_block_splat(p[m - 1]);
+  for (; i + string_block_size <= starts; i += string_block_size)
+  {
+    uint32_t mask = mystl::string_block_match(s + i, head) &
+                    mystl::string_block_match(s + i + m - 1, tail);
+    for (; mask != 0; mask &= mask - 1)
+    {
+      const size_t k = i + static_cast<size_t>(__builtin_ctz(mask));
+      if (std::memcmp(s + k + 1, p + 1, m - 2) == 0) return s + k;
+    }
+  }
+#endif
+  while (i < starts)
+  {
+    const char* q = static_cast<const char*>(std::memchr(s + i, p[0], starts - i));
+    if (q == nullptr) return nullptr;
+    i = static_cast<size_t>(q - s);
+    if (s[i + m - 1] == p[m - 1] && std::memcmp(s + i + 1, p + 1, m - 2) == 0)
+      return q;
+    ++i;
+  }
+  return nullptr;
+}
+
+inline const char* string_rfind(const char* s, size_t n, const char* p, size_t m,
+                                mystl::char_traits<char>) noexcept
+{
+  if (m == 0) return s + n;
+  if (m > n) return nullptr;
+  if (m == 1) return mystl::string_rfind_char(s, n, p[0]);
+  size_t starts = n - m + 1;
+#if defined(__SSE2__)
+  const string_block head = mystl::string_block_splat(p[0]);
+  const string_block tail = mystl::string_block_splat(p[m - 1]);
+  while (starts >= string_block_size)
+  {
+    starts -= string_block_size;
+    uint32_t mask = mystl::string_block_match(s + starts, head) &
+                    mystl::string_block_match(s + starts + m - 1, tail);
+    while (mask != 0)
+    {
+      const int bit = 31 - __builtin_clz(mask);
+      const size_t k = starts + static_cast<size_t>(bit);
+      if (std::memcmp(s + k + 1, p + 1, m - 2) == 0) return s + k;
+      mask &= ~(uint32_t(1) << bit);
+    }
+  }
+#endif
+  while (starts != 0)
+  {
+    --starts;
+    if (s[starts] == p[0] && s[starts + m - 1] == p[m - 1] &&
+        std::memcmp(s + starts + 1, p + 1, m - 2) == 0)
+      return s + starts;
+  }
+  return nullptr;
+}
+
+// membership of the 256 byte values, for sets pcmpestri cannot take
+struct string_byte_set
+{
+  uint64_t bits[4];
+
+  string_byte_set(const char* set, size_t m) noexcept
+    :bits()
+  {
+    for (size_t i = 0; i != m; ++i)
+    {
+      const auto c = static_cast<unsigned char>(set[i]);
+      bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+  }
+
+  bool test(char ch) const noexcept
+  {
+    const auto c = static_cast<unsigned char>(ch);
+    return (bits[c >> 6] >> (c & 63)) & 1;
+  }
+};
+
+#if defined(__SSE4_2__)
+// Mode selects "any of" or "none of"; the set has at most 16 bytes
+template <int Mode>
+const char* string_scan_set(const char* s, size_t n, const char* set, size_t m) noexcept
+{
+  char buf[16] = {};
+  std::memcpy(buf, set, m);
+  const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+  const int la = static_cast<int>(m);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+    const int k = _mm_cmpestri(a, la, b, 16, Mode);
+    if (k != 16) return s + i + k;
+  }
+  if (i != n)
+  {
+    // the last bytes are copied out, a load past the end could fault
+    char rest[16] = {};
+    std::memcpy(rest, s + i, n - i);
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rest));
+    const int k = _mm_cmpestri(a, la, b, static_cast<int>(n - i), Mode);
+    if (k != 16) return s + i + k;
+  }
+  return nullptr;
+}
+#endif
+
+inline const char* string_find_in(const char* s, size_t n, const char* set, size_t m,
+                                  bool member, mystl::char_traits<char>) noexcept
+{
+  if (member && m == 1) return static_cast<const char*>(std::memchr(s, set[0], n));
+#if defined(__SSE4_2__)
+  if (m <= 16)
+  {
+    return member
+      ? mystl::string_scan_set<_SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY |
+                               _SIDD_LEAST_SIGNIFICANT>(s, n, set, m)
+      : mystl::string_scan_set<_SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY |
+                               _SIDD_MASKED_NEGATIVE_POLARITY |
+                               _SIDD_LEAST_SIGNIFICANT>(s, n, set, m);
+  }
+#endif
+  const string_byte_set table(set, m);
+  for (size_t i = 0; i != n; ++i)
+  {
+    if (table.test(s[i]) == member) return s + i;
+  }
+  return nullptr;
+}
+
+inline const char* string_rfind_in(const char* s, size_t n, const char* set, size_t m,
+                                   bool member, mystl::char_traits<char>) noexcept
+{
+  if (member && m == 1) return mystl::string_rfind_char(s, n, set[0]);
+  const string_byte_set table(set, m);
+  while (n != 0)
+  {
+    --n;
+    if (table.test(s[n]) == member) return s + n;
+  }
+  return nullptr;
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_CHAR_TRAITS_H_
@@ -0,0 +1,1139 @@
+#ifndef _LITESTL_DEQUE_H_
+#define _LITESTL_DEQUE_H_
+
+// double-ended queue in fixed-size chunks
+// elements live in chunks of about 4KB and a map holds the chunk pointers,
+// pushing or popping at either end is O(1) and never moves an element, only
+// the map of pointers is reallocated as it grows
+// its iterators are segmented (see segmented_iterator_traits), so copy, move,
+// fill and accumulate run one loop per chunk instead of one step per element
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "iterator.h"
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "type_traits.h"
+#include "uninitialized.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// elements per chunk: a 4KB chunk for small types, 16 elements for others
+template <class T>
+struct deque_buf_size
+{
+  static const size_t value = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+};
+
+template <class T>
+const size_t deque_buf_size<T>::value;
+
+// iterator of deque
+// cur is always inside [first, last), the end iterator of a deque points to
+// a slot of an allocated chunk
+template <class T, class Ref, class Ptr>
+struct deque_iterator :public iterator<random_access_iterator_tag, T>
+{
+  typedef deque_iterator<T, T&, T*>             iterator;
+  typedef deque_iterator<T, const T&, const T*> const_iterator;
+  typedef deque_iterator                        self;
+
+  typedef T            value_type;
+  typedef Ptr          pointer;
+  typedef Ref          reference;
+  typedef size_t       size_type;
+  typedef ptrdiff_t    difference_type;
+  typedef T*           value_pointer;
+  typedef T**          map_pointer;
+
+  static const size_type buffer_size = deque_buf_size<T>::value;
+
+  value_pointer cur;    // current element
+  value_pointer first;  // head of the chunk
+  value_pointer last;   // tail of the chunk
+  map_pointer   node;   // slot of the chunk in the map
+
+  deque_iterator() noexcept
+    :cur(nullptr), first(nullptr), last(nullptr), node(nullptr) {}
+
+  deque_iterator(value_pointer v, map_pointer n)
+    :cur(v), first(*n), last(*n + buffer_size), node(n) {}
+
+  deque_iterator(const iterator& rhs)
+    :cur(rhs.cur), first(rhs.first), last(rhs.last), node(rhs.node) {}
+
+  self& operator=(const iterator& rhs)
+  {
+    cur = rhs.cur;
+    first = rhs.first;
+    last = rhs.last;
+    node = rhs.node;
+    return *this;
+  }
+
+  // move to another chunk, cur is left to the caller
+  void set_node(map_pointer new_node)
+  {
+    node = new_node;
+    first = *new_node;
+    last = first + buffer_size;
+  }
+
+  reference operator*()  const { return *cur; }
+  pointer   operator->() const { return cur; }
+
+  difference_type operator-(const self& x) const
+  {
+    return static_cast<difference_type>(buffer_size) * (node - x.node)
+      + (cur - first) - (x.cur - x.first);
+  }
+
+  self& operator++()
+  {
+    if (++cur == last)
+    {
+      set_node(node + 1);
+      cur = first;
+    }
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  self& operator--()
+  {
+    if (cur == first)
+    {
+      set_node(node - 1);
+      cur = last;
+    }
+    --cur;
+    return *this;
+  }
+  self operator--(int)
+  {
+    self tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  self& operator+=(difference_type n)
+  {
+    const auto offset = n + (cur - first);
+    const auto size = static_cast<difference_type>(buffer_size);
+    if (offset >= 0 && offset < size)
+    {
+      cur += n;
+    }
+    else
+    {
+      const auto node_offset = offset > 0 ? offset / size : -((-offset - 1) / size) - 1;
+      set_node(node + node_offset);
+      cur = first + (offset - node_offset * size);
+    }
+    return *this;
+  }
+  self operator+(difference_type n) const
+  {
+    self tmp = *this;
+    return tmp += n;
+  }
+  self& operator-=(difference_type n)
+  {
+    return *this += -n;
+  }
+  self operator-(difference_type n) const
+  {
+    self tmp = *this;
+    return tmp -= n;
+  }
+
+  reference operator[](difference_type n) const { return *(*this + n); }
+
+  bool operator==(const self& rhs) const { return cur == rhs.cur; }
+  bool operator< (const self& rhs) const
+  {
+    return node == rhs.node ? (cur < rhs.cur) : (node < rhs.node);
+  }
+  bool operator!=(const self& rhs) const { return !(*this == rhs); }
+  bool operator> (const self& rhs) const { return rhs < *this; }
+  bool operator<=(const self& rhs) const { return !(rhs < *this); }
+  bool operator>=(const self& rhs) const { return !(*this < rhs); }
+};
+
+template <class T, class Ref, class Ptr>
+const size_t deque_iterator<T, Ref, Ptr>::buffer_size;
+
+// the segments of a deque are its chunks
+template <class T, class Ref, class Ptr>
+struct segmented_iterator_traits<deque_iterator<T, Ref, Ptr>>
+{
+  typedef m_true_type                 is_segmented_iterator;
+  typedef deque_iterator<T, Ref, Ptr> iterator;
+  typedef T**                         segment_iterator;
+  typedef Ptr                         local_iterator;
+
+  static segment_iterator segment(const iterator& it) { return it.node; }
+  static local_iterator   local(const iterator& it)   { return it.cur; }
+  static local_iterator   begin(segment_iterator s)   { return *s; }
+  static local_iterator   end(segment_iterator s)     { return *s + iterator::buffer_size; }
+
+  // the end of a chunk is the head of the next one
+  static iterator compose(segment_iterator s, local_iterator pos)
+  {
+    if (pos == end(s))
+    {
+      ++s;
+      pos = begin(s);
+    }
+    return iterator(const_cast<T*>(pos), s);
+  }
+};
+
+// template class: deque
+// T: element type, Alloc: allocator of the chunks
+template <class T, class Alloc = mystl::allocator<T>>
+class deque
+{
+public:
+  typedef Alloc                                    allocator_type;
+  typedef Alloc                                    data_allocator;
+  typedef mystl::allocator<T*>                     map_allocator;
+
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+  typedef T**                                      map_pointer;
+
+  typedef deque_iterator<T, T&, T*>                iterator;
+  typedef deque_iterator<T, const T&, const T*>    const_iterator;
+
+  static const size_type buffer_size = deque_buf_size<T>::value;
+
+  allocator_type get_allocator() { return allocator_type(); }
+
+private:
+  // the map is made on the first insertion, a default constructed or a
+  // moved-from deque owns no memory
+  static const size_type initial_map_size = 8;
+
+  iterator    begin_;     // first element
+  iterator    end_;       // past the last element
+  map_pointer map_;       // chunk pointers, only [begin_.node, end_.node] are in use
+  size_type   map_size_;  // slots in the map
+
+public:
+  // construct, copy, move and destroy
+  deque() noexcept
+    :begin_(), end_(), map_(nullptr), map_size_(0) {}
+
+  explicit deque(size_type n)
+    :deque()
+  {
+    map_init(n);
+    try
+    {
+      mystl::uninitialized_value_construct_n(begin_, n);
+    }
+    catch (...)
+    {
+      free_all();
+      throw;
+    }
+  }
+
+  deque(size_type n, const value_type& value)
+    :deque()
+  {
+    map_init(n);
+    try
+    {
+      mystl::uninitialized_fill(begin_, end_, value);
+    }
+    catch (...)
+    {
+      free_all();
+      throw;
+    }
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  deque(Iter first, Iter last)
+    :deque()
+  {
+    range_init(first, last, iterator_category(first));
+  }
+
+  deque(std::initializer_list<value_type> ilist)
+    :deque()
+  {
+    range_init(ilist.begin(), ilist.end(), forward_iterator_tag());
+  }
+
+  deque(const deque& rhs)
+    :deque()
+  {
+    range_init(rhs.begin(), rhs.end(), forward_iterator_tag());
+  }
+
+  deque(deque&& rhs) noexcept
+    :begin_(rhs.begin_), end_(rhs.end_), map_(rhs.map_), map_size_(rhs.map_size_)
+  {
+    rhs.begin_ = iterator();
+    rhs.end_ = iterator();
+    rhs.map_ = nullptr;
+    rhs.map_size_ = 0;
+  }
+
+  deque& operator=(const deque& rhs)
+  {
+    if (this != &rhs)
+    {
+      assign(rhs.begin(), rhs.end());
+    }
+    return *this;
+  }
+
+  deque& operator=(deque&& rhs) noexcept
+  {
+    deque tmp(mystl::move(rhs));
+    swap(tmp);
+    return *this;
+  }
+
+  deque& operator=(std::initializer_list<value_type> ilist)
+  {
+    assign(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~deque()
+  {
+    free_all();
+  }
+
+public:
+  // iterators
+  iterator       begin()        noexcept { return begin_; }
+  const_iterator begin()  const noexcept { return begin_; }
+  iterator       end()          noexcept { return end_; }
+  const_iterator end()    const noexcept { return end_; }
+  const_iterator cbegin() const noexcept { return begin_; }
+  const_iterator cend()   const noexcept { return end_; }
+
+  // capacity
+  bool      empty()    const noexcept { return begin_ == end_; }
+  size_type size()     const noexcept { return static_cast<size_type>(end_ - begin_); }
+  size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+
+  void resize(size_type n);
+  void resize(size_type n, const value_type& value);
+
+  // element access
+  reference       operator[](size_type n)       { return begin_[static_cast<difference_type>(n)]; }
+  const_reference operator[](size_type n) const { return begin_[static_cast<difference_type>(n)]; }
+
+  reference at(size_type n)
+  {
+    if (n >= size()) throw std::out_of_range("deque<T>::at() subscript out of range");
+    return (*this)[n];
+  }
+  const_reference at(size_type n) const
+  {
+    if (n >= size()) throw std::out_of_range("deque<T>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  reference       front()       { return *begin_; }
+  const_reference front() const { return *begin_; }
+  reference       back()        { return *(end_ - 1); }
+  const_reference back()  const { return *(end_ - 1); }
+
+  // assign
+  void assign(size_type n, const value_type& value);
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void assign(Iter first, Iter last)
+  {
+    assign_aux(first, last, iterator_category(first));
+  }
+
+  void assign(std::initializer_list<value_type> ilist)
+  {
+    assign_aux(ilist.begin(), ilist.end(), forward_iterator_tag());
+  }
+
+  // emplace / push / pop at both ends
+  template <class... Args>
+  void emplace_front(Args&&... args);
+
+  template <class... Args>
+  void emplace_back(Args&&... args);
+
+  void push_front(const value_type& value) { emplace_front(value); }
+  void push_front(value_type&& value)      { emplace_front(mystl::move(value)); }
+  void push_back(const value_type& value)  { emplace_back(value); }
+  void push_back(value_type&& value)       { emplace_back(mystl::move(value)); }
+
+  void pop_front();
+  void pop_back();
+
+  // insert in the middle, the shorter side of pos is moved
+  template <class... Args>
+  iterator emplace(const_iterator pos, Args&&... args);
+
+  iterator insert(const_iterator pos, const value_type& value)
+  {
+    return emplace(pos, value);
+  }
+  iterator insert(const_iterator pos, value_type&& value)
+  {
+    return emplace(pos, mystl::move(value));
+  }
+
+  iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  iterator insert(const_iterator pos, Iter first, Iter last)
+  {
+    return range_insert(to_iterator(pos), first, last, iterator_category(first));
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+  {
+    return range_insert(to_iterator(pos), ilist.begin(), ilist.end(), forward_iterator_tag());
+  }
+
+  // erase / clear
+  iterator erase(const_iterator pos);
+  iterator erase(const_iterator first, const_iterator last);
+
+  // the chunk of the first element is kept
+  void clear() noexcept;
+
+  void swap(deque& rhs) noexcept
+  {
+    mystl::swap(begin_, rhs.begin_);
+    mystl::swap(end_, rhs.end_);
+    mystl::swap(map_, rhs.map_);
+    mystl::swap(map_size_, rhs.map_size_);
+  }
+
+private:
+  // helper functions
+  static iterator to_iterator(const_iterator it)
+  {
+    return it.node == nullptr ? iterator() : iterator(const_cast<T*>(it.cur), it.node);
+  }
+
+  template <class... Args>
+  void emplace_front_aux(Args&&... args);
+  template <class... Args>
+  void emplace_back_aux(Args&&... args);
+
+  void map_init(size_type n);
+  void create_buffers(map_pointer nstart, map_pointer nfinish);
+  void destroy_buffers(map_pointer nstart, map_pointer nfinish) noexcept;
+  void free_all() noexcept;
+
+  void reserve_map_at_front(size_type nodes);
+  void reserve_map_at_back(size_type nodes);
+  void reallocate_map(size_type nodes_to_add, bool add_at_front);
+
+  iterator reserve_elements_at_front(size_type n);
+  iterator reserve_elements_at_back(size_type n);
+
+  template <class IIter>
+  void range_init(IIter first, IIter last, input_iterator_tag);
+  template <class FIter>
+  void range_init(FIter first, FIter last, forward_iterator_tag);
+
+  template <class IIter>
+  void assign_aux(IIter first, IIter last, input_iterator_tag);
+  template <class FIter>
+  void assign_aux(FIter first, FIter last, forward_iterator_tag);
+
+  template <class... Args>
+  iterator insert_aux(iterator pos, Args&&... args);
+
+  void default_append(size_type n);
+
+  template <class IIter>
+  iterator range_insert(iterator pos, IIter first, IIter last, input_iterator_tag);
+  template <class FIter>
+  iterator range_insert(iterator pos, FIter first, FIter last, forward_iterator_tag);
+};
+
+template <class T, class Alloc>
+const size_t deque<T, Alloc>::buffer_size;
+
+template <class T, class Alloc>
+const size_t deque<T, Alloc>::initial_map_size;
+
+/*****************************************************************************************/
+
+template <class T, class Alloc>
+void deque<T, Alloc>::resize(size_type n)
+{
+  const auto len = size();
+  if (n < len) erase(begin_ + static_cast<difference_type>(n), end_);
+  else         default_append(n - len);
+}
+
+template <class T, class Alloc>
+void deque<T, Alloc>::resize(size_type n, const value_type& value)
+{
+  const auto len = size();
+  if (n < len) erase(begin_ + static_cast<difference_type>(n), end_);
+  else         insert(end_, n - len, value);
+}
+
+template <class T, class Alloc>
+void deque<T, Alloc>::assign(size_type n, const value_type& value)
+{
+  const auto len = size();
+  if (n > len)
+  {
+    mystl::fill(begin_, end_, value);
+    insert(end_, n - len, value);
+  }
+  else
+  {
+    erase(begin_ + static_cast<difference_type>(n), end_);
+    mystl::fill(begin_, end_, value);
+  }
+}
+
+template <class T, class Alloc>
+template <class... Args>
+void deque<T, Alloc>::emplace_front(Args&&... args)
+{
+  if (begin_.cur != begin_.first)
+  {
+    data_allocator::construct(begin_.cur - 1, mystl::forward<Args>(args)...);
+    --begin_.cur;
+  }
+  else
+  {
+    emplace_front_aux(mystl::forward<Args>(args)...);
+  }
+}
+
+// the chunk after the last element is allocated as soon as the last slot of
+// a chunk is taken, so end_ always points into a chunk
+template <class T, class Alloc>
+template <class... Args>
+void deque<T, Alloc>::emplace_back(Args&&... args)
+{
+  if (end_.last - end_.cur > 1)
+  {
+    data_allocator::construct(end_.cur, mystl::forward<Args>(args)...);
+    ++end_.cur;
+  }
+  else
+  {
+    emplace_back_aux(mystl::forward<Args>(args)...);
+  }
+}
+
+template <class T, class Alloc>
+void deque<T, Alloc>::pop_front()
+{
+  data_allocator::destroy(begin_.cur);
+  if (begin_.cur != begin_.last - 1)
+  {
+    ++begin_.cur;
+    return;
+  }
+  data_allocator::deallocate(begin_.first, buffer_size);
+  begin_.set_node(begin_.node + 1);
+  begin_.cur = begin_.first;
+}
+
+template <class T, class Alloc>
+void deque<T, Alloc>::pop_back()
+{
+  if (end_.cur != end_.first)
+  {
+    --end_.cur;
+    data_allocator::destroy(end_.cur);
+    return;
+  }
+  data_allocator::deallocate(end_.first, buffer_size);
+  end_.set_node(end_.node - 1);
+  end_.cur = end_.last - 1;
+  data_allocator::destroy(end_.cur);
+}
+
+template <class T, class Alloc>
+template <class... Args>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::emplace(const_iterator pos, Args&&... args)
+{
+  if (pos.cur == begin_.cur)
+  {
+    emplace_front(mystl::forward<Args>(args)...);
+    return begin_;
+  }
+  if (pos.cur == end_.cur)
+  {
+    emplace_back(mystl::forward<Args>(args)...);
+    return end_ - 1;
+  }
+  return insert_aux(to_iterator(pos), mystl::forward<Args>(args)...);
+}
+
+template <class T, class Alloc>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::insert(const_iterator pos, size_type n, const value_type& value)
+{
+  const auto before = pos - begin_;
+  if (n == 0) return begin_ + before;
+  if (pos.cur == begin_.cur)
+  {
+    const auto new_begin = reserve_elements_at_front(n);
+    try
+    {
+      mystl::uninitialized_fill(new_begin, begin_, value);
+    }
+    catch (...)
+    {
+      destroy_buffers(new_begin.node, begin_.node - 1);
+      throw;
+    }
+    begin_ = new_begin;
+    return begin_;
+  }
+  if (pos.cur == end_.cur)
+  {
+    const auto new_end = reserve_elements_at_back(n);
+    try
+    {
+      mystl::uninitialized_fill(end_, new_end, value);
+    }
+    catch (...)
+    {
+      destroy_buffers(end_.node + 1, new_end.node);
+      throw;
+    }
+    const auto result = end_;
+    end_ = new_end;
+    return result;
+  }
+  // copy value first, it may be an element of the deque
+  const value_type value_copy(value);
+  const auto len = static_cast<difference_type>(size());
+  const auto count = static_cast<difference_type>(n);
+  if (before < len / 2)
+  {
+    insert(begin_, n, value_copy);
+    mystl::rotate(begin_, begin_ + count, begin_ + count + before);
+  }
+  else
+  {
+    insert(end_, n, value_copy);
+    mystl::rotate(begin_ + before, begin_ + len, end_);
+  }
+  return begin_ + before;
+}
+
+template <class T, class Alloc>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::erase(const_iterator pos)
+{
+  auto it = to_iterator(pos);
+  auto next = it;
+  ++next;
+  const auto before = it - begin_;
+  if (static_cast<size_type>(before) < size() / 2)
+  {
+    mystl::move_backward(begin_, it, next);
+    pop_front();
+  }
+  else
+  {
+    mystl::move(next, end_, it);
+    pop_back();
+  }
+  return begin_ + before;
+}
+
+template <class T, class Alloc>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::erase(const_iterator first, const_iterator last)
+{
+  if (first == last)
+  {
+    return to_iterator(first);
+  }
+  if (first == begin_ && last == end_)
+  {
+    clear();
+    return end_;
+  }
+  const auto n = last - first;
+  const auto before = first - begin_;
+  if (static_cast<size_type>(before) < (size() - n) / 2)
+  {
+    mystl::move_backward(begin_, to_iterator(first), to_iterator(last));
+    const auto new_begin = begin_ + n;
+    mystl::destroy(begin_, new_begin);
+    destroy_buffers(begin_.node, new_begin.node - 1);
+    begin_ = new_begin;
+  }
+  else
+  {
+    mystl::move(to_iterator(last), end_, to_iterator(first));
+    const auto new_end = end_ - n;
+    mystl::destroy(new_end, end_);
+    destroy_buffers(new_end.node + 1, end_.node);
+    end_ = new_end;
+  }
+  return begin_ + before;
+}
+
+template <class T, class Alloc>
+void deque<T, Alloc>::clear() noexcept
+{
+  if (map_ == nullptr) return;
+  for (map_pointer node = begin_.node + 1; node < end_.node; ++node)
+  {
+    data_allocator::destroy(*node, *node + buffer_size);
+  }
+  if (begin_.node != end_.node)
+  {
+    data_allocator::destroy(begin_.cur, begin_.last);
+    data_allocator::destroy(end_.first, end_.cur);
+  }
+  else
+  {
+    data_allocator::destroy(begin_.cur, end_.cur);
+  }
+  destroy_buffers(begin_.node + 1, end_.node);
+  end_ = begin_;
+}
+
+/*****************************************************************************************/
+// helper function
+
+template <class T, class Alloc>
+template <class... Args>
+void deque<T, Alloc>::emplace_front_aux(Args&&... args)
+{
+  if (map_ == nullptr) map_init(0);
+  reserve_map_at_front(1);
+  *(begin_.node - 1) = data_allocator::allocate(buffer_size);
+  try
+  {
+    data_allocator::construct(*(begin_.node - 1) + (buffer_size - 1),
+                              mystl::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    data_allocator::deallocate(*(begin_.node - 1), buffer_size);
+    throw;
+  }
+  begin_.set_node(begin_.node - 1);
+  begin_.cur = begin_.last - 1;
+}
+
+template <class T, class Alloc>
+template <class... Args>
+void deque<T, Alloc>::emplace_back_aux(Args&&... args)
+{
+  if (map_ == nullptr)
+  {
+    map_init(0);
+    data_allocator::construct(end_.cur, mystl::forward<Args>(args)...);
+    ++end_.cur;
+    return;
+  }
+  reserve_map_at_back(1);
+  *(end_.node + 1) = data_allocator::allocate(buffer_size);
+  try
+  {
+    data_allocator::construct(end_.cur, mystl::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    data_allocator::deallocate(*(end_.node + 1), buffer_size);
+    throw;
+  }
+  end_.set_node(end_.node + 1);
+  end_.cur = end_.first;
+}
+
+// make a map and the chunks for n elements, centred in the map
+template <class T, class Alloc>
+void deque<T, Alloc>::map_init(size_type n)
+{
+  const size_type nodes = n / buffer_size + 1;
+  map_size_ = nodes + 2 > initial_map_size ? nodes + 2 : static_cast<size_type>(initial_map_size);
+  map_ = map_allocator::allocate(map_size_);
+  const map_pointer nstart = map_ + (map_size_ - nodes) / 2;
+  const map_pointer nfinish = nstart + nodes - 1;
+  try
+  {
+    create_buffers(nstart, nfinish);
+  }
+  catch (...)
+  {
+    map_allocator::deallocate(map_, map_size_);
+    map_ = nullptr;
+    map_size_ = 0;
+    throw;
+  }
+  begin_.set_node(nstart);
+  begin_.cur = begin_.first;
+  end_.set_node(nfinish);
+  end_.cur = end_.first + n % buffer_size;
+}
+
+// allocate the chunks of [nstart, nfinish]
+template <class T, class Alloc>
+void deque<T, Alloc>::create_buffers(map_pointer nstart, map_pointer nfinish)
+{
+  map_pointer cur = nstart;
+  try
+  {
+    for (; cur <= nfinish; ++cur)
+    {
+      *cur = data_allocator::allocate(buffer_size);
+    }
+  }
+  catch (...)
+  {
+    while (cur != nstart)
+    {
+      --cur;
+      data_allocator::deallocate(*cur, buffer_size);
+    }
+    throw;
+  }
+}
+
+// free the chunks of [nstart, nfinish]
+template <class T, class Alloc>
+void deque<T, Alloc>::destroy_buffers(map_pointer nstart, map_pointer nfinish) noexcept
+{
+  for (map_pointer cur = nstart; cur <= nfinish; ++cur)
+  {
+    data_allocator::deallocate(*cur, buffer_size);
+  }
+}
+
+template <class T, class Alloc>
+void deque<T, Alloc>::free_all() noexcept
+{
+  if (map_ == nullptr) return;
+  clear();
+  data_allocator::deallocate(begin_.first, buffer_size);
+  map_allocator::deallocate(map_, map_size_);
+  begin_ = iterator();
+  end_ = iterator();
+  map_ = nullptr;
+  map_size_ = 0;
+}
+
+template <class T, class Alloc>
+void deque<T, Alloc>::reserve_map_at_front(size_type nodes)
+{
+  if (nodes > static_cast<size_type>(begin_.node - map_))
+  {
+    reallocate_map(nodes, true);
+  }
+}
+
+template <class T, class Alloc>
+void deque<T, Alloc>::reserve_map_at_back(size_type nodes)
+{
+  if (nodes + 1 > map_size_ - static_cast<size_type>(end_.node - map_))
+  {
+    reallocate_map(nodes, false);
+  }
+}
+
+// only the chunk pointers move, the elements stay where they are; a map more
+// than twice as large as needed is recentred instead of grown
+template <class T, class Alloc>
+void deque<T, Alloc>::reallocate_map(size_type nodes_to_add, bool add_at_front)
+{
+  const size_type old_nodes = static_cast<size_type>(end_.node - begin_.node) + 1;
+  const size_type new_nodes = old_nodes + nodes_to_add;
+  map_pointer new_start;
+  if (map_size_ > 2 * new_nodes)
+  {
+    new_start = map_ + (map_size_ - new_nodes) / 2 + (add_at_front ? nodes_to_add : 0);
+    std::memmove(new_start, begin_.node, old_nodes * sizeof(pointer));
+  }
+  else
+  {
+    const size_type new_size = map_size_ + (map_size_ > nodes_to_add ? map_size_ : nodes_to_add) + 2;
+    map_pointer new_map = map_allocator::allocate(new_size);
+    new_start = new_map + (new_size - new_nodes) / 2 + (add_at_front ? nodes_to_add : 0);
+    std::memcpy(new_start, begin_.node, old_nodes * sizeof(pointer));
+    map_allocator::deallocate(map_, map_size_);
+    map_ = new_map;
+    map_size_ = new_size;
+  }
+  begin_.node = new_start;
+  end_.node = new_start + old_nodes - 1;
+}
+
+// make room for n elements before begin_, return the new begin
+template <class T, class Alloc>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::reserve_elements_at_front(size_type n)
+{
+  if (map_ == nullptr) map_init(0);
+  const size_type vacancies = static_cast<size_type>(begin_.cur - begin_.first);
+  if (n > vacancies)
+  {
+    const size_type new_nodes = (n - vacancies + buffer_size - 1) / buffer_size;
+    reserve_map_at_front(new_nodes);
+    create_buffers(begin_.node - new_nodes, begin_.node - 1);
+  }
+  return begin_ - static_cast<difference_type>(n);
+}
+
+// make room for n elements after end_, return the new end
+template <class T, class Alloc>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::reserve_elements_at_back(size_type n)
+{
+  if (map_ == nullptr) map_init(0);
+  const size_type vacancies = static_cast<size_type>(end_.last - end_.cur) - 1;
+  if (n > vacancies)
+  {
+    const size_type new_nodes = (n - vacancies + buffer_size - 1) / buffer_size;
+    reserve_map_at_back(new_nodes);
+    create_buffers(end_.node + 1, end_.node + new_nodes);
+  }
+  return end_ + static_cast<difference_type>(n);
+}
+
+template <class T, class Alloc>
+template <class IIter>
+void deque<T, Alloc>::range_init(IIter first, IIter last, input_iterator_tag)
+{
+  try
+  {
+    for (; first != last; ++first) emplace_back(*first);
+  }
+  catch (...)
+  {
+    free_all();
+    throw;
+  }
+}
+
+template <class T, class Alloc>
+template <class FIter>
+void deque<T, Alloc>::range_init(FIter first, FIter last, forward_iterator_tag)
+{
+  map_init(static_cast<size_type>(mystl::distance(first, last)));
+  try
+  {
+    mystl::uninitialized_copy(first, last, begin_);
+  }
+  catch (...)
+  {
+    free_all();
+    throw;
+  }
+}
+
+template <class T, class Alloc>
+template <class IIter>
+void deque<T, Alloc>::assign_aux(IIter first, IIter last, input_iterator_tag)
+{
+  auto cur = begin_;
+  for (; first != last && cur != end_; ++first, ++cur) *cur = *first;
+  if (first == last) erase(cur, end_);
+  else               range_insert(end_, first, last, input_iterator_tag());
+}
+
+template <class T, class Alloc>
+template <class FIter>
+void deque<T, Alloc>::assign_aux(FIter first, FIter last, forward_iterator_tag)
+{
+  const auto len = size();
+  const auto n = static_cast<size_type>(mystl::distance(first, last));
+  if (n <= len)
+  {
+    erase(mystl::copy(first, last, begin_), end_);
+  }
+  else
+  {
+    auto mid = first;
+    mystl::advance(mid, len);
+    mystl::copy(first, mid, begin_);
+    range_insert(end_, mid, last, forward_iterator_tag());
+  }
+}
+
+// open a slot at pos by moving the shorter side by one
+template <class T, class Alloc>
+template <class... Args>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::insert_aux(iterator pos, Args&&... args)
+{
+  // build the value first, args may refer to an element
+  value_type value(mystl::forward<Args>(args)...);
+  const auto before = pos - begin_;
+  if (static_cast<size_type>(before) < size() / 2)
+  {
+    emplace_front(mystl::move(front()));
+    pos = begin_ + before;
+    mystl::move(begin_ + 2, pos + 1, begin_ + 1);
+  }
+  else
+  {
+    emplace_back(mystl::move(back()));
+    pos = begin_ + before;
+    mystl::move_backward(pos, end_ - 2, end_ - 1);
+  }
+  *pos = mystl::move(value);
+  return pos;
+}
+
+template <class T, class Alloc>
+void deque<T, Alloc>::default_append(size_type n)
+{
+  if (n == 0) return;
+  const auto new_end = reserve_elements_at_back(n);
+  try
+  {
+    mystl::uninitialized_value_construct_n(end_, n);
+  }
+  catch (...)
+  {
+    destroy_buffers(end_.node + 1, new_end.node);
+    throw;
+  }
+  end_ = new_end;
+}
+
+// a single pass range is appended and rotated into place
+template <class T, class Alloc>
+template <class IIter>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::range_insert(iterator pos, IIter first, IIter last, input_iterator_tag)
+{
+  const auto before = pos - begin_;
+  const auto old_size = static_cast<difference_type>(size());
+  for (; first != last; ++first) emplace_back(*first);
+  mystl::rotate(begin_ + before, begin_ + old_size, end_);
+  return begin_ + before;
+}
+
+// the new elements are built at the end nearer to pos, then rotated into place
+template <class T, class Alloc>
+template <class FIter>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::range_insert(iterator pos, FIter first, FIter last, forward_iterator_tag)
+{
+  const auto before = pos - begin_;
+  const auto len = static_cast<difference_type>(size());
+  const auto n = mystl::distance(first, last);
+  if (n == 0) return pos;
+  if (before < len / 2)
+  {
+    const auto new_begin = reserve_elements_at_front(static_cast<size_type>(n));
+    try
+    {
+      mystl::uninitialized_copy(first, last, new_begin);
+    }
+    catch (...)
+    {
+      destroy_buffers(new_begin.node, begin_.node - 1);
+      throw;
+    }
+    begin_ = new_begin;
+    mystl::rotate(begin_, begin_ + n, begin_ + n + before);
+  }
+  else
+  {
+    const auto new_end = reserve_elements_at_back(static_cast<size_type>(n));
+    try
+    {
+      mystl::uninitialized_copy(first, last, end_);
+    }
+    catch (...)
+    {
+      destroy_buffers(end_.node + 1, new_end.node);
+      throw;
+    }
+    end_ = new_end;
+    mystl::rotate(begin_ + before, begin_ + len, end_);
+  }
+  return begin_ + before;
+}
+
+/*****************************************************************************************/
+// overload comparison operators
+
+template <class T, class Alloc>
+bool operator==(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
+{
+  return lhs.size() == rhs.size() &&
+    mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Alloc>
+bool operator<(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, class Alloc>
+bool operator!=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, class Alloc>
+bool operator>(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, class Alloc>
+bool operator<=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, class Alloc>
+bool operator>=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// overload mystl::swap
+template <class T, class Alloc>
+void swap(deque<T, Alloc>& lhs, deque<T, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_DEQUE_H_
@@ -0,0 +1,516 @@
+#ifndef _LITESTL_FLAT_MAP_H_
+#define _LITESTL_FLAT_MAP_H_
+
+// sorted associative container on contiguous storage
+// keys and mapped values live in two vectors kept in key order, so a lookup
+// is a binary search over the keys alone and iteration is a linear scan;
+// inserting or erasing one element moves the elements after it, bulk insert
+// sorts the new elements and merges them in one pass
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "iterator.h"
+#include "algobase.h"   // mystl::branchless_lower_bound
+#include "algo_set.h"   // mystl::set_union
+#include "algo_sort.h"  // mystl::stable_sort
+#include "functional.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl
+{
+
+// iterator of flat_map, it walks the key and the mapped arrays together
+// its reference is a pair of references, T is const for const_iterator
+template <class Key, class T>
+struct flat_map_iterator
+{
+  typedef random_access_iterator_tag            iterator_category;
+  typedef mystl::pair<Key, typename std::remove_const<T>::type> value_type;
+  typedef ptrdiff_t                             difference_type;
+  typedef mystl::pair<const Key&, T&>           reference;
+
+  // operator-> needs an address, so the pair of references is kept in it
+  struct pointer
+  {
+    reference ref;
+    const reference* operator->() const { return &ref; }
+  };
+
+  const Key* key;
+  T*         value;
+
+  flat_map_iterator() noexcept :key(nullptr), value(nullptr) {}
+  flat_map_iterator(const Key* k, T* v) noexcept :key(k), value(v) {}
+
+  // iterator to const_iterator
+  template <class U, typename std::enable_if<
+    std::is_same<const U, T>::value, int>::type = 0>
+  flat_map_iterator(const flat_map_iterator<Key, U>& rhs) noexcept
+    :key(rhs.key), value(rhs.value) {}
+
+  reference operator*()  const { return reference(*key, *value); }
+  pointer   operator->() const { return pointer{ **this }; }
+  reference operator[](difference_type n) const { return reference(key[n], value[n]); }
+
+  flat_map_iterator& operator++()    { ++key; ++value; return *this; }
+  flat_map_iterator& operator--()    { --key; --value; return *this; }
+  flat_map_iterator  operator++(int) { flat_map_iterator tmp = *this; ++*this; return tmp; }
+  flat_map_iterator  operator--(int) { flat_map_iterator tmp = *this; --*this; return tmp; }
+
+  flat_map_iterator& operator+=(difference_type n) { key += n; value += n; return *this; }
+  flat_map_iterator& operator-=(difference_type n) { key -= n; value -= n; return *this; }
+  flat_map_iterator  operator+(difference_type n) const { return flat_map_iterator(key + n, value + n); }
+  flat_map_iterator  operator-(difference_type n) const { return flat_map_iterator(key - n, value - n); }
+
+  difference_type operator-(const flat_map_iterator& rhs) const { return key - rhs.key; }
+
+  bool operator==(const flat_map_iterator& rhs) const { return key == rhs.key; }
+  bool operator!=(const flat_map_iterator& rhs) const { return key != rhs.key; }
+  bool operator< (const flat_map_iterator& rhs) const { return key < rhs.key; }
+  bool operator> (const flat_map_iterator& rhs) const { return key > rhs.key; }
+  bool operator<=(const flat_map_iterator& rhs) const { return key <= rhs.key; }
+  bool operator>=(const flat_map_iterator& rhs) const { return key >= rhs.key; }
+};
+
+// input of the bulk insert merge, it moves from a key and a mapped array
+template <class Key, class T>
+struct flat_map_merge_source
+{
+  typedef input_iterator_tag           iterator_category;
+  typedef mystl::pair<Key, T>          value_type;
+  typedef ptrdiff_t                    difference_type;
+  typedef void                         pointer;
+  typedef mystl::pair<Key&&, T&&>      reference;
+
+  Key* key;
+  T*   value;
+
+  flat_map_merge_source(Key* k, T* v) noexcept :key(k), value(v) {}
+
+  reference operator*() const
+  {
+    return reference(mystl::move(*key), mystl::move(*value));
+  }
+
+  flat_map_merge_source& operator++() { ++key; ++value; return *this; }
+
+  bool operator==(const flat_map_merge_source& rhs) const { return key == rhs.key; }
+  bool operator!=(const flat_map_merge_source& rhs) const { return key != rhs.key; }
+};
+
+// output of the bulk insert merge, it appends to a key and a mapped array
+template <class Key, class T>
+struct flat_map_merge_sink
+{
+  typedef output_iterator_tag iterator_category;
+  typedef void                value_type;
+  typedef void                difference_type;
+  typedef void                pointer;
+  typedef void                reference;
+
+  mystl::vector<Key>* keys;
+  mystl::vector<T>*   values;
+
+  flat_map_merge_sink(mystl::vector<Key>& k, mystl::vector<T>& v) noexcept
+    :keys(&k), values(&v) {}
+
+  flat_map_merge_sink& operator=(mystl::pair<Key&&, T&&>&& x)
+  {
+    keys->push_back(static_cast<Key&&>(x.first));
+    values->push_back(static_cast<T&&>(x.second));
+    return *this;
+  }
+
+  flat_map_merge_sink& operator*()  { return *this; }
+  flat_map_merge_sink& operator++() { return *this; }
+};
+
+// template class: flat_map
+// keys are unique, the first of several equal keys in a bulk insert wins and
+// keys already in the map are never replaced
+template <class Key, class T, class Compare = mystl::less<Key>>
+class flat_map
+{
+public:
+  typedef Key                                   key_type;
+  typedef T                                     mapped_type;
+  typedef mystl::pair<Key, T>                   value_type;
+  typedef Compare                               key_compare;
+  typedef mystl::vector<Key>                    key_container_type;
+  typedef mystl::vector<T>                      mapped_container_type;
+
+  typedef flat_map_iterator<Key, T>             iterator;
+  typedef flat_map_iterator<Key, const T>       const_iterator;
+  typedef typename iterator::reference          reference;
+  typedef typename const_iterator::reference    const_reference;
+  typedef size_t                                size_type;
+  typedef ptrdiff_t                             difference_type;
+
+  // compare two elements by key
+  class value_compare
+  {
+    friend class flat_map;
+  private:
+    Compare comp;
+    value_compare(Compare c) :comp(c) {}
+  public:
+    template <class P1, class P2>
+    bool operator()(const P1& lhs, const P2& rhs) const
+    {
+      return comp(lhs.first, rhs.first);
+    }
+  };
+
+private:
+  key_container_type    keys_;
+  mapped_container_type values_;
+  key_compare           comp_;
+
+public:
+  // construct, copy, move and destroy
+  flat_map() :keys_(), values_(), comp_() {}
+
+  explicit flat_map(const key_compare& comp) :keys_(), values_(), comp_(comp) {}
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  flat_map(Iter first, Iter last, const key_compare& comp = key_compare())
+    :keys_(), values_(), comp_(comp)
+  {
+    insert(first, last);
+  }
+
+  flat_map(std::initializer_list<value_type> ilist,
+           const key_compare& comp = key_compare())
+    :keys_(), values_(), comp_(comp)
+  {
+    insert(ilist.begin(), ilist.end());
+  }
+
+  flat_map(const flat_map& rhs) = default;
+  flat_map(flat_map&& rhs) = default;
+
+  flat_map& operator=(const flat_map& rhs) = default;
+  flat_map& operator=(flat_map&& rhs) = default;
+
+  flat_map& operator=(std::initializer_list<value_type> ilist)
+  {
+    clear();
+    insert(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~flat_map() = default;
+
+public:
+  // iterators
+  iterator       begin()        noexcept { return iterator(keys_.begin(), values_.begin()); }
+  const_iterator begin()  const noexcept { return const_iterator(keys_.begin(), values_.begin()); }
+  iterator       end()          noexcept { return iterator(keys_.end(), values_.end()); }
+  const_iterator end()    const noexcept { return const_iterator(keys_.end(), values_.end()); }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend()   const noexcept { return end(); }
+
+  // the underlying arrays, in key order
+  const key_container_type&    keys()   const noexcept { return keys_; }
+  const mapped_container_type& values() const noexcept { return values_; }
+
+  // capacity
+  bool      empty()    const noexcept { return keys_.empty(); }
+  size_type size()     const noexcept { return keys_.size(); }
+  size_type max_size() const noexcept { return values_.max_size() < keys_.max_size() ? values_.max_size() : keys_.max_size(); }
+
+  void reserve(size_type n)
+  {
+    keys_.reserve(n);
+    values_.reserve(n);
+  }
+
+  void shrink_to_fit()
+  {
+    keys_.shrink_to_fit();
+    values_.shrink_to_fit();
+  }
+
+  // element access
+  mapped_type& operator[](const key_type& key)
+  {
+    return try_emplace(key).first->second;
+  }
+  mapped_type& operator[](key_type&& key)
+  {
+    return try_emplace(mystl::move(key)).first->second;
+  }
+
+  mapped_type& at(const key_type& key)
+  {
+    auto it = find(key);
+    if (it == end()) throw std::out_of_range("flat_map<Key, T> no such element exists");
+    return *it.value;
+  }
+  const mapped_type& at(const key_type& key) const
+  {
+    auto it = find(key);
+    if (it == end()) throw std::out_of_range("flat_map<Key, T> no such element exists");
+    return *it.value;
+  }
+
+  // lookup
+  iterator       lower_bound(const key_type& key)       { return at_index(lower_index(key)); }
+  const_iterator lower_bound(const key_type& key) const { return at_index(lower_index(key)); }
+  iterator       upper_bound(const key_type& key)       { return at_index(upper_index(key)); }
+  const_iterator upper_bound(const key_type& key) const { return at_index(upper_index(key)); }
+
+  iterator find(const key_type& key)
+  {
+    const auto i = lower_index(key);
+    return i != size() && !comp_(key, keys_[i]) ? at_index(i) : end();
+  }
+  const_iterator find(const key_type& key) const
+  {
+    const auto i = lower_index(key);
+    return i != size() && !comp_(key, keys_[i]) ? at_index(i) : end();
+  }
+
+  size_type count(const key_type& key) const
+  {
+    return find(key) == end() ? 0 : 1;
+  }
+
+  mystl::pair<iterator, iterator> equal_range(const key_type& key)
+  {
+    auto it = find(key);
+    return mystl::pair<iterator, iterator>(it, it == end() ? it : it + 1);
+  }
+  mystl::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+  {
+    auto it = find(key);
+    return mystl::pair<const_iterator, const_iterator>(it, it == end() ? it : it + 1);
+  }
+
+  // modify
+  template <class... Args>
+  mystl::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+  {
+    return try_emplace_key(key, mystl::forward<Args>(args)...);
+  }
+  template <class... Args>
+  mystl::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+  {
+    return try_emplace_key(mystl::move(key), mystl::forward<Args>(args)...);
+  }
+
+  template <class... Args>
+  mystl::pair<iterator, bool> emplace(Args&&... args)
+  {
+    value_type value(mystl::forward<Args>(args)...);
+    return try_emplace_key(mystl::move(value.first), mystl::move(value.second));
+  }
+
+  mystl::pair<iterator, bool> insert(const value_type& value)
+  {
+    return try_emplace_key(value.first, value.second);
+  }
+  mystl::pair<iterator, bool> insert(value_type&& value)
+  {
+    return try_emplace_key(mystl::move(value.first), mystl::move(value.second));
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void insert(Iter first, Iter last);
+
+  void insert(std::initializer_list<value_type> ilist)
+  {
+    insert(ilist.begin(), ilist.end());
+  }
+
+  iterator erase(const_iterator pos)
+  {
+    return erase(pos, pos + 1);
+  }
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    const auto i = first.key - keys_.begin();
+    const auto j = last.key - keys_.begin();
+    keys_.erase(keys_.begin() + i, keys_.begin() + j);
+    values_.erase(values_.begin() + i, values_.begin() + j);
+    return at_index(static_cast<size_type>(i));
+  }
+  size_type erase(const key_type& key)
+  {
+    auto it = find(key);
+    if (it == end()) return 0;
+    erase(it);
+    return 1;
+  }
+
+  void clear() noexcept
+  {
+    keys_.clear();
+    values_.clear();
+  }
+
+  void swap(flat_map& rhs) noexcept
+  {
+    keys_.swap(rhs.keys_);
+    values_.swap(rhs.values_);
+    mystl::swap(comp_, rhs.comp_);
+  }
+
+  key_compare   key_comp()   const { return comp_; }
+  value_compare value_comp() const { return value_compare(comp_); }
+
+private:
+  // helper functions
+  iterator at_index(size_type i)
+  {
+    return iterator(keys_.begin() + i, values_.begin() + i);
+  }
+  const_iterator at_index(size_type i) const
+  {
+    return const_iterator(keys_.begin() + i, values_.begin() + i);
+  }
+
+  size_type lower_index(const key_type& key) const
+  {
+    return static_cast<size_type>(
+      mystl::branchless_lower_bound(keys_.begin(), keys_.end(), key, comp_) - keys_.begin());
+  }
+  size_type upper_index(const key_type& key) const
+  {
+    return static_cast<size_type>(
+      mystl::branchless_upper_bound(keys_.begin(), keys_.end(), key, comp_) - keys_.begin());
+  }
+
+  template <class K, class... Args>
+  mystl::pair<iterator, bool> try_emplace_key(K&& key, Args&&... args);
+};
+
+/*****************************************************************************************/
+
+// the new elements are stable sorted and deduplicated, then merged with the
+// map by set_union, which keeps the map's element when keys are equal
+template <class Key, class T, class Compare>
+template <class Iter, typename std::enable_if<
+  mystl::is_input_iterator<Iter>::value, int>::type>
+void flat_map<Key, T, Compare>::insert(Iter first, Iter last)
+{
+  mystl::vector<value_type> buf(first, last);
+  if (buf.empty()) return;
+  const value_compare vcomp(comp_);
+  mystl::stable_sort(buf.begin(), buf.end(), vcomp);
+
+  key_container_type    new_keys;
+  mapped_container_type new_values;
+  new_keys.reserve(buf.size());
+  new_values.reserve(buf.size());
+  for (auto it = buf.begin(); it != buf.end(); ++it)
+  {
+    if (!new_keys.empty() && !comp_(new_keys.back(), it->first)) continue;
+    new_keys.push_back(mystl::move(it->first));
+    new_values.push_back(mystl::move(it->second));
+  }
+
+  // all new keys after the old ones: append
+  if (empty() || comp_(keys_.back(), new_keys.front()))
+  {
+    keys_.insert(keys_.end(), mystl::make_move_iterator(new_keys.begin()),
+                 mystl::make_move_iterator(new_keys.end()));
+    values_.insert(values_.end(), mystl::make_move_iterator(new_values.begin()),
+                   mystl::make_move_iterator(new_values.end()));
+    return;
+  }
+
+  typedef flat_map_merge_source<Key, T> source;
+  key_container_type    keys;
+  mapped_container_type values;
+  keys.reserve(size() + new_keys.size());
+  values.reserve(size() + new_keys.size());
+  mystl::set_union(source(keys_.begin(), values_.begin()),
+                   source(keys_.end(), values_.end()),
+                   source(new_keys.begin(), new_values.begin()),
+                   source(new_keys.end(), new_values.end()),
+                   flat_map_merge_sink<Key, T>(keys, values), vcomp);
+  keys_.swap(keys);
+  values_.swap(values);
+}
+
+/*****************************************************************************************/
+// helper function
+
+template <class Key, class T, class Compare>
+template <class K, class... Args>
+mystl::pair<typename flat_map<Key, T, Compare>::iterator, bool>
+flat_map<Key, T, Compare>::try_emplace_key(K&& key, Args&&... args)
+{
+  const auto i = lower_index(key);
+  if (i != size() && !comp_(key, keys_[i]))
+  {
+    return mystl::make_pair(at_index(i), false);
+  }
+  values_.emplace(values_.begin() + i, mystl::forward<Args>(args)...);
+  try
+  {
+    keys_.emplace(keys_.begin() + i, mystl::forward<K>(key));
+  }
+  catch (...)
+  {
+    values_.erase(values_.begin() + i);
+    throw;
+  }
+  return mystl::make_pair(at_index(i), true);
+}
+
+/*****************************************************************************************/
+// overload comparison operators
+
+template <class Key, class T, class Compare>
+bool operator==(const flat_map<Key, T, Compare>& lhs, const flat_map<Key, T, Compare>& rhs)
+{
+  return lhs.keys() == rhs.keys() && lhs.values() == rhs.values();
+}
+
+template <class Key, class T, class Compare>
+bool operator<(const flat_map<Key, T, Compare>& lhs, const flat_map<Key, T, Compare>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class Key, class T, class Compare>
+bool operator!=(const flat_map<Key, T, Compare>& lhs, const flat_map<Key, T, Compare>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class Key, class T, class Compare>
+bool operator>(const flat_map<Key, T, Compare>& lhs, const flat_map<Key, T, Compare>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class Key, class T, class Compare>
+bool operator<=(const flat_map<Key, T, Compare>& lhs, const flat_map<Key, T, Compare>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class Key, class T, class Compare>
+bool operator>=(const flat_map<Key, T, Compare>& lhs, const flat_map<Key, T, Compare>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// overload mystl::swap
+template <class Key, class T, class Compare>
+void swap(flat_map<Key, T, Compare>& lhs, flat_map<Key, T, Compare>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_FLAT_MAP_H_
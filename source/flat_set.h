@@ -0,0 +1,284 @@
+#ifndef _LITESTL_FLAT_SET_H_
+#define _LITESTL_FLAT_SET_H_
+
+// sorted set on contiguous storage
+// the keys live in one vector kept in order, so a lookup is a binary search
+// and iteration is a linear scan; inserting or erasing one key moves the keys
+// after it, bulk insert sorts the new keys and merges them in one pass
+
+#include <cstddef>
+#include <initializer_list>
+
+#include "iterator.h"
+#include "algobase.h"   // mystl::branchless_lower_bound
+#include "algo_set.h"   // mystl::set_union
+#include "algo_sort.h"  // mystl::stable_sort
+#include "functional.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl
+{
+
+// template class: flat_set
+// keys are unique, the first of several equal keys in a bulk insert wins and
+// keys already in the set are never replaced
+template <class Key, class Compare = mystl::less<Key>>
+class flat_set
+{
+public:
+  typedef Key                       key_type;
+  typedef Key                       value_type;
+  typedef Compare                   key_compare;
+  typedef Compare                   value_compare;
+  typedef mystl::vector<Key>        container_type;
+
+  // keys cannot be modified in place, that would break the order
+  typedef const Key*                iterator;
+  typedef const Key*                const_iterator;
+  typedef const Key&                reference;
+  typedef const Key&                const_reference;
+  typedef size_t                    size_type;
+  typedef ptrdiff_t                 difference_type;
+
+private:
+  container_type keys_;
+  key_compare    comp_;
+
+public:
+  // construct, copy, move and destroy
+  flat_set() :keys_(), comp_() {}
+
+  explicit flat_set(const key_compare& comp) :keys_(), comp_(comp) {}
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  flat_set(Iter first, Iter last, const key_compare& comp = key_compare())
+    :keys_(), comp_(comp)
+  {
+    insert(first, last);
+  }
+
+  flat_set(std::initializer_list<value_type> ilist,
+           const key_compare& comp = key_compare())
+    :keys_(), comp_(comp)
+  {
+    insert(ilist.begin(), ilist.end());
+  }
+
+  flat_set(const flat_set& rhs) = default;
+  flat_set(flat_set&& rhs) = default;
+
+  flat_set& operator=(const flat_set& rhs) = default;
+  flat_set& operator=(flat_set&& rhs) = default;
+
+  flat_set& operator=(std::initializer_list<value_type> ilist)
+  {
+    clear();
+    insert(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~flat_set() = default;
+
+public:
+  // iterators
+  iterator begin()  const noexcept { return keys_.begin(); }
+  iterator end()    const noexcept { return keys_.end(); }
+  iterator cbegin() const noexcept { return keys_.begin(); }
+  iterator cend()   const noexcept { return keys_.end(); }
+
+  // the underlying array, in key order
+  const container_type& keys() const noexcept { return keys_; }
+
+  // capacity
+  bool      empty()    const noexcept { return keys_.empty(); }
+  size_type size()     const noexcept { return keys_.size(); }
+  size_type max_size() const noexcept { return keys_.max_size(); }
+
+  void reserve(size_type n) { keys_.reserve(n); }
+  void shrink_to_fit()      { keys_.shrink_to_fit(); }
+
+  // lookup
+  iterator lower_bound(const key_type& key) const
+  {
+    return mystl::branchless_lower_bound(keys_.begin(), keys_.end(), key, comp_);
+  }
+  iterator upper_bound(const key_type& key) const
+  {
+    return mystl::branchless_upper_bound(keys_.begin(), keys_.end(), key, comp_);
+  }
+
+  iterator find(const key_type& key) const
+  {
+    auto it = lower_bound(key);
+    return it != end() && !comp_(key, *it) ? it : end();
+  }
+
+  size_type count(const key_type& key) const
+  {
+    return find(key) == end() ? 0 : 1;
+  }
+
+  mystl::pair<iterator, iterator> equal_range(const key_type& key) const
+  {
+    auto it = find(key);
+    return mystl::pair<iterator, iterator>(it, it == end() ? it : it + 1);
+  }
+
+  // modify
+  template <class... Args>
+  mystl::pair<iterator, bool> emplace(Args&&... args)
+  {
+    value_type value(mystl::forward<Args>(args)...);
+    return insert(mystl::move(value));
+  }
+
+  mystl::pair<iterator, bool> insert(const value_type& value)
+  {
+    return insert_key(value);
+  }
+  mystl::pair<iterator, bool> insert(value_type&& value)
+  {
+    return insert_key(mystl::move(value));
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void insert(Iter first, Iter last);
+
+  void insert(std::initializer_list<value_type> ilist)
+  {
+    insert(ilist.begin(), ilist.end());
+  }
+
+  iterator erase(const_iterator pos)
+  {
+    return erase(pos, pos + 1);
+  }
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    const auto i = first - keys_.begin();
+    keys_.erase(keys_.begin() + i, keys_.begin() + (last - keys_.begin()));
+    return keys_.begin() + i;
+  }
+  size_type erase(const key_type& key)
+  {
+    auto it = find(key);
+    if (it == end()) return 0;
+    erase(it);
+    return 1;
+  }
+
+  void clear() noexcept { keys_.clear(); }
+
+  void swap(flat_set& rhs) noexcept
+  {
+    keys_.swap(rhs.keys_);
+    mystl::swap(comp_, rhs.comp_);
+  }
+
+  key_compare   key_comp()   const { return comp_; }
+  value_compare value_comp() const { return comp_; }
+
+private:
+  // helper functions
+  template <class K>
+  mystl::pair<iterator, bool> insert_key(K&& key)
+  {
+    auto it = lower_bound(key);
+    if (it != end() && !comp_(key, *it)) return mystl::make_pair(it, false);
+    const auto i = it - keys_.begin();
+    keys_.insert(keys_.begin() + i, mystl::forward<K>(key));
+    return mystl::make_pair(begin() + i, true);
+  }
+};
+
+/*****************************************************************************************/
+
+// the new keys are stable sorted and deduplicated, then merged with the set
+// by set_union, which keeps the set's key when keys are equal
+template <class Key, class Compare>
+template <class Iter, typename std::enable_if<
+  mystl::is_input_iterator<Iter>::value, int>::type>
+void flat_set<Key, Compare>::insert(Iter first, Iter last)
+{
+  container_type buf(first, last);
+  if (buf.empty()) return;
+  mystl::stable_sort(buf.begin(), buf.end(), comp_);
+  auto buf_end = buf.begin() + 1;
+  for (auto it = buf.begin() + 1; it != buf.end(); ++it)
+  {
+    if (!comp_(*(buf_end - 1), *it)) continue;
+    if (buf_end != it) *buf_end = mystl::move(*it);
+    ++buf_end;
+  }
+  buf.erase(buf_end, buf.end());
+
+  // all new keys after the old ones: append
+  if (empty() || comp_(keys_.back(), buf.front()))
+  {
+    keys_.insert(keys_.end(), mystl::make_move_iterator(buf.begin()),
+                 mystl::make_move_iterator(buf.end()));
+    return;
+  }
+
+  container_type keys;
+  keys.reserve(size() + buf.size());
+  mystl::set_union(mystl::make_move_iterator(keys_.begin()),
+                   mystl::make_move_iterator(keys_.end()),
+                   mystl::make_move_iterator(buf.begin()),
+                   mystl::make_move_iterator(buf.end()),
+                   mystl::back_inserter(keys), comp_);
+  keys_.swap(keys);
+}
+
+/*****************************************************************************************/
+// overload comparison operators
+
+template <class Key, class Compare>
+bool operator==(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+{
+  return lhs.keys() == rhs.keys();
+}
+
+template <class Key, class Compare>
+bool operator<(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+{
+  return lhs.keys() < rhs.keys();
+}
+
+template <class Key, class Compare>
+bool operator!=(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class Key, class Compare>
+bool operator>(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class Key, class Compare>
+bool operator<=(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class Key, class Compare>
+bool operator>=(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// overload mystl::swap
+template <class Key, class Compare>
+void swap(flat_set<Key, Compare>& lhs, flat_set<Key, Compare>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_FLAT_SET_H_
@@ -4,6 +4,8 @@
 // functor
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 
 namespace mystl
 {
@@ -193,6 +195,113 @@ struct project_second: public binary_function<Arg1, Arg2, Arg2>
   Arg2 operator()(const Arg1&, const Arg2& y) const { return y; }
 };
 
+// hash function
+
+// finalizer of MurmurHash3, every input bit flips about half of the output bits
+inline uint64_t hash_mix64(uint64_t x) noexcept
+{
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+// hash of n bytes, read 8 at a time
+inline size_t hash_bytes(const void* data, size_t n) noexcept
+{
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  uint64_t h = 0x9e3779b97f4a7c15ULL ^ (n * 0x87c37b91114253d5ULL);
+  for (; n >= 8; n -= 8, p += 8)
+  {
+    uint64_t word;
+    std::memcpy(&word, p, 8);
+    word *= 0x87c37b91114253d5ULL;
+    word = (word << 31) | (word >> 33);
+    h ^= word * 0x4cf5ad432745937fULL;
+    h = ((h << 27) | (h >> 37)) * 5 + 0x52dce729;
+  }
+  if (n != 0)
+  {
+    uint64_t word = 0;
+    std::memcpy(&word, p, n);
+    h ^= mystl::hash_mix64(word);
+  }
+  return static_cast<size_t>(mystl::hash_mix64(h));
+}
+
+// function object: hash, specialized for the types it knows
+template <class Key>
+struct hash {};
+
+// pointer: the address is mixed, its low bits are always 0
+template <class T>
+struct hash<T*>
+{
+  size_t operator()(T* p) const noexcept
+  {
+    return static_cast<size_t>(
+      mystl::hash_mix64(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p))));
+  }
+};
+
+// integer: mixed so that keys differing in the high bits spread too
+#define MYSTL_INTEGER_HASH(Type)                                           \
+template <> struct hash<Type>                                              \
+{                                                                          \
+  size_t operator()(Type x) const noexcept                                 \
+  { return static_cast<size_t>(mystl::hash_mix64(static_cast<uint64_t>(x))); } \
+};
+
+MYSTL_INTEGER_HASH(bool)
+MYSTL_INTEGER_HASH(char)
+MYSTL_INTEGER_HASH(signed char)
+MYSTL_INTEGER_HASH(unsigned char)
+MYSTL_INTEGER_HASH(wchar_t)
+MYSTL_INTEGER_HASH(char16_t)
+MYSTL_INTEGER_HASH(char32_t)
+MYSTL_INTEGER_HASH(short)
+MYSTL_INTEGER_HASH(unsigned short)
+MYSTL_INTEGER_HASH(int)
+MYSTL_INTEGER_HASH(unsigned int)
+MYSTL_INTEGER_HASH(long)
+MYSTL_INTEGER_HASH(unsigned long)
+MYSTL_INTEGER_HASH(long long)
+MYSTL_INTEGER_HASH(unsigned long long)
+
+#undef MYSTL_INTEGER_HASH
+
+// floating point: hash the bits, but 0.0 and -0.0 are equal
+template <>
+struct hash<float>
+{
+  size_t operator()(const float& x) const noexcept
+  {
+    return x == 0.0f ? 0 : mystl::hash_bytes(&x, sizeof(float));
+  }
+};
+
+template <>
+struct hash<double>
+{
+  size_t operator()(const double& x) const noexcept
+  {
+    return x == 0.0 ? 0 : mystl::hash_bytes(&x, sizeof(double));
+  }
+};
+
+template <>
+struct hash<long double>
+{
+  size_t operator()(const long double& x) const noexcept
+  {
+    // only the 10 value bytes of the x87 format, the rest is padding
+    return x == 0.0L ? 0 : mystl::hash_bytes(&x, sizeof(long double) < 10
+                                                  ? sizeof(long double) : 10);
+  }
+};
+
 } // namespace mystl
 
 #endif // !_LITESTL_FUNCTIONAL_H_
\ No newline at end of file
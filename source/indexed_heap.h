@@ -0,0 +1,319 @@
+#ifndef _LITESTL_INDEXED_HEAP_H_
+#define _LITESTL_INDEXED_HEAP_H_
+
+// addressable priority queue
+// every pushed element gets a handle, which stays valid until the element is
+// popped or erased, and its priority can be changed in place through it
+
+#include <cassert>
+#include <cstddef>
+
+#include "allocator.h"
+#include "construct.h"
+#include "functional.h" // mystl::less
+#include "util.h"
+
+namespace mystl
+{
+
+// template class: indexed_heap
+// binary heap of handles, with pos_[handle] tracking the position of every
+// handle in the heap so that it can be found and re-sifted in O(log n)
+// Compare works as in algo_heap.h: mystl::less gives the largest on top
+template <class Key, class Priority, class Compare = mystl::less<Priority>>
+class indexed_heap
+{
+public:
+  typedef Key      key_type;
+  typedef Priority priority_type;
+  typedef Compare  priority_compare;
+  typedef size_t   size_type;
+  typedef size_t   handle_type;
+
+  static const size_type npos = static_cast<size_type>(-1);
+
+private:
+  struct node
+  {
+    Key      key;
+    Priority prio;
+
+    template <class K, class P>
+    node(K&& k, P&& p)
+      :key(mystl::forward<K>(k)), prio(mystl::forward<P>(p)) {}
+  };
+
+  node*      nodes_;     // element of every handle
+  size_type* heap_;      // heap_[i]: handle at heap position i
+  size_type* pos_;       // pos_[h]: heap position of handle h, npos if free
+  size_type* free_;      // stack of freed handles
+  size_type  size_;      // number of elements
+  size_type  nfree_;     // number of freed handles
+  size_type  slots_;     // number of handles ever given out
+  size_type  cap_;       // allocated handles
+  Compare    comp_;
+
+public:
+  // construct, copy and destroy
+  explicit indexed_heap(const Compare& comp = Compare())
+    :nodes_(nullptr), heap_(nullptr), pos_(nullptr), free_(nullptr),
+    size_(0), nfree_(0), slots_(0), cap_(0), comp_(comp) {}
+
+  indexed_heap(indexed_heap&& rhs) noexcept
+    :nodes_(rhs.nodes_), heap_(rhs.heap_), pos_(rhs.pos_), free_(rhs.free_),
+    size_(rhs.size_), nfree_(rhs.nfree_), slots_(rhs.slots_), cap_(rhs.cap_),
+    comp_(rhs.comp_)
+  {
+    rhs.nodes_ = nullptr;
+    rhs.heap_ = rhs.pos_ = rhs.free_ = nullptr;
+    rhs.size_ = rhs.nfree_ = rhs.slots_ = rhs.cap_ = 0;
+  }
+
+  indexed_heap& operator=(indexed_heap&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      indexed_heap temp(mystl::move(rhs));
+      swap(temp);
+    }
+    return *this;
+  }
+
+  ~indexed_heap()
+  {
+    clear();
+    deallocate_all();
+  }
+
+  void swap(indexed_heap& rhs) noexcept
+  {
+    mystl::swap(nodes_, rhs.nodes_);
+    mystl::swap(heap_, rhs.heap_);
+    mystl::swap(pos_, rhs.pos_);
+    mystl::swap(free_, rhs.free_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(nfree_, rhs.nfree_);
+    mystl::swap(slots_, rhs.slots_);
+    mystl::swap(cap_, rhs.cap_);
+    mystl::swap(comp_, rhs.comp_);
+  }
+
+public:
+  // capacity
+  bool      empty() const noexcept { return size_ == 0; }
+  size_type size()  const noexcept { return size_; }
+
+  void reserve(size_type n);
+
+  // access
+  const Key&      top()          const { return nodes_[heap_[0]].key; }
+  const Priority& top_priority() const { return nodes_[heap_[0]].prio; }
+  handle_type     top_handle()   const { return heap_[0]; }
+
+  bool contains(handle_type h) const noexcept
+  {
+    return h < slots_ && pos_[h] != npos;
+  }
+  const Key&      key(handle_type h)      const { return nodes_[h].key; }
+  const Priority& priority(handle_type h) const { return nodes_[h].prio; }
+
+  // modify
+  template <class K, class P>
+  handle_type push(K&& key, P&& prio);
+
+  void pop()
+  {
+    erase(heap_[0]);
+  }
+
+  void erase(handle_type h);
+
+  // set the priority of h and move it up or down as needed
+  template <class P>
+  void update(handle_type h, P&& prio);
+
+  // update for a priority not greater / not less than the current one by
+  // mystl::less, whatever Compare puts on top: with mystl::greater, as for
+  // shortest paths, decrease_key moves the element towards the top
+  // debug builds assert the direction
+  template <class P>
+  void decrease_key(handle_type h, P&& prio)
+  {
+    assert(!mystl::less<Priority>()(nodes_[h].prio, prio) &&
+           "decrease_key to a greater priority");
+    update(h, mystl::forward<P>(prio));
+  }
+  template <class P>
+  void increase_key(handle_type h, P&& prio)
+  {
+    assert(!mystl::less<Priority>()(prio, nodes_[h].prio) &&
+           "increase_key to a smaller priority");
+    update(h, mystl::forward<P>(prio));
+  }
+
+  void clear();
+
+private:
+  void sift_up(size_type holeIdx, handle_type h);
+  void sift_down(size_type holeIdx, handle_type h);
+  void deallocate_all();
+
+private:
+  indexed_heap(const indexed_heap&);
+
+  void operator=(const indexed_heap&);
+};
+
+template <class Key, class Priority, class Compare>
+const typename indexed_heap<Key, Priority, Compare>::size_type
+indexed_heap<Key, Priority, Compare>::npos;
+
+// reserve room for n handles
+template <class Key, class Priority, class Compare>
+void indexed_heap<Key, Priority, Compare>::reserve(size_type n)
+{
+  if (n <= cap_) return;
+  node*      nodes = mystl::allocator<node>::allocate(n);
+  size_type* heap  = mystl::allocator<size_type>::allocate(n);
+  size_type* pos   = mystl::allocator<size_type>::allocate(n);
+  size_type* freed = mystl::allocator<size_type>::allocate(n);
+  for (size_type h = 0; h < slots_; ++h)
+  {
+    pos[h] = pos_[h];
+    if (pos_[h] != npos)
+    {
+      mystl::construct(nodes + h, mystl::move(nodes_[h]));
+      mystl::destroy(nodes_ + h);
+    }
+  }
+  for (size_type i = 0; i < size_; ++i) heap[i] = heap_[i];
+  for (size_type i = 0; i < nfree_; ++i) freed[i] = free_[i];
+  deallocate_all();
+  nodes_ = nodes;
+  heap_ = heap;
+  pos_ = pos;
+  free_ = freed;
+  cap_ = n;
+}
+
+template <class Key, class Priority, class Compare>
+void indexed_heap<Key, Priority, Compare>::deallocate_all()
+{
+  mystl::allocator<node>::deallocate(nodes_, cap_);
+  mystl::allocator<size_type>::deallocate(heap_, cap_);
+  mystl::allocator<size_type>::deallocate(pos_, cap_);
+  mystl::allocator<size_type>::deallocate(free_, cap_);
+}
+
+template <class Key, class Priority, class Compare>
+template <class K, class P>
+typename indexed_heap<Key, Priority, Compare>::handle_type
+indexed_heap<Key, Priority, Compare>::push(K&& key, P&& prio)
+{
+  handle_type h;
+  if (nfree_ != 0)
+  {
+    h = free_[--nfree_];
+  }
+  else
+  {
+    if (slots_ == cap_) reserve(cap_ == 0 ? 16 : cap_ * 2);
+    h = slots_++;
+  }
+  mystl::construct(nodes_ + h, mystl::forward<K>(key), mystl::forward<P>(prio));
+  sift_up(size_++, h);
+  return h;
+}
+
+template <class Key, class Priority, class Compare>
+void indexed_heap<Key, Priority, Compare>::erase(handle_type h)
+{
+  const auto holeIdx = pos_[h];
+  mystl::destroy(nodes_ + h);
+  pos_[h] = npos;
+  free_[nfree_++] = h;
+  // fill the hole with the last element
+  const auto last = heap_[--size_];
+  if (holeIdx == size_) return;
+  if (holeIdx > 0 && comp_(nodes_[heap_[(holeIdx - 1) / 2]].prio, nodes_[last].prio))
+  {
+    sift_up(holeIdx, last);
+  }
+  else
+  {
+    sift_down(holeIdx, last);
+  }
+}
+
+template <class Key, class Priority, class Compare>
+template <class P>
+void indexed_heap<Key, Priority, Compare>::update(handle_type h, P&& prio)
+{
+  const bool up = comp_(nodes_[h].prio, prio);
+  nodes_[h].prio = mystl::forward<P>(prio);
+  if (up) sift_up(pos_[h], h);
+  else    sift_down(pos_[h], h);
+}
+
+template <class Key, class Priority, class Compare>
+void indexed_heap<Key, Priority, Compare>::clear()
+{
+  for (size_type i = 0; i < size_; ++i)
+  {
+    mystl::destroy(nodes_ + heap_[i]);
+  }
+  size_ = nfree_ = slots_ = 0;
+}
+
+// percolate the hole at holeIdx up, and put h into the final hole
+template <class Key, class Priority, class Compare>
+void indexed_heap<Key, Priority, Compare>::sift_up(size_type holeIdx,
+                                                   handle_type h)
+{
+  while (holeIdx > 0)
+  {
+    const auto parent = (holeIdx - 1) / 2;
+    const auto ph = heap_[parent];
+    if (!comp_(nodes_[ph].prio, nodes_[h].prio)) break;
+    heap_[holeIdx] = ph;
+    pos_[ph] = holeIdx;
+    holeIdx = parent;
+  }
+  heap_[holeIdx] = h;
+  pos_[h] = holeIdx;
+}
+
+// percolate the hole at holeIdx down, and put h into the final hole
+template <class Key, class Priority, class Compare>
+void indexed_heap<Key, Priority, Compare>::sift_down(size_type holeIdx,
+                                                     handle_type h)
+{
+  auto child = 2 * holeIdx + 1;
+  while (child < size_)
+  {
+    if (child + 1 < size_ &&
+        comp_(nodes_[heap_[child]].prio, nodes_[heap_[child + 1]].prio))
+    {
+      ++child;
+    }
+    const auto ch = heap_[child];
+    if (!comp_(nodes_[h].prio, nodes_[ch].prio)) break;
+    heap_[holeIdx] = ch;
+    pos_[ch] = holeIdx;
+    holeIdx = child;
+    child = 2 * holeIdx + 1;
+  }
+  heap_[holeIdx] = h;
+  pos_[h] = holeIdx;
+}
+
+template <class Key, class Priority, class Compare>
+void swap(indexed_heap<Key, Priority, Compare>& lhs,
+          indexed_heap<Key, Priority, Compare>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_INDEXED_HEAP_H_
@@ -0,0 +1,417 @@
+#ifndef _LITESTL_INTRUSIVE_HASH_SET_H_
+#define _LITESTL_INTRUSIVE_HASH_SET_H_
+
+// chained hash set whose links live in the elements
+// an element derives from hash_set_hook<Tag>; inserting links it into the
+// chain of its bucket and allocates nothing, only a growing bucket array
+// does, and reserve sizes that ahead of time
+// like intrusive_list, the set never copies or destroys an element
+
+#include <cstddef>
+#include <cstring>
+
+#include "iterator.h"
+#include "allocator.h"
+#include "functional.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// base class of an element that can be linked into an intrusive_hash_set
+template <class Tag = void>
+struct hash_set_hook
+{
+  hash_set_hook* next;
+  size_t         hash;  // of the element, kept for rehash and lookups
+
+  hash_set_hook() noexcept :next(nullptr), hash(0) {}
+
+  // a copy of an element is not in the sets of the original
+  hash_set_hook(const hash_set_hook&) noexcept :next(nullptr), hash(0) {}
+  hash_set_hook& operator=(const hash_set_hook&) noexcept { return *this; }
+};
+
+template <class T, class Hash, class KeyEqual, class Tag>
+class intrusive_hash_set;
+
+// iterator of intrusive_hash_set, it walks the chains bucket by bucket
+template <class Set, class Ref, class Ptr>
+struct intrusive_hash_set_iterator
+  :public mystl::iterator<mystl::forward_iterator_tag, typename Set::value_type>
+{
+  typedef typename Set::value_type  value_type;
+  typedef Ptr                       pointer;
+  typedef Ref                       reference;
+  typedef ptrdiff_t                 difference_type;
+  typedef size_t                    size_type;
+  typedef typename Set::hook_type   hook_type;
+
+  typedef intrusive_hash_set_iterator<Set, value_type&, value_type*>             iterator;
+  typedef intrusive_hash_set_iterator<Set, const value_type&, const value_type*> const_iterator;
+
+  const Set* set;
+  size_type  bucket;  // set->bucket_count() for end
+  hook_type* node;    // nullptr for end
+
+  intrusive_hash_set_iterator() noexcept :set(nullptr), bucket(0), node(nullptr) {}
+  intrusive_hash_set_iterator(const Set* s, size_type b, hook_type* n) noexcept
+    :set(s), bucket(b), node(n) {}
+  intrusive_hash_set_iterator(const iterator& rhs) noexcept
+    :set(rhs.set), bucket(rhs.bucket), node(rhs.node) {}
+
+  intrusive_hash_set_iterator& operator=(const intrusive_hash_set_iterator&) = default;
+
+  reference operator*()  const { return *static_cast<value_type*>(node); }
+  pointer   operator->() const { return &(operator*()); }
+
+  intrusive_hash_set_iterator& operator++()
+  {
+    node = node->next;
+    if (node == nullptr)
+    {
+      bucket = set->next_bucket(bucket + 1);
+      node = bucket == set->bucket_count() ? nullptr : set->buckets_[bucket];
+    }
+    return *this;
+  }
+  intrusive_hash_set_iterator operator++(int)
+  {
+    intrusive_hash_set_iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  bool operator==(const intrusive_hash_set_iterator& rhs) const { return node == rhs.node; }
+  bool operator!=(const intrusive_hash_set_iterator& rhs) const { return node != rhs.node; }
+};
+
+// template class: intrusive_hash_set
+// T: element type, derived from hash_set_hook<Tag>
+// Hash and KeyEqual are called with an element, and find, count and erase
+// also take any key K for which hash(K) and equal(K, element) are defined,
+// so an element can be looked up by its id without building one
+// the bucket count is 0 or a power of 2, and grows to keep at most one
+// element per bucket on average
+template <class T, class Hash = mystl::hash<T>, class KeyEqual = mystl::equal_to<T>,
+  class Tag = void>
+class intrusive_hash_set
+{
+  template <class Set, class Ref, class Ptr>
+  friend struct intrusive_hash_set_iterator;
+
+public:
+  typedef T                         value_type;
+  typedef T                         key_type;
+  typedef Hash                      hasher;
+  typedef KeyEqual                  key_equal;
+  typedef T*                        pointer;
+  typedef const T*                  const_pointer;
+  typedef T&                        reference;
+  typedef const T&                  const_reference;
+  typedef size_t                    size_type;
+  typedef ptrdiff_t                 difference_type;
+  typedef hash_set_hook<Tag>        hook_type;
+
+  typedef intrusive_hash_set_iterator<intrusive_hash_set, T&, T*>             iterator;
+  typedef intrusive_hash_set_iterator<intrusive_hash_set, const T&, const T*> const_iterator;
+
+private:
+  typedef mystl::allocator<hook_type*> bucket_allocator;
+
+  static const size_type min_bucket_count = 8;
+
+  hook_type** buckets_;
+  size_type   bucket_count_;  // 0 or a power of 2
+  size_type   size_;
+  hasher      hash_;
+  key_equal   equal_;
+
+public:
+  // construct, move and destroy
+  intrusive_hash_set()
+    :buckets_(nullptr), bucket_count_(0), size_(0), hash_(), equal_() {}
+
+  explicit intrusive_hash_set(size_type n, const Hash& hf = Hash(),
+                              const KeyEqual& eq = KeyEqual())
+    :buckets_(nullptr), bucket_count_(0), size_(0), hash_(hf), equal_(eq)
+  {
+    reserve(n);
+  }
+
+  intrusive_hash_set(intrusive_hash_set&& rhs) noexcept
+    :buckets_(rhs.buckets_), bucket_count_(rhs.bucket_count_), size_(rhs.size_),
+    hash_(rhs.hash_), equal_(rhs.equal_)
+  {
+    rhs.buckets_ = nullptr;
+    rhs.bucket_count_ = 0;
+    rhs.size_ = 0;
+  }
+
+  intrusive_hash_set& operator=(intrusive_hash_set&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      intrusive_hash_set tmp(mystl::move(rhs));
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  // the elements stay alive, they are only unlinked
+  ~intrusive_hash_set()
+  {
+    clear();
+    bucket_allocator::deallocate(buckets_, bucket_count_);
+  }
+
+public:
+  // iterators
+  iterator begin() noexcept
+  {
+    const size_type b = next_bucket(0);
+    return iterator(this, b, b == bucket_count_ ? nullptr : buckets_[b]);
+  }
+  const_iterator begin() const noexcept
+  {
+    const size_type b = next_bucket(0);
+    return const_iterator(this, b, b == bucket_count_ ? nullptr : buckets_[b]);
+  }
+  iterator       end()          noexcept { return iterator(this, bucket_count_, nullptr); }
+  const_iterator end()    const noexcept { return const_iterator(this, bucket_count_, nullptr); }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend()   const noexcept { return end(); }
+
+  // the position of an element in the set
+  iterator iterator_to(reference x) noexcept
+  {
+    hook_type* h = hook_of(x);
+    return iterator(this, bucket_of(h->hash), h);
+  }
+  const_iterator iterator_to(const_reference x) const noexcept
+  {
+    hook_type* h = hook_of(const_cast<reference>(x));
+    return const_iterator(this, bucket_of(h->hash), h);
+  }
+
+  // capacity
+  bool      empty() const noexcept { return size_ == 0; }
+  size_type size()  const noexcept { return size_; }
+
+  // hash policy
+  size_type bucket_count()    const noexcept { return bucket_count_; }
+  float     load_factor()     const noexcept
+  {
+    return bucket_count_ == 0 ? 0.0f : static_cast<float>(size_) / bucket_count_;
+  }
+  float     max_load_factor() const noexcept { return 1.0f; }
+
+  // room for n elements without growing the bucket array
+  void reserve(size_type n)
+  {
+    if (n > bucket_count_) rehash(n);
+  }
+  void rehash(size_type n);
+
+  // link x unless an equal element is in the set
+  mystl::pair<iterator, bool> insert(reference x);
+
+  // lookup
+  template <class K>
+  iterator find(const K& key)
+  {
+    const size_t h = hash_(key);
+    const size_type b = bucket_of(h);
+    return iterator(this, b, find_node(key, h));
+  }
+  template <class K>
+  const_iterator find(const K& key) const
+  {
+    const size_t h = hash_(key);
+    const size_type b = bucket_of(h);
+    return const_iterator(this, b, find_node(key, h));
+  }
+  template <class K>
+  size_type count(const K& key) const
+  {
+    return find_node(key, hash_(key)) == nullptr ? 0 : 1;
+  }
+
+  // unlink
+  iterator erase(const_iterator pos) noexcept
+  {
+    iterator next(this, pos.bucket, pos.node);
+    ++next;
+    unlink(pos.node, pos.bucket);
+    return next;
+  }
+  iterator erase(iterator pos) noexcept
+  {
+    return erase(const_iterator(pos));
+  }
+
+  // unlink x, which must be in this set
+  void erase(reference x) noexcept
+  {
+    hook_type* h = hook_of(x);
+    unlink(h, bucket_of(h->hash));
+  }
+
+  template <class K>
+  size_type erase(const K& key)
+  {
+    hook_type* h = find_node(key, hash_(key));
+    if (h == nullptr) return 0;
+    unlink(h, bucket_of(h->hash));
+    return 1;
+  }
+
+  void clear() noexcept
+  {
+    clear_and_dispose([](pointer) {});
+  }
+
+  // unlink every element and hand it to d, d may destroy or recycle it
+  template <class Disposer>
+  void clear_and_dispose(Disposer d);
+
+  void swap(intrusive_hash_set& rhs) noexcept
+  {
+    mystl::swap(buckets_, rhs.buckets_);
+    mystl::swap(bucket_count_, rhs.bucket_count_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(hash_, rhs.hash_);
+    mystl::swap(equal_, rhs.equal_);
+  }
+
+  hasher    hash_fcn() const { return hash_; }
+  key_equal key_eq()   const { return equal_; }
+
+private:
+  // helper functions
+  static hook_type* hook_of(reference x) noexcept
+  {
+    return static_cast<hook_type*>(&x);
+  }
+
+  size_type bucket_of(size_t h) const noexcept
+  {
+    return static_cast<size_type>(h) & (bucket_count_ - 1);
+  }
+
+  // the first non-empty bucket from b, bucket_count_ if none
+  size_type next_bucket(size_type b) const noexcept
+  {
+    while (b < bucket_count_ && buckets_[b] == nullptr) ++b;
+    return b;
+  }
+
+  template <class K>
+  hook_type* find_node(const K& key, size_t h) const
+  {
+    if (size_ == 0) return nullptr;
+    for (hook_type* p = buckets_[bucket_of(h)]; p != nullptr; p = p->next)
+    {
+      if (p->hash == h && equal_(key, *static_cast<const T*>(p))) return p;
+    }
+    return nullptr;
+  }
+
+  void unlink(hook_type* h, size_type b) noexcept
+  {
+    hook_type** link = &buckets_[b];
+    while (*link != h) link = &(*link)->next;
+    *link = h->next;
+    h->next = nullptr;
+    --size_;
+  }
+
+  intrusive_hash_set(const intrusive_hash_set&);
+
+  void operator=(const intrusive_hash_set&);
+};
+
+template <class T, class Hash, class KeyEqual, class Tag>
+const typename intrusive_hash_set<T, Hash, KeyEqual, Tag>::size_type
+intrusive_hash_set<T, Hash, KeyEqual, Tag>::min_bucket_count;
+
+/*****************************************************************************************/
+
+// relink every element into a bucket array of at least n buckets
+template <class T, class Hash, class KeyEqual, class Tag>
+void intrusive_hash_set<T, Hash, KeyEqual, Tag>::rehash(size_type n)
+{
+  if (n < size_) n = size_;
+  size_type count = min_bucket_count;
+  while (count < n) count *= 2;
+  if (count == bucket_count_) return;
+
+  hook_type** buckets = bucket_allocator::allocate(count);
+  std::memset(buckets, 0, count * sizeof(hook_type*));
+  for (size_type b = 0; b != bucket_count_; ++b)
+  {
+    hook_type* p = buckets_[b];
+    while (p != nullptr)
+    {
+      hook_type* next = p->next;
+      hook_type*& head = buckets[static_cast<size_type>(p->hash) & (count - 1)];
+      p->next = head;
+      head = p;
+      p = next;
+    }
+  }
+  bucket_allocator::deallocate(buckets_, bucket_count_);
+  buckets_ = buckets;
+  bucket_count_ = count;
+}
+
+template <class T, class Hash, class KeyEqual, class Tag>
+mystl::pair<typename intrusive_hash_set<T, Hash, KeyEqual, Tag>::iterator, bool>
+intrusive_hash_set<T, Hash, KeyEqual, Tag>::insert(reference x)
+{
+  const size_t h = hash_(x);
+  hook_type* found = find_node(x, h);
+  if (found != nullptr)
+  {
+    return mystl::make_pair(iterator(this, bucket_of(h), found), false);
+  }
+  if (size_ + 1 > bucket_count_) rehash(bucket_count_ * 2);
+  hook_type* node = hook_of(x);
+  const size_type b = bucket_of(h);
+  node->hash = h;
+  node->next = buckets_[b];
+  buckets_[b] = node;
+  ++size_;
+  return mystl::make_pair(iterator(this, b, node), true);
+}
+
+template <class T, class Hash, class KeyEqual, class Tag>
+template <class Disposer>
+void intrusive_hash_set<T, Hash, KeyEqual, Tag>::clear_and_dispose(Disposer d)
+{
+  for (size_type b = 0; b != bucket_count_ && size_ != 0; ++b)
+  {
+    hook_type* p = buckets_[b];
+    buckets_[b] = nullptr;
+    while (p != nullptr)
+    {
+      hook_type* next = p->next;
+      p->next = nullptr;
+      --size_;
+      d(static_cast<pointer>(p));
+      p = next;
+    }
+  }
+}
+
+// overload mystl::swap
+template <class T, class Hash, class KeyEqual, class Tag>
+void swap(intrusive_hash_set<T, Hash, KeyEqual, Tag>& lhs,
+          intrusive_hash_set<T, Hash, KeyEqual, Tag>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_INTRUSIVE_HASH_SET_H_
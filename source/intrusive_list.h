@@ -0,0 +1,318 @@
+#ifndef _LITESTL_INTRUSIVE_LIST_H_
+#define _LITESTL_INTRUSIVE_LIST_H_
+
+// doubly linked list whose links live in the elements
+// an element derives from list_hook<Tag>; the list never allocates, never
+// copies and never destroys an element, it only links and unlinks them, so
+// the caller keeps the elements alive while they are in a list
+// an element can be in as many lists at once as it has hooks with distinct
+// tags
+
+#include <cstddef>
+
+#include "iterator.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// base class of an element that can be linked into an intrusive_list<T, Tag>
+template <class Tag = void>
+struct list_hook
+{
+  list_hook* prev;
+  list_hook* next;
+
+  list_hook() noexcept :prev(nullptr), next(nullptr) {}
+
+  // a copy of an element is not in the lists of the original
+  list_hook(const list_hook&) noexcept :prev(nullptr), next(nullptr) {}
+  list_hook& operator=(const list_hook&) noexcept { return *this; }
+
+  bool is_linked() const noexcept { return next != nullptr; }
+};
+
+// iterator of intrusive_list
+template <class T, class Tag, class Ref, class Ptr>
+struct intrusive_list_iterator
+  :public mystl::iterator<mystl::bidirectional_iterator_tag, T>
+{
+  typedef T                         value_type;
+  typedef Ptr                       pointer;
+  typedef Ref                       reference;
+  typedef ptrdiff_t                 difference_type;
+  typedef list_hook<Tag>            hook_type;
+
+  typedef intrusive_list_iterator<T, Tag, T&, T*>             iterator;
+  typedef intrusive_list_iterator<T, Tag, const T&, const T*> const_iterator;
+
+  hook_type* node;
+
+  intrusive_list_iterator() noexcept :node(nullptr) {}
+  explicit intrusive_list_iterator(hook_type* n) noexcept :node(n) {}
+  intrusive_list_iterator(const iterator& rhs) noexcept :node(rhs.node) {}
+
+  intrusive_list_iterator& operator=(const intrusive_list_iterator&) = default;
+
+  reference operator*()  const { return *static_cast<T*>(node); }
+  pointer   operator->() const { return &(operator*()); }
+
+  intrusive_list_iterator& operator++()
+  {
+    node = node->next;
+    return *this;
+  }
+  intrusive_list_iterator operator++(int)
+  {
+    intrusive_list_iterator tmp = *this;
+    node = node->next;
+    return tmp;
+  }
+  intrusive_list_iterator& operator--()
+  {
+    node = node->prev;
+    return *this;
+  }
+  intrusive_list_iterator operator--(int)
+  {
+    intrusive_list_iterator tmp = *this;
+    node = node->prev;
+    return tmp;
+  }
+
+  bool operator==(const intrusive_list_iterator& rhs) const { return node == rhs.node; }
+  bool operator!=(const intrusive_list_iterator& rhs) const { return node != rhs.node; }
+};
+
+// template class: intrusive_list
+// T: element type, derived from list_hook<Tag>
+// the list is circular through head_, which is the end position
+template <class T, class Tag = void>
+class intrusive_list
+{
+public:
+  typedef T                         value_type;
+  typedef T*                        pointer;
+  typedef const T*                  const_pointer;
+  typedef T&                        reference;
+  typedef const T&                  const_reference;
+  typedef size_t                    size_type;
+  typedef ptrdiff_t                 difference_type;
+  typedef list_hook<Tag>            hook_type;
+
+  typedef intrusive_list_iterator<T, Tag, T&, T*>             iterator;
+  typedef intrusive_list_iterator<T, Tag, const T&, const T*> const_iterator;
+
+private:
+  hook_type head_;
+  size_type size_;
+
+public:
+  // construct, move and destroy
+  intrusive_list() noexcept
+    :size_(0)
+  {
+    head_.prev = head_.next = &head_;
+  }
+
+  intrusive_list(intrusive_list&& rhs) noexcept
+    :intrusive_list()
+  {
+    take(rhs);
+  }
+
+  intrusive_list& operator=(intrusive_list&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      clear();
+      take(rhs);
+    }
+    return *this;
+  }
+
+  // the elements stay alive, they are only unlinked
+  ~intrusive_list()
+  {
+    clear();
+  }
+
+public:
+  // iterators
+  iterator       begin()        noexcept { return iterator(head_.next); }
+  const_iterator begin()  const noexcept { return const_iterator(head_.next); }
+  iterator       end()          noexcept { return iterator(&head_); }
+  const_iterator end()    const noexcept { return const_iterator(end_node()); }
+
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend()   const noexcept { return end(); }
+
+  // the position of an element in the list
+  static iterator       iterator_to(reference x) noexcept { return iterator(hook_of(x)); }
+  static const_iterator iterator_to(const_reference x) noexcept
+  { return const_iterator(hook_of(const_cast<reference>(x))); }
+
+  // capacity
+  bool      empty() const noexcept { return size_ == 0; }
+  size_type size()  const noexcept { return size_; }
+
+  // access
+  reference       front()       { return *begin(); }
+  const_reference front() const { return *begin(); }
+  reference       back()        { return *iterator(head_.prev); }
+  const_reference back()  const { return *const_iterator(head_.prev); }
+
+  // link and unlink
+  void push_front(reference x) noexcept { link_before(head_.next, hook_of(x)); }
+  void push_back(reference x)  noexcept { link_before(&head_, hook_of(x)); }
+  void pop_front() noexcept { unlink(head_.next); }
+  void pop_back()  noexcept { unlink(head_.prev); }
+
+  iterator insert(const_iterator pos, reference x) noexcept
+  {
+    link_before(pos.node, hook_of(x));
+    return iterator(hook_of(x));
+  }
+
+  iterator erase(const_iterator pos) noexcept
+  {
+    hook_type* next = pos.node->next;
+    unlink(pos.node);
+    return iterator(next);
+  }
+  iterator erase(const_iterator first, const_iterator last) noexcept
+  {
+    while (first != last) first = erase(first);
+    return iterator(last.node);
+  }
+
+  // unlink x, which must be in this list
+  void erase(reference x) noexcept { unlink(hook_of(x)); }
+
+  // unlink and hand the element to d, d may destroy or recycle it
+  template <class Disposer>
+  iterator erase_and_dispose(const_iterator pos, Disposer d)
+  {
+    hook_type* next = pos.node->next;
+    unlink(pos.node);
+    d(static_cast<pointer>(pos.node));
+    return iterator(next);
+  }
+
+  void clear() noexcept
+  {
+    clear_and_dispose([](pointer) {});
+  }
+
+  template <class Disposer>
+  void clear_and_dispose(Disposer d)
+  {
+    hook_type* p = head_.next;
+    head_.prev = head_.next = &head_;
+    size_ = 0;
+    while (p != &head_)
+    {
+      hook_type* next = p->next;
+      p->prev = p->next = nullptr;
+      d(static_cast<pointer>(p));
+      p = next;
+    }
+  }
+
+  // move all of other before pos
+  void splice(const_iterator pos, intrusive_list& other) noexcept
+  {
+    if (other.empty() || &other == this) return;
+    hook_type* first = other.head_.next;
+    hook_type* last = other.head_.prev;
+    other.head_.prev = other.head_.next = &other.head_;
+    first->prev = pos.node->prev;
+    pos.node->prev->next = first;
+    last->next = pos.node;
+    pos.node->prev = last;
+    size_ += other.size_;
+    other.size_ = 0;
+  }
+
+  // move the element at it of other before pos
+  void splice(const_iterator pos, intrusive_list& other, const_iterator it) noexcept
+  {
+    if (pos.node == it.node || pos.node == it.node->next) return;
+    other.unlink(it.node);
+    link_before(pos.node, it.node);
+  }
+
+  void reverse() noexcept
+  {
+    hook_type* p = &head_;
+    do
+    {
+      mystl::swap(p->prev, p->next);
+      p = p->prev;
+    } while (p != &head_);
+  }
+
+  void swap(intrusive_list& rhs) noexcept
+  {
+    intrusive_list tmp(mystl::move(rhs));
+    rhs.take(*this);
+    take(tmp);
+  }
+
+private:
+  // helper functions
+  static hook_type* hook_of(reference x) noexcept
+  {
+    return static_cast<hook_type*>(&x);
+  }
+
+  hook_type* end_node() const noexcept
+  {
+    return const_cast<hook_type*>(&head_);
+  }
+
+  void link_before(hook_type* pos, hook_type* n) noexcept
+  {
+    n->next = pos;
+    n->prev = pos->prev;
+    pos->prev->next = n;
+    pos->prev = n;
+    ++size_;
+  }
+
+  void unlink(hook_type* n) noexcept
+  {
+    n->prev->next = n->next;
+    n->next->prev = n->prev;
+    n->prev = n->next = nullptr;
+    --size_;
+  }
+
+  // this list is empty: take the elements of rhs, which becomes empty
+  void take(intrusive_list& rhs) noexcept
+  {
+    if (rhs.empty()) return;
+    head_.next = rhs.head_.next;
+    head_.prev = rhs.head_.prev;
+    head_.next->prev = &head_;
+    head_.prev->next = &head_;
+    size_ = rhs.size_;
+    rhs.head_.prev = rhs.head_.next = &rhs.head_;
+    rhs.size_ = 0;
+  }
+
+  intrusive_list(const intrusive_list&);
+
+  void operator=(const intrusive_list&);
+};
+
+// overload mystl::swap
+template <class T, class Tag>
+void swap(intrusive_list<T, Tag>& lhs, intrusive_list<T, Tag>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_INTRUSIVE_LIST_H_
@@ -24,7 +24,7 @@ struct iterator
 {
   typedef Category  iterator_category;
   typedef T         value_type;
-  typedef Distance  distance;
+  typedef Distance  difference_type;
   typedef Pointer   pointer;
   typedef Reference reference;
 };
@@ -75,7 +75,7 @@ struct iterator_has_category {};
 // has category
 template <class Iterator>
 struct iterator_has_category<Iterator, true>
-  :public iterator_convert_impl<Itertor,
+  :public iterator_convert_impl<Iterator,
   std::is_convertible<
   typename Iterator::iterator_category, input_iterator_tag>::value ||
   std::is_convertible<
@@ -97,7 +97,7 @@ struct iterator_traits<T*>
 {
   typedef random_access_iterator_tag iterator_category;
   typedef T                          value_type;
-  typedef ptrdiff_t                  differedce_type;
+  typedef ptrdiff_t                  difference_type;
   typedef T*                         pointer;
   typedef T&                         reference;
 };
@@ -108,7 +108,7 @@ struct iterator_traits<const T*>
 {
   typedef random_access_iterator_tag iterator_category;
   typedef T                          value_type;
-  typedef ptrdiff_t                  differedce_type;
+  typedef ptrdiff_t                  difference_type;
   typedef const T*                   pointer;
   typedef const T&                   reference;
 };
@@ -122,13 +122,13 @@ typename iterator_traits<Iterator>::iterator_category
 iterator_category(const Iterator&)
 {
   typedef typename iterator_traits<Iterator>::iterator_category Category;
-  return Category;
+  return Category();
 }
 
 // distance_type
 template <class Iterator>
 typename iterator_traits<Iterator>::difference_type*
-iterator_category(const Iterator&)
+distance_type(const Iterator&)
 {
   return static_cast<typename iterator_traits<Iterator>::difference_type*>(0);
 }
@@ -136,7 +136,7 @@ iterator_category(const Iterator&)
 // value_type
 template <class Iterator>
 typename iterator_traits<Iterator>::value_type*
-iterator_category(const Iterator&)
+value_type(const Iterator&)
 {
   return static_cast<typename iterator_traits<Iterator>::value_type*>(0);
 }
@@ -145,16 +145,16 @@ iterator_category(const Iterator&)
 // with_category_of
 // can convert to a certain type of iterator implicitly or not
 
-// T-type iterator cannot convert to U-type
-template <class T, class U>
-struct with_category_of<T, U, false> :public m_false_type {};
-
 // T-type iterator can convert to U-type
 template <class T, class U, bool = with_category<iterator_traits<T>>::value>
 struct with_category_of
   :public m_bool_constant<std::is_convertible<
   typename iterator_traits<T>::iterator_category, U>::value> {};
 
+// T-type iterator cannot convert to U-type
+template <class T, class U>
+struct with_category_of<T, U, false> :public m_false_type {};
+
 
 // distinguish concrete iterator type
 template <class Iterator>
@@ -242,6 +242,107 @@ void advance(IIter& i, Distance n)
   return advance_aux(i, n, iterator_category(i));
 }
 
+// template struct: segmented_iterator_traits
+// an iterator over a chain of contiguous segments, like that of deque, tells
+// algorithms about the segments so they run one plain loop per segment:
+//   segment(it)         the segment holding it
+//   local(it)           the position of it inside its segment
+//   begin(s), end(s)    the bounds of segment s
+//   compose(s, p)       the iterator at position p of segment s
+template <class Iterator>
+struct segmented_iterator_traits
+{
+  typedef m_false_type is_segmented_iterator;
+};
+
+// template class: move_iterator
+// single pass adaptor whose dereference is an rvalue, so algorithms that copy
+// from it move the elements instead
+template <class Iterator>
+class move_iterator
+{
+public:
+  typedef input_iterator_tag                                  iterator_category;
+  typedef typename iterator_traits<Iterator>::value_type      value_type;
+  typedef typename iterator_traits<Iterator>::difference_type difference_type;
+  typedef Iterator                                            pointer;
+  typedef value_type&&                                        reference;
+
+  typedef Iterator iterator_type;
+
+private:
+  Iterator current;
+
+public:
+  move_iterator() :current() {}
+  explicit move_iterator(iterator_type i) :current(i) {}
+
+  iterator_type base() const { return current; }
+
+  reference operator*() const { return static_cast<reference>(*current); }
+
+  move_iterator& operator++()
+  {
+    ++current;
+    return *this;
+  }
+  move_iterator operator++(int)
+  {
+    move_iterator tmp = *this;
+    ++current;
+    return tmp;
+  }
+
+  bool operator==(const move_iterator& rhs) const { return current == rhs.current; }
+  bool operator!=(const move_iterator& rhs) const { return current != rhs.current; }
+};
+
+template <class Iterator>
+move_iterator<Iterator> make_move_iterator(Iterator i)
+{
+  return move_iterator<Iterator>(i);
+}
+
+// template class: back_insert_iterator
+// assigning to it calls push_back on the container
+template <class Container>
+class back_insert_iterator
+{
+public:
+  typedef output_iterator_tag iterator_category;
+  typedef void                value_type;
+  typedef void                difference_type;
+  typedef void                pointer;
+  typedef void                reference;
+
+private:
+  Container* container;
+
+public:
+  explicit back_insert_iterator(Container& c) :container(&c) {}
+
+  back_insert_iterator& operator=(const typename Container::value_type& value)
+  {
+    container->push_back(value);
+    return *this;
+  }
+  back_insert_iterator& operator=(typename Container::value_type&& value)
+  {
+    container->push_back(static_cast<typename Container::value_type&&>(value));
+    return *this;
+  }
+
+  back_insert_iterator& operator*()     { return *this; }
+  back_insert_iterator& operator++()    { return *this; }
+  back_insert_iterator  operator++(int) { return *this; }
+};
+
+template <class Container>
+back_insert_iterator<Container> back_inserter(Container& c)
+{
+  return back_insert_iterator<Container>(c);
+}
+
 } // namespace mystl
 
 #endif // !_LITESTL_ITERATOR_H_
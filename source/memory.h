@@ -6,11 +6,13 @@
 #include <cstddef>
 #include <cstdlib>
 #include <climits>
+#include <new>
 
 #include "construct.h"
 #include "allocator.h"
 #include "algobase.h"
 #include "uninitialized.h" // mystl::uninitialized_fill_n
+#include "util.h"          // mystl::default_init_t
 
 namespace mystl
 {
@@ -36,7 +38,7 @@ pair<T*, ptrdiff_t> get_temporary_buffer_aux(ptrdiff_t len, T*)
     if (temp) return pair<T*, ptrdiff_t>(temp, len);
     len /= 2; // if fail to allocate, halve size of requested space
   }
-  return return pair<T*, ptrdiff_t>(nullptr, 0);
+  return pair<T*, ptrdiff_t>(nullptr, 0);
 }
 
 template <class T>
@@ -117,11 +119,12 @@ private:
 // construct
 template <class FIter, class T>
 temporary_buffer<FIter, T>::temporary_buffer(FIter first, FIter last)
+  :original_len(0), len(0), buffer(nullptr)
 {
   try
   {
     len = mystl::distance(first, last);
-    allocate__buffer();
+    allocate_buffer();
     if (len > 0)
     {
       initialize_buffer(*first, std::is_trivially_default_constructible<T>());
@@ -154,6 +157,107 @@ void temporary_buffer<FIter, T>::allocate_buffer()
 
 /********************************************************************************/
 
+// template class: scratch_buffer
+// working memory of exactly n elements for the algorithms that need a full
+// size buffer; unlike temporary_buffer the size is never cut down: the memory
+// comes from mystl::allocator, which throws std::bad_alloc if it cannot be had
+// with std::nothrow the buffer is raw memory, empty if it cannot be had, and
+// the caller constructs and destroys the elements it puts there
+template <class T>
+class scratch_buffer
+{
+private:
+  size_t len;     // size of buffer
+  T*     buffer;  // pointer to buffer
+  bool   built;   // the elements were constructed here and are destroyed here
+
+public:
+  // construct, the elements are copies of val unless T is trivial
+  scratch_buffer(size_t n, const T& val)
+    :len(n), buffer(nullptr), built(true)
+  {
+    if (n > static_cast<size_t>(-1) / sizeof(T)) throw std::bad_alloc();
+    buffer = mystl::allocator<T>::allocate(n);
+    try
+    {
+      initialize_buffer(val, std::is_trivially_default_constructible<T>());
+    }
+    catch (...)
+    {
+      mystl::allocator<T>::deallocate(buffer, len);
+      throw;
+    }
+  }
+
+  // construct, the elements are default-initialized: trivial ones are not
+  // written
+  scratch_buffer(size_t n, default_init_t)
+    :len(n), buffer(nullptr), built(true)
+  {
+    if (n > static_cast<size_t>(-1) / sizeof(T)) throw std::bad_alloc();
+    buffer = mystl::allocator<T>::allocate(n);
+    try
+    {
+      mystl::uninitialized_default_construct_n(buffer, n);
+    }
+    catch (...)
+    {
+      mystl::allocator<T>::deallocate(buffer, len);
+      throw;
+    }
+  }
+
+  // construct, raw memory of n elements or none
+  scratch_buffer(size_t n, const std::nothrow_t&) noexcept
+    :len(0), buffer(nullptr), built(false)
+  {
+    if (n > static_cast<size_t>(-1) / sizeof(T)) return;
+    try
+    {
+      buffer = mystl::allocator<T>::allocate(n);
+      len = n;
+    }
+    catch (const std::bad_alloc&)
+    {
+    }
+  }
+
+  ~scratch_buffer()
+  {
+    if (built) mystl::destroy(buffer, buffer + len);
+    mystl::allocator<T>::deallocate(buffer, len);
+  }
+
+public:
+  size_t size() const noexcept
+  {
+    return len;
+  }
+
+  T* begin() noexcept
+  {
+    return buffer;
+  }
+  T* end() noexcept
+  {
+    return buffer + len;
+  }
+
+private:
+  void initialize_buffer(const T&, std::true_type) {}
+  void initialize_buffer(const T& val, std::false_type)
+  {
+    mystl::uninitialized_fill_n(buffer, len, val);
+  }
+
+private:
+  scratch_buffer(const scratch_buffer&);
+
+  void operator=(const scratch_buffer&);
+};
+
+/********************************************************************************/
+
 // template class: auto_ptr
 // 
 template <class T>
@@ -0,0 +1,341 @@
+#ifndef _LITESTL_MMAP_ARRAY_H_
+#define _LITESTL_MMAP_ARRAY_H_
+
+// arrays backed by a memory-mapped file
+// mapped_file maps a whole file, mmap_array<T> views it as elements of T;
+// nothing is read or copied up front, a page is read from the file the first
+// time it is touched, so opening a file of any size is immediate
+// the iterators are plain pointers: lower_bound, set_intersection, mismatch,
+// accumulate and the other algorithms take their pointer paths on them
+// this header uses the POSIX mmap interface
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "span.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// how the pages are mapped
+enum map_mode
+{
+  map_read,     // read only, shared with the page cache
+  map_private   // writable copy on write, the file never changes
+};
+
+// access pattern hints, passed to madvise
+enum map_advice
+{
+  advise_normal,
+  advise_sequential,  // read ahead aggressively, drop pages behind
+  advise_random,      // no read ahead
+  advise_willneed,    // start reading the pages now
+  advise_dontneed     // drop the pages; private changes are lost
+};
+
+// a read-only view of mapped elements
+template <class T>
+using mapped_span = mystl::span<const T>;
+
+// class: mapped_file
+// owns one mapping of a whole file; the file descriptor is closed once the
+// mapping exists, the mapping keeps the file alive
+class mapped_file
+{
+private:
+  unsigned char* data_;
+  size_t         size_;
+  map_mode       mode_;
+  bool           open_;
+
+public:
+  // construct, move and destroy
+  mapped_file() noexcept
+    :data_(nullptr), size_(0), mode_(map_read), open_(false) {}
+
+  mapped_file(mapped_file&& rhs) noexcept
+    :data_(rhs.data_), size_(rhs.size_), mode_(rhs.mode_), open_(rhs.open_)
+  {
+    rhs.data_ = nullptr;
+    rhs.size_ = 0;
+    rhs.open_ = false;
+  }
+
+  mapped_file& operator=(mapped_file&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      close();
+      data_ = rhs.data_;
+      size_ = rhs.size_;
+      mode_ = rhs.mode_;
+      open_ = rhs.open_;
+      rhs.data_ = nullptr;
+      rhs.size_ = 0;
+      rhs.open_ = false;
+    }
+    return *this;
+  }
+
+  ~mapped_file()
+  {
+    close();
+  }
+
+public:
+  // map the file at path, replacing any current mapping
+  // return false if the file cannot be opened or mapped, errno tells why
+  // an empty file maps to an empty range
+  bool open(const char* path, map_mode mode = map_read) noexcept
+  {
+    close();
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+      ::close(fd);
+      return false;
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+    if (size != 0)
+    {
+      const int prot = mode == map_private ? PROT_READ | PROT_WRITE : PROT_READ;
+      const int flags = mode == map_private ? MAP_PRIVATE : MAP_SHARED;
+      void* p = ::mmap(nullptr, size, prot, flags, fd, 0);
+      if (p == MAP_FAILED)
+      {
+        ::close(fd);
+        return false;
+      }
+      data_ = static_cast<unsigned char*>(p);
+    }
+    ::close(fd);
+    size_ = size;
+    mode_ = mode;
+    open_ = true;
+    return true;
+  }
+
+  void close() noexcept
+  {
+    if (data_ != nullptr) ::munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+  }
+
+  bool     is_open() const noexcept { return open_; }
+  size_t   size()    const noexcept { return size_; }
+  map_mode mode()    const noexcept { return mode_; }
+
+  const unsigned char* data() const noexcept { return data_; }
+
+  // the pages can only be written in a private mapping
+  unsigned char* writable_data() const
+  {
+    if (mode_ != map_private)
+      throw std::logic_error("mapped_file::writable_data() needs map_private");
+    return data_;
+  }
+
+  // hint how the bytes [offset, offset + n) will be used
+  // the range is widened to whole pages; return false if madvise fails
+  bool advise(map_advice advice, size_t offset = 0,
+              size_t n = static_cast<size_t>(-1)) const noexcept
+  {
+    if (data_ == nullptr || offset >= size_) return true;
+    if (n > size_ - offset) n = size_ - offset;
+    const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t first = offset / page * page;
+    return ::madvise(data_ + first, offset + n - first, native_advice(advice)) == 0;
+  }
+
+  void swap(mapped_file& rhs) noexcept
+  {
+    mystl::swap(data_, rhs.data_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(mode_, rhs.mode_);
+    mystl::swap(open_, rhs.open_);
+  }
+
+private:
+  static int native_advice(map_advice advice) noexcept
+  {
+    switch (advice)
+    {
+      case advise_sequential: return MADV_SEQUENTIAL;
+      case advise_random:     return MADV_RANDOM;
+      case advise_willneed:   return MADV_WILLNEED;
+      case advise_dontneed:   return MADV_DONTNEED;
+      default:                return MADV_NORMAL;
+    }
+  }
+
+  mapped_file(const mapped_file&);
+
+  void operator=(const mapped_file&);
+};
+
+// template class: mmap_array
+// T: element type, trivially copyable, stored in the file in native layout
+// the elements start offset bytes into the file, which must be a multiple of
+// alignof(T); a partial element at the end of the file is not part of it
+template <class T>
+class mmap_array
+{
+  static_assert(std::is_trivially_copyable<T>::value,
+                "mmap_array needs trivially copyable elements");
+
+public:
+  typedef T                         value_type;
+  typedef const T*                  pointer;
+  typedef const T*                  const_pointer;
+  typedef const T&                  reference;
+  typedef const T&                  const_reference;
+  typedef size_t                    size_type;
+  typedef ptrdiff_t                 difference_type;
+
+  typedef const T*                  iterator;
+  typedef const T*                  const_iterator;
+
+private:
+  mapped_file file_;
+  const T*    data_;
+  size_type   size_;
+
+public:
+  // construct, move and destroy
+  mmap_array() noexcept
+    :data_(nullptr), size_(0) {}
+
+  mmap_array(mmap_array&& rhs) noexcept
+    :file_(mystl::move(rhs.file_)), data_(rhs.data_), size_(rhs.size_)
+  {
+    rhs.data_ = nullptr;
+    rhs.size_ = 0;
+  }
+
+  mmap_array& operator=(mmap_array&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      file_ = mystl::move(rhs.file_);
+      data_ = rhs.data_;
+      size_ = rhs.size_;
+      rhs.data_ = nullptr;
+      rhs.size_ = 0;
+    }
+    return *this;
+  }
+
+public:
+  // map the file at path; return false if it cannot be mapped or offset is
+  // past its end or misaligned
+  bool open(const char* path, map_mode mode = map_read, size_type offset = 0) noexcept
+  {
+    close();
+    if (offset % alignof(T) != 0) return false;
+    if (!file_.open(path, mode)) return false;
+    if (offset > file_.size())
+    {
+      file_.close();
+      return false;
+    }
+    data_ = reinterpret_cast<const T*>(file_.data() + offset);
+    size_ = (file_.size() - offset) / sizeof(T);
+    return true;
+  }
+
+  void close() noexcept
+  {
+    file_.close();
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  bool is_open() const noexcept { return file_.is_open(); }
+
+  // iterators
+  const_iterator begin()  const noexcept { return data_; }
+  const_iterator end()    const noexcept { return data_ + size_; }
+  const_iterator cbegin() const noexcept { return data_; }
+  const_iterator cend()   const noexcept { return data_ + size_; }
+
+  // capacity
+  bool      empty() const noexcept { return size_ == 0; }
+  size_type size()  const noexcept { return size_; }
+
+  // access
+  const_reference operator[](size_type n) const { return data_[n]; }
+  const_reference at(size_type n) const
+  {
+    if (n >= size_) throw std::out_of_range("mmap_array<T>::at() subscript out of range");
+    return data_[n];
+  }
+  const_reference front() const { return data_[0]; }
+  const_reference back()  const { return data_[size_ - 1]; }
+  const_pointer   data()  const noexcept { return data_; }
+
+  mapped_span<T> view() const noexcept { return mapped_span<T>(data_, size_); }
+
+  // the elements as writable memory, for make_heap, sort and the like;
+  // changes stay in this mapping
+  mystl::span<T> writable()
+  {
+    if (file_.mode() != map_private)
+      throw std::logic_error("mmap_array<T>::writable() needs map_private");
+    return mystl::span<T>(const_cast<T*>(data_), size_);
+  }
+
+  // hint how the elements [first, first + n) will be used
+  // the range is clamped to the elements, the bytes of a trailing partial
+  // element are never part of it
+  bool advise(map_advice advice, size_type first = 0,
+              size_type n = static_cast<size_type>(-1)) const noexcept
+  {
+    if (first >= size_) return true;
+    if (n > size_ - first) n = size_ - first;
+    const auto base = static_cast<size_type>(
+      reinterpret_cast<const unsigned char*>(data_) - file_.data());
+    return file_.advise(advice, base + first * sizeof(T), n * sizeof(T));
+  }
+
+  const mapped_file& file() const noexcept { return file_; }
+
+  void swap(mmap_array& rhs) noexcept
+  {
+    file_.swap(rhs.file_);
+    mystl::swap(data_, rhs.data_);
+    mystl::swap(size_, rhs.size_);
+  }
+
+private:
+  mmap_array(const mmap_array&);
+
+  void operator=(const mmap_array&);
+};
+
+// overload mystl::swap
+inline void swap(mapped_file& lhs, mapped_file& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+template <class T>
+void swap(mmap_array<T>& lhs, mmap_array<T>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_MMAP_ARRAY_H_
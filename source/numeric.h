@@ -3,17 +3,263 @@
 
 // numeric algorithm
 
+#include <cstdint>
+#include <type_traits>
+
 #include "iterator.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace mystl
 {
 
+/********************************************************************************/
+// simd kernels for contiguous integers
+// integer addition wraps, so it is associative: a pointer range of 32-bit or
+// 64-bit integers is summed in vector lanes and the lanes are folded at the
+// end, which gives the same bits as the loop; floating point keeps the loop,
+// its order of additions matters
+// the lanes are as wide as the wider of the element and the result, narrower
+// elements are sign or zero extended like the loop converts them
+/********************************************************************************/
+#if defined(__SSE2__)
+
+// eligible: the element and the result are integers, the element 4 or 8 bytes
+template <class T, class U>
+struct numeric_simd_sum
+{
+  typedef typename std::remove_cv<T>::type E;
+  static const bool value =
+    std::is_integral<E>::value && std::is_integral<U>::value &&
+    !std::is_same<E, bool>::value && !std::is_same<U, bool>::value &&
+    (sizeof(E) == 4 || sizeof(E) == 8) && sizeof(U) <= 8;
+  static const bool wide = sizeof(E) == 8 || sizeof(U) == 8;
+};
+
+// eligible: 32-bit integers whose product is a 32-bit integer
+template <class T1, class T2, class U>
+struct numeric_simd_dot
+{
+  typedef typename std::remove_cv<T1>::type E1;
+  typedef typename std::remove_cv<T2>::type E2;
+  typedef decltype(E1() * E2()) P;
+  static const bool value =
+    numeric_simd_sum<E1, U>::value && numeric_simd_sum<E2, U>::value &&
+    sizeof(E1) == 4 && sizeof(E2) == 4 && sizeof(P) == 4;
+  static const bool wide = sizeof(U) == 8;
+};
+
+// the low 32 bits of the products of the lanes
+inline __m128i simd_mullo32(__m128i a, __m128i b)
+{
+#if defined(__SSE4_1__)
+  return _mm_mullo_epi32(a, b);
+#else
+  const __m128i even = _mm_mul_epu32(a, b);
+  const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+
+// add four 32-bit lanes, extended to 64 bits, to two 64-bit accumulators
+inline void simd_widen_add(__m128i v, __m128i& lo, __m128i& hi, std::true_type)
+{
+  const __m128i sign = _mm_srai_epi32(v, 31);
+  lo = _mm_add_epi64(lo, _mm_unpacklo_epi32(v, sign));
+  hi = _mm_add_epi64(hi, _mm_unpackhi_epi32(v, sign));
+}
+
+inline void simd_widen_add(__m128i v, __m128i& lo, __m128i& hi, std::false_type)
+{
+  const __m128i zero = _mm_setzero_si128();
+  lo = _mm_add_epi64(lo, _mm_unpacklo_epi32(v, zero));
+  hi = _mm_add_epi64(hi, _mm_unpackhi_epi32(v, zero));
+}
+
+#if defined(__AVX2__)
+inline __m256i simd_widen256(__m128i v, std::true_type)  { return _mm256_cvtepi32_epi64(v); }
+inline __m256i simd_widen256(__m128i v, std::false_type) { return _mm256_cvtepu32_epi64(v); }
+#endif
+
+inline uint32_t simd_fold32(__m128i v)
+{
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+}
+
+inline uint64_t simd_fold64(__m128i v)
+{
+  uint64_t lanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), v);
+  return lanes[0] + lanes[1];
+}
+
+inline __m128i simd_load(const void* p)
+{
+  return _mm_loadu_si128(static_cast<const __m128i*>(p));
+}
+
+// sum of n 32-bit elements in 32-bit lanes
+template <class T>
+uint32_t simd_sum32(const T* p, size_t n)
+{
+  size_t i = 0;
+  __m128i acc = _mm_setzero_si128();
+#if defined(__AVX2__)
+  __m256i acc8 = _mm256_setzero_si256();
+  for (; i + 8 <= n; i += 8)
+    acc8 = _mm256_add_epi32(acc8, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+  acc = _mm_add_epi32(_mm256_castsi256_si128(acc8), _mm256_extracti128_si256(acc8, 1));
+#endif
+  for (; i + 4 <= n; i += 4)
+    acc = _mm_add_epi32(acc, simd_load(p + i));
+  uint32_t sum = simd_fold32(acc);
+  for (; i < n; ++i)
+    sum += static_cast<uint32_t>(p[i]);
+  return sum;
+}
+
+// sum of n 64-bit elements
+template <class T>
+uint64_t simd_sum64(const T* p, size_t n, std::true_type)
+{
+  size_t i = 0;
+  __m128i acc = _mm_setzero_si128();
+#if defined(__AVX2__)
+  __m256i acc4 = _mm256_setzero_si256();
+  for (; i + 4 <= n; i += 4)
+    acc4 = _mm256_add_epi64(acc4, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+  acc = _mm_add_epi64(_mm256_castsi256_si128(acc4), _mm256_extracti128_si256(acc4, 1));
+#endif
+  for (; i + 2 <= n; i += 2)
+    acc = _mm_add_epi64(acc, simd_load(p + i));
+  uint64_t sum = simd_fold64(acc);
+  for (; i < n; ++i)
+    sum += static_cast<uint64_t>(p[i]);
+  return sum;
+}
+
+// sum of n 32-bit elements, each extended to 64 bits
+template <class T>
+uint64_t simd_sum64(const T* p, size_t n, std::false_type)
+{
+  typedef std::integral_constant<bool, std::is_signed<T>::value> is_signed;
+  size_t i = 0;
+  __m128i lo = _mm_setzero_si128();
+  __m128i hi = _mm_setzero_si128();
+#if defined(__AVX2__)
+  __m256i acc4 = _mm256_setzero_si256();
+  for (; i + 4 <= n; i += 4)
+    acc4 = _mm256_add_epi64(acc4, simd_widen256(simd_load(p + i), is_signed()));
+  lo = _mm_add_epi64(_mm256_castsi256_si128(acc4), _mm256_extracti128_si256(acc4, 1));
+#endif
+  for (; i + 4 <= n; i += 4)
+    simd_widen_add(simd_load(p + i), lo, hi, is_signed());
+  uint64_t sum = simd_fold64(_mm_add_epi64(lo, hi));
+  for (; i < n; ++i)
+    sum += static_cast<uint64_t>(static_cast<int64_t>(p[i]));
+  return sum;
+}
+
+// sum of n 32-bit products in 32-bit lanes
+template <class T1, class T2>
+uint32_t simd_dot32(const T1* a, const T2* b, size_t n)
+{
+  size_t i = 0;
+  __m128i acc = _mm_setzero_si128();
+#if defined(__AVX2__)
+  __m256i acc8 = _mm256_setzero_si256();
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    acc8 = _mm256_add_epi32(acc8, _mm256_mullo_epi32(x, y));
+  }
+  acc = _mm_add_epi32(_mm256_castsi256_si128(acc8), _mm256_extracti128_si256(acc8, 1));
+#endif
+  for (; i + 4 <= n; i += 4)
+    acc = _mm_add_epi32(acc, simd_mullo32(simd_load(a + i), simd_load(b + i)));
+  uint32_t sum = simd_fold32(acc);
+  for (; i < n; ++i)
+    sum += static_cast<uint32_t>(a[i]) * static_cast<uint32_t>(b[i]);
+  return sum;
+}
+
+// sum of n 32-bit products, each extended to 64 bits
+template <class T1, class T2>
+uint64_t simd_dot64(const T1* a, const T2* b, size_t n)
+{
+  typedef decltype(a[0] * b[0]) P;
+  typedef std::integral_constant<bool, std::is_signed<P>::value> is_signed;
+  size_t i = 0;
+  __m128i lo = _mm_setzero_si128();
+  __m128i hi = _mm_setzero_si128();
+#if defined(__AVX2__)
+  __m256i acc4 = _mm256_setzero_si256();
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    const __m256i prod = _mm256_mullo_epi32(x, y);
+    acc4 = _mm256_add_epi64(acc4, simd_widen256(_mm256_castsi256_si128(prod), is_signed()));
+    acc4 = _mm256_add_epi64(acc4, simd_widen256(_mm256_extracti128_si256(prod, 1), is_signed()));
+  }
+  lo = _mm_add_epi64(_mm256_castsi256_si128(acc4), _mm256_extracti128_si256(acc4, 1));
+#endif
+  for (; i + 4 <= n; i += 4)
+    simd_widen_add(simd_mullo32(simd_load(a + i), simd_load(b + i)), lo, hi, is_signed());
+  uint64_t sum = simd_fold64(_mm_add_epi64(lo, hi));
+  for (; i < n; ++i)
+    sum += static_cast<uint64_t>(static_cast<int64_t>(static_cast<P>(
+      static_cast<uint32_t>(a[i]) * static_cast<uint32_t>(b[i]))));
+  return sum;
+}
+
+template <class T, class U>
+U simd_accumulate(const T* first, size_t n, U init, std::false_type)
+{
+  return static_cast<U>(static_cast<uint32_t>(init) + mystl::simd_sum32(first, n));
+}
+
+template <class T, class U>
+U simd_accumulate(const T* first, size_t n, U init, std::true_type)
+{
+  return static_cast<U>(static_cast<uint64_t>(init) + mystl::simd_sum64(first, n,
+    std::integral_constant<bool, sizeof(T) == 8>()));
+}
+
+template <class T1, class T2, class U>
+U simd_inner_product(const T1* first1, const T2* first2, size_t n, U init, std::false_type)
+{
+  return static_cast<U>(static_cast<uint32_t>(init) + mystl::simd_dot32(first1, first2, n));
+}
+
+template <class T1, class T2, class U>
+U simd_inner_product(const T1* first1, const T2* first2, size_t n, U init, std::true_type)
+{
+  return static_cast<U>(static_cast<uint64_t>(init) + mystl::simd_dot64(first1, first2, n));
+}
+
+#endif // __SSE2__
+
 /********************************************************************************/
 // accumulate
 /********************************************************************************/
+// a segmented range is summed one segment at a time, each a loop over
+// contiguous storage; the order of the additions is unchanged
 // ver1: +
 template <class IIter, class T>
-T accumulate(IIter first, IIter last, T init)
+T accumulate_aux(IIter first, IIter last, T init, m_false_type)
 {
   for (; first != last; ++first)
   {
@@ -22,9 +268,41 @@ T accumulate(IIter first, IIter last, T init)
   return init;
 }
 
+template <class SIter, class T>
+T accumulate_aux(SIter first, SIter last, T init, m_true_type)
+{
+  typedef segmented_iterator_traits<SIter> traits;
+  auto seg = traits::segment(first);
+  const auto last_seg = traits::segment(last);
+  if (seg == last_seg)
+    return accumulate_aux(traits::local(first), traits::local(last), init, m_false_type());
+  init = accumulate_aux(traits::local(first), traits::end(seg), init, m_false_type());
+  for (++seg; seg != last_seg; ++seg)
+    init = accumulate_aux(traits::begin(seg), traits::end(seg), init, m_false_type());
+  return accumulate_aux(traits::begin(last_seg), traits::local(last), init, m_false_type());
+}
+
+template <class IIter, class T>
+T accumulate(IIter first, IIter last, T init)
+{
+  return accumulate_aux(first, last, init,
+    typename segmented_iterator_traits<IIter>::is_segmented_iterator());
+}
+
+#if defined(__SSE2__)
+// contiguous integers: the lanes above, e.g. a column of a soa_vector
+template <class T, class U>
+typename std::enable_if<numeric_simd_sum<T, U>::value, U>::type
+accumulate(T* first, T* last, U init)
+{
+  return mystl::simd_accumulate(first, static_cast<size_t>(last - first), init,
+    std::integral_constant<bool, numeric_simd_sum<T, U>::wide>());
+}
+#endif
+
 // ver2: bop
 template <class IIter, class T, class BinaryOp>
-T accumulate(IIter first, IIter last, T init, BinaryOp bop)
+T accumulate_aux(IIter first, IIter last, T init, BinaryOp bop, m_false_type)
 {
   for (; first != last; ++first)
   {
@@ -33,6 +311,27 @@ T accumulate(IIter first, IIter last, T init, BinaryOp bop)
   return init;
 }
 
+template <class SIter, class T, class BinaryOp>
+T accumulate_aux(SIter first, SIter last, T init, BinaryOp bop, m_true_type)
+{
+  typedef segmented_iterator_traits<SIter> traits;
+  auto seg = traits::segment(first);
+  const auto last_seg = traits::segment(last);
+  if (seg == last_seg)
+    return accumulate_aux(traits::local(first), traits::local(last), init, bop, m_false_type());
+  init = accumulate_aux(traits::local(first), traits::end(seg), init, bop, m_false_type());
+  for (++seg; seg != last_seg; ++seg)
+    init = accumulate_aux(traits::begin(seg), traits::end(seg), init, bop, m_false_type());
+  return accumulate_aux(traits::begin(last_seg), traits::local(last), init, bop, m_false_type());
+}
+
+template <class IIter, class T, class BinaryOp>
+T accumulate(IIter first, IIter last, T init, BinaryOp bop)
+{
+  return accumulate_aux(first, last, init, bop,
+    typename segmented_iterator_traits<IIter>::is_segmented_iterator());
+}
+
 /********************************************************************************/
 // adjacent_difference
 /********************************************************************************/
@@ -82,6 +381,17 @@ T inner_product(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2, T init
   return init;
 }
 
+#if defined(__SSE2__)
+// contiguous 32-bit integers: the lanes above
+template <class T1, class T2, class U>
+typename std::enable_if<numeric_simd_dot<T1, T2, U>::value, U>::type
+inner_product(T1* first1, T1* last1, T2* first2, T2*, U init)
+{
+  return mystl::simd_inner_product(first1, first2, static_cast<size_t>(last1 - first1), init,
+    std::integral_constant<bool, numeric_simd_dot<T1, T2, U>::wide>());
+}
+#endif
+
 // ver2: bop1, bop2
 template <class IIter1, class IIter2, class T, class BinaryOp1, class BinaryOp2>
 T inner_product(IIter1 first1, IIter1 last1, IIter2 first2, IIter2 last2, T init,
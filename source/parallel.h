@@ -0,0 +1,346 @@
+#ifndef _LITESTL_PARALLEL_H_
+#define _LITESTL_PARALLEL_H_
+
+// run work on several threads
+// a work-stealing scheduler with one pool of threads for the whole program,
+// fork-join calls on it may nest freely: a thread waiting for a forked task
+// runs other tasks meanwhile, so no thread is added and none sits idle
+// an exception thrown by a task is kept in the task and rethrown by the
+// parallel_invoke that forked it, on the forking thread
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "allocator.h"
+#include "construct.h"
+
+namespace mystl
+{
+
+// a unit of work, it lives in the frame of the thread that forked it, which
+// does not return before the task is done
+// error is the exception the task ended with, if any, it is set before done
+struct parallel_task
+{
+  std::atomic<bool>  done;
+  std::exception_ptr error;
+
+  parallel_task() :done(false) {}
+
+  virtual void run() = 0;
+
+protected:
+  ~parallel_task() {}
+};
+
+template <class Function>
+struct parallel_task_of :public parallel_task
+{
+  Function& f;
+
+  explicit parallel_task_of(Function& fn) :f(fn) {}
+
+  void run() { f(); }
+};
+
+/********************************************************************************/
+// class: task_deque
+// tasks forked by one thread, the owner pushes and pops at the back, the
+// other threads steal from the front, so they take the oldest, biggest tasks
+/********************************************************************************/
+class task_deque
+{
+private:
+  std::mutex      mutex_;
+  parallel_task** data_;   // ring buffer
+  size_t          head_;   // index of the front
+  size_t          size_;
+  size_t          cap_;
+
+public:
+  task_deque() :data_(nullptr), head_(0), size_(0), cap_(0) {}
+
+  ~task_deque()
+  {
+    mystl::allocator<parallel_task*>::deallocate(data_, cap_);
+  }
+
+  void push_back(parallel_task* t)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size_ == cap_) grow();
+    data_[(head_ + size_) % cap_] = t;
+    ++size_;
+  }
+
+  parallel_task* pop_back()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size_ == 0) return nullptr;
+    --size_;
+    return data_[(head_ + size_) % cap_];
+  }
+
+  parallel_task* steal_front()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size_ == 0) return nullptr;
+    parallel_task* t = data_[head_];
+    head_ = (head_ + 1) % cap_;
+    --size_;
+    return t;
+  }
+
+private:
+  void grow()
+  {
+    const size_t new_cap = cap_ == 0 ? 64 : cap_ * 2;
+    parallel_task** data = mystl::allocator<parallel_task*>::allocate(new_cap);
+    for (size_t i = 0; i < size_; ++i)
+    {
+      data[i] = data_[(head_ + i) % cap_];
+    }
+    mystl::allocator<parallel_task*>::deallocate(data_, cap_);
+    data_ = data;
+    head_ = 0;
+    cap_ = new_cap;
+  }
+
+private:
+  task_deque(const task_deque&);
+
+  void operator=(const task_deque&);
+};
+
+/********************************************************************************/
+// class: task_scheduler
+// hardware_concurrency - 1 worker threads, each with its own deque; threads
+// outside the pool share one more deque; the thread that forks always
+// takes part in the work, so concurrency() threads run tasks
+// an idle worker steals from the other deques, and sleeps when no task is
+// queued anywhere
+/********************************************************************************/
+class task_scheduler
+{
+private:
+  task_deque*         deques_;   // nworkers_ + 1, the last one is shared
+  std::thread*        threads_;
+  size_t              nworkers_;
+  std::atomic<bool>   stop_;
+  std::atomic<size_t> pending_;  // tasks in the deques
+  std::atomic<size_t> sleeping_; // workers waiting on wake_
+  std::mutex              sleep_mutex_;
+  std::condition_variable wake_;
+
+public:
+  // the scheduler of the program, started on first use
+  static task_scheduler& instance()
+  {
+    static task_scheduler scheduler;
+    return scheduler;
+  }
+
+  size_t concurrency() const noexcept
+  {
+    return nworkers_ + 1;
+  }
+
+  // make t available to the other threads
+  void fork(parallel_task* t)
+  {
+    local_deque()->push_back(t);
+    pending_.fetch_add(1);
+    if (sleeping_.load() != 0)
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      wake_.notify_one();
+    }
+  }
+
+  // run tasks until t is done, t itself first if nobody has stolen it; an
+  // exception of t is left in t->error
+  void join(parallel_task* t)
+  {
+    task_deque* own = local_deque();
+    size_t victim = 0;
+    while (!t->done.load(std::memory_order_acquire))
+    {
+      parallel_task* other = find_task(own, victim);
+      if (other != nullptr) execute(other);
+      else                  std::this_thread::yield();
+    }
+  }
+
+private:
+  task_scheduler()
+    :deques_(nullptr), threads_(nullptr), nworkers_(0),
+    stop_(false), pending_(0), sleeping_(0)
+  {
+    const size_t hw = std::thread::hardware_concurrency();
+    nworkers_ = hw > 1 ? hw - 1 : 0;
+    deques_ = mystl::allocator<task_deque>::allocate(nworkers_ + 1);
+    for (size_t i = 0; i <= nworkers_; ++i)
+    {
+      mystl::construct(deques_ + i);
+    }
+    threads_ = mystl::allocator<std::thread>::allocate(nworkers_);
+    for (size_t i = 0; i < nworkers_; ++i)
+    {
+      mystl::construct(threads_ + i, &task_scheduler::work, this, i);
+    }
+  }
+
+  ~task_scheduler()
+  {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stop_.store(true);
+    }
+    wake_.notify_all();
+    for (size_t i = 0; i < nworkers_; ++i)
+    {
+      threads_[i].join();
+    }
+    mystl::destroy(threads_, threads_ + nworkers_);
+    mystl::allocator<std::thread>::deallocate(threads_, nworkers_);
+    mystl::destroy(deques_, deques_ + nworkers_ + 1);
+    mystl::allocator<task_deque>::deallocate(deques_, nworkers_ + 1);
+  }
+
+  // deque of the calling thread, set for the workers only
+  static task_deque*& worker_deque()
+  {
+    static thread_local task_deque* d = nullptr;
+    return d;
+  }
+
+  task_deque* local_deque()
+  {
+    task_deque* d = worker_deque();
+    return d != nullptr ? d : deques_ + nworkers_;
+  }
+
+  // the newest task of own, else the oldest of another deque, starting the
+  // round where the last steal succeeded
+  parallel_task* find_task(task_deque* own, size_t& victim)
+  {
+    parallel_task* t = own->pop_back();
+    for (size_t k = 0; t == nullptr && k <= nworkers_; ++k)
+    {
+      task_deque* d = deques_ + (victim + k) % (nworkers_ + 1);
+      if (d == own) continue;
+      t = d->steal_front();
+      if (t != nullptr) victim = (victim + k) % (nworkers_ + 1);
+    }
+    if (t != nullptr) pending_.fetch_sub(1);
+    return t;
+  }
+
+  static void execute(parallel_task* t)
+  {
+    try
+    {
+      t->run();
+    }
+    catch (...)
+    {
+      t->error = std::current_exception();
+    }
+    t->done.store(true, std::memory_order_release);
+  }
+
+  void work(size_t i)
+  {
+    worker_deque() = deques_ + i;
+    size_t victim = i + 1;
+    while (!stop_.load())
+    {
+      parallel_task* t = find_task(deques_ + i, victim);
+      if (t != nullptr)
+      {
+        execute(t);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      sleeping_.fetch_add(1);
+      wake_.wait(lock, [this] { return stop_.load() || pending_.load() != 0; });
+      sleeping_.fetch_sub(1);
+    }
+  }
+
+private:
+  task_scheduler(const task_scheduler&);
+
+  void operator=(const task_scheduler&);
+};
+
+// number of threads worth using for n units of work,
+// when every thread should get at least grain units
+inline size_t parallel_degree(size_t n, size_t grain)
+{
+  size_t threads = task_scheduler::instance().concurrency();
+  const size_t by_work = grain == 0 ? n : n / grain;
+  if (by_work < threads) threads = by_work;
+  return threads == 0 ? 1 : threads;
+}
+
+// call f() and g(), possibly at the same time, return after both finish
+// f runs on the calling thread, g is left for another thread to steal
+// if f or g throws, the exception reaches the caller once the other one has
+// finished, the one of f if both throw; on a single thread g is not called
+// after f threw
+template <class Function1, class Function2>
+void parallel_invoke(Function1 f, Function2 g)
+{
+  task_scheduler& scheduler = task_scheduler::instance();
+  if (scheduler.concurrency() == 1)
+  {
+    f();
+    g();
+    return;
+  }
+  parallel_task_of<Function2> task(g);
+  scheduler.fork(&task);
+  try
+  {
+    f();
+  }
+  catch (...)
+  {
+    scheduler.join(&task);
+    throw;
+  }
+  scheduler.join(&task);
+  if (task.error) std::rethrow_exception(task.error);
+}
+
+template <class Function>
+void parallel_invoke_range(size_t first, size_t last, Function& f)
+{
+  if (last - first == 1)
+  {
+    f(first);
+    return;
+  }
+  const size_t mid = first + (last - first) / 2;
+  mystl::parallel_invoke([&] { mystl::parallel_invoke_range(first, mid, f); },
+                         [&] { mystl::parallel_invoke_range(mid, last, f); });
+}
+
+// call f(0), f(1), ... f(n - 1), possibly at the same time, by splitting
+// [0, n) in halves recursively; f(0) runs on the calling thread, return after
+// all calls finish
+template <class Function>
+void parallel_invoke_n(size_t n, Function f)
+{
+  if (n == 0) return;
+  mystl::parallel_invoke_range(0, n, f);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_PARALLEL_H_
@@ -0,0 +1,257 @@
+#ifndef _LITESTL_RADIX_HEAP_H_
+#define _LITESTL_RADIX_HEAP_H_
+
+// monotone priority queue for integer keys
+// the smallest key comes out first, and a pushed key must not be less than
+// the key of the last popped element, as with timers and shortest paths
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"       // mystl::pair
+
+namespace mystl
+{
+
+// number of bits needed to represent x
+inline size_t radix_bit_width(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return x == 0 ? 0 : 64 - static_cast<size_t>(__builtin_clzll(x));
+#else
+  size_t n = 0;
+  for (; x != 0; x >>= 1) ++n;
+  return n;
+#endif
+}
+
+// template class: radix_heap
+// element with key k lives in bucket bit_width(k ^ last_), where last_ is the
+// last popped key, so bucket 0 holds the keys equal to last_ and bucket b the
+// keys whose highest bit differing from last_ is bit b - 1
+// when the top is needed and bucket 0 is empty, the first non-empty bucket
+// is scanned for its minimum, which becomes last_, and its elements drop to
+// lower buckets; an element moves down at most once per bit: amortized
+// O(log C) per operation
+template <class Key, class Value>
+class radix_heap
+{
+  static_assert(std::is_integral<Key>::value, "radix_heap needs integer keys");
+
+public:
+  typedef Key                     key_type;
+  typedef Value                   mapped_type;
+  typedef mystl::pair<Key, Value> value_type;
+  typedef const value_type&       const_reference;
+  typedef size_t                  size_type;
+
+private:
+  typedef typename std::make_unsigned<Key>::type ukey;
+
+  static const size_type bits = sizeof(ukey) * CHAR_BIT;
+
+  // growable array of elements
+  struct bucket
+  {
+    value_type* data;
+    size_type   size;
+    size_type   cap;
+  };
+
+  // bucket 0 is refilled lazily when the top is asked for, which does not
+  // change the contents of the heap
+  mutable bucket buckets_[bits + 1];
+  mutable ukey   last_;   // smallest key, or the last popped one
+  size_type      size_;
+
+public:
+  // construct, move and destroy
+  radix_heap() noexcept
+    :last_(0), size_(0)
+  {
+    for (size_type i = 0; i <= bits; ++i)
+    {
+      buckets_[i].data = nullptr;
+      buckets_[i].size = buckets_[i].cap = 0;
+    }
+  }
+
+  radix_heap(radix_heap&& rhs) noexcept
+    :last_(rhs.last_), size_(rhs.size_)
+  {
+    for (size_type i = 0; i <= bits; ++i)
+    {
+      buckets_[i] = rhs.buckets_[i];
+      rhs.buckets_[i].data = nullptr;
+      rhs.buckets_[i].size = rhs.buckets_[i].cap = 0;
+    }
+    rhs.size_ = 0;
+  }
+
+  radix_heap& operator=(radix_heap&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      radix_heap temp(mystl::move(rhs));
+      swap(temp);
+    }
+    return *this;
+  }
+
+  ~radix_heap()
+  {
+    clear();
+    for (size_type i = 0; i <= bits; ++i)
+    {
+      mystl::allocator<value_type>::deallocate(buckets_[i].data, buckets_[i].cap);
+    }
+  }
+
+  void swap(radix_heap& rhs) noexcept
+  {
+    for (size_type i = 0; i <= bits; ++i)
+    {
+      mystl::swap(buckets_[i], rhs.buckets_[i]);
+    }
+    mystl::swap(last_, rhs.last_);
+    mystl::swap(size_, rhs.size_);
+  }
+
+public:
+  // capacity
+  bool      empty() const noexcept { return size_ == 0; }
+  size_type size()  const noexcept { return size_; }
+
+  // access the element with the smallest key
+  const_reference top() const
+  {
+    if (buckets_[0].size == 0) pull();
+    return buckets_[0].data[buckets_[0].size - 1];
+  }
+  Key top_key() const
+  {
+    return top().first;
+  }
+
+  // modify
+  void push(const value_type& val)
+  {
+    push_back(bucket_of(to_ukey(val.first)), val);
+  }
+  void push(value_type&& val)
+  {
+    const auto k = to_ukey(val.first);
+    push_back(bucket_of(k), mystl::move(val));
+  }
+  template <class K, class V>
+  void push(K&& key, V&& val)
+  {
+    push(value_type(mystl::forward<K>(key), mystl::forward<V>(val)));
+  }
+  template <class... Args>
+  void emplace(Args&&... args)
+  {
+    push(value_type(mystl::forward<Args>(args)...));
+  }
+
+  void pop()
+  {
+    bucket& b = buckets_[0];
+    if (b.size == 0) pull();
+    mystl::destroy(b.data + --b.size);
+    --size_;
+  }
+
+  void clear()
+  {
+    for (size_type i = 0; i <= bits; ++i)
+    {
+      mystl::destroy(buckets_[i].data, buckets_[i].data + buckets_[i].size);
+      buckets_[i].size = 0;
+    }
+    size_ = 0;
+    last_ = 0;
+  }
+
+private:
+  // signed keys are shifted so that unsigned order matches
+  static ukey to_ukey(Key k) noexcept
+  {
+    return std::is_signed<Key>::value
+      ? static_cast<ukey>(static_cast<ukey>(k) ^ (static_cast<ukey>(1) << (bits - 1)))
+      : static_cast<ukey>(k);
+  }
+
+  size_type bucket_of(ukey k) const noexcept
+  {
+    return mystl::radix_bit_width(static_cast<uint64_t>(k ^ last_));
+  }
+
+  template <class V>
+  void push_back(size_type i, V&& val)
+  {
+    bucket& b = buckets_[i];
+    if (b.size == b.cap) grow(b);
+    mystl::construct(b.data + b.size, mystl::forward<V>(val));
+    ++b.size;
+    ++size_;
+  }
+
+  static void grow(bucket& b)
+  {
+    const size_type new_cap = b.cap == 0 ? 8 : b.cap * 2;
+    value_type* data = mystl::allocator<value_type>::allocate(new_cap);
+    for (size_type i = 0; i < b.size; ++i)
+    {
+      mystl::construct(data + i, mystl::move(b.data[i]));
+    }
+    mystl::destroy(b.data, b.data + b.size);
+    mystl::allocator<value_type>::deallocate(b.data, b.cap);
+    b.data = data;
+    b.cap = new_cap;
+  }
+
+  // refill bucket 0 from the first non-empty bucket
+  void pull() const
+  {
+    size_type i = 1;
+    while (buckets_[i].size == 0) ++i;
+    bucket& src = buckets_[i];
+    ukey m = to_ukey(src.data[0].first);
+    for (size_type j = 1; j < src.size; ++j)
+    {
+      const auto k = to_ukey(src.data[j].first);
+      if (k < m) m = k;
+    }
+    last_ = m;
+    for (size_type j = 0; j < src.size; ++j)
+    {
+      const auto k = to_ukey(src.data[j].first);
+      bucket& dst = buckets_[bucket_of(k)];
+      if (dst.size == dst.cap) grow(dst);
+      mystl::construct(dst.data + dst.size, mystl::move(src.data[j]));
+      ++dst.size;
+    }
+    mystl::destroy(src.data, src.data + src.size);
+    src.size = 0;
+  }
+
+private:
+  radix_heap(const radix_heap&);
+
+  void operator=(const radix_heap&);
+};
+
+template <class Key, class Value>
+void swap(radix_heap<Key, Value>& lhs, radix_heap<Key, Value>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_RADIX_HEAP_H_
@@ -0,0 +1,328 @@
+#ifndef _LITESTL_RING_BUFFER_H_
+#define _LITESTL_RING_BUFFER_H_
+
+// bounded lock-free queues
+// spsc_ring: one producer thread and one consumer thread
+// mpmc_ring: any number of producers and consumers
+// neither takes a lock or allocates after construction; a full ring refuses
+// a push and an empty one refuses a pop, the caller decides how to wait
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// fields written by different threads are kept this far apart, so a write
+// by one thread does not invalidate the cache line the other one reads
+static const size_t ring_cache_line = 64;
+
+/********************************************************************************/
+// template class: spsc_ring
+// a ring of N slots, N a power of 2, for one producer and one consumer
+// head_ and tail_ count pops and pushes since construction, each side keeps
+// the last value it read of the other side's counter and reads the shared
+// one again only when that copy says the ring is full or empty
+// push_n and pop_n move a batch and publish it with one store
+/********************************************************************************/
+template <class T, size_t N>
+class spsc_ring
+{
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "spsc_ring size must be a power of 2");
+
+public:
+  typedef T      value_type;
+  typedef size_t size_type;
+
+  static const size_type mask = N - 1;
+
+private:
+  // read by both sides, never written after construction
+  alignas(ring_cache_line) T* data_;
+
+  // the consumer's line
+  alignas(ring_cache_line) std::atomic<size_type> head_;
+  size_type cached_tail_;
+
+  // the producer's line
+  alignas(ring_cache_line) std::atomic<size_type> tail_;
+  size_type cached_head_;
+
+public:
+  spsc_ring()
+    :data_(mystl::allocator<T>::allocate(N)), head_(0), cached_tail_(0),
+    tail_(0), cached_head_(0) {}
+
+  ~spsc_ring()
+  {
+    const size_type tail = tail_.load(std::memory_order_relaxed);
+    for (size_type i = head_.load(std::memory_order_relaxed); i != tail; ++i)
+    {
+      mystl::destroy(data_ + (i & mask));
+    }
+    mystl::allocator<T>::deallocate(data_, N);
+  }
+
+  // producer side
+  template <class... Args>
+  bool try_emplace(Args&&... args)
+  {
+    const size_type tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ == N)
+    {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail - cached_head_ == N) return false;
+    }
+    mystl::construct(data_ + (tail & mask), mystl::forward<Args>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_push(const value_type& value) { return try_emplace(value); }
+  bool try_push(value_type&& value)      { return try_emplace(mystl::move(value)); }
+
+  // push up to n elements from first, return the number pushed
+  template <class Iter>
+  size_type push_n(Iter first, size_type n);
+
+  // consumer side
+  bool try_pop(value_type& out)
+  {
+    const size_type head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_)
+    {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head == cached_tail_) return false;
+    }
+    T* p = data_ + (head & mask);
+    out = mystl::move(*p);
+    mystl::destroy(p);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // move up to n elements to result, return the number popped
+  template <class OIter>
+  size_type pop_n(OIter result, size_type n);
+
+  // exact only on a quiet ring, otherwise a snapshot
+  size_type size() const noexcept
+  {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+  bool empty() const noexcept { return size() == 0; }
+
+  static constexpr size_type capacity() noexcept { return N; }
+
+private:
+  spsc_ring(const spsc_ring&);
+
+  void operator=(const spsc_ring&);
+};
+
+template <class T, size_t N>
+const size_t spsc_ring<T, N>::mask;
+
+// a constructor that throws ends the batch, the elements built before it are
+// still published
+template <class T, size_t N>
+template <class Iter>
+typename spsc_ring<T, N>::size_type
+spsc_ring<T, N>::push_n(Iter first, size_type n)
+{
+  const size_type tail = tail_.load(std::memory_order_relaxed);
+  if (N - (tail - cached_head_) < n)
+  {
+    cached_head_ = head_.load(std::memory_order_acquire);
+  }
+  const size_type room = N - (tail - cached_head_);
+  const size_type count = room < n ? room : n;
+  size_type i = 0;
+  try
+  {
+    for (; i < count; ++i, ++first)
+    {
+      mystl::construct(data_ + ((tail + i) & mask), *first);
+    }
+  }
+  catch (...)
+  {
+    tail_.store(tail + i, std::memory_order_release);
+    throw;
+  }
+  tail_.store(tail + count, std::memory_order_release);
+  return count;
+}
+
+template <class T, size_t N>
+template <class OIter>
+typename spsc_ring<T, N>::size_type
+spsc_ring<T, N>::pop_n(OIter result, size_type n)
+{
+  const size_type head = head_.load(std::memory_order_relaxed);
+  if (cached_tail_ - head < n)
+  {
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+  }
+  const size_type ready = cached_tail_ - head;
+  const size_type count = ready < n ? ready : n;
+  for (size_type i = 0; i < count; ++i, ++result)
+  {
+    T* p = data_ + ((head + i) & mask);
+    *result = mystl::move(*p);
+    mystl::destroy(p);
+  }
+  head_.store(head + count, std::memory_order_release);
+  return count;
+}
+
+/********************************************************************************/
+// template class: mpmc_ring
+// a ring whose capacity is rounded up to a power of 2, for any number of
+// producers and consumers
+// every slot has a sequence number: a slot is free for the push of ticket t
+// when its sequence is t, and full for the pop of ticket t when it is t + 1;
+// a thread takes a ticket with one compare-exchange on the shared counter,
+// then builds or takes the element without blocking anyone else
+/********************************************************************************/
+template <class T>
+class mpmc_ring
+{
+public:
+  typedef T      value_type;
+  typedef size_t size_type;
+
+private:
+  struct slot
+  {
+    std::atomic<size_type> seq;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+    T* value() noexcept { return reinterpret_cast<T*>(&storage); }
+  };
+
+  typedef mystl::allocator<slot> slot_allocator;
+
+  alignas(ring_cache_line) slot* slots_;
+  size_type mask_;
+
+  alignas(ring_cache_line) std::atomic<size_type> enqueue_;
+  alignas(ring_cache_line) std::atomic<size_type> dequeue_;
+
+public:
+  explicit mpmc_ring(size_type capacity)
+    :slots_(nullptr), mask_(0), enqueue_(0), dequeue_(0)
+  {
+    size_type n = 2;
+    while (n < capacity) n *= 2;
+    slots_ = slot_allocator::allocate(n);
+    mask_ = n - 1;
+    for (size_type i = 0; i < n; ++i)
+    {
+      mystl::construct(slots_ + i);
+      slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  ~mpmc_ring()
+  {
+    const size_type last = enqueue_.load(std::memory_order_relaxed);
+    for (size_type i = dequeue_.load(std::memory_order_relaxed); i != last; ++i)
+    {
+      mystl::destroy(slots_[i & mask_].value());
+    }
+    mystl::destroy(slots_, slots_ + mask_ + 1);
+    slot_allocator::deallocate(slots_, mask_ + 1);
+  }
+
+  template <class... Args>
+  bool try_emplace(Args&&... args)
+  {
+    // the ticket is taken before the element is built, a throwing constructor
+    // would leave the slot unpublished and stall the consumers for good
+    static_assert(std::is_nothrow_constructible<T, Args&&...>::value,
+                  "mpmc_ring elements must be built without throwing");
+    size_type pos = enqueue_.load(std::memory_order_relaxed);
+    slot* s;
+    while (true)
+    {
+      s = slots_ + (pos & mask_);
+      const size_type seq = s->seq.load(std::memory_order_acquire);
+      const auto diff = static_cast<ptrdiff_t>(seq - pos);
+      if (diff == 0)
+      {
+        if (enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if (diff < 0)
+      {
+        return false;  // the slot still holds the element of the previous lap
+      }
+      else
+      {
+        pos = enqueue_.load(std::memory_order_relaxed);
+      }
+    }
+    mystl::construct(s->value(), mystl::forward<Args>(args)...);
+    s->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_push(const value_type& value) { return try_emplace(value); }
+  bool try_push(value_type&& value)      { return try_emplace(mystl::move(value)); }
+
+  bool try_pop(value_type& out)
+  {
+    size_type pos = dequeue_.load(std::memory_order_relaxed);
+    slot* s;
+    while (true)
+    {
+      s = slots_ + (pos & mask_);
+      const size_type seq = s->seq.load(std::memory_order_acquire);
+      const auto diff = static_cast<ptrdiff_t>(seq - (pos + 1));
+      if (diff == 0)
+      {
+        if (dequeue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if (diff < 0)
+      {
+        return false;  // the push of this ticket has not been published
+      }
+      else
+      {
+        pos = dequeue_.load(std::memory_order_relaxed);
+      }
+    }
+    out = mystl::move(*s->value());
+    mystl::destroy(s->value());
+    // free for the push one lap later
+    s->seq.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  // a snapshot, exact only on a quiet ring
+  size_type size() const noexcept
+  {
+    const size_type last = enqueue_.load(std::memory_order_acquire);
+    const size_type first = dequeue_.load(std::memory_order_acquire);
+    return last > first ? last - first : 0;
+  }
+  bool empty() const noexcept { return size() == 0; }
+
+  size_type capacity() const noexcept { return mask_ + 1; }
+
+private:
+  mpmc_ring(const mpmc_ring&);
+
+  void operator=(const mpmc_ring&);
+};
+
+} // namespace mystl
+
+#endif // !_LITESTL_RING_BUFFER_H_
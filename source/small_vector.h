@@ -0,0 +1,668 @@
+#ifndef _LITESTL_SMALL_VECTOR_H_
+#define _LITESTL_SMALL_VECTOR_H_
+
+// dynamic array with room for N elements inside the object
+// the heap is only used once the size passes N, so short sequences cost no
+// allocation at all
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+
+#include "iterator.h"
+#include "algobase.h"   // mystl::unchecked_copy, mystl::unchecked_move
+#include "allocator.h"
+#include "construct.h"
+#include "uninitialized.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// template class: small_vector
+// T: element type, N: number of elements stored inline, Alloc: allocator
+// begin_ points to the inline buffer until the elements move to the heap;
+// when they fit again, shrink_to_fit brings them back
+template <class T, size_t N, class Alloc = mystl::allocator<T>>
+class small_vector
+{
+  static_assert(N > 0, "small_vector needs inline room for one element");
+
+public:
+  typedef Alloc                     allocator_type;
+  typedef Alloc                     data_allocator;
+
+  typedef T                         value_type;
+  typedef T*                        pointer;
+  typedef const T*                  const_pointer;
+  typedef T&                        reference;
+  typedef const T&                  const_reference;
+  typedef size_t                    size_type;
+  typedef ptrdiff_t                 difference_type;
+
+  typedef value_type*               iterator;
+  typedef const value_type*         const_iterator;
+
+  static const size_type inline_capacity = N;
+
+  allocator_type get_allocator() const { return data_allocator(); }
+
+private:
+  // trivially copyable elements are copied and moved with memmove
+  typedef std::integral_constant<bool,
+    std::is_trivially_copyable<T>::value> trivial;
+
+  iterator begin_;  // head of used space
+  iterator end_;    // tail of used space
+  iterator cap_;    // tail of storage
+  typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf_;
+
+public:
+  // construct, copy, move and destroy
+  small_vector() noexcept
+    :begin_(inline_begin()), end_(begin_), cap_(begin_ + N) {}
+
+  explicit small_vector(size_type n)
+    :small_vector()
+  {
+    reserve(n);
+    end_ = mystl::uninitialized_value_construct_n(begin_, n);
+  }
+
+  small_vector(size_type n, const value_type& value)
+    :small_vector()
+  {
+    reserve(n);
+    end_ = mystl::uninitialized_fill_n(begin_, n, value);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  small_vector(Iter first, Iter last)
+    :small_vector()
+  {
+    insert(end_, first, last);
+  }
+
+  small_vector(const small_vector& rhs)
+    :small_vector()
+  {
+    reserve(rhs.size());
+    end_ = copy_to_raw(rhs.begin_, rhs.end_, begin_, trivial());
+  }
+
+  small_vector(small_vector&& rhs)
+    noexcept(std::is_nothrow_move_constructible<T>::value)
+    :small_vector()
+  {
+    take(rhs);
+  }
+
+  small_vector(std::initializer_list<value_type> ilist)
+    :small_vector()
+  {
+    reserve(ilist.size());
+    end_ = copy_to_raw(ilist.begin(), ilist.end(), begin_, trivial());
+  }
+
+  small_vector& operator=(const small_vector& rhs)
+  {
+    if (this != &rhs) assign(rhs.begin_, rhs.end_);
+    return *this;
+  }
+
+  small_vector& operator=(small_vector&& rhs)
+    noexcept(std::is_nothrow_move_constructible<T>::value)
+  {
+    if (this != &rhs)
+    {
+      clear();
+      take(rhs);
+    }
+    return *this;
+  }
+
+  small_vector& operator=(std::initializer_list<value_type> ilist)
+  {
+    assign(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~small_vector()
+  {
+    mystl::destroy(begin_, end_);
+    free_heap();
+  }
+
+public:
+  // iterators
+  iterator       begin()        noexcept { return begin_; }
+  const_iterator begin()  const noexcept { return begin_; }
+  iterator       end()          noexcept { return end_; }
+  const_iterator end()    const noexcept { return end_; }
+  const_iterator cbegin() const noexcept { return begin_; }
+  const_iterator cend()   const noexcept { return end_; }
+
+  // capacity
+  bool      empty()     const noexcept { return begin_ == end_; }
+  size_type size()      const noexcept { return static_cast<size_type>(end_ - begin_); }
+  size_type capacity()  const noexcept { return static_cast<size_type>(cap_ - begin_); }
+  size_type max_size()  const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+  bool      is_inline() const noexcept { return begin_ == inline_begin(); }
+
+  void reserve(size_type n)
+  {
+    if (n <= capacity()) return;
+    if (n > max_size()) throw std::length_error("small_vector<T, N>'s size too big");
+    grow_to(n);
+  }
+
+  void shrink_to_fit();
+
+  // access
+  reference       operator[](size_type n)       { return *(begin_ + n); }
+  const_reference operator[](size_type n) const { return *(begin_ + n); }
+
+  reference at(size_type n)
+  {
+    if (n >= size()) throw std::out_of_range("small_vector<T, N>::at() subscript out of range");
+    return *(begin_ + n);
+  }
+  const_reference at(size_type n) const
+  {
+    if (n >= size()) throw std::out_of_range("small_vector<T, N>::at() subscript out of range");
+    return *(begin_ + n);
+  }
+
+  reference       front()       { return *begin_; }
+  const_reference front() const { return *begin_; }
+  reference       back()        { return *(end_ - 1); }
+  const_reference back()  const { return *(end_ - 1); }
+
+  pointer       data()       noexcept { return begin_; }
+  const_pointer data() const noexcept { return begin_; }
+
+  // modify
+  void assign(size_type n, const value_type& value)
+  {
+    clear();
+    insert(end_, n, value);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void assign(Iter first, Iter last)
+  {
+    clear();
+    insert(end_, first, last);
+  }
+
+  void assign(std::initializer_list<value_type> ilist)
+  {
+    assign(ilist.begin(), ilist.end());
+  }
+
+  template <class... Args>
+  void emplace_back(Args&&... args)
+  {
+    if (end_ != cap_)
+    {
+      data_allocator::construct(end_, mystl::forward<Args>(args)...);
+      ++end_;
+    }
+    else
+    {
+      realloc_emplace_back(mystl::forward<Args>(args)...);
+    }
+  }
+
+  void push_back(const value_type& value) { emplace_back(value); }
+  void push_back(value_type&& value)      { emplace_back(mystl::move(value)); }
+
+  void pop_back()
+  {
+    --end_;
+    data_allocator::destroy(end_);
+  }
+
+  template <class... Args>
+  iterator emplace(const_iterator pos, Args&&... args);
+
+  iterator insert(const_iterator pos, const value_type& value)
+  {
+    return emplace(pos, value);
+  }
+  iterator insert(const_iterator pos, value_type&& value)
+  {
+    return emplace(pos, mystl::move(value));
+  }
+
+  iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  iterator insert(const_iterator pos, Iter first, Iter last)
+  {
+    return range_insert(pos - begin_, first, last, iterator_category(first));
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+  {
+    return range_insert(pos - begin_, ilist.begin(), ilist.end(),
+                        forward_iterator_tag());
+  }
+
+  iterator erase(const_iterator pos)
+  {
+    return erase(pos, pos + 1);
+  }
+  iterator erase(const_iterator first, const_iterator last);
+
+  void clear() noexcept
+  {
+    mystl::destroy(begin_, end_);
+    end_ = begin_;
+  }
+
+  void resize(size_type n);
+  void resize(size_type n, const value_type& value);
+  void resize(size_type n, default_init_t);
+
+  void swap(small_vector& rhs);
+
+private:
+  // helper functions
+  iterator inline_begin() noexcept
+  {
+    return reinterpret_cast<iterator>(&buf_);
+  }
+  const_iterator inline_begin() const noexcept
+  {
+    return reinterpret_cast<const_iterator>(&buf_);
+  }
+
+  void free_heap()
+  {
+    if (!is_inline()) data_allocator::deallocate(begin_, capacity());
+  }
+
+  // copy / move [first, last) to raw storage at result, return its end
+  // move_to_raw leaves nothing to destroy in the source
+  template <class IIter>
+  static iterator copy_to_raw(IIter first, IIter last, iterator result,
+                              std::true_type)
+  {
+    return mystl::unchecked_copy(first, last, result);
+  }
+  template <class IIter>
+  static iterator copy_to_raw(IIter first, IIter last, iterator result,
+                              std::false_type)
+  {
+    return mystl::uninitialized_copy(first, last, result);
+  }
+
+  static iterator move_to_raw(iterator first, iterator last, iterator result,
+                              std::true_type)
+  {
+    return mystl::unchecked_move(first, last, result);
+  }
+  static iterator move_to_raw(iterator first, iterator last, iterator result,
+                              std::false_type)
+  {
+    auto end = mystl::uninitialized_move(first, last, result);
+    mystl::destroy(first, last);
+    return end;
+  }
+
+  size_type next_capacity(size_type add) const;
+  void      grow_to(size_type new_cap);
+  void      take(small_vector& rhs);
+
+  template <class... Args>
+  void realloc_emplace_back(Args&&... args);
+
+  template <class IIter>
+  iterator range_insert(difference_type idx, IIter first, IIter last,
+                        input_iterator_tag);
+  template <class FIter>
+  iterator range_insert(difference_type idx, FIter first, FIter last,
+                        forward_iterator_tag);
+};
+
+template <class T, size_t N, class Alloc>
+const typename small_vector<T, N, Alloc>::size_type
+small_vector<T, N, Alloc>::inline_capacity;
+
+/*****************************************************************************************/
+
+// move the elements back inline if they fit, else drop the unused capacity
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::shrink_to_fit()
+{
+  if (is_inline() || end_ == cap_) return;
+  if (size() <= N)
+  {
+    auto old_begin = begin_;
+    const auto old_cap = capacity();
+    end_ = move_to_raw(begin_, end_, inline_begin(), trivial());
+    begin_ = inline_begin();
+    cap_ = begin_ + N;
+    data_allocator::deallocate(old_begin, old_cap);
+  }
+  else
+  {
+    grow_to(size());
+  }
+}
+
+// construct an element at pos
+template <class T, size_t N, class Alloc>
+template <class... Args>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::emplace(const_iterator pos, Args&&... args)
+{
+  const auto idx = pos - begin_;
+  if (pos == end_)
+  {
+    emplace_back(mystl::forward<Args>(args)...);
+    return begin_ + idx;
+  }
+  // args may refer to an element that is about to move
+  value_type temp(mystl::forward<Args>(args)...);
+  if (end_ == cap_) grow_to(next_capacity(1));
+  iterator xpos = begin_ + idx;
+  data_allocator::construct(end_, mystl::move(*(end_ - 1)));
+  ++end_;
+  mystl::move_backward(xpos, end_ - 2, end_ - 1);
+  *xpos = mystl::move(temp);
+  return xpos;
+}
+
+// insert n copies of value at pos
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::insert(const_iterator pos, size_type n,
+                                  const value_type& value)
+{
+  const auto idx = pos - begin_;
+  if (n == 0) return begin_ + idx;
+  const value_type temp(value);
+  if (static_cast<size_type>(cap_ - end_) < n) grow_to(next_capacity(n));
+  iterator xpos = begin_ + idx;
+  const auto after = static_cast<size_type>(end_ - xpos);
+  const auto old_end = end_;
+  if (after > n)
+  {
+    end_ = mystl::uninitialized_move(old_end - n, old_end, old_end);
+    mystl::move_backward(xpos, old_end - n, old_end);
+    mystl::fill_n(xpos, n, temp);
+  }
+  else
+  {
+    end_ = mystl::uninitialized_fill_n(old_end, n - after, temp);
+    end_ = mystl::uninitialized_move(xpos, old_end, end_);
+    mystl::fill_n(xpos, after, temp);
+  }
+  return xpos;
+}
+
+// erase [first, last)
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::erase(const_iterator first, const_iterator last)
+{
+  iterator xfirst = begin_ + (first - begin_);
+  if (first == last) return xfirst;
+  iterator xlast = begin_ + (last - begin_);
+  auto new_end = mystl::move(xlast, end_, xfirst);
+  mystl::destroy(new_end, end_);
+  end_ = new_end;
+  return xfirst;
+}
+
+// resize
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::resize(size_type n)
+{
+  if (n < size())
+  {
+    erase(begin_ + n, end_);
+    return;
+  }
+  reserve(n);
+  end_ = mystl::uninitialized_value_construct_n(end_, n - size());
+}
+
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::resize(size_type n, const value_type& value)
+{
+  if (n < size()) erase(begin_ + n, end_);
+  else            insert(end_, n - size(), value);
+}
+
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::resize(size_type n, default_init_t)
+{
+  if (n < size())
+  {
+    erase(begin_ + n, end_);
+    return;
+  }
+  reserve(n);
+  end_ = mystl::uninitialized_default_construct_n(end_, n - size());
+}
+
+// two heap buffers swap pointers, inline elements have to move
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::swap(small_vector& rhs)
+{
+  if (this == &rhs) return;
+  if (!is_inline() && !rhs.is_inline())
+  {
+    mystl::swap(begin_, rhs.begin_);
+    mystl::swap(end_, rhs.end_);
+    mystl::swap(cap_, rhs.cap_);
+    return;
+  }
+  small_vector temp(mystl::move(rhs));
+  rhs = mystl::move(*this);
+  *this = mystl::move(temp);
+}
+
+/*****************************************************************************************/
+// helper function
+
+// capacity to hold add more elements, at least twice the current one
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::size_type
+small_vector<T, N, Alloc>::next_capacity(size_type add) const
+{
+  const auto old_size = size();
+  if (max_size() - old_size < add)
+  {
+    throw std::length_error("small_vector<T, N>'s size too big");
+  }
+  const auto cap = capacity();
+  const auto grown = cap > max_size() / 2 ? max_size() : cap * 2;
+  return grown < old_size + add ? old_size + add : grown;
+}
+
+// move the elements to heap storage of new_cap elements
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::grow_to(size_type new_cap)
+{
+  const auto old_size = size();
+  auto new_begin = data_allocator::allocate(new_cap);
+  try
+  {
+    move_to_raw(begin_, end_, new_begin, trivial());
+  }
+  catch (...)
+  {
+    data_allocator::deallocate(new_begin, new_cap);
+    throw;
+  }
+  free_heap();
+  begin_ = new_begin;
+  end_ = new_begin + old_size;
+  cap_ = new_begin + new_cap;
+}
+
+// take the elements of rhs, *this being empty: a heap buffer is stolen,
+// inline elements are moved
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::take(small_vector& rhs)
+{
+  if (!rhs.is_inline())
+  {
+    free_heap();
+    begin_ = rhs.begin_;
+    end_ = rhs.end_;
+    cap_ = rhs.cap_;
+    rhs.begin_ = rhs.inline_begin();
+    rhs.end_ = rhs.begin_;
+    rhs.cap_ = rhs.begin_ + N;
+  }
+  else
+  {
+    end_ = move_to_raw(rhs.begin_, rhs.end_, begin_, trivial());
+    rhs.end_ = rhs.begin_;
+  }
+}
+
+// construct the new element in the new storage first, since args may refer
+// to an element that is about to move
+// if a move throws, the new element and storage are freed and the old
+// elements are all left in place
+template <class T, size_t N, class Alloc>
+template <class... Args>
+void small_vector<T, N, Alloc>::realloc_emplace_back(Args&&... args)
+{
+  const auto new_cap = next_capacity(1);
+  const auto old_size = size();
+  auto new_begin = data_allocator::allocate(new_cap);
+  try
+  {
+    data_allocator::construct(new_begin + old_size, mystl::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    data_allocator::deallocate(new_begin, new_cap);
+    throw;
+  }
+  try
+  {
+    move_to_raw(begin_, end_, new_begin, trivial());
+  }
+  catch (...)
+  {
+    data_allocator::destroy(new_begin + old_size);
+    data_allocator::deallocate(new_begin, new_cap);
+    throw;
+  }
+  free_heap();
+  begin_ = new_begin;
+  end_ = new_begin + old_size + 1;
+  cap_ = new_begin + new_cap;
+}
+
+// a single pass range is appended and rotated into place
+template <class T, size_t N, class Alloc>
+template <class IIter>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::range_insert(difference_type idx, IIter first,
+                                        IIter last, input_iterator_tag)
+{
+  const auto old_size = size();
+  for (; first != last; ++first) emplace_back(*first);
+  mystl::rotate(begin_ + idx, begin_ + old_size, end_);
+  return begin_ + idx;
+}
+
+template <class T, size_t N, class Alloc>
+template <class FIter>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::range_insert(difference_type idx, FIter first,
+                                        FIter last, forward_iterator_tag)
+{
+  const auto n = static_cast<size_type>(mystl::distance(first, last));
+  if (n == 0) return begin_ + idx;
+  if (static_cast<size_type>(cap_ - end_) < n) grow_to(next_capacity(n));
+  iterator xpos = begin_ + idx;
+  const auto after = static_cast<size_type>(end_ - xpos);
+  const auto old_end = end_;
+  if (after > n)
+  {
+    end_ = mystl::uninitialized_move(old_end - n, old_end, old_end);
+    mystl::move_backward(xpos, old_end - n, old_end);
+    mystl::copy(first, last, xpos);
+  }
+  else
+  {
+    auto mid = first;
+    mystl::advance(mid, after);
+    end_ = mystl::uninitialized_copy(mid, last, old_end);
+    end_ = mystl::uninitialized_move(xpos, old_end, end_);
+    mystl::copy(first, mid, xpos);
+  }
+  return xpos;
+}
+
+/*****************************************************************************************/
+// overload comparison operators
+
+template <class T, size_t N, class Alloc>
+bool operator==(const small_vector<T, N, Alloc>& lhs,
+                const small_vector<T, N, Alloc>& rhs)
+{
+  return lhs.size() == rhs.size() &&
+    mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t N, class Alloc>
+bool operator<(const small_vector<T, N, Alloc>& lhs,
+               const small_vector<T, N, Alloc>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(),
+                                        rhs.begin(), rhs.end());
+}
+
+template <class T, size_t N, class Alloc>
+bool operator!=(const small_vector<T, N, Alloc>& lhs,
+                const small_vector<T, N, Alloc>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, size_t N, class Alloc>
+bool operator>(const small_vector<T, N, Alloc>& lhs,
+               const small_vector<T, N, Alloc>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, size_t N, class Alloc>
+bool operator<=(const small_vector<T, N, Alloc>& lhs,
+                const small_vector<T, N, Alloc>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, size_t N, class Alloc>
+bool operator>=(const small_vector<T, N, Alloc>& lhs,
+                const small_vector<T, N, Alloc>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// overload mystl::swap
+template <class T, size_t N, class Alloc>
+void swap(small_vector<T, N, Alloc>& lhs, small_vector<T, N, Alloc>& rhs)
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_SMALL_VECTOR_H_
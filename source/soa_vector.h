@@ -0,0 +1,538 @@
+#ifndef _LITESTL_SOA_VECTOR_H_
+#define _LITESTL_SOA_VECTOR_H_
+
+// dynamic array stored as a structure of arrays
+// soa_vector<Ts...> holds rows of (Ts...), but every field lives in its own
+// contiguous column, aligned to a cache line; a loop over one field reads
+// only that field, and column<I>() hands it to the pointer paths of the
+// algorithms, e.g. accumulate and inner_product in numeric.h
+// the iterators yield rows as tuples of references, so they are proxies:
+// they have no operator-> and sort cannot swap through them
+
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+#include "iterator.h"
+#include "algobase.h"   // mystl::move
+#include "allocator.h"
+#include "construct.h"
+#include "span.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "vector.h"     // mystl::geometric_growth
+
+namespace mystl
+{
+
+// every column starts on its own cache line
+static const size_t soa_alignment = 64;
+
+// column indices, the C++11 stand-in for index_sequence
+template <size_t... Is>
+struct soa_indices {};
+
+template <size_t N, size_t... Is>
+struct soa_make_indices :public soa_make_indices<N - 1, N - 1, Is...> {};
+
+template <size_t... Is>
+struct soa_make_indices<0, Is...>
+{
+  typedef soa_indices<Is...> type;
+};
+
+template <size_t I>
+struct soa_index :public std::integral_constant<size_t, I> {};
+
+// iterator of soa_vector
+// it keeps the column pointers and a row number, so it stays valid until the
+// columns move, the same as a vector iterator
+template <bool Const, class... Ts>
+struct soa_vector_iterator
+  :public mystl::iterator<mystl::random_access_iterator_tag, std::tuple<Ts...>,
+  ptrdiff_t, void, typename std::conditional<Const,
+  std::tuple<const Ts&...>, std::tuple<Ts&...>>::type>
+{
+  typedef std::tuple<Ts...>                               value_type;
+  typedef typename std::conditional<Const,
+    std::tuple<const Ts&...>, std::tuple<Ts&...>>::type    reference;
+  typedef void                                            pointer;
+  typedef ptrdiff_t                                       difference_type;
+  typedef typename std::conditional<Const,
+    std::tuple<const Ts*...>, std::tuple<Ts*...>>::type    columns;
+
+  typedef soa_vector_iterator<false, Ts...>               iterator;
+  typedef soa_vector_iterator<true, Ts...>                const_iterator;
+  typedef soa_vector_iterator                             self;
+
+  columns cols;
+  size_t  row;
+
+  soa_vector_iterator() noexcept :cols(), row(0) {}
+  soa_vector_iterator(const columns& c, size_t n) noexcept :cols(c), row(n) {}
+  soa_vector_iterator(const iterator& rhs) noexcept :cols(rhs.cols), row(rhs.row) {}
+
+  soa_vector_iterator& operator=(const soa_vector_iterator&) = default;
+
+  reference operator*() const
+  { return at(row, typename soa_make_indices<sizeof...(Ts)>::type()); }
+  reference operator[](difference_type n) const
+  { return at(row + n, typename soa_make_indices<sizeof...(Ts)>::type()); }
+
+  self& operator++()                  { ++row; return *this; }
+  self  operator++(int)               { self tmp = *this; ++row; return tmp; }
+  self& operator--()                  { --row; return *this; }
+  self  operator--(int)               { self tmp = *this; --row; return tmp; }
+  self& operator+=(difference_type n) { row += n; return *this; }
+  self& operator-=(difference_type n) { row -= n; return *this; }
+
+  self operator+(difference_type n) const { return self(cols, row + n); }
+  self operator-(difference_type n) const { return self(cols, row - n); }
+
+  difference_type operator-(const self& rhs) const
+  { return static_cast<difference_type>(row) - static_cast<difference_type>(rhs.row); }
+
+  bool operator==(const self& rhs) const { return row == rhs.row; }
+  bool operator!=(const self& rhs) const { return row != rhs.row; }
+  bool operator< (const self& rhs) const { return row <  rhs.row; }
+  bool operator> (const self& rhs) const { return row >  rhs.row; }
+  bool operator<=(const self& rhs) const { return row <= rhs.row; }
+  bool operator>=(const self& rhs) const { return row >= rhs.row; }
+
+private:
+  template <size_t... Is>
+  reference at(size_t n, soa_indices<Is...>) const
+  {
+    return reference(std::get<Is>(cols)[n]...);
+  }
+};
+
+template <bool Const, class... Ts>
+soa_vector_iterator<Const, Ts...>
+operator+(ptrdiff_t n, const soa_vector_iterator<Const, Ts...>& it)
+{
+  return it + n;
+}
+
+// template class: soa_vector
+// Ts: the fields of a row, one column each
+// all columns share one allocation; a column of capacity n takes n elements
+// rounded up to soa_alignment bytes
+template <class... Ts>
+class soa_vector
+{
+  static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+
+public:
+  typedef std::tuple<Ts...>                   value_type;
+  typedef std::tuple<Ts&...>                  reference;
+  typedef std::tuple<const Ts&...>            const_reference;
+  typedef size_t                              size_type;
+  typedef ptrdiff_t                           difference_type;
+
+  typedef soa_vector_iterator<false, Ts...>   iterator;
+  typedef soa_vector_iterator<true, Ts...>    const_iterator;
+
+  // the element type of column I
+  template <size_t I>
+  struct column_type
+  {
+    typedef typename std::tuple_element<I, value_type>::type type;
+  };
+
+  static const size_type column_count = sizeof...(Ts);
+
+private:
+  typedef mystl::allocator<unsigned char>                     byte_allocator;
+  typedef std::tuple<Ts*...>                                  columns;
+  typedef typename soa_make_indices<sizeof...(Ts)>::type      indices;
+  typedef soa_index<sizeof...(Ts)>                            last_column;
+
+  unsigned char* block_;  // the allocation, not aligned
+  columns        cols_;   // head of each column
+  size_type      size_;
+  size_type      cap_;
+
+public:
+  // construct, copy, move and destroy
+  soa_vector() noexcept
+    :block_(nullptr), cols_(), size_(0), cap_(0) {}
+
+  explicit soa_vector(size_type n)
+    :soa_vector()
+  {
+    resize(n);
+  }
+
+  soa_vector(const soa_vector& rhs)
+    :soa_vector()
+  {
+    reserve(rhs.size_);
+    for (size_type i = 0; i < rhs.size_; ++i)
+      copy_row(rhs, i, indices());
+  }
+
+  soa_vector(soa_vector&& rhs) noexcept
+    :block_(rhs.block_), cols_(rhs.cols_), size_(rhs.size_), cap_(rhs.cap_)
+  {
+    rhs.block_ = nullptr;
+    rhs.cols_ = columns();
+    rhs.size_ = 0;
+    rhs.cap_ = 0;
+  }
+
+  soa_vector& operator=(const soa_vector& rhs)
+  {
+    if (this != &rhs)
+    {
+      soa_vector tmp(rhs);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  soa_vector& operator=(soa_vector&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      soa_vector tmp(mystl::move(rhs));
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  ~soa_vector()
+  {
+    destroy_rows(0, size_, soa_index<0>());
+    byte_allocator::deallocate(block_);
+  }
+
+public:
+  // iterators
+  iterator       begin()        noexcept { return iterator(cols_, 0); }
+  const_iterator begin()  const noexcept { return const_iterator(cols_, 0); }
+  iterator       end()          noexcept { return iterator(cols_, size_); }
+  const_iterator end()    const noexcept { return const_iterator(cols_, size_); }
+
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend()   const noexcept { return end(); }
+
+  // capacity
+  bool      empty()    const noexcept { return size_ == 0; }
+  size_type size()     const noexcept { return size_; }
+  size_type capacity() const noexcept { return cap_; }
+  size_type max_size() const noexcept
+  { return static_cast<size_type>(-1) / 2 / row_bytes(soa_index<0>()); }
+
+  void reserve(size_type n)
+  {
+    if (n > max_size()) throw std::length_error("soa_vector<Ts...>'s size too big");
+    if (n > cap_) reallocate(n);
+  }
+
+  void shrink_to_fit()
+  {
+    if (size_ < cap_)
+    {
+      if (size_ == 0)
+      {
+        byte_allocator::deallocate(block_);
+        block_ = nullptr;
+        cols_ = columns();
+        cap_ = 0;
+      }
+      else
+      {
+        reallocate(size_);
+      }
+    }
+  }
+
+  // access
+  reference       operator[](size_type n)       { return row(n, indices()); }
+  const_reference operator[](size_type n) const { return row(n, indices()); }
+
+  reference at(size_type n)
+  {
+    if (n >= size_) throw std::out_of_range("soa_vector<Ts...>::at() subscript out of range");
+    return row(n, indices());
+  }
+  const_reference at(size_type n) const
+  {
+    if (n >= size_) throw std::out_of_range("soa_vector<Ts...>::at() subscript out of range");
+    return row(n, indices());
+  }
+
+  reference       front()       { return row(0, indices()); }
+  const_reference front() const { return row(0, indices()); }
+  reference       back()        { return row(size_ - 1, indices()); }
+  const_reference back()  const { return row(size_ - 1, indices()); }
+
+  // column access
+  template <size_t I>
+  typename column_type<I>::type* data() noexcept
+  { return std::get<I>(cols_); }
+  template <size_t I>
+  const typename column_type<I>::type* data() const noexcept
+  { return std::get<I>(cols_); }
+
+  template <size_t I>
+  mystl::span<typename column_type<I>::type> column() noexcept
+  { return mystl::span<typename column_type<I>::type>(std::get<I>(cols_), size_); }
+  template <size_t I>
+  mystl::span<const typename column_type<I>::type> column() const noexcept
+  { return mystl::span<const typename column_type<I>::type>(std::get<I>(cols_), size_); }
+
+  // modify
+  // emplace_back takes one argument per column
+  template <class... Args>
+  void emplace_back(Args&& ...args)
+  {
+    static_assert(sizeof...(Args) == sizeof...(Ts),
+                  "emplace_back takes one argument per column");
+    if (size_ == cap_)
+    {
+      // the arguments may refer to this vector, so the row is built in the
+      // new columns before the old ones move
+      if (size_ == max_size()) throw std::length_error("soa_vector<Ts...>'s size too big");
+      const auto n = mystl::geometric_growth<>::next_capacity(cap_, size_ + 1, max_size());
+      columns cols;
+      auto block = allocate_block(n, cols);
+      try
+      {
+        construct_row(cols, size_, soa_index<0>(), mystl::forward<Args>(args)...);
+      }
+      catch (...)
+      {
+        byte_allocator::deallocate(block);
+        throw;
+      }
+      replace_block(block, cols, n);
+    }
+    else
+    {
+      construct_row(cols_, size_, soa_index<0>(), mystl::forward<Args>(args)...);
+    }
+    ++size_;
+  }
+
+  void push_back(const value_type& value) { push_row(value, indices()); }
+  void push_back(value_type&& value)      { push_row(mystl::move(value), indices()); }
+
+  void pop_back()
+  {
+    --size_;
+    destroy_rows(size_, size_ + 1, soa_index<0>());
+  }
+
+  iterator erase(const_iterator pos)
+  {
+    return erase(pos, pos + 1);
+  }
+
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    if (first != last)
+    {
+      const auto n = static_cast<size_type>(last - first);
+      erase_rows(first.row, last.row, soa_index<0>());
+      size_ -= n;
+    }
+    return iterator(cols_, first.row);
+  }
+
+  void resize(size_type n)
+  {
+    if (n < size_)
+    {
+      destroy_rows(n, size_, soa_index<0>());
+      size_ = n;
+    }
+    else if (n > size_)
+    {
+      reserve(n);
+      for (; size_ < n; ++size_)
+        construct_default(size_, soa_index<0>());
+    }
+  }
+
+  void clear() noexcept
+  {
+    destroy_rows(0, size_, soa_index<0>());
+    size_ = 0;
+  }
+
+  void swap(soa_vector& rhs) noexcept
+  {
+    mystl::swap(block_, rhs.block_);
+    cols_.swap(rhs.cols_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(cap_, rhs.cap_);
+  }
+
+private:
+  // helper functions
+  // each walks the columns from I up to the last one
+
+  // the bytes of one row, all columns
+  template <size_t I>
+  static size_type row_bytes(soa_index<I>) noexcept
+  {
+    return sizeof(typename column_type<I>::type) + row_bytes(soa_index<I + 1>());
+  }
+  static size_type row_bytes(last_column) noexcept { return 0; }
+
+  static size_type round_up(size_type bytes) noexcept
+  {
+    return (bytes + soa_alignment - 1) & ~(soa_alignment - 1);
+  }
+
+  // the bytes of the columns for capacity n
+  template <size_t I>
+  static size_type block_bytes(size_type n, soa_index<I>) noexcept
+  {
+    typedef typename column_type<I>::type T;
+    static_assert(alignof(T) <= soa_alignment, "column type is over-aligned");
+    return round_up(n * sizeof(T)) + block_bytes(n, soa_index<I + 1>());
+  }
+  static size_type block_bytes(size_type, last_column) noexcept { return 0; }
+
+  // lay out the columns for capacity n from p
+  template <size_t I>
+  static void place_columns(unsigned char* p, size_type n, columns& cols, soa_index<I>) noexcept
+  {
+    typedef typename column_type<I>::type T;
+    std::get<I>(cols) = reinterpret_cast<T*>(p);
+    place_columns(p + round_up(n * sizeof(T)), n, cols, soa_index<I + 1>());
+  }
+  static void place_columns(unsigned char*, size_type, columns&, last_column) noexcept {}
+
+  template <size_t I>
+  void relocate_columns(columns& to, soa_index<I>) noexcept
+  {
+    mystl::uninitialized_relocate(std::get<I>(cols_), std::get<I>(cols_) + size_,
+                                  std::get<I>(to));
+    relocate_columns(to, soa_index<I + 1>());
+  }
+  void relocate_columns(columns&, last_column) noexcept {}
+
+  template <size_t I>
+  void destroy_rows(size_type first, size_type last, soa_index<I>) noexcept
+  {
+    mystl::destroy(std::get<I>(cols_) + first, std::get<I>(cols_) + last);
+    destroy_rows(first, last, soa_index<I + 1>());
+  }
+  void destroy_rows(size_type, size_type, last_column) noexcept {}
+
+  // move the rows after last down to first and destroy the tail
+  template <size_t I>
+  void erase_rows(size_type first, size_type last, soa_index<I>)
+  {
+    auto col = std::get<I>(cols_);
+    mystl::move(col + last, col + size_, col + first);
+    mystl::destroy(col + size_ - (last - first), col + size_);
+    erase_rows(first, last, soa_index<I + 1>());
+  }
+  void erase_rows(size_type, size_type, last_column) {}
+
+  // construct row n column by column; if one throws, the columns already
+  // constructed are destroyed again
+  template <size_t I, class Arg, class... Rest>
+  static void construct_row(columns& cols, size_type n, soa_index<I>,
+                            Arg&& arg, Rest&& ...rest)
+  {
+    mystl::construct(std::get<I>(cols) + n, mystl::forward<Arg>(arg));
+    try
+    {
+      construct_row(cols, n, soa_index<I + 1>(), mystl::forward<Rest>(rest)...);
+    }
+    catch (...)
+    {
+      mystl::destroy(std::get<I>(cols) + n);
+      throw;
+    }
+  }
+  static void construct_row(columns&, size_type, last_column) {}
+
+  template <size_t I>
+  void construct_default(size_type n, soa_index<I>)
+  {
+    typedef typename column_type<I>::type T;
+    ::new (static_cast<void*>(std::get<I>(cols_) + n)) T();
+    try
+    {
+      construct_default(n, soa_index<I + 1>());
+    }
+    catch (...)
+    {
+      mystl::destroy(std::get<I>(cols_) + n);
+      throw;
+    }
+  }
+  void construct_default(size_type, last_column) {}
+
+  template <size_t... Is>
+  reference row(size_type n, soa_indices<Is...>)
+  {
+    return reference(std::get<Is>(cols_)[n]...);
+  }
+
+  template <size_t... Is>
+  const_reference row(size_type n, soa_indices<Is...>) const
+  {
+    return const_reference(std::get<Is>(cols_)[n]...);
+  }
+
+  template <size_t... Is>
+  void copy_row(const soa_vector& rhs, size_type n, soa_indices<Is...>)
+  {
+    emplace_back(std::get<Is>(rhs.cols_)[n]...);
+  }
+
+  template <class Tuple, size_t... Is>
+  void push_row(Tuple&& value, soa_indices<Is...>)
+  {
+    emplace_back(std::get<Is>(mystl::forward<Tuple>(value))...);
+  }
+
+  // allocate the columns for capacity n
+  static unsigned char* allocate_block(size_type n, columns& cols)
+  {
+    auto block = byte_allocator::allocate(block_bytes(n, soa_index<0>()) + soa_alignment - 1);
+    const auto addr = reinterpret_cast<size_t>(block);
+    place_columns(block + (round_up(addr) - addr), n, cols, soa_index<0>());
+    return block;
+  }
+
+  // move the rows into the new columns and free the old ones
+  void replace_block(unsigned char* block, columns& cols, size_type n) noexcept
+  {
+    relocate_columns(cols, soa_index<0>());
+    byte_allocator::deallocate(block_);
+    block_ = block;
+    cols_ = cols;
+    cap_ = n;
+  }
+
+  void reallocate(size_type n)
+  {
+    columns cols;
+    auto block = allocate_block(n, cols);
+    replace_block(block, cols, n);
+  }
+};
+
+template <class... Ts>
+const size_t soa_vector<Ts...>::column_count;
+
+// overload mystl::swap
+template <class... Ts>
+void swap(soa_vector<Ts...>& lhs, soa_vector<Ts...>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_SOA_VECTOR_H_
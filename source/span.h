@@ -0,0 +1,179 @@
+#ifndef _LITESTL_SPAN_H_
+#define _LITESTL_SPAN_H_
+
+// view of contiguous elements owned by someone else
+// a span is a pointer and a length, or only a pointer when the length is
+// part of its type; its iterators are plain pointers, so copy, fill_n, equal
+// and the other algorithms take their pointer paths on it
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace mystl
+{
+
+// the length of the span is only known at run time
+static const size_t dynamic_extent = static_cast<size_t>(-1);
+
+// a fixed extent is not stored
+template <class T, size_t Extent>
+struct span_storage
+{
+  T* data;
+
+  span_storage(T* p, size_t) noexcept :data(p) {}
+
+  size_t size() const noexcept { return Extent; }
+};
+
+template <class T>
+struct span_storage<T, dynamic_extent>
+{
+  T*     data;
+  size_t count;
+
+  span_storage(T* p, size_t n) noexcept :data(p), count(n) {}
+
+  size_t size() const noexcept { return count; }
+};
+
+// U can be viewed as T: same type, or T adds const or volatile
+template <class U, class T>
+struct span_convertible
+  :public std::is_convertible<U(*)[], T(*)[]> {};
+
+// a container with data() and size() over elements that can be viewed as T
+template <class Container, class T, class = void>
+struct span_compatible :public std::false_type {};
+
+template <class Container, class T>
+struct span_compatible<Container, T, typename std::enable_if<
+  std::is_pointer<decltype(std::declval<Container&>().data())>::value &&
+  std::is_convertible<decltype(std::declval<Container&>().size()), size_t>::value>::type>
+  :public span_convertible<
+    typename std::remove_pointer<decltype(std::declval<Container&>().data())>::type, T> {};
+
+// template class: span
+// T: element type, Extent: number of elements, or dynamic_extent
+// the elements must outlive the span; nothing is checked, the same as a
+// pointer
+template <class T, size_t Extent = dynamic_extent>
+class span
+{
+public:
+  typedef T                                  element_type;
+  typedef typename std::remove_cv<T>::type   value_type;
+  typedef T*                                 pointer;
+  typedef const T*                           const_pointer;
+  typedef T&                                 reference;
+  typedef const T&                           const_reference;
+  typedef size_t                             size_type;
+  typedef ptrdiff_t                          difference_type;
+
+  typedef T*                                 iterator;
+  typedef const T*                           const_iterator;
+
+  static const size_type extent = Extent;
+
+private:
+  span_storage<T, Extent> storage_;
+
+public:
+  // construct
+  span() noexcept
+    :storage_(nullptr, 0)
+  {
+    static_assert(Extent == 0 || Extent == dynamic_extent,
+                  "only an empty or dynamic span has a default");
+  }
+
+  span(pointer p, size_type n) noexcept
+    :storage_(p, n) {}
+
+  template <class It, typename std::enable_if<
+    std::is_pointer<It>::value && std::is_convertible<It, pointer>::value, int>::type = 0>
+  span(It first, It last) noexcept
+    :storage_(first, static_cast<size_type>(last - first)) {}
+
+  template <size_t N, typename std::enable_if<
+    Extent == dynamic_extent || Extent == N, int>::type = 0>
+  span(element_type (&arr)[N]) noexcept
+    :storage_(arr, N) {}
+
+  template <class Container, typename std::enable_if<
+    Extent == dynamic_extent && !std::is_array<Container>::value &&
+    span_compatible<Container, T>::value, int>::type = 0>
+  span(Container& c)
+    :storage_(c.data(), static_cast<size_type>(c.size())) {}
+
+  template <class Container, typename std::enable_if<
+    Extent == dynamic_extent && !std::is_array<Container>::value &&
+    span_compatible<const Container, T>::value, int>::type = 0>
+  span(const Container& c)
+    :storage_(c.data(), static_cast<size_type>(c.size())) {}
+
+  template <class U, size_t N, typename std::enable_if<
+    (Extent == dynamic_extent || Extent == N) &&
+    span_convertible<U, T>::value, int>::type = 0>
+  span(const span<U, N>& rhs) noexcept
+    :storage_(rhs.data(), rhs.size()) {}
+
+  // iterators
+  iterator begin() const noexcept { return storage_.data; }
+  iterator end()   const noexcept { return storage_.data + storage_.size(); }
+
+  const_iterator cbegin() const noexcept { return storage_.data; }
+  const_iterator cend()   const noexcept { return storage_.data + storage_.size(); }
+
+  // capacity
+  size_type size()       const noexcept { return storage_.size(); }
+  size_type size_bytes() const noexcept { return storage_.size() * sizeof(T); }
+  bool      empty()      const noexcept { return storage_.size() == 0; }
+
+  // access
+  reference operator[](size_type n) const { return storage_.data[n]; }
+  reference front()                 const { return storage_.data[0]; }
+  reference back()                  const { return storage_.data[storage_.size() - 1]; }
+  pointer   data()         const noexcept { return storage_.data; }
+
+  // subviews
+  span<T> first(size_type n) const
+  { return span<T>(storage_.data, n); }
+  span<T> last(size_type n) const
+  { return span<T>(storage_.data + (storage_.size() - n), n); }
+  span<T> subspan(size_type offset, size_type n = dynamic_extent) const
+  {
+    return span<T>(storage_.data + offset,
+                   n == dynamic_extent ? storage_.size() - offset : n);
+  }
+
+  template <size_t N>
+  span<T, N> first() const
+  { return span<T, N>(storage_.data, N); }
+  template <size_t N>
+  span<T, N> last() const
+  { return span<T, N>(storage_.data + (storage_.size() - N), N); }
+};
+
+template <class T, size_t Extent>
+const size_t span<T, Extent>::extent;
+
+// the bytes of the elements
+template <class T, size_t Extent>
+span<const unsigned char> as_bytes(span<T, Extent> s) noexcept
+{
+  return span<const unsigned char>(reinterpret_cast<const unsigned char*>(s.data()),
+                                   s.size_bytes());
+}
+
+template <class T, size_t Extent>
+span<unsigned char> as_writable_bytes(span<T, Extent> s) noexcept
+{
+  static_assert(!std::is_const<T>::value, "as_writable_bytes needs writable elements");
+  return span<unsigned char>(reinterpret_cast<unsigned char*>(s.data()), s.size_bytes());
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_SPAN_H_
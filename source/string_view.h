@@ -0,0 +1,320 @@
+#ifndef _LITESTL_STRING_VIEW_H_
+#define _LITESTL_STRING_VIEW_H_
+
+// read-only view of contiguous characters owned by someone else
+// a view is a pointer and a length, passing one copies no characters; its
+// iterators are plain pointers, so the algorithms take their pointer paths
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "char_traits.h"
+#include "functional.h"  // mystl::hash, mystl::hash_bytes
+
+namespace mystl
+{
+
+// template class: basic_string_view
+// CharT: character type, Traits: character operations
+// the viewed characters must outlive the view, and need not end with a
+// terminator
+template <class CharT, class Traits = mystl::char_traits<CharT>>
+class basic_string_view
+{
+public:
+  typedef Traits                    traits_type;
+
+  typedef CharT                     value_type;
+  typedef const CharT*              pointer;
+  typedef const CharT*              const_pointer;
+  typedef const CharT&              reference;
+  typedef const CharT&              const_reference;
+  typedef size_t                    size_type;
+  typedef ptrdiff_t                 difference_type;
+
+  typedef const value_type*         iterator;
+  typedef const value_type*         const_iterator;
+
+  static const size_type npos = static_cast<size_type>(-1);
+
+private:
+  const_pointer data_;
+  size_type     size_;
+
+public:
+  // construct
+  constexpr basic_string_view() noexcept
+    :data_(nullptr), size_(0) {}
+
+  constexpr basic_string_view(const_pointer s, size_type n) noexcept
+    :data_(s), size_(n) {}
+
+  basic_string_view(const_pointer s)
+    :data_(s), size_(traits_type::length(s)) {}
+
+  // iterators
+  constexpr const_iterator begin()  const noexcept { return data_; }
+  constexpr const_iterator end()    const noexcept { return data_ + size_; }
+  constexpr const_iterator cbegin() const noexcept { return data_; }
+  constexpr const_iterator cend()   const noexcept { return data_ + size_; }
+
+  // capacity
+  constexpr bool      empty()    const noexcept { return size_ == 0; }
+  constexpr size_type size()     const noexcept { return size_; }
+  constexpr size_type length()   const noexcept { return size_; }
+  constexpr size_type max_size() const noexcept { return npos / sizeof(value_type); }
+
+  // access
+  constexpr const_reference operator[](size_type n) const { return data_[n]; }
+
+  const_reference at(size_type n) const
+  {
+    if (n >= size_) throw std::out_of_range("basic_string_view<CharT>::at() subscript out of range");
+    return data_[n];
+  }
+
+  constexpr const_reference front() const { return data_[0]; }
+  constexpr const_reference back()  const { return data_[size_ - 1]; }
+  constexpr const_pointer   data()  const noexcept { return data_; }
+
+  // modify the view, not the characters
+  void remove_prefix(size_type n) noexcept { data_ += n; size_ -= n; }
+  void remove_suffix(size_type n) noexcept { size_ -= n; }
+
+  void swap(basic_string_view& rhs) noexcept
+  {
+    const basic_string_view tmp = *this;
+    *this = rhs;
+    rhs = tmp;
+  }
+
+  size_type copy(CharT* dst, size_type n, size_type pos = 0) const
+  {
+    check_pos(pos);
+    n = clamp(pos, n);
+    traits_type::copy(dst, data_ + pos, n);
+    return n;
+  }
+
+  basic_string_view substr(size_type pos = 0, size_type n = npos) const
+  {
+    check_pos(pos);
+    return basic_string_view(data_ + pos, clamp(pos, n));
+  }
+
+  bool starts_with(basic_string_view v) const noexcept
+  {
+    return size_ >= v.size_ && traits_type::compare(data_, v.data_, v.size_) == 0;
+  }
+  bool starts_with(value_type c) const noexcept
+  {
+    return size_ != 0 && traits_type::eq(data_[0], c);
+  }
+  bool ends_with(basic_string_view v) const noexcept
+  {
+    return size_ >= v.size_ &&
+           traits_type::compare(data_ + size_ - v.size_, v.data_, v.size_) == 0;
+  }
+  bool ends_with(value_type c) const noexcept
+  {
+    return size_ != 0 && traits_type::eq(data_[size_ - 1], c);
+  }
+
+  // compare
+  int compare(basic_string_view v) const noexcept
+  {
+    const int r = traits_type::compare(data_, v.data_, size_ < v.size_ ? size_ : v.size_);
+    if (r != 0) return r;
+    return size_ < v.size_ ? -1 : (size_ > v.size_ ? 1 : 0);
+  }
+  int compare(size_type pos, size_type n, basic_string_view v) const
+  { return substr(pos, n).compare(v); }
+  int compare(size_type pos, size_type n1, basic_string_view v,
+              size_type pos2, size_type n2) const
+  { return substr(pos, n1).compare(v.substr(pos2, n2)); }
+  int compare(const_pointer s) const
+  { return compare(basic_string_view(s)); }
+  int compare(size_type pos, size_type n1, const_pointer s) const
+  { return substr(pos, n1).compare(basic_string_view(s)); }
+  int compare(size_type pos, size_type n1, const_pointer s, size_type n2) const
+  { return substr(pos, n1).compare(basic_string_view(s, n2)); }
+
+  // search
+  size_type find(basic_string_view v, size_type pos = 0) const noexcept
+  { return find(v.data_, pos, v.size_); }
+  size_type find(const_pointer s, size_type pos, size_type n) const noexcept
+  {
+    if (pos > size_) return npos;
+    return offset(mystl::string_find(data_ + pos, size_ - pos, s, n, traits_type()));
+  }
+  size_type find(const_pointer s, size_type pos = 0) const
+  { return find(s, pos, traits_type::length(s)); }
+  size_type find(value_type c, size_type pos = 0) const noexcept
+  {
+    if (pos >= size_) return npos;
+    return offset(traits_type::find(data_ + pos, size_ - pos, c));
+  }
+
+  size_type rfind(basic_string_view v, size_type pos = npos) const noexcept
+  { return rfind(v.data_, pos, v.size_); }
+  size_type rfind(const_pointer s, size_type pos, size_type n) const noexcept
+  {
+    if (n > size_) return npos;
+    const size_type start = pos < size_ - n ? pos : size_ - n;
+    return offset(mystl::string_rfind(data_, start + n, s, n, traits_type()));
+  }
+  size_type rfind(const_pointer s, size_type pos = npos) const
+  { return rfind(s, pos, traits_type::length(s)); }
+  size_type rfind(value_type c, size_type pos = npos) const noexcept
+  { return rfind(&c, pos, 1); }
+
+  size_type find_first_of(basic_string_view v, size_type pos = 0) const noexcept
+  { return find_in(v.data_, pos, v.size_, true); }
+  size_type find_first_of(const_pointer s, size_type pos, size_type n) const noexcept
+  { return find_in(s, pos, n, true); }
+  size_type find_first_of(const_pointer s, size_type pos = 0) const
+  { return find_in(s, pos, traits_type::length(s), true); }
+  size_type find_first_of(value_type c, size_type pos = 0) const noexcept
+  { return find(c, pos); }
+
+  size_type find_last_of(basic_string_view v, size_type pos = npos) const noexcept
+  { return rfind_in(v.data_, pos, v.size_, true); }
+  size_type find_last_of(const_pointer s, size_type pos, size_type n) const noexcept
+  { return rfind_in(s, pos, n, true); }
+  size_type find_last_of(const_pointer s, size_type pos = npos) const
+  { return rfind_in(s, pos, traits_type::length(s), true); }
+  size_type find_last_of(value_type c, size_type pos = npos) const noexcept
+  { return rfind(&c, pos, 1); }
+
+  size_type find_first_not_of(basic_string_view v, size_type pos = 0) const noexcept
+  { return find_in(v.data_, pos, v.size_, false); }
+  size_type find_first_not_of(const_pointer s, size_type pos, size_type n) const noexcept
+  { return find_in(s, pos, n, false); }
+  size_type find_first_not_of(const_pointer s, size_type pos = 0) const
+  { return find_in(s, pos, traits_type::length(s), false); }
+  size_type find_first_not_of(value_type c, size_type pos = 0) const noexcept
+  { return find_in(&c, pos, 1, false); }
+
+  size_type find_last_not_of(basic_string_view v, size_type pos = npos) const noexcept
+  { return rfind_in(v.data_, pos, v.size_, false); }
+  size_type find_last_not_of(const_pointer s, size_type pos, size_type n) const noexcept
+  { return rfind_in(s, pos, n, false); }
+  size_type find_last_not_of(const_pointer s, size_type pos = npos) const
+  { return rfind_in(s, pos, traits_type::length(s), false); }
+  size_type find_last_not_of(value_type c, size_type pos = npos) const noexcept
+  { return rfind_in(&c, pos, 1, false); }
+
+private:
+  // helper functions
+  void check_pos(size_type pos) const
+  {
+    if (pos > size_) throw std::out_of_range("basic_string_view<CharT>'s position out of range");
+  }
+  size_type clamp(size_type pos, size_type n) const noexcept
+  {
+    const size_type rest = size_ - pos;
+    return n < rest ? n : rest;
+  }
+  size_type offset(const_pointer r) const noexcept
+  {
+    return r == nullptr ? npos : static_cast<size_type>(r - data_);
+  }
+
+  size_type find_in(const_pointer s, size_type pos, size_type n, bool member) const noexcept
+  {
+    if (pos >= size_) return npos;
+    return offset(mystl::string_find_in(data_ + pos, size_ - pos, s, n, member, traits_type()));
+  }
+  size_type rfind_in(const_pointer s, size_type pos, size_type n, bool member) const noexcept
+  {
+    if (size_ == 0) return npos;
+    const size_type last = pos < size_ - 1 ? pos : size_ - 1;
+    return offset(mystl::string_rfind_in(data_, last + 1, s, n, member, traits_type()));
+  }
+};
+
+template <class CharT, class Traits>
+const typename basic_string_view<CharT, Traits>::size_type
+basic_string_view<CharT, Traits>::npos;
+
+/*****************************************************************************************/
+// compare
+// a C string on one side is viewed before comparing
+template <class CharT, class Traits>
+bool operator==(basic_string_view<CharT, Traits> lhs, basic_string_view<CharT, Traits> rhs) noexcept
+{
+  return lhs.size() == rhs.size() && Traits::compare(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+
+template <class CharT, class Traits>
+bool operator!=(basic_string_view<CharT, Traits> lhs, basic_string_view<CharT, Traits> rhs) noexcept
+{
+  return !(lhs == rhs);
+}
+
+template <class CharT, class Traits>
+bool operator<(basic_string_view<CharT, Traits> lhs, basic_string_view<CharT, Traits> rhs) noexcept
+{
+  return lhs.compare(rhs) < 0;
+}
+
+template <class CharT, class Traits>
+bool operator>(basic_string_view<CharT, Traits> lhs, basic_string_view<CharT, Traits> rhs) noexcept
+{
+  return rhs < lhs;
+}
+
+template <class CharT, class Traits>
+bool operator<=(basic_string_view<CharT, Traits> lhs, basic_string_view<CharT, Traits> rhs) noexcept
+{
+  return !(rhs < lhs);
+}
+
+template <class CharT, class Traits>
+bool operator>=(basic_string_view<CharT, Traits> lhs, basic_string_view<CharT, Traits> rhs) noexcept
+{
+  return !(lhs < rhs);
+}
+
+#define MYSTL_STRING_VIEW_COMPARE(OP)                                                  \
+template <class CharT, class Traits>                                                   \
+bool operator OP(basic_string_view<CharT, Traits> lhs, const CharT* rhs)               \
+{ return lhs OP basic_string_view<CharT, Traits>(rhs); }                               \
+template <class CharT, class Traits>                                                   \
+bool operator OP(const CharT* lhs, basic_string_view<CharT, Traits> rhs)               \
+{ return basic_string_view<CharT, Traits>(lhs) OP rhs; }
+
+MYSTL_STRING_VIEW_COMPARE(==)
+MYSTL_STRING_VIEW_COMPARE(!=)
+MYSTL_STRING_VIEW_COMPARE(<)
+MYSTL_STRING_VIEW_COMPARE(>)
+MYSTL_STRING_VIEW_COMPARE(<=)
+MYSTL_STRING_VIEW_COMPARE(>=)
+
+#undef MYSTL_STRING_VIEW_COMPARE
+
+// overload mystl::swap
+template <class CharT, class Traits>
+void swap(basic_string_view<CharT, Traits>& lhs, basic_string_view<CharT, Traits>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+// hash of the characters, equal to the hash of a basic_string holding them
+template <class CharT, class Traits>
+struct hash<basic_string_view<CharT, Traits>>
+{
+  size_t operator()(basic_string_view<CharT, Traits> v) const noexcept
+  {
+    return mystl::hash_bytes(v.data(), v.size() * sizeof(CharT));
+  }
+};
+
+typedef basic_string_view<char>     string_view;
+typedef basic_string_view<wchar_t>  wstring_view;
+typedef basic_string_view<char16_t> u16string_view;
+typedef basic_string_view<char32_t> u32string_view;
+
+} // namespace mystl
+
+#endif // !_LITESTL_STRING_VIEW_H_
@@ -20,6 +20,14 @@ using m_bool_constant = m_integral_constant<bool, b>;
 typedef m_bool_constant<true>  m_true_type;
 typedef m_bool_constant<false> m_false_type;
 
+// is_trivially_relocatable
+// an object of T can be moved to another address by copying its bytes, and
+// nothing is left to destroy at the old one; true for trivially copyable
+// types, specialize it for others that hold no pointer into themselves
+template <class T>
+struct is_trivially_relocatable
+  :public m_bool_constant<std::is_trivially_copyable<T>::value> {};
+
 } // namespace mystl
 
 #endif // !_LITESTL_TYPE_TRAITS_H_
\ No newline at end of file
@@ -0,0 +1,377 @@
+#ifndef _LITESTL_UNINITIALIZED_H_
+#define _LITESTL_UNINITIALIZED_H_
+
+// construct objects in uninitialized memory
+// uninitialized_copy, uninitialized_copy_n, uninitialized_fill,
+// uninitialized_fill_n, uninitialized_move, uninitialized_move_n,
+// uninitialized_value_construct_n, uninitialized_default_construct_n,
+// uninitialized_relocate
+// if a constructor throws, the objects already built are destroyed
+
+#include <cstring>
+
+#include "algobase.h"
+#include "construct.h"
+#include "iterator.h"
+#include "type_traits.h"
+#include "util.h"
+
+namespace mystl
+{
+
+/********************************************************************************/
+// uninitialized_copy
+// copy [first, last) to the uninitialized space starting at result
+// return an iter pointing to the end of result
+/********************************************************************************/
+template <class IIter, class FIter>
+FIter unchecked_uninit_copy(IIter first, IIter last, FIter result,
+                            std::true_type)
+{
+  return mystl::copy(first, last, result);
+}
+
+template <class IIter, class FIter>
+FIter unchecked_uninit_copy(IIter first, IIter last, FIter result,
+                            std::false_type)
+{
+  auto cur = result;
+  try
+  {
+    for (; first != last; ++first, ++cur)
+    {
+      mystl::construct(&*cur, *first);
+    }
+  }
+  catch (...)
+  {
+    mystl::destroy(result, cur);
+    throw;
+  }
+  return cur;
+}
+
+template <class IIter, class FIter>
+FIter uninitialized_copy(IIter first, IIter last, FIter result)
+{
+  return mystl::unchecked_uninit_copy(first, last, result,
+    std::integral_constant<bool, std::is_trivially_copy_assignable<
+    typename iterator_traits<FIter>::value_type>::value>{});
+}
+
+/********************************************************************************/
+// uninitialized_copy_n
+// copy [first, first + n) to the uninitialized space starting at result
+// return an iter pointing to the end of result
+/********************************************************************************/
+template <class IIter, class Size, class FIter>
+FIter unchecked_uninit_copy_n(IIter first, Size n, FIter result,
+                              std::true_type)
+{
+  return mystl::copy_n(first, n, result).second;
+}
+
+template <class IIter, class Size, class FIter>
+FIter unchecked_uninit_copy_n(IIter first, Size n, FIter result,
+                              std::false_type)
+{
+  auto cur = result;
+  try
+  {
+    for (; n > 0; --n, ++first, ++cur)
+    {
+      mystl::construct(&*cur, *first);
+    }
+  }
+  catch (...)
+  {
+    mystl::destroy(result, cur);
+    throw;
+  }
+  return cur;
+}
+
+template <class IIter, class Size, class FIter>
+FIter uninitialized_copy_n(IIter first, Size n, FIter result)
+{
+  return mystl::unchecked_uninit_copy_n(first, n, result,
+    std::integral_constant<bool, std::is_trivially_copy_assignable<
+    typename iterator_traits<FIter>::value_type>::value>{});
+}
+
+/********************************************************************************/
+// uninitialized_fill
+// fill the uninitialized space [first, last) with val
+/********************************************************************************/
+template <class FIter, class T>
+void unchecked_uninit_fill(FIter first, FIter last, const T& val,
+                           std::true_type)
+{
+  mystl::fill(first, last, val);
+}
+
+template <class FIter, class T>
+void unchecked_uninit_fill(FIter first, FIter last, const T& val,
+                           std::false_type)
+{
+  auto cur = first;
+  try
+  {
+    for (; cur != last; ++cur)
+    {
+      mystl::construct(&*cur, val);
+    }
+  }
+  catch (...)
+  {
+    mystl::destroy(first, cur);
+    throw;
+  }
+}
+
+template <class FIter, class T>
+void uninitialized_fill(FIter first, FIter last, const T& val)
+{
+  mystl::unchecked_uninit_fill(first, last, val,
+    std::integral_constant<bool, std::is_trivially_copy_assignable<
+    typename iterator_traits<FIter>::value_type>::value>{});
+}
+
+/********************************************************************************/
+// uninitialized_fill_n
+// fill the uninitialized space [first, first + n) with val
+// return an iter pointing to the end of filled space
+/********************************************************************************/
+template <class FIter, class Size, class T>
+FIter unchecked_uninit_fill_n(FIter first, Size n, const T& val,
+                              std::true_type)
+{
+  return mystl::fill_n(first, n, val);
+}
+
+template <class FIter, class Size, class T>
+FIter unchecked_uninit_fill_n(FIter first, Size n, const T& val,
+                              std::false_type)
+{
+  auto cur = first;
+  try
+  {
+    for (; n > 0; --n, ++cur)
+    {
+      mystl::construct(&*cur, val);
+    }
+  }
+  catch (...)
+  {
+    mystl::destroy(first, cur);
+    throw;
+  }
+  return cur;
+}
+
+template <class FIter, class Size, class T>
+FIter uninitialized_fill_n(FIter first, Size n, const T& val)
+{
+  return mystl::unchecked_uninit_fill_n(first, n, val,
+    std::integral_constant<bool, std::is_trivially_copy_assignable<
+    typename iterator_traits<FIter>::value_type>::value>{});
+}
+
+/********************************************************************************/
+// uninitialized_move
+// move [first, last) to the uninitialized space starting at result
+// return an iter pointing to the end of result
+/********************************************************************************/
+template <class IIter, class FIter>
+FIter unchecked_uninit_move(IIter first, IIter last, FIter result,
+                            std::true_type)
+{
+  return mystl::move(first, last, result);
+}
+
+template <class IIter, class FIter>
+FIter unchecked_uninit_move(IIter first, IIter last, FIter result,
+                            std::false_type)
+{
+  auto cur = result;
+  try
+  {
+    for (; first != last; ++first, ++cur)
+    {
+      mystl::construct(&*cur, mystl::move(*first));
+    }
+  }
+  catch (...)
+  {
+    mystl::destroy(result, cur);
+    throw;
+  }
+  return cur;
+}
+
+template <class IIter, class FIter>
+FIter uninitialized_move(IIter first, IIter last, FIter result)
+{
+  return mystl::unchecked_uninit_move(first, last, result,
+    std::integral_constant<bool, std::is_trivially_move_assignable<
+    typename iterator_traits<IIter>::value_type>::value>{});
+}
+
+/********************************************************************************/
+// uninitialized_move_n
+// move [first, first + n) to the uninitialized space starting at result
+// return an iter pointing to the end of result
+/********************************************************************************/
+template <class IIter, class Size, class FIter>
+FIter unchecked_uninit_move_n(IIter first, Size n, FIter result,
+                              std::true_type)
+{
+  return mystl::move(first, first + n, result);
+}
+
+template <class IIter, class Size, class FIter>
+FIter unchecked_uninit_move_n(IIter first, Size n, FIter result,
+                              std::false_type)
+{
+  auto cur = result;
+  try
+  {
+    for (; n > 0; --n, ++first, ++cur)
+    {
+      mystl::construct(&*cur, mystl::move(*first));
+    }
+  }
+  catch (...)
+  {
+    mystl::destroy(result, cur);
+    throw;
+  }
+  return cur;
+}
+
+template <class IIter, class Size, class FIter>
+FIter uninitialized_move_n(IIter first, Size n, FIter result)
+{
+  return mystl::unchecked_uninit_move_n(first, n, result,
+    std::integral_constant<bool, std::is_trivially_move_assignable<
+    typename iterator_traits<IIter>::value_type>::value>{});
+}
+
+/********************************************************************************/
+// uninitialized_value_construct_n
+// construct value-initialized objects in [first, first + n)
+// return an iter pointing to the end of constructed space
+/********************************************************************************/
+template <class FIter, class Size>
+FIter unchecked_uninit_value_n(FIter first, Size n, std::true_type)
+{
+  typedef typename iterator_traits<FIter>::value_type T;
+  return mystl::fill_n(first, n, T());
+}
+
+template <class FIter, class Size>
+FIter unchecked_uninit_value_n(FIter first, Size n, std::false_type)
+{
+  auto cur = first;
+  try
+  {
+    for (; n > 0; --n, ++cur)
+    {
+      mystl::construct(&*cur);
+    }
+  }
+  catch (...)
+  {
+    mystl::destroy(first, cur);
+    throw;
+  }
+  return cur;
+}
+
+template <class FIter, class Size>
+FIter uninitialized_value_construct_n(FIter first, Size n)
+{
+  typedef typename iterator_traits<FIter>::value_type T;
+  return mystl::unchecked_uninit_value_n(first, n,
+    std::integral_constant<bool, std::is_trivially_default_constructible<T>::value &&
+    std::is_trivially_copy_assignable<T>::value>{});
+}
+
+/********************************************************************************/
+// uninitialized_default_construct_n
+// construct default-initialized objects in [first, first + n), objects of
+// trivial types are left with indeterminate values, nothing is written
+// return an iter pointing to the end of constructed space
+/********************************************************************************/
+template <class FIter, class Size>
+FIter unchecked_uninit_default_n(FIter first, Size n, std::true_type)
+{
+  mystl::advance(first, n);
+  return first;
+}
+
+template <class FIter, class Size>
+FIter unchecked_uninit_default_n(FIter first, Size n, std::false_type)
+{
+  typedef typename iterator_traits<FIter>::value_type T;
+  auto cur = first;
+  try
+  {
+    for (; n > 0; --n, ++cur)
+    {
+      ::new (static_cast<void*>(&*cur)) T;
+    }
+  }
+  catch (...)
+  {
+    mystl::destroy(first, cur);
+    throw;
+  }
+  return cur;
+}
+
+template <class FIter, class Size>
+FIter uninitialized_default_construct_n(FIter first, Size n)
+{
+  typedef typename iterator_traits<FIter>::value_type T;
+  return mystl::unchecked_uninit_default_n(first, n,
+    std::is_trivially_default_constructible<T>{});
+}
+
+/********************************************************************************/
+// uninitialized_relocate
+// move the objects of [first, last) to the uninitialized space starting at
+// result and destroy them, the two ranges must not overlap
+// trivially relocatable objects are copied with memcpy
+// return a pointer to the end of result
+/********************************************************************************/
+template <class T>
+T* unchecked_uninit_relocate(T* first, T* last, T* result, std::true_type)
+{
+  const auto n = static_cast<size_t>(last - first);
+  if (n != 0)
+  {
+    std::memcpy(static_cast<void*>(result), static_cast<const void*>(first),
+                n * sizeof(T));
+  }
+  return result + n;
+}
+
+template <class T>
+T* unchecked_uninit_relocate(T* first, T* last, T* result, std::false_type)
+{
+  auto end = mystl::uninitialized_move(first, last, result);
+  mystl::destroy(first, last);
+  return end;
+}
+
+template <class T>
+T* uninitialized_relocate(T* first, T* last, T* result)
+{
+  return mystl::unchecked_uninit_relocate(first, last, result,
+    std::integral_constant<bool, is_trivially_relocatable<T>::value>{});
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_UNINITIALIZED_H_
@@ -0,0 +1,780 @@
+#ifndef _LITESTL_UNORDERED_MAP_H_
+#define _LITESTL_UNORDERED_MAP_H_
+
+// flat open addressing hash map
+// elements live in one array of slots, with one control byte per slot:
+//   empty : 0x80
+//   full  : the low 7 bits of the hash (h2)
+// a lookup starts at slot (hash >> 7) & mask and probes linearly, comparing
+// 16 control bytes at once with SSE2, so keys are only compared for slots
+// whose h2 matches; it stops at the first group holding an empty slot
+// erase shifts the following elements of the run backward instead of
+// leaving a tombstone, so probe sequences never grow longer with churn
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "iterator.h"
+#include "allocator.h"
+#include "construct.h"
+#include "functional.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// 16 control bytes, read from any slot index
+struct hash_ctrl_group
+{
+  static const size_t  width = 16;
+  static const uint8_t empty = 0x80;
+
+#if defined(__SSE2__)
+  __m128i ctrl;
+
+  explicit hash_ctrl_group(const uint8_t* p) noexcept
+    :ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+  // bit i is set if byte i equals h2
+  uint32_t match(uint8_t h2) const noexcept
+  {
+    return static_cast<uint32_t>(_mm_movemask_epi8(
+      _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(h2)), ctrl)));
+  }
+
+  // only empty has the high bit set
+  uint32_t match_empty() const noexcept
+  {
+    return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+  }
+#else
+  const uint8_t* ctrl;
+
+  explicit hash_ctrl_group(const uint8_t* p) noexcept :ctrl(p) {}
+
+  uint32_t match(uint8_t h2) const noexcept
+  {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < width; ++i)
+    {
+      mask |= static_cast<uint32_t>(ctrl[i] == h2) << i;
+    }
+    return mask;
+  }
+
+  uint32_t match_empty() const noexcept
+  {
+    return match(empty);
+  }
+#endif
+
+  uint32_t match_full() const noexcept
+  {
+    return ~match_empty() & 0xffffu;
+  }
+
+  // index of the lowest set bit, mask must not be 0
+  static size_t lowest(uint32_t mask) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctz(mask));
+#else
+    size_t i = 0;
+    while ((mask & 1) == 0)
+    {
+      mask >>= 1;
+      ++i;
+    }
+    return i;
+#endif
+  }
+};
+
+template <class Key, class T, class Hash, class KeyEqual>
+class unordered_map;
+
+// iterator of unordered_map, it walks the slots from the one after the map's
+// anchor, an empty slot, around the array back to the anchor; no run of full
+// slots crosses the anchor, so the backward shift of erase only moves elements
+// that the walk has not reached yet
+template <class Map, class Ref, class Ptr>
+struct unordered_map_iterator
+  :public mystl::iterator<mystl::forward_iterator_tag, typename Map::value_type>
+{
+  typedef typename Map::value_type  value_type;
+  typedef Ptr                       pointer;
+  typedef Ref                       reference;
+  typedef ptrdiff_t                 difference_type;
+  typedef size_t                    size_type;
+
+  typedef unordered_map_iterator<Map, typename Map::value_type&,
+                                 typename Map::value_type*> iterator;
+  typedef unordered_map_iterator<Map, const typename Map::value_type&,
+                                 const typename Map::value_type*> const_iterator;
+
+  const Map* map;
+  size_type  index;  // map->bucket_count() for end
+
+  unordered_map_iterator() noexcept :map(nullptr), index(0) {}
+  unordered_map_iterator(const Map* m, size_type i) noexcept :map(m), index(i) {}
+  unordered_map_iterator(const iterator& rhs) noexcept
+    :map(rhs.map), index(rhs.index) {}
+
+  unordered_map_iterator& operator=(const unordered_map_iterator&) = default;
+
+  reference operator*()  const { return map->slots_[index]; }
+  pointer   operator->() const { return &(operator*()); }
+
+  unordered_map_iterator& operator++()
+  {
+    index = map->next_full(index);
+    return *this;
+  }
+  unordered_map_iterator operator++(int)
+  {
+    unordered_map_iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  bool operator==(const unordered_map_iterator& rhs) const { return index == rhs.index; }
+  bool operator!=(const unordered_map_iterator& rhs) const { return index != rhs.index; }
+};
+
+// template class: unordered_map
+// Hash should spread its output over all bits, mystl::hash does
+template <class Key, class T, class Hash = mystl::hash<Key>,
+          class KeyEqual = mystl::equal_to<Key>>
+class unordered_map
+{
+  template <class Map, class Ref, class Ptr>
+  friend struct unordered_map_iterator;
+
+public:
+  typedef Key                             key_type;
+  typedef T                               mapped_type;
+  typedef mystl::pair<const Key, T>       value_type;
+  typedef Hash                            hasher;
+  typedef KeyEqual                        key_equal;
+
+  typedef mystl::allocator<value_type>    data_allocator;
+  typedef mystl::allocator<uint8_t>       ctrl_allocator;
+
+  typedef value_type*                     pointer;
+  typedef const value_type*               const_pointer;
+  typedef value_type&                     reference;
+  typedef const value_type&               const_reference;
+  typedef size_t                          size_type;
+  typedef ptrdiff_t                       difference_type;
+
+  typedef unordered_map_iterator<unordered_map, value_type&, value_type*> iterator;
+  typedef unordered_map_iterator<unordered_map, const value_type&,
+                                 const value_type*>                       const_iterator;
+
+private:
+  typedef hash_ctrl_group group;
+
+  static const size_type min_bucket_count = 16;  // at least one group
+
+  uint8_t*    ctrl_;    // bucket_count_ + group::width bytes, the tail repeats the head
+  value_type* slots_;
+  size_type   bucket_count_;  // 0 or a power of 2
+  size_type   size_;
+  size_type   anchor_;  // an empty slot, where iteration starts and ends
+  hasher      hash_;
+  key_equal   equal_;
+
+public:
+  // construct, copy, move and destroy
+  unordered_map()
+    :ctrl_(nullptr), slots_(nullptr), bucket_count_(0), size_(0), anchor_(0),
+    hash_(), equal_() {}
+
+  explicit unordered_map(size_type n, const Hash& hf = Hash(),
+                         const KeyEqual& eql = KeyEqual())
+    :ctrl_(nullptr), slots_(nullptr), bucket_count_(0), size_(0), anchor_(0),
+    hash_(hf), equal_(eql)
+  {
+    reserve(n);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  unordered_map(Iter first, Iter last)
+    :unordered_map()
+  {
+    insert(first, last);
+  }
+
+  unordered_map(std::initializer_list<value_type> ilist)
+    :unordered_map()
+  {
+    reserve(ilist.size());
+    insert(ilist.begin(), ilist.end());
+  }
+
+  unordered_map(const unordered_map& rhs)
+    :ctrl_(nullptr), slots_(nullptr), bucket_count_(0), size_(0), anchor_(0),
+    hash_(rhs.hash_), equal_(rhs.equal_)
+  {
+    copy_from(rhs);
+  }
+
+  unordered_map(unordered_map&& rhs) noexcept
+    :ctrl_(rhs.ctrl_), slots_(rhs.slots_), bucket_count_(rhs.bucket_count_),
+    size_(rhs.size_), anchor_(rhs.anchor_),
+    hash_(mystl::move(rhs.hash_)), equal_(mystl::move(rhs.equal_))
+  {
+    rhs.ctrl_ = nullptr;
+    rhs.slots_ = nullptr;
+    rhs.bucket_count_ = 0;
+    rhs.size_ = 0;
+    rhs.anchor_ = 0;
+  }
+
+  unordered_map& operator=(const unordered_map& rhs)
+  {
+    if (this != &rhs)
+    {
+      unordered_map tmp(rhs);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  unordered_map& operator=(unordered_map&& rhs) noexcept
+  {
+    unordered_map tmp(mystl::move(rhs));
+    swap(tmp);
+    return *this;
+  }
+
+  unordered_map& operator=(std::initializer_list<value_type> ilist)
+  {
+    clear();
+    reserve(ilist.size());
+    insert(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~unordered_map()
+  {
+    clear();
+    free_storage();
+  }
+
+public:
+  // iterators
+  iterator begin() noexcept
+  {
+    return iterator(this, first_full());
+  }
+  const_iterator begin() const noexcept
+  {
+    return const_iterator(this, first_full());
+  }
+  iterator       end()          noexcept { return iterator(this, bucket_count_); }
+  const_iterator end()    const noexcept { return const_iterator(this, bucket_count_); }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend()   const noexcept { return end(); }
+
+  // capacity
+  bool      empty()    const noexcept { return size_ == 0; }
+  size_type size()     const noexcept { return size_; }
+  size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(value_type) / 2; }
+
+  // bucket interface
+  size_type bucket_count()    const noexcept { return bucket_count_; }
+  float     load_factor()     const noexcept
+  {
+    return bucket_count_ == 0 ? 0.0f : static_cast<float>(size_) / bucket_count_;
+  }
+  float     max_load_factor() const noexcept { return 0.875f; }
+
+  // make room for n elements without rehashing
+  void reserve(size_type n)
+  {
+    if (n <= capacity_of(bucket_count_)) return;
+    size_type count = bucket_count_ == 0 ? min_bucket_count : bucket_count_;
+    while (capacity_of(count) < n)
+    {
+      if (count > max_size() / 2) throw std::length_error("unordered_map<Key, T>'s size too big");
+      count *= 2;
+    }
+    rehash_to(count);
+  }
+
+  // element access
+  mapped_type& operator[](const key_type& key)
+  {
+    return try_emplace(key).first->second;
+  }
+  mapped_type& operator[](key_type&& key)
+  {
+    return try_emplace(mystl::move(key)).first->second;
+  }
+
+  mapped_type& at(const key_type& key)
+  {
+    const auto i = find_index(key);
+    if (i == bucket_count_) throw std::out_of_range("unordered_map<Key, T> no such element exists");
+    return slots_[i].second;
+  }
+  const mapped_type& at(const key_type& key) const
+  {
+    const auto i = find_index(key);
+    if (i == bucket_count_) throw std::out_of_range("unordered_map<Key, T> no such element exists");
+    return slots_[i].second;
+  }
+
+  // lookup
+  iterator       find(const key_type& key)       { return iterator(this, find_index(key)); }
+  const_iterator find(const key_type& key) const { return const_iterator(this, find_index(key)); }
+
+  size_type count(const key_type& key) const
+  {
+    return find_index(key) == bucket_count_ ? 0 : 1;
+  }
+
+  mystl::pair<iterator, iterator> equal_range(const key_type& key)
+  {
+    auto it = find(key);
+    auto last = it;
+    if (last != end()) ++last;
+    return mystl::make_pair(it, last);
+  }
+  mystl::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+  {
+    auto it = find(key);
+    auto last = it;
+    if (last != end()) ++last;
+    return mystl::make_pair(it, last);
+  }
+
+  // modify
+  template <class... Args>
+  mystl::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+  {
+    return try_emplace_key(key, mystl::forward<Args>(args)...);
+  }
+  template <class... Args>
+  mystl::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+  {
+    return try_emplace_key(mystl::move(key), mystl::forward<Args>(args)...);
+  }
+
+  // the element is built first to get its key
+  template <class... Args>
+  mystl::pair<iterator, bool> emplace(Args&&... args)
+  {
+    value_type value(mystl::forward<Args>(args)...);
+    return insert(mystl::move(value));
+  }
+
+  mystl::pair<iterator, bool> insert(const value_type& value)
+  {
+    const auto r = prepare_insert(value.first);
+    if (r.second) construct_at(r.first, value);
+    return mystl::make_pair(iterator(this, r.first), r.second);
+  }
+  mystl::pair<iterator, bool> insert(value_type&& value)
+  {
+    const auto r = prepare_insert(value.first);
+    if (r.second) construct_at(r.first, mystl::move(value));
+    return mystl::make_pair(iterator(this, r.first), r.second);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void insert(Iter first, Iter last)
+  {
+    for (; first != last; ++first) insert(*first);
+  }
+
+  void insert(std::initializer_list<value_type> ilist)
+  {
+    insert(ilist.begin(), ilist.end());
+  }
+
+  // return the element that follows pos in the iteration
+  iterator erase(const_iterator pos)
+  {
+    erase_index(pos.index);
+    return iterator(this, is_full(pos.index) ? pos.index : next_full(pos.index));
+  }
+  iterator erase(const_iterator first, const_iterator last);
+
+  size_type erase(const key_type& key)
+  {
+    const auto i = find_index(key);
+    if (i == bucket_count_) return 0;
+    erase_index(i);
+    return 1;
+  }
+
+  void clear() noexcept;
+
+  void swap(unordered_map& rhs) noexcept
+  {
+    mystl::swap(ctrl_, rhs.ctrl_);
+    mystl::swap(slots_, rhs.slots_);
+    mystl::swap(bucket_count_, rhs.bucket_count_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(anchor_, rhs.anchor_);
+    mystl::swap(hash_, rhs.hash_);
+    mystl::swap(equal_, rhs.equal_);
+  }
+
+  hasher    hash_fcn() const { return hash_; }
+  key_equal key_eq()   const { return equal_; }
+
+private:
+  // helper functions
+  static size_type capacity_of(size_type count) noexcept
+  {
+    return count - count / 8;
+  }
+
+  size_type home_of(size_t h) const noexcept
+  {
+    return (h >> 7) & (bucket_count_ - 1);
+  }
+
+  static uint8_t h2_of(size_t h) noexcept
+  {
+    return static_cast<uint8_t>(h & 0x7f);
+  }
+
+  bool is_full(size_type i) const noexcept
+  {
+    return i < bucket_count_ && ctrl_[i] != group::empty;
+  }
+
+  // the first group::width control bytes are repeated after the last one
+  void set_ctrl(size_type i, uint8_t c) noexcept
+  {
+    ctrl_[i] = c;
+    if (i < group::width) ctrl_[bucket_count_ + i] = c;
+  }
+
+  template <class... Args>
+  void construct_at(size_type i, Args&&... args)
+  {
+    try
+    {
+      data_allocator::construct(slots_ + i, mystl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      set_ctrl(i, group::empty);
+      --size_;
+      throw;
+    }
+  }
+
+  // move the element of slot from into the raw slot to and destroy the old
+  // one; its key is const only to the user
+  static void relocate(value_type* to, value_type* from)
+  {
+    data_allocator::construct(to, mystl::move(const_cast<key_type&>(from->first)),
+                              mystl::move(from->second));
+    data_allocator::destroy(from);
+  }
+
+  // first empty slot from index i on, there is always one
+  size_type find_empty_from(size_type i) const noexcept
+  {
+    const size_type mask = bucket_count_ - 1;
+    for (;; i = (i + group::width) & mask)
+    {
+      const uint32_t empties = group(ctrl_ + i).match_empty();
+      if (empties != 0) return (i + group::lowest(empties)) & mask;
+    }
+  }
+
+  size_type find_index(const key_type& key) const;
+  mystl::pair<size_type, bool> prepare_insert(const key_type& key);
+
+  template <class K, class... Args>
+  mystl::pair<iterator, bool> try_emplace_key(K&& key, Args&&... args);
+
+  size_type first_full() const noexcept;
+  size_type next_full(size_type i) const noexcept;
+  void      erase_index(size_type i);
+  void      rehash_to(size_type count);
+  void      copy_from(const unordered_map& rhs);
+  void      free_storage() noexcept;
+};
+
+template <class Key, class T, class Hash, class KeyEqual>
+const typename unordered_map<Key, T, Hash, KeyEqual>::size_type
+unordered_map<Key, T, Hash, KeyEqual>::min_bucket_count;
+
+/*****************************************************************************************/
+
+// erase [first, last), from the back: erasing a slot only shifts elements
+// that come after it, so the slots before it stay where they are
+template <class Key, class T, class Hash, class KeyEqual>
+typename unordered_map<Key, T, Hash, KeyEqual>::iterator
+unordered_map<Key, T, Hash, KeyEqual>::erase(const_iterator first, const_iterator last)
+{
+  if (first == last) return iterator(this, last.index);
+  const size_type mask = bucket_count_ - 1;
+  size_type i = last.index == bucket_count_ ? anchor_ : last.index;
+  do
+  {
+    i = (i - 1) & mask;
+    if (ctrl_[i] != group::empty) erase_index(i);
+  } while (i != first.index);
+  return iterator(this, is_full(i) ? i : next_full(i));
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+void unordered_map<Key, T, Hash, KeyEqual>::clear() noexcept
+{
+  if (size_ == 0) return;
+  for (size_type i = 0; i < bucket_count_; ++i)
+  {
+    if (ctrl_[i] != group::empty) data_allocator::destroy(slots_ + i);
+  }
+  std::memset(ctrl_, group::empty, bucket_count_ + group::width);
+  size_ = 0;
+  anchor_ = 0;
+}
+
+/*****************************************************************************************/
+// helper function
+
+// index of the slot holding key, bucket_count_ if there is none
+template <class Key, class T, class Hash, class KeyEqual>
+typename unordered_map<Key, T, Hash, KeyEqual>::size_type
+unordered_map<Key, T, Hash, KeyEqual>::find_index(const key_type& key) const
+{
+  if (size_ == 0) return bucket_count_;
+  const size_t h = hash_(key);
+  const uint8_t h2 = h2_of(h);
+  const size_type mask = bucket_count_ - 1;
+  for (size_type pos = home_of(h);; pos = (pos + group::width) & mask)
+  {
+    const group g(ctrl_ + pos);
+    for (uint32_t m = g.match(h2); m != 0; m &= m - 1)
+    {
+      const size_type i = (pos + group::lowest(m)) & mask;
+      if (equal_(slots_[i].first, key)) return i;
+    }
+    if (g.match_empty() != 0) return bucket_count_;
+  }
+}
+
+// find key, or mark the slot where it goes as full; return the slot and
+// whether key is new
+template <class Key, class T, class Hash, class KeyEqual>
+mystl::pair<typename unordered_map<Key, T, Hash, KeyEqual>::size_type, bool>
+unordered_map<Key, T, Hash, KeyEqual>::prepare_insert(const key_type& key)
+{
+  const size_type found = find_index(key);
+  if (found != bucket_count_) return mystl::make_pair(found, false);
+  if (size_ + 1 > capacity_of(bucket_count_))
+  {
+    reserve(size_ + 1);
+  }
+  const size_t h = hash_(key);
+  const size_type i = find_empty_from(home_of(h));
+  set_ctrl(i, h2_of(h));
+  ++size_;
+  if (i == anchor_) anchor_ = find_empty_from(i);
+  return mystl::make_pair(i, true);
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+template <class K, class... Args>
+mystl::pair<typename unordered_map<Key, T, Hash, KeyEqual>::iterator, bool>
+unordered_map<Key, T, Hash, KeyEqual>::try_emplace_key(K&& key, Args&&... args)
+{
+  const auto r = prepare_insert(key);
+  if (r.second)
+  {
+    construct_at(r.first, mystl::forward<K>(key), mapped_type(mystl::forward<Args>(args)...));
+  }
+  return mystl::make_pair(iterator(this, r.first), r.second);
+}
+
+// iteration runs from the slot after anchor_ around to anchor_
+template <class Key, class T, class Hash, class KeyEqual>
+typename unordered_map<Key, T, Hash, KeyEqual>::size_type
+unordered_map<Key, T, Hash, KeyEqual>::first_full() const noexcept
+{
+  return size_ == 0 ? bucket_count_ : next_full(anchor_);
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+typename unordered_map<Key, T, Hash, KeyEqual>::size_type
+unordered_map<Key, T, Hash, KeyEqual>::next_full(size_type i) const noexcept
+{
+  const size_type mask = bucket_count_ - 1;
+  // slots until anchor_, counted from the one after i
+  size_type left = (anchor_ - i - 1) & mask;
+  for (i = (i + 1) & mask; left != 0;)
+  {
+    uint32_t full = group(ctrl_ + i).match_full();
+    if (left < group::width) full &= (1u << left) - 1;
+    if (full != 0) return (i + group::lowest(full)) & mask;
+    const size_type step = left < group::width ? left : static_cast<size_type>(group::width);
+    i = (i + step) & mask;
+    left -= step;
+  }
+  return bucket_count_;
+}
+
+// destroy slot i, then move back each following element of the run that may
+// sit closer to its home slot
+template <class Key, class T, class Hash, class KeyEqual>
+void unordered_map<Key, T, Hash, KeyEqual>::erase_index(size_type i)
+{
+  const size_type mask = bucket_count_ - 1;
+  data_allocator::destroy(slots_ + i);
+  size_type hole = i;
+  for (size_type j = (i + 1) & mask; ctrl_[j] != group::empty; j = (j + 1) & mask)
+  {
+    const size_type home = home_of(hash_(slots_[j].first));
+    if (((j - home) & mask) >= ((j - hole) & mask))
+    {
+      relocate(slots_ + hole, slots_ + j);
+      set_ctrl(hole, ctrl_[j]);
+      hole = j;
+    }
+  }
+  set_ctrl(hole, group::empty);
+  --size_;
+}
+
+// move all elements to a table of count slots
+template <class Key, class T, class Hash, class KeyEqual>
+void unordered_map<Key, T, Hash, KeyEqual>::rehash_to(size_type count)
+{
+  value_type* new_slots = data_allocator::allocate(count);
+  uint8_t* new_ctrl = nullptr;
+  try
+  {
+    new_ctrl = ctrl_allocator::allocate(count + group::width);
+  }
+  catch (...)
+  {
+    data_allocator::deallocate(new_slots, count);
+    throw;
+  }
+  std::memset(new_ctrl, group::empty, count + group::width);
+
+  uint8_t* old_ctrl = ctrl_;
+  value_type* old_slots = slots_;
+  const size_type old_count = bucket_count_;
+  ctrl_ = new_ctrl;
+  slots_ = new_slots;
+  bucket_count_ = count;
+  for (size_type i = 0; i < old_count; ++i)
+  {
+    if (old_ctrl[i] == group::empty) continue;
+    const size_t h = hash_(old_slots[i].first);
+    const size_type j = find_empty_from(home_of(h));
+    set_ctrl(j, h2_of(h));
+    relocate(slots_ + j, old_slots + i);
+  }
+  anchor_ = find_empty_from(0);
+  if (old_ctrl != nullptr)
+  {
+    ctrl_allocator::deallocate(old_ctrl, old_count + group::width);
+    data_allocator::deallocate(old_slots, old_count);
+  }
+}
+
+// copy the slots of rhs to the same places
+template <class Key, class T, class Hash, class KeyEqual>
+void unordered_map<Key, T, Hash, KeyEqual>::copy_from(const unordered_map& rhs)
+{
+  if (rhs.size_ == 0) return;
+  const size_type count = rhs.bucket_count_;
+  slots_ = data_allocator::allocate(count);
+  try
+  {
+    ctrl_ = ctrl_allocator::allocate(count + group::width);
+  }
+  catch (...)
+  {
+    data_allocator::deallocate(slots_, count);
+    slots_ = nullptr;
+    throw;
+  }
+  bucket_count_ = count;
+  std::memset(ctrl_, group::empty, count + group::width);
+  for (size_type i = 0; i < count; ++i)
+  {
+    if (rhs.ctrl_[i] == group::empty) continue;
+    try
+    {
+      data_allocator::construct(slots_ + i, rhs.slots_[i]);
+    }
+    catch (...)
+    {
+      clear();
+      free_storage();
+      throw;
+    }
+    set_ctrl(i, rhs.ctrl_[i]);
+    ++size_;
+  }
+  anchor_ = rhs.anchor_;
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+void unordered_map<Key, T, Hash, KeyEqual>::free_storage() noexcept
+{
+  if (ctrl_ == nullptr) return;
+  ctrl_allocator::deallocate(ctrl_, bucket_count_ + group::width);
+  data_allocator::deallocate(slots_, bucket_count_);
+  ctrl_ = nullptr;
+  slots_ = nullptr;
+  bucket_count_ = 0;
+  anchor_ = 0;
+}
+
+/*****************************************************************************************/
+// overload comparison operators
+
+template <class Key, class T, class Hash, class KeyEqual>
+bool operator==(const unordered_map<Key, T, Hash, KeyEqual>& lhs,
+                const unordered_map<Key, T, Hash, KeyEqual>& rhs)
+{
+  if (lhs.size() != rhs.size()) return false;
+  for (auto it = lhs.begin(); it != lhs.end(); ++it)
+  {
+    auto other = rhs.find(it->first);
+    if (other == rhs.end() || !(other->second == it->second)) return false;
+  }
+  return true;
+}
+
+template <class Key, class T, class Hash, class KeyEqual>
+bool operator!=(const unordered_map<Key, T, Hash, KeyEqual>& lhs,
+                const unordered_map<Key, T, Hash, KeyEqual>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+// overload mystl::swap
+template <class Key, class T, class Hash, class KeyEqual>
+void swap(unordered_map<Key, T, Hash, KeyEqual>& lhs,
+          unordered_map<Key, T, Hash, KeyEqual>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_UNORDERED_MAP_H_
@@ -54,6 +54,119 @@ void swap(T(&a)[N], T(&b)[N])
   mystl::swap_range(a, a + N, b);
 }
 
+// tag asking containers to default-initialize new elements, which leaves
+// trivial ones uninitialized, e.g. a buffer about to be filled by a read
+struct default_init_t {};
+
+constexpr default_init_t default_init{};
+
+/********************************************************************************/
+
+// template struct: pair
+// hold two objects of arbitrary type
+template <class T1, class T2>
+struct pair
+{
+  typedef T1 first_type;
+  typedef T2 second_type;
+
+  first_type  first;
+  second_type second;
+
+  // construct
+  pair()
+    :first(), second() {}
+
+  pair(const T1& a, const T2& b)
+    :first(a), second(b) {}
+
+  template <class U1, class U2>
+  pair(U1&& a, U2&& b)
+    :first(mystl::forward<U1>(a)), second(mystl::forward<U2>(b)) {}
+
+  template <class U1, class U2>
+  pair(const pair<U1, U2>& rhs)
+    :first(rhs.first), second(rhs.second) {}
+
+  template <class U1, class U2>
+  pair(pair<U1, U2>&& rhs)
+    :first(mystl::forward<U1>(rhs.first)),
+    second(mystl::forward<U2>(rhs.second)) {}
+
+  pair(const pair&) = default;
+  pair(pair&&) = default;
+
+  pair& operator=(const pair& rhs)
+  {
+    first = rhs.first;
+    second = rhs.second;
+    return *this;
+  }
+
+  pair& operator=(pair&& rhs)
+  {
+    first = mystl::move(rhs.first);
+    second = mystl::move(rhs.second);
+    return *this;
+  }
+
+  void swap(pair& rhs)
+  {
+    if (this != &rhs)
+    {
+      mystl::swap(first, rhs.first);
+      mystl::swap(second, rhs.second);
+    }
+  }
+};
+
+// overload relational operator
+template <class T1, class T2>
+bool operator==(const pair<T1, T2>& lhs, const pair<T1, T2>& rhs)
+{
+  return lhs.first == rhs.first && lhs.second == rhs.second;
+}
+
+template <class T1, class T2>
+bool operator<(const pair<T1, T2>& lhs, const pair<T1, T2>& rhs)
+{
+  return lhs.first < rhs.first ||
+    (!(rhs.first < lhs.first) && lhs.second < rhs.second);
+}
+
+template <class T1, class T2>
+bool operator!=(const pair<T1, T2>& lhs, const pair<T1, T2>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T1, class T2>
+bool operator>(const pair<T1, T2>& lhs, const pair<T1, T2>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T1, class T2>
+bool operator<=(const pair<T1, T2>& lhs, const pair<T1, T2>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T1, class T2>
+bool operator>=(const pair<T1, T2>& lhs, const pair<T1, T2>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// make_pair
+template <class T1, class T2>
+pair<typename std::decay<T1>::type, typename std::decay<T2>::type>
+make_pair(T1&& first, T2&& second)
+{
+  return pair<typename std::decay<T1>::type, typename std::decay<T2>::type>(
+    mystl::forward<T1>(first), mystl::forward<T2>(second));
+}
+
 } // namespace mystl
 
 #endif // !_LITESTL_UTIL_H_
\ No newline at end of file
@@ -0,0 +1,936 @@
+#ifndef _LITESTL_VECTOR_H_
+#define _LITESTL_VECTOR_H_
+
+// dynamic array in contiguous storage
+// the capacity grows by a policy given as template parameter, and elements
+// are relocated with memcpy when mystl::is_trivially_relocatable allows it
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+
+#include "iterator.h"
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "type_traits.h"
+#include "uninitialized.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// growth policy: the capacity is multiplied by Num / Den, or raised to the
+// size needed if that is more
+template <size_t Num = 2, size_t Den = 1>
+struct geometric_growth
+{
+  static_assert(Den > 0 && Num > Den, "growth factor must be greater than 1");
+
+  static size_t next_capacity(size_t cap, size_t need, size_t max_size) noexcept
+  {
+    const size_t grown = cap > max_size / Num ? max_size : cap * Num / Den;
+    return grown < need ? need : grown;
+  }
+};
+
+// template class: vector
+// T: element type, Alloc: allocator, Growth: growth policy
+template <class T, class Alloc = mystl::allocator<T>,
+  class Growth = mystl::geometric_growth<>>
+class vector
+{
+public:
+  typedef Alloc                     allocator_type;
+  typedef Alloc                     data_allocator;
+  typedef Growth                    growth_policy;
+
+  typedef T                         value_type;
+  typedef T*                        pointer;
+  typedef const T*                  const_pointer;
+  typedef T&                        reference;
+  typedef const T&                  const_reference;
+  typedef size_t                    size_type;
+  typedef ptrdiff_t                 difference_type;
+
+  typedef value_type*               iterator;
+  typedef const value_type*         const_iterator;
+
+  allocator_type get_allocator() const { return data_allocator(); }
+
+private:
+  typedef std::integral_constant<bool,
+    is_trivially_relocatable<T>::value> relocatable;
+
+  iterator begin_;  // head of used space
+  iterator end_;    // tail of used space
+  iterator cap_;    // tail of storage
+
+public:
+  // construct, copy, move and destroy
+  vector() noexcept
+    :begin_(nullptr), end_(nullptr), cap_(nullptr) {}
+
+  explicit vector(size_type n)
+    :vector()
+  {
+    init_space(n);
+    end_ = mystl::uninitialized_value_construct_n(begin_, n);
+  }
+
+  vector(size_type n, const value_type& value)
+    :vector()
+  {
+    init_space(n);
+    end_ = mystl::uninitialized_fill_n(begin_, n, value);
+  }
+
+  // trivial elements are left uninitialized
+  vector(size_type n, default_init_t)
+    :vector()
+  {
+    init_space(n);
+    end_ = mystl::uninitialized_default_construct_n(begin_, n);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  vector(Iter first, Iter last)
+    :vector()
+  {
+    range_init(first, last, iterator_category(first));
+  }
+
+  vector(const vector& rhs)
+    :vector()
+  {
+    init_space(rhs.size());
+    end_ = mystl::uninitialized_copy(rhs.begin_, rhs.end_, begin_);
+  }
+
+  vector(vector&& rhs) noexcept
+    :begin_(rhs.begin_), end_(rhs.end_), cap_(rhs.cap_)
+  {
+    rhs.begin_ = rhs.end_ = rhs.cap_ = nullptr;
+  }
+
+  vector(std::initializer_list<value_type> ilist)
+    :vector()
+  {
+    range_init(ilist.begin(), ilist.end(), forward_iterator_tag());
+  }
+
+  vector& operator=(const vector& rhs)
+  {
+    if (this != &rhs) assign(rhs.begin_, rhs.end_);
+    return *this;
+  }
+
+  vector& operator=(vector&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      vector temp(mystl::move(rhs));
+      swap(temp);
+    }
+    return *this;
+  }
+
+  vector& operator=(std::initializer_list<value_type> ilist)
+  {
+    assign(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~vector()
+  {
+    mystl::destroy(begin_, end_);
+    data_allocator::deallocate(begin_, capacity());
+  }
+
+public:
+  // iterators
+  iterator       begin()        noexcept { return begin_; }
+  const_iterator begin()  const noexcept { return begin_; }
+  iterator       end()          noexcept { return end_; }
+  const_iterator end()    const noexcept { return end_; }
+  const_iterator cbegin() const noexcept { return begin_; }
+  const_iterator cend()   const noexcept { return end_; }
+
+  // capacity
+  bool      empty()    const noexcept { return begin_ == end_; }
+  size_type size()     const noexcept { return static_cast<size_type>(end_ - begin_); }
+  size_type capacity() const noexcept { return static_cast<size_type>(cap_ - begin_); }
+  size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+
+  void reserve(size_type n);
+  void shrink_to_fit();
+
+  // access
+  reference       operator[](size_type n)       { return *(begin_ + n); }
+  const_reference operator[](size_type n) const { return *(begin_ + n); }
+
+  reference at(size_type n)
+  {
+    if (n >= size()) throw std::out_of_range("vector<T>::at() subscript out of range");
+    return *(begin_ + n);
+  }
+  const_reference at(size_type n) const
+  {
+    if (n >= size()) throw std::out_of_range("vector<T>::at() subscript out of range");
+    return *(begin_ + n);
+  }
+
+  reference       front()       { return *begin_; }
+  const_reference front() const { return *begin_; }
+  reference       back()        { return *(end_ - 1); }
+  const_reference back()  const { return *(end_ - 1); }
+
+  pointer       data()       noexcept { return begin_; }
+  const_pointer data() const noexcept { return begin_; }
+
+  // modify
+  void assign(size_type n, const value_type& value);
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void assign(Iter first, Iter last)
+  {
+    assign_aux(first, last, iterator_category(first));
+  }
+
+  void assign(std::initializer_list<value_type> ilist)
+  {
+    assign(ilist.begin(), ilist.end());
+  }
+
+  // the common case costs a single capacity check
+  template <class... Args>
+  void emplace_back(Args&&... args)
+  {
+    if (end_ != cap_)
+    {
+      data_allocator::construct(end_, mystl::forward<Args>(args)...);
+      ++end_;
+    }
+    else
+    {
+      realloc_emplace(end_, mystl::forward<Args>(args)...);
+    }
+  }
+
+  void push_back(const value_type& value) { emplace_back(value); }
+  void push_back(value_type&& value)      { emplace_back(mystl::move(value)); }
+
+  void pop_back()
+  {
+    --end_;
+    data_allocator::destroy(end_);
+  }
+
+  template <class... Args>
+  iterator emplace(const_iterator pos, Args&&... args);
+
+  iterator insert(const_iterator pos, const value_type& value)
+  {
+    return emplace(pos, value);
+  }
+  iterator insert(const_iterator pos, value_type&& value)
+  {
+    return emplace(pos, mystl::move(value));
+  }
+
+  iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  iterator insert(const_iterator pos, Iter first, Iter last)
+  {
+    return range_insert(const_cast<iterator>(pos), first, last,
+                        iterator_category(first));
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+  {
+    return range_insert(const_cast<iterator>(pos), ilist.begin(), ilist.end(),
+                        forward_iterator_tag());
+  }
+
+  iterator erase(const_iterator pos)
+  {
+    return erase(pos, pos + 1);
+  }
+  iterator erase(const_iterator first, const_iterator last);
+
+  void clear() noexcept
+  {
+    mystl::destroy(begin_, end_);
+    end_ = begin_;
+  }
+
+  // new elements are value-initialized, copied from value, or with
+  // default_init, default-initialized: trivial ones are not written
+  void resize(size_type n);
+  void resize(size_type n, const value_type& value);
+  void resize(size_type n, default_init_t);
+
+  void swap(vector& rhs) noexcept
+  {
+    mystl::swap(begin_, rhs.begin_);
+    mystl::swap(end_, rhs.end_);
+    mystl::swap(cap_, rhs.cap_);
+  }
+
+private:
+  // helper functions
+
+  // initialize / reallocate
+  void      init_space(size_type n);
+  size_type next_capacity(size_type add) const;
+  void      reallocate(size_type new_cap);
+  void      replace_storage(iterator new_begin, size_type new_size,
+                            size_type new_cap);
+
+  template <class IIter>
+  void range_init(IIter first, IIter last, input_iterator_tag);
+  template <class FIter>
+  void range_init(FIter first, FIter last, forward_iterator_tag);
+
+  // assign
+  template <class IIter>
+  void assign_aux(IIter first, IIter last, input_iterator_tag);
+  template <class FIter>
+  void assign_aux(FIter first, FIter last, forward_iterator_tag);
+
+  // insert
+  template <class... Args>
+  void realloc_emplace(iterator pos, Args&&... args);
+
+  void relocate_around(iterator pos, iterator new_begin, size_type n,
+                       std::true_type);
+  void relocate_around(iterator pos, iterator new_begin, size_type n,
+                       std::false_type);
+
+  void open_gap(iterator pos, size_type n);
+  void close_gap(iterator pos, size_type n);
+
+  void emplace_in_place(iterator pos, value_type&& value, std::true_type);
+  void emplace_in_place(iterator pos, value_type&& value, std::false_type);
+
+  void fill_insert_in_place(iterator pos, size_type n, const value_type& value,
+                            std::true_type);
+  void fill_insert_in_place(iterator pos, size_type n, const value_type& value,
+                            std::false_type);
+
+  template <class IIter>
+  iterator range_insert(iterator pos, IIter first, IIter last,
+                        input_iterator_tag);
+  template <class FIter>
+  iterator range_insert(iterator pos, FIter first, FIter last,
+                        forward_iterator_tag);
+  template <class FIter>
+  void range_insert_in_place(iterator pos, FIter first, FIter last,
+                             size_type n, std::true_type);
+  template <class FIter>
+  void range_insert_in_place(iterator pos, FIter first, FIter last,
+                             size_type n, std::false_type);
+
+  // erase
+  void erase_aux(iterator first, iterator last, std::true_type);
+  void erase_aux(iterator first, iterator last, std::false_type);
+};
+
+/*****************************************************************************************/
+// a vector holds no pointer into itself
+template <class T, class Alloc, class Growth>
+struct is_trivially_relocatable<vector<T, Alloc, Growth>> :public m_true_type {};
+
+/*****************************************************************************************/
+
+// reserve room for at least n elements
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reserve(size_type n)
+{
+  if (n <= capacity()) return;
+  if (n > max_size()) throw std::length_error("vector<T>'s size too big");
+  reallocate(n);
+}
+
+// give back the unused capacity
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::shrink_to_fit()
+{
+  if (end_ != cap_) reallocate(size());
+}
+
+// assign n copies of value
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::assign(size_type n, const value_type& value)
+{
+  if (n > capacity())
+  {
+    vector temp(n, value);
+    swap(temp);
+  }
+  else if (n > size())
+  {
+    mystl::fill_n(begin_, size(), value);
+    end_ = mystl::uninitialized_fill_n(end_, n - size(), value);
+  }
+  else
+  {
+    erase(mystl::fill_n(begin_, n, value), end_);
+  }
+}
+
+// construct an element at pos
+template <class T, class Alloc, class Growth>
+template <class... Args>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::emplace(const_iterator pos, Args&&... args)
+{
+  iterator xpos = const_cast<iterator>(pos);
+  const auto n = xpos - begin_;
+  if (end_ == cap_)
+  {
+    realloc_emplace(xpos, mystl::forward<Args>(args)...);
+  }
+  else if (xpos == end_)
+  {
+    data_allocator::construct(end_, mystl::forward<Args>(args)...);
+    ++end_;
+  }
+  else
+  {
+    // args may refer to an element that is about to move
+    value_type temp(mystl::forward<Args>(args)...);
+    emplace_in_place(xpos, mystl::move(temp), relocatable());
+  }
+  return begin_ + n;
+}
+
+// insert n copies of value at pos
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::insert(const_iterator pos, size_type n,
+                                 const value_type& value)
+{
+  iterator xpos = const_cast<iterator>(pos);
+  const auto idx = static_cast<size_type>(xpos - begin_);
+  if (n == 0) return xpos;
+  if (static_cast<size_type>(cap_ - end_) < n)
+  {
+    const auto new_cap = next_capacity(n);
+    auto new_begin = data_allocator::allocate(new_cap);
+    try
+    {
+      mystl::uninitialized_fill_n(new_begin + idx, n, value);
+    }
+    catch (...)
+    {
+      data_allocator::deallocate(new_begin, new_cap);
+      throw;
+    }
+    const auto new_size = size() + n;
+    try
+    {
+      relocate_around(xpos, new_begin, n, relocatable());
+    }
+    catch (...)
+    {
+      mystl::destroy(new_begin + idx, new_begin + idx + n);
+      data_allocator::deallocate(new_begin, new_cap);
+      throw;
+    }
+    replace_storage(new_begin, new_size, new_cap);
+  }
+  else
+  {
+    const value_type temp(value);
+    fill_insert_in_place(xpos, n, temp, relocatable());
+  }
+  return begin_ + idx;
+}
+
+// erase [first, last)
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::erase(const_iterator first, const_iterator last)
+{
+  iterator xfirst = const_cast<iterator>(first);
+  iterator xlast = const_cast<iterator>(last);
+  if (xfirst != xlast) erase_aux(xfirst, xlast, relocatable());
+  return xfirst;
+}
+
+// resize
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::resize(size_type n)
+{
+  if (n < size())
+  {
+    erase(begin_ + n, end_);
+    return;
+  }
+  const auto add = n - size();
+  if (static_cast<size_type>(cap_ - end_) < add) reallocate(next_capacity(add));
+  end_ = mystl::uninitialized_value_construct_n(end_, add);
+}
+
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::resize(size_type n, const value_type& value)
+{
+  if (n < size()) erase(begin_ + n, end_);
+  else            insert(end_, n - size(), value);
+}
+
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::resize(size_type n, default_init_t)
+{
+  if (n < size())
+  {
+    erase(begin_ + n, end_);
+    return;
+  }
+  const auto add = n - size();
+  if (static_cast<size_type>(cap_ - end_) < add) reallocate(next_capacity(add));
+  end_ = mystl::uninitialized_default_construct_n(end_, add);
+}
+
+/*****************************************************************************************/
+// helper function
+
+// allocate room for n elements
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::init_space(size_type n)
+{
+  begin_ = data_allocator::allocate(n);
+  end_ = begin_;
+  cap_ = begin_ + n;
+}
+
+// capacity to hold add more elements
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::size_type
+vector<T, Alloc, Growth>::next_capacity(size_type add) const
+{
+  const auto old_size = size();
+  if (max_size() - old_size < add)
+  {
+    throw std::length_error("vector<T>'s size too big");
+  }
+  return growth_policy::next_capacity(capacity(), old_size + add, max_size());
+}
+
+// move the elements to new storage of new_cap elements
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reallocate(size_type new_cap)
+{
+  const auto old_size = size();
+  auto new_begin = data_allocator::allocate(new_cap);
+  try
+  {
+    mystl::uninitialized_relocate(begin_, end_, new_begin);
+  }
+  catch (...)
+  {
+    data_allocator::deallocate(new_begin, new_cap);
+    throw;
+  }
+  replace_storage(new_begin, old_size, new_cap);
+}
+
+// free the old storage, whose elements have been relocated
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::replace_storage(iterator new_begin,
+                                               size_type new_size,
+                                               size_type new_cap)
+{
+  data_allocator::deallocate(begin_, capacity());
+  begin_ = new_begin;
+  end_ = new_begin + new_size;
+  cap_ = new_begin + new_cap;
+}
+
+template <class T, class Alloc, class Growth>
+template <class IIter>
+void vector<T, Alloc, Growth>::range_init(IIter first, IIter last,
+                                          input_iterator_tag)
+{
+  for (; first != last; ++first) emplace_back(*first);
+}
+
+template <class T, class Alloc, class Growth>
+template <class FIter>
+void vector<T, Alloc, Growth>::range_init(FIter first, FIter last,
+                                          forward_iterator_tag)
+{
+  init_space(static_cast<size_type>(mystl::distance(first, last)));
+  end_ = mystl::uninitialized_copy(first, last, begin_);
+}
+
+template <class T, class Alloc, class Growth>
+template <class IIter>
+void vector<T, Alloc, Growth>::assign_aux(IIter first, IIter last,
+                                          input_iterator_tag)
+{
+  auto cur = begin_;
+  for (; first != last && cur != end_; ++first, ++cur)
+  {
+    *cur = *first;
+  }
+  if (first == last)
+  {
+    erase(cur, end_);
+    return;
+  }
+  for (; first != last; ++first) emplace_back(*first);
+}
+
+template <class T, class Alloc, class Growth>
+template <class FIter>
+void vector<T, Alloc, Growth>::assign_aux(FIter first, FIter last,
+                                          forward_iterator_tag)
+{
+  const auto len = static_cast<size_type>(mystl::distance(first, last));
+  if (len > capacity())
+  {
+    vector temp(first, last);
+    swap(temp);
+  }
+  else if (size() >= len)
+  {
+    erase(mystl::copy(first, last, begin_), end_);
+  }
+  else
+  {
+    auto mid = first;
+    mystl::advance(mid, size());
+    mystl::copy(first, mid, begin_);
+    end_ = mystl::uninitialized_copy(mid, last, end_);
+  }
+}
+
+// grow the storage and construct an element at pos on the way, before the
+// old elements move, since args may refer to one of them
+template <class T, class Alloc, class Growth>
+template <class... Args>
+void vector<T, Alloc, Growth>::realloc_emplace(iterator pos, Args&&... args)
+{
+  const auto new_cap = next_capacity(1);
+  const auto idx = pos - begin_;
+  auto new_begin = data_allocator::allocate(new_cap);
+  try
+  {
+    data_allocator::construct(new_begin + idx, mystl::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    data_allocator::deallocate(new_begin, new_cap);
+    throw;
+  }
+  const auto new_size = size() + 1;
+  try
+  {
+    relocate_around(pos, new_begin, 1, relocatable());
+  }
+  catch (...)
+  {
+    data_allocator::destroy(new_begin + idx);
+    data_allocator::deallocate(new_begin, new_cap);
+    throw;
+  }
+  replace_storage(new_begin, new_size, new_cap);
+}
+
+// relocate [begin_, pos) to new_begin and [pos, end_) to n places after it
+// if a move throws, what was built in the new storage is destroyed and the
+// old elements are all left in place
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::relocate_around(iterator pos, iterator new_begin,
+                                               size_type n, std::true_type)
+{
+  const auto idx = pos - begin_;
+  mystl::uninitialized_relocate(begin_, pos, new_begin);
+  mystl::uninitialized_relocate(pos, end_, new_begin + idx + n);
+}
+
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::relocate_around(iterator pos, iterator new_begin,
+                                               size_type n, std::false_type)
+{
+  const auto idx = pos - begin_;
+  auto mid = mystl::uninitialized_move(begin_, pos, new_begin);
+  try
+  {
+    mystl::uninitialized_move(pos, end_, new_begin + idx + n);
+  }
+  catch (...)
+  {
+    mystl::destroy(new_begin, mid);
+    throw;
+  }
+  mystl::destroy(begin_, end_);
+}
+
+// move the bytes of [pos, end_) n places up, leaving raw memory at pos
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::open_gap(iterator pos, size_type n)
+{
+  std::memmove(static_cast<void*>(pos + n), static_cast<const void*>(pos),
+               static_cast<size_type>(end_ - pos) * sizeof(T));
+  end_ += n;
+}
+
+// undo open_gap
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::close_gap(iterator pos, size_type n)
+{
+  std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + n),
+               static_cast<size_type>(end_ - pos - n) * sizeof(T));
+  end_ -= n;
+}
+
+// move value into pos, the capacity being enough
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::emplace_in_place(iterator pos, value_type&& value,
+                                                std::true_type)
+{
+  open_gap(pos, 1);
+  try
+  {
+    data_allocator::construct(pos, mystl::move(value));
+  }
+  catch (...)
+  {
+    close_gap(pos, 1);
+    throw;
+  }
+}
+
+// the last element is moved into the spare slot, the rest one place up, and
+// value into the hole, so a move-only type needs no copy
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::emplace_in_place(iterator pos, value_type&& value,
+                                                std::false_type)
+{
+  data_allocator::construct(end_, mystl::move(*(end_ - 1)));
+  ++end_;
+  mystl::move_backward(pos, end_ - 2, end_ - 1);
+  *pos = mystl::move(value);
+}
+
+// insert n copies of value at pos, the capacity being enough
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::fill_insert_in_place(iterator pos, size_type n,
+                                                    const value_type& value,
+                                                    std::true_type)
+{
+  open_gap(pos, n);
+  try
+  {
+    mystl::uninitialized_fill_n(pos, n, value);
+  }
+  catch (...)
+  {
+    close_gap(pos, n);
+    throw;
+  }
+}
+
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::fill_insert_in_place(iterator pos, size_type n,
+                                                    const value_type& value,
+                                                    std::false_type)
+{
+  const auto after = static_cast<size_type>(end_ - pos);
+  const auto old_end = end_;
+  if (after > n)
+  {
+    end_ = mystl::uninitialized_move(old_end - n, old_end, old_end);
+    mystl::move_backward(pos, old_end - n, old_end);
+    mystl::fill_n(pos, n, value);
+  }
+  else
+  {
+    end_ = mystl::uninitialized_fill_n(old_end, n - after, value);
+    end_ = mystl::uninitialized_move(pos, old_end, end_);
+    mystl::fill_n(pos, after, value);
+  }
+}
+
+// a single pass range is appended and rotated into place
+template <class T, class Alloc, class Growth>
+template <class IIter>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::range_insert(iterator pos, IIter first, IIter last,
+                                       input_iterator_tag)
+{
+  const auto idx = pos - begin_;
+  const auto old_size = size();
+  for (; first != last; ++first) emplace_back(*first);
+  mystl::rotate(begin_ + idx, begin_ + old_size, end_);
+  return begin_ + idx;
+}
+
+template <class T, class Alloc, class Growth>
+template <class FIter>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::range_insert(iterator pos, FIter first, FIter last,
+                                       forward_iterator_tag)
+{
+  const auto idx = static_cast<size_type>(pos - begin_);
+  const auto n = static_cast<size_type>(mystl::distance(first, last));
+  if (n == 0) return pos;
+  if (static_cast<size_type>(cap_ - end_) < n)
+  {
+    const auto new_cap = next_capacity(n);
+    auto new_begin = data_allocator::allocate(new_cap);
+    try
+    {
+      mystl::uninitialized_copy(first, last, new_begin + idx);
+    }
+    catch (...)
+    {
+      data_allocator::deallocate(new_begin, new_cap);
+      throw;
+    }
+    const auto new_size = size() + n;
+    try
+    {
+      relocate_around(pos, new_begin, n, relocatable());
+    }
+    catch (...)
+    {
+      mystl::destroy(new_begin + idx, new_begin + idx + n);
+      data_allocator::deallocate(new_begin, new_cap);
+      throw;
+    }
+    replace_storage(new_begin, new_size, new_cap);
+  }
+  else
+  {
+    range_insert_in_place(pos, first, last, n, relocatable());
+  }
+  return begin_ + idx;
+}
+
+template <class T, class Alloc, class Growth>
+template <class FIter>
+void vector<T, Alloc, Growth>::range_insert_in_place(iterator pos, FIter first,
+                                                     FIter last, size_type n,
+                                                     std::true_type)
+{
+  open_gap(pos, n);
+  try
+  {
+    mystl::uninitialized_copy(first, last, pos);
+  }
+  catch (...)
+  {
+    close_gap(pos, n);
+    throw;
+  }
+}
+
+template <class T, class Alloc, class Growth>
+template <class FIter>
+void vector<T, Alloc, Growth>::range_insert_in_place(iterator pos, FIter first,
+                                                     FIter last, size_type n,
+                                                     std::false_type)
+{
+  const auto after = static_cast<size_type>(end_ - pos);
+  const auto old_end = end_;
+  if (after > n)
+  {
+    end_ = mystl::uninitialized_move(old_end - n, old_end, old_end);
+    mystl::move_backward(pos, old_end - n, old_end);
+    mystl::copy(first, last, pos);
+  }
+  else
+  {
+    auto mid = first;
+    mystl::advance(mid, after);
+    end_ = mystl::uninitialized_copy(mid, last, old_end);
+    end_ = mystl::uninitialized_move(pos, old_end, end_);
+    mystl::copy(first, mid, pos);
+  }
+}
+
+// destroy [first, last) and move the bytes of the tail down
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::erase_aux(iterator first, iterator last,
+                                         std::true_type)
+{
+  mystl::destroy(first, last);
+  close_gap(first, static_cast<size_type>(last - first));
+}
+
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::erase_aux(iterator first, iterator last,
+                                         std::false_type)
+{
+  auto new_end = mystl::move(last, end_, first);
+  mystl::destroy(new_end, end_);
+  end_ = new_end;
+}
+
+/*****************************************************************************************/
+// overload comparison operators
+
+template <class T, class Alloc, class Growth>
+bool operator==(const vector<T, Alloc, Growth>& lhs,
+                const vector<T, Alloc, Growth>& rhs)
+{
+  return lhs.size() == rhs.size() &&
+    mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Alloc, class Growth>
+bool operator<(const vector<T, Alloc, Growth>& lhs,
+               const vector<T, Alloc, Growth>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(),
+                                        rhs.begin(), rhs.end());
+}
+
+template <class T, class Alloc, class Growth>
+bool operator!=(const vector<T, Alloc, Growth>& lhs,
+                const vector<T, Alloc, Growth>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, class Alloc, class Growth>
+bool operator>(const vector<T, Alloc, Growth>& lhs,
+               const vector<T, Alloc, Growth>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, class Alloc, class Growth>
+bool operator<=(const vector<T, Alloc, Growth>& lhs,
+                const vector<T, Alloc, Growth>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, class Alloc, class Growth>
+bool operator>=(const vector<T, Alloc, Growth>& lhs,
+                const vector<T, Alloc, Growth>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// overload mystl::swap
+template <class T, class Alloc, class Growth>
+void swap(vector<T, Alloc, Growth>& lhs, vector<T, Alloc, Growth>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // !_LITESTL_VECTOR_H_
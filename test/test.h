@@ -0,0 +1,50 @@
+#ifndef _LITESTL_TEST_H_
+#define _LITESTL_TEST_H_
+
+// checks of the differential tests
+// a test runs a mystl component and its std counterpart on the same random
+// input and compares the results; a failed check prints where it failed and
+// makes the test return non-zero, also in release builds
+
+#include <cstdio>
+
+namespace test
+{
+
+inline int& failures()
+{
+  static int n = 0;
+  return n;
+}
+
+inline int result(const char* name)
+{
+  if (failures() == 0)
+    std::printf("%s: ok\n", name);
+  else
+    std::printf("%s: %d failed checks\n", name, failures());
+  return failures() == 0 ? 0 : 1;
+}
+
+} // namespace test
+
+#define EXPECT(cond)                                                       \
+  do                                                                       \
+  {                                                                        \
+    if (!(cond))                                                           \
+    {                                                                      \
+      if (++test::failures() <= 20)                                        \
+        std::fprintf(stderr, "%s:%d: EXPECT(%s) failed\n",                 \
+                     __FILE__, __LINE__, #cond);                           \
+    }                                                                      \
+  } while (0)
+
+#define EXPECT_THROW(expr, exception)                                      \
+  do                                                                       \
+  {                                                                        \
+    bool thrown = false;                                                   \
+    try { expr; } catch (const exception&) { thrown = true; }              \
+    EXPECT(thrown && #expr);                                               \
+  } while (0)
+
+#endif // !_LITESTL_TEST_H_
@@ -0,0 +1,277 @@
+// archive round trip: random vectors, flat_maps and bitmap_sets written whole
+// and streamed, then read back through the mapped views and compared with
+// std::vector, std::map and std::set; and the writer and reader errors
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include "archive.h"
+
+#include "test.h"
+
+namespace
+{
+
+const char* path = "/tmp/litestl_test_archive.bin";
+
+struct point
+{
+  int32_t x;
+  int32_t y;
+  double  w;
+};
+
+template <class Map, class Std>
+bool same_map(const Map& m, const Std& s)
+{
+  if (m.size() != s.size()) return false;
+  auto q = s.begin();
+  for (auto it = m.begin(); it != m.end(); ++it, ++q)
+  {
+    if ((*it).first != q->first || (*it).second != q->second) return false;
+  }
+  return true;
+}
+
+template <class View, class Std>
+bool same_set(const View& v, const Std& s)
+{
+  if (v.size() != s.size()) return false;
+  auto q = s.begin();
+  for (auto it = v.begin(); it != v.end(); ++it, ++q)
+  {
+    if (*it != *q) return false;
+  }
+  return true;
+}
+
+// values in dense runs, in full chunks and scattered, so the writer picks
+// run, bitmap and array containers
+std::set<uint32_t> random_values(std::mt19937& rng)
+{
+  std::set<uint32_t> s;
+  for (int r = 0; r < 20; ++r)
+  {
+    const uint32_t start = rng();
+    const uint32_t len = rng() % 3000;
+    for (uint32_t k = 0; k < len && start + k >= start; ++k) s.insert(start + k);
+  }
+  const uint32_t chunk = (rng() % 1000) << 16;
+  for (uint32_t k = 0; k < 65536; k += 1 + rng() % 3) s.insert(chunk + k);
+  for (int i = 0; i < 5000; ++i) s.insert(rng() % 10000000);
+  return s;
+}
+
+void test_round_trip(std::mt19937& rng)
+{
+  std::vector<uint64_t> ints(rng() % 100000);
+  for (auto& x : ints) x = (uint64_t(rng()) << 32) | rng();
+  std::vector<point> points(rng() % 1000);
+  for (auto& p : points)
+  {
+    p.x = static_cast<int32_t>(rng());
+    p.y = static_cast<int32_t>(rng());
+    p.w = rng() / 7.0;
+  }
+
+  std::map<int64_t, double> ref;
+  for (int i = 0; i < 50000; ++i)
+    ref[static_cast<int64_t>(rng() % 200000) - 100000] = rng() / 3.0;
+  mystl::flat_map<int64_t, double> fm;
+  for (auto& e : ref) fm[e.first] = e.second;
+
+  std::map<uint32_t, uint16_t, std::greater<uint32_t>> desc;
+  for (int i = 0; i < 1000; ++i) desc[rng() % 5000] = static_cast<uint16_t>(rng());
+
+  const auto values = random_values(rng);
+  mystl::bitmap_set bs(values.begin(), values.end());
+  const auto streamed = random_values(rng);
+
+  {
+    mystl::archive_writer w;
+    EXPECT(w.open(path));
+    // 0: whole vector
+    mystl::vector<uint64_t> v(ints.data(), ints.data() + ints.size());
+    w.write(v);
+    // 1: streamed vector of structs, in pieces
+    w.begin_vector<point>();
+    for (size_t i = 0; i < points.size(); )
+    {
+      const size_t n = mystl::min<size_t>(rng() % 50, points.size() - i);
+      if (n == 1)
+        w.push_element(points[i]);
+      else
+        w.push_elements(points.data() + i, n);
+      i += n;
+    }
+    // 2: whole flat_map
+    w.write(fm);
+    // 3: streamed flat_map with fewer entries than reserved, keys decreasing
+    w.begin_flat_map<uint32_t, uint16_t>(desc.size() + 17);
+    for (auto& e : desc) w.push_entry(e.first, e.second, mystl::greater<uint32_t>());
+    // 4: whole bitmap_set
+    w.write(bs);
+    // 5: streamed bitmap_set
+    w.begin_bitmap_set();
+    for (auto x : streamed) w.push_value(x);
+    // 6: empty sections
+    w.write(static_cast<const int*>(nullptr), 0);
+    w.write(mystl::flat_map<int, int>());
+    w.write(mystl::bitmap_set());
+    EXPECT(w.close());
+    EXPECT(!w.is_open());
+  }
+
+  mystl::archive_reader r;
+  EXPECT(r.open(path));
+  EXPECT(r.section_count() == 9);
+  EXPECT(r.kind(0) == mystl::archive_vector);
+  EXPECT(r.kind(2) == mystl::archive_flat_map);
+  EXPECT(r.kind(5) == mystl::archive_bitmap_set);
+
+  auto v0 = r.vector_section<uint64_t>(0);
+  EXPECT(v0.size() == ints.size());
+  EXPECT(mystl::equal(v0.begin(), v0.end(), ints.data()));
+  EXPECT(reinterpret_cast<uintptr_t>(v0.data()) % mystl::archive_alignment == 0);
+
+  auto v1 = r.vector_section<point>(1);
+  bool same_points = v1.size() == points.size();
+  for (size_t i = 0; same_points && i < points.size(); ++i)
+  {
+    same_points = v1[i].x == points[i].x && v1[i].y == points[i].y &&
+      v1[i].w == points[i].w;
+  }
+  EXPECT(same_points);
+
+  auto m2 = r.flat_map_section<int64_t, double>(2);
+  EXPECT(same_map(m2, ref));
+  for (int i = 0; i < 20000; ++i)
+  {
+    const auto k = static_cast<int64_t>(rng() % 220000) - 110000;
+    const auto q = ref.lower_bound(k);
+    const auto it = m2.lower_bound(k);
+    EXPECT((q == ref.end()) == (it == m2.end()));
+    if (q != ref.end() && it != m2.end()) EXPECT(*it.key == q->first);
+    EXPECT(m2.contains(k) == (ref.count(k) != 0));
+    if (ref.count(k) != 0) EXPECT(m2.at(k) == ref[k]);
+  }
+  EXPECT_THROW(m2.at(200000), std::out_of_range);
+
+  auto m3 = r.flat_map_section<uint32_t, uint16_t>(3, mystl::greater<uint32_t>());
+  EXPECT(same_map(m3, desc));
+  for (uint32_t k = 0; k < 5000; k += 7)
+    EXPECT(m3.contains(k) == (desc.count(k) != 0));
+
+  auto b4 = r.bitmap_set_section(4);
+  auto b5 = r.bitmap_set_section(5);
+  EXPECT(same_set(b4, values));
+  EXPECT(same_set(b5, streamed));
+  for (int i = 0; i < 20000; ++i)
+  {
+    const uint32_t x = i % 2 ? rng() : rng() % 10000000;
+    EXPECT(b4.contains(x) == (values.count(x) != 0));
+    EXPECT(b5.contains(x) == (streamed.count(x) != 0));
+  }
+  mystl::bitmap_set back(b4.begin(), b4.end());
+  EXPECT(back.size() == values.size());
+
+  EXPECT(r.vector_section<int>(6).empty());
+  EXPECT((r.flat_map_section<int, int>(7).empty()));
+  EXPECT(r.bitmap_set_section(8).empty());
+  EXPECT(r.bitmap_set_section(8).begin() == r.bitmap_set_section(8).end());
+  r.close();
+  EXPECT(!r.is_open());
+}
+
+void test_writer_errors()
+{
+  mystl::archive_writer w;
+  EXPECT_THROW(w.begin_vector<int>(), std::logic_error);
+  EXPECT(w.open(path));
+
+  w.begin_flat_map<int, int>(4);
+  w.push_entry(1, 10);
+  w.push_entry(3, 30);
+  EXPECT_THROW(w.push_entry(3, 31), std::logic_error);
+  EXPECT_THROW(w.push_entry(2, 20), std::logic_error);
+  EXPECT_THROW(w.push_entry(4, 4.0), std::logic_error);
+  w.push_entry(5, 50);
+  w.push_entry(9, 90);
+  EXPECT_THROW(w.push_entry(10, 100), std::logic_error);
+
+  // a new section does not compare with the keys of the last one
+  w.begin_flat_map<int, int>(2);
+  w.push_entry(0, 0);
+  EXPECT_THROW(w.push_entry(0, 1), std::logic_error);
+  EXPECT_THROW(w.push_element(0), std::logic_error);
+
+  w.begin_bitmap_set();
+  w.push_value(7);
+  EXPECT_THROW(w.push_value(7), std::logic_error);
+  EXPECT_THROW(w.push_value(6), std::logic_error);
+  w.push_value(70000);
+  EXPECT(w.close());
+
+  // the rejected entries never reached the file
+  mystl::archive_reader r;
+  EXPECT(r.open(path));
+  EXPECT(r.section_count() == 3);
+  auto m0 = r.flat_map_section<int, int>(0);
+  EXPECT(m0.size() == 4);
+  EXPECT(m0.at(1) == 10 && m0.at(3) == 30 && m0.at(5) == 50 && m0.at(9) == 90);
+  EXPECT(!m0.contains(2));
+  EXPECT((r.flat_map_section<int, int>(1).size() == 1));
+  EXPECT(r.bitmap_set_section(2).size() == 2);
+}
+
+void test_reader_errors()
+{
+  {
+    mystl::archive_writer w;
+    EXPECT(w.open(path));
+    w.write(static_cast<const uint32_t*>(nullptr), 0);
+    EXPECT(w.close());
+  }
+  mystl::archive_reader r;
+  EXPECT(r.open(path));
+  EXPECT_THROW(r.vector_section<uint64_t>(0), std::logic_error);
+  EXPECT_THROW((r.flat_map_section<uint32_t, uint32_t>(0)), std::logic_error);
+  EXPECT_THROW(r.bitmap_set_section(0), std::logic_error);
+  EXPECT_THROW(r.vector_section<uint32_t>(1), std::out_of_range);
+  r.close();
+
+  // not an archive, and an archive cut short
+  std::FILE* f = std::fopen(path, "wb");
+  std::vector<unsigned char> junk(1000, 0x5a);
+  EXPECT(f != nullptr && std::fwrite(junk.data(), 1, junk.size(), f) == junk.size());
+  std::fclose(f);
+  EXPECT(!r.open(path));
+  EXPECT(!r.open("/nonexistent/litestl.bin"));
+
+  {
+    mystl::archive_writer w;
+    EXPECT(w.open(path));
+    std::vector<uint64_t> v(1000, 1);
+    w.write(v.data(), v.size());
+    EXPECT(w.close());
+  }
+  EXPECT(::truncate(path, 4000) == 0);
+  EXPECT(!r.open(path));
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937 rng(50);
+  for (int round = 0; round < 3; ++round) test_round_trip(rng);
+  test_writer_errors();
+  test_reader_errors();
+  std::remove(path);
+  return test::result("test_archive");
+}
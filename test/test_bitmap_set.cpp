@@ -0,0 +1,166 @@
+// bitmap_set against std::set<uint32_t>
+// the random sets mix sparse chunks (array containers), dense chunks (bitmap
+// containers) and long intervals turned into run containers
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "bitmap_set.h"
+
+#include "test.h"
+
+namespace
+{
+
+std::set<uint32_t> random_values(std::mt19937& rng)
+{
+  std::set<uint32_t> s;
+  const uint32_t chunks = 1 + rng() % 4;
+  for (uint32_t c = 0; c < chunks; ++c)
+  {
+    const uint32_t base = (rng() % 8) << 16;
+    switch (rng() % 3)
+    {
+      case 0:  // sparse
+        for (uint32_t i = rng() % 200; i > 0; --i) s.insert(base + rng() % 65536);
+        break;
+      case 1:  // dense
+        for (uint32_t i = 5000 + rng() % 20000; i > 0; --i) s.insert(base + rng() % 65536);
+        break;
+      default:  // intervals
+        for (uint32_t i = rng() % 10; i > 0; --i)
+        {
+          const uint32_t lo = rng() % 65536;
+          const uint32_t len = rng() % 3000;
+          for (uint32_t x = lo; x < lo + len && x < 65536; ++x) s.insert(base + x);
+        }
+        break;
+    }
+  }
+  return s;
+}
+
+mystl::bitmap_set make_bitmap(const std::set<uint32_t>& s, bool runs)
+{
+  mystl::bitmap_set b;
+  for (auto x : s) b.insert(x);
+  if (runs) b.run_optimize();
+  return b;
+}
+
+bool same(const mystl::bitmap_set& b, const std::set<uint32_t>& s)
+{
+  return b.size() == s.size() && std::equal(s.begin(), s.end(), b.begin());
+}
+
+std::set<uint32_t> std_op(const std::set<uint32_t>& a, const std::set<uint32_t>& b, int op)
+{
+  std::set<uint32_t> r;
+  auto out = std::inserter(r, r.end());
+  switch (op)
+  {
+    case 0:  std::set_union(a.begin(), a.end(), b.begin(), b.end(), out); break;
+    case 1:  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), out); break;
+    case 2:  std::set_difference(a.begin(), a.end(), b.begin(), b.end(), out); break;
+    default: std::set_symmetric_difference(a.begin(), a.end(), b.begin(), b.end(), out); break;
+  }
+  return r;
+}
+
+// values in one half of a chunk, in a container of kind k:
+// 0 array, 1 bitmap, 2 runs of 100 values in every other block of 200
+std::set<uint32_t> half_values(int k, uint32_t half)
+{
+  std::set<uint32_t> s;
+  const uint32_t base = (3 << 16) + half * 32768;
+  if (k == 0)
+  {
+    for (uint32_t i = 0; i < 300; ++i) s.insert(base + 7 * i);
+  }
+  else if (k == 1)
+  {
+    for (uint32_t i = 0; i < 16000; ++i) s.insert(base + 2 * i);
+  }
+  else
+  {
+    for (uint32_t b = 0; b < 32000; b += 200)
+      for (uint32_t i = 0; i < 100; ++i) s.insert(base + b + i);
+  }
+  return s;
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937 rng(1);
+  for (int it = 0; it < 60; ++it)
+  {
+    auto sa = random_values(rng);
+    auto sb = random_values(rng);
+    const auto a = make_bitmap(sa, rng() % 2 == 0);
+    const auto b = make_bitmap(sb, rng() % 2 == 0);
+    EXPECT(same(a, sa));
+    EXPECT(same(b, sb));
+
+    // lookup
+    for (int i = 0; i < 1000; ++i)
+    {
+      const uint32_t x = rng() % (8 << 16);
+      EXPECT(a.contains(x) == (sa.count(x) != 0));
+    }
+
+    // set algebra and the counting functions
+    const auto u = std_op(sa, sb, 0);
+    const auto n = std_op(sa, sb, 1);
+    const auto d = std_op(sa, sb, 2);
+    const auto x = std_op(sa, sb, 3);
+    EXPECT(same(a | b, u));
+    EXPECT(same(a & b, n));
+    EXPECT(same(a - b, d));
+    EXPECT(same(a ^ b, x));
+    EXPECT(mystl::set_union_size(a, b) == u.size());
+    EXPECT(mystl::set_intersection_size(a, b) == n.size());
+    EXPECT(mystl::set_difference_size(a, b) == d.size());
+    EXPECT(mystl::set_symmetric_difference_size(a, b) == x.size());
+    EXPECT(mystl::set_intersects(a, b) == !n.empty());
+    EXPECT((a == b) == (sa == sb));
+    EXPECT((a == a) && !(a != a));
+
+    // insert and erase, also in run containers
+    auto c = a;
+    for (int i = 0; i < 2000; ++i)
+    {
+      const uint32_t v = rng() % (8 << 16);
+      if (rng() % 2 == 0)
+        EXPECT(c.insert(v) == sa.insert(v).second);
+      else
+        EXPECT(c.erase(v) == (sa.erase(v) != 0));
+    }
+    EXPECT(same(c, sa));
+  }
+
+  // set_intersects stops early, check it on disjoint chunks of every pair of
+  // container kinds and after adding a single common value
+  for (int ka = 0; ka < 3; ++ka)
+  {
+    for (int kb = 0; kb < 3; ++kb)
+    {
+      auto sa = half_values(ka, 0);
+      auto sb = half_values(kb, 1);
+      auto a = make_bitmap(sa, ka == 2);
+      auto b = make_bitmap(sb, kb == 2);
+      EXPECT(!mystl::set_intersects(a, b) && !mystl::set_intersects(b, a));
+      EXPECT(mystl::set_intersection_size(a, b) == 0);
+      const uint32_t common = *sb.begin();
+      a.insert(common);
+      EXPECT(mystl::set_intersects(a, b) && mystl::set_intersects(b, a));
+      EXPECT(mystl::set_intersection_size(a, b) == 1);
+    }
+  }
+  return test::result("test_bitmap_set");
+}
@@ -0,0 +1,185 @@
+// btree_map and btree_set against std::map and std::set: random inserts,
+// lookups and erases, erase while iterating, and the node count after heavy
+// erasing; small nodes make deep trees
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "btree_map.h"
+#include "btree_set.h"
+
+#include "test.h"
+
+namespace
+{
+
+size_t live_nodes = 0;
+
+// mystl::allocator that counts the nodes alive
+template <class T>
+struct counting_allocator
+{
+  static T* allocate(size_t n)
+  {
+    live_nodes += n;
+    return mystl::allocator<T>::allocate(n);
+  }
+  static void deallocate(T* p, size_t n)
+  {
+    live_nodes -= n;
+    mystl::allocator<T>::deallocate(p, n);
+  }
+};
+
+template <class Map, class Std>
+bool same_map(const Map& m, const Std& s)
+{
+  if (m.size() != s.size()) return false;
+  auto q = s.begin();
+  for (auto it = m.begin(); it != m.end(); ++it, ++q)
+  {
+    if ((*it).first != q->first || (*it).second != q->second) return false;
+  }
+  // and backward, through the prev links
+  auto r = s.end();
+  for (auto it = m.end(); it != m.begin();)
+  {
+    --it;
+    --r;
+    if ((*it).first != r->first) return false;
+  }
+  return true;
+}
+
+template <class Map>
+void random_ops(unsigned seed, int key_range)
+{
+  std::mt19937 rng(seed);
+  Map m;
+  std::map<int, int> s;
+  for (int it = 0; it < 60000; ++it)
+  {
+    const int k = static_cast<int>(rng() % static_cast<unsigned>(key_range));
+    const int v = static_cast<int>(rng() % 1000);
+    // phases of mostly inserts and mostly erases
+    const bool grow = it / 5000 % 2 == 0;
+    const unsigned op = rng() % 10;
+    if (op < (grow ? 6u : 2u))
+    {
+      EXPECT(m.insert(mystl::pair<int, int>(k, v)).second ==
+             s.insert(std::make_pair(k, v)).second);
+    }
+    else if (op < 8)
+    {
+      EXPECT(m.erase(k) == s.erase(k));
+    }
+    else if (op < 9)
+    {
+      // erase a short range and check the returned position
+      auto first = m.lower_bound(k);
+      auto last = m.upper_bound(k + 20);
+      auto r = m.erase(first, last);
+      auto sr = s.erase(s.lower_bound(k), s.upper_bound(k + 20));
+      EXPECT((r == m.end()) == (sr == s.end()));
+      if (r != m.end() && sr != s.end()) EXPECT((*r).first == sr->first);
+    }
+    else
+    {
+      auto p = m.find(k);
+      auto q = s.find(k);
+      EXPECT((p == m.end()) == (q == s.end()));
+      if (p != m.end() && q != s.end()) EXPECT((*p).second == q->second);
+      auto lb = m.lower_bound(k);
+      auto slb = s.lower_bound(k);
+      EXPECT((lb == m.end()) == (slb == s.end()));
+      if (lb != m.end() && slb != s.end()) EXPECT((*lb).first == slb->first);
+    }
+    if (it % 1000 == 0) EXPECT(same_map(m, s));
+  }
+  EXPECT(same_map(m, s));
+
+  // erase every odd value while walking the tree
+  for (auto it = m.begin(); it != m.end();)
+  {
+    if ((*it).second % 2) it = m.erase(it);
+    else ++it;
+  }
+  for (auto it = s.begin(); it != s.end();)
+  {
+    if (it->second % 2) it = s.erase(it);
+    else ++it;
+  }
+  EXPECT(same_map(m, s));
+}
+
+// erasing nine of ten keys at random must give the nodes back: with
+// rebalancing every node but the root stays at least half full
+template <size_t NodeBytes>
+void test_occupancy()
+{
+  typedef mystl::btree_map<int, int, mystl::less<int>, counting_allocator, NodeBytes> map_type;
+  const size_t slots = mystl::btree<int, int, mystl::less<int>, counting_allocator,
+                                    NodeBytes>::leaf_slots;
+  std::mt19937 rng(5);
+  std::vector<int> keys(200000);
+  for (size_t i = 0; i < keys.size(); ++i) keys[i] = static_cast<int>(i);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  {
+    map_type m;
+    for (auto k : keys) m[k] = k;
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (size_t i = 0; i < keys.size() / 10 * 9; ++i) m.erase(keys[i]);
+    const size_t leaves_at_half = m.size() / (slots / 2) + 1;
+    // leaves at least half full, plus the inner nodes above them
+    EXPECT(live_nodes <= leaves_at_half * 2);
+
+    std::set<int> rest(keys.begin() + static_cast<ptrdiff_t>(keys.size() / 10 * 9), keys.end());
+    bool ok = m.size() == rest.size();
+    auto q = rest.begin();
+    for (auto it = m.begin(); ok && it != m.end(); ++it, ++q)
+    {
+      if ((*it).first != *q || (*it).second != *q) ok = false;
+    }
+    EXPECT(ok);
+    for (auto k : rest) m.erase(k);
+    EXPECT(m.empty() && m.begin() == m.end());
+  }
+  EXPECT(live_nodes == 0);
+}
+
+void test_set()
+{
+  std::mt19937 rng(9);
+  mystl::btree_set<int, mystl::less<int>, mystl::allocator, 64> m;
+  std::set<int> s;
+  for (int it = 0; it < 50000; ++it)
+  {
+    const int k = static_cast<int>(rng() % 4000);
+    if (rng() % 2) EXPECT(m.insert(k).second == s.insert(k).second);
+    else           EXPECT(m.erase(k) == s.erase(k));
+  }
+  bool ok = m.size() == s.size();
+  auto q = s.begin();
+  for (auto it = m.begin(); ok && it != m.end(); ++it, ++q)
+  {
+    if (*it != *q) ok = false;
+  }
+  EXPECT(ok);
+}
+
+} // namespace
+
+int main()
+{
+  random_ops<mystl::btree_map<int, int>>(1, 20000);
+  random_ops<mystl::btree_map<int, int, mystl::less<int>, mystl::allocator, 64>>(2, 20000);
+  random_ops<mystl::btree_map<int, int, mystl::less<int>, mystl::allocator, 64>>(3, 300);
+  test_occupancy<64>();
+  test_occupancy<512>();
+  test_set();
+  return test::result("test_btree_map");
+}
@@ -0,0 +1,178 @@
+// deque against std::deque: random operations at both ends and in the middle,
+// and copy, move, fill and accumulate taking their per-segment paths
+
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "algobase.h"
+#include "deque.h"
+#include "numeric.h"
+
+#include "test.h"
+
+namespace
+{
+
+template <class D, class S>
+bool same(const D& d, const S& s)
+{
+  if (d.size() != s.size()) return false;
+  auto q = s.begin();
+  for (auto it = d.begin(); it != d.end(); ++it, ++q)
+  {
+    if (!(*it == *q)) return false;
+  }
+  return true;
+}
+
+template <class T, class Make>
+void random_ops(unsigned seed, Make make)
+{
+  std::mt19937 rng(seed);
+  mystl::deque<T> d;
+  std::deque<T> s;
+  for (int it = 0; it < 40000; ++it)
+  {
+    const T x = make(static_cast<int>(rng() % 100000));
+    const size_t pos = s.empty() ? 0 : rng() % (s.size() + 1);
+    switch (rng() % 12)
+    {
+      case 0: case 1:
+        d.push_back(x);
+        s.push_back(x);
+        break;
+      case 2: case 3:
+        d.push_front(x);
+        s.push_front(x);
+        break;
+      case 4:
+        if (!s.empty()) { d.pop_back(); s.pop_back(); }
+        break;
+      case 5:
+        if (!s.empty()) { d.pop_front(); s.pop_front(); }
+        break;
+      case 6:
+        d.insert(d.begin() + static_cast<ptrdiff_t>(pos), x);
+        s.insert(s.begin() + static_cast<ptrdiff_t>(pos), x);
+        break;
+      case 7:
+      {
+        const size_t n = rng() % 300;
+        d.insert(d.begin() + static_cast<ptrdiff_t>(pos), n, x);
+        // the std::deque of libstdc++ 12 breaks on an empty insert
+        if (n != 0) s.insert(s.begin() + static_cast<ptrdiff_t>(pos), n, x);
+        break;
+      }
+      case 8:
+      {
+        std::vector<T> r(rng() % 300, x);
+        d.insert(d.begin() + static_cast<ptrdiff_t>(pos), r.data(), r.data() + r.size());
+        // as above
+        if (!r.empty()) s.insert(s.begin() + static_cast<ptrdiff_t>(pos), r.begin(), r.end());
+        break;
+      }
+      case 9:
+        if (pos < s.size())
+        {
+          const size_t last = pos + rng() % (s.size() - pos + 1) / 4;
+          auto r = d.erase(d.begin() + static_cast<ptrdiff_t>(pos),
+                           d.begin() + static_cast<ptrdiff_t>(last));
+          s.erase(s.begin() + static_cast<ptrdiff_t>(pos),
+                  s.begin() + static_cast<ptrdiff_t>(last));
+          EXPECT(r - d.begin() == static_cast<ptrdiff_t>(pos));
+        }
+        break;
+      case 10:
+        if (rng() % 20 == 0)
+        {
+          const size_t n = rng() % 2000;
+          d.resize(n, x);
+          s.resize(n, x);
+        }
+        break;
+      default:
+        if (!s.empty())
+        {
+          const size_t i = rng() % s.size();
+          EXPECT(d[i] == s[i] && d.at(i) == s.at(i));
+          EXPECT(d.front() == s.front() && d.back() == s.back());
+        }
+        break;
+    }
+    if (it % 500 == 0) EXPECT(same(d, s));
+  }
+  EXPECT(same(d, s));
+  d.clear();
+  EXPECT(d.empty() && d.begin() == d.end());
+}
+
+// every algorithm crosses many chunk boundaries, from unaligned offsets
+void test_segmented_algorithms()
+{
+  std::mt19937 rng(4);
+  for (int it = 0; it < 200; ++it)
+  {
+    mystl::deque<long long> d;
+    const size_t n = rng() % 5000;
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (rng() % 2) d.push_back(static_cast<long long>(rng() % 1000));
+      else           d.push_front(static_cast<long long>(rng() % 1000));
+    }
+    std::vector<long long> ref;
+    for (size_t i = 0; i < n; ++i) ref.push_back(d[i]);
+    const size_t a = n == 0 ? 0 : rng() % n;
+    const size_t b = a + (n == a ? 0 : rng() % (n - a));
+    auto first = d.begin() + static_cast<ptrdiff_t>(a);
+    auto last = d.begin() + static_cast<ptrdiff_t>(b);
+
+    // accumulate
+    long long sum = 0;
+    for (size_t i = a; i < b; ++i) sum += ref[i];
+    EXPECT(mystl::accumulate(first, last, 0LL) == sum);
+
+    // deque to pointer and pointer to deque
+    std::vector<long long> out(b - a + 1, -1);
+    EXPECT(mystl::copy(first, last, out.data()) == out.data() + (b - a));
+    bool ok = out[b - a] == -1;
+    for (size_t i = a; i < b; ++i) ok = ok && out[i - a] == ref[i];
+    EXPECT(ok);
+    for (auto& x : out) x = -x - 7;
+    EXPECT(mystl::copy(out.data(), out.data() + (b - a), first) == last);
+    ok = true;
+    for (size_t i = 0; i < n; ++i)
+      ok = ok && d[i] == (i >= a && i < b ? -ref[i] - 7 : ref[i]);
+    EXPECT(ok);
+
+    // deque to deque, with different chunk offsets on each side
+    mystl::deque<long long> e;
+    for (size_t i = 0; i < rng() % 700; ++i) e.push_front(0);
+    const size_t off = e.size();
+    e.resize(off + (b - a) + 3, 0);
+    mystl::move(first, last, e.begin() + static_cast<ptrdiff_t>(off));
+    ok = e[off + (b - a)] == 0;
+    for (size_t i = a; i < b; ++i) ok = ok && e[off + i - a] == d[i];
+    EXPECT(ok);
+
+    // fill and fill_n
+    mystl::fill(first, last, 42LL);
+    ok = true;
+    for (size_t i = 0; i < n; ++i)
+      ok = ok && (i >= a && i < b ? d[i] == 42 : d[i] != 42 || ref[i] == 42);
+    EXPECT(ok);
+    EXPECT(mystl::fill_n(first, b - a, 5LL) == last);
+    EXPECT(mystl::accumulate(first, last, 0LL) == 5LL * static_cast<long long>(b - a));
+  }
+}
+
+} // namespace
+
+int main()
+{
+  random_ops<int>(1, [](int x) { return x; });
+  random_ops<std::string>(2, [](int x) { return std::string(static_cast<size_t>(x % 30), 'a' + x % 26); });
+  test_segmented_algorithms();
+  return test::result("test_deque");
+}
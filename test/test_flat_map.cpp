@@ -0,0 +1,158 @@
+// flat_map and flat_set against std::map and std::set: random single and bulk
+// inserts, lookups, bounds and erases
+
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "flat_map.h"
+#include "flat_set.h"
+
+#include "test.h"
+
+namespace
+{
+
+template <class Map, class Std>
+bool same_map(const Map& m, const Std& s)
+{
+  if (m.size() != s.size()) return false;
+  auto q = s.begin();
+  for (auto it = m.begin(); it != m.end(); ++it, ++q)
+  {
+    if ((*it).first != q->first || (*it).second != q->second) return false;
+  }
+  return true;
+}
+
+template <class Set, class Std>
+bool same_set(const Set& m, const Std& s)
+{
+  if (m.size() != s.size()) return false;
+  auto q = s.begin();
+  for (auto it = m.begin(); it != m.end(); ++it, ++q)
+  {
+    if (*it != *q) return false;
+  }
+  return true;
+}
+
+void test_flat_map()
+{
+  std::mt19937 rng(1);
+  mystl::flat_map<int, int> m;
+  std::map<int, int> s;
+  for (int it = 0; it < 20000; ++it)
+  {
+    const int k = static_cast<int>(rng() % 3000);
+    const int v = static_cast<int>(rng() % 1000);
+    switch (rng() % 7)
+    {
+      case 0:
+        EXPECT(m.insert(mystl::pair<int, int>(k, v)).second ==
+               s.insert(std::make_pair(k, v)).second);
+        break;
+      case 1:
+        m[k] = v;
+        s[k] = v;
+        break;
+      case 2:
+      {
+        // a batch with repeated keys; the first of equal keys wins, and keys
+        // already present keep their value
+        std::vector<mystl::pair<int, int>> batch;
+        const int base = static_cast<int>(rng() % 3500);
+        const size_t n = rng() % 40;
+        for (size_t i = 0; i < n; ++i)
+        {
+          batch.push_back(mystl::pair<int, int>(
+            base + static_cast<int>(rng() % 60), static_cast<int>(rng() % 1000)));
+        }
+        m.insert(batch.data(), batch.data() + batch.size());
+        for (auto& x : batch) s.insert(std::make_pair(x.first, x.second));
+        break;
+      }
+      case 3:
+        EXPECT(m.erase(k) == s.erase(k));
+        break;
+      case 4:
+        if (!s.empty())
+        {
+          auto lo = m.lower_bound(k);
+          auto hi = m.upper_bound(k + 50);
+          m.erase(lo, hi);
+          s.erase(s.lower_bound(k), s.upper_bound(k + 50));
+        }
+        break;
+      default:
+      {
+        auto p = m.find(k);
+        auto q = s.find(k);
+        EXPECT((p == m.end()) == (q == s.end()));
+        if (p != m.end() && q != s.end()) EXPECT((*p).second == q->second);
+        auto lb = m.lower_bound(k);
+        auto slb = s.lower_bound(k);
+        EXPECT((lb == m.end()) == (slb == s.end()));
+        if (lb != m.end() && slb != s.end()) EXPECT((*lb).first == slb->first);
+        auto ub = m.upper_bound(k);
+        auto sub = s.upper_bound(k);
+        EXPECT((ub == m.end()) == (sub == s.end()));
+        if (ub != m.end() && sub != s.end()) EXPECT((*ub).first == sub->first);
+        EXPECT(m.count(k) == s.count(k));
+        break;
+      }
+    }
+    if (it % 500 == 0) EXPECT(same_map(m, s));
+  }
+  EXPECT(same_map(m, s));
+}
+
+void test_flat_set()
+{
+  std::mt19937 rng(2);
+  mystl::flat_set<int> m;
+  std::set<int> s;
+  for (int it = 0; it < 20000; ++it)
+  {
+    const int k = static_cast<int>(rng() % 3000);
+    switch (rng() % 4)
+    {
+      case 0:
+        EXPECT(m.insert(k).second == s.insert(k).second);
+        break;
+      case 1:
+      {
+        std::vector<int> batch(rng() % 40);
+        for (auto& x : batch) x = static_cast<int>(rng() % 3500);
+        m.insert(batch.data(), batch.data() + batch.size());
+        s.insert(batch.begin(), batch.end());
+        break;
+      }
+      case 2:
+        EXPECT(m.erase(k) == s.erase(k));
+        break;
+      default:
+      {
+        auto lb = m.lower_bound(k);
+        auto slb = s.lower_bound(k);
+        EXPECT((lb == m.end()) == (slb == s.end()));
+        if (lb != m.end() && slb != s.end()) EXPECT(*lb == *slb);
+        EXPECT((m.find(k) == m.end()) == (s.find(k) == s.end()));
+        break;
+      }
+    }
+    if (it % 500 == 0) EXPECT(same_set(m, s));
+  }
+  EXPECT(same_set(m, s));
+}
+
+} // namespace
+
+int main()
+{
+  test_flat_map();
+  test_flat_set();
+  return test::result("test_flat_map");
+}
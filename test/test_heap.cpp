@@ -0,0 +1,275 @@
+// heap variants against std::priority_queue and std::sort
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "algo_heap.h"
+#include "functional.h"
+#include "indexed_heap.h"
+#include "radix_heap.h"
+
+#include "test.h"
+
+namespace
+{
+
+template <size_t D, class T, class Compare>
+bool is_dary_heap(const std::vector<T>& v, Compare comp)
+{
+  for (size_t i = 1; i < v.size(); ++i)
+  {
+    if (comp(v[(i - 1) / D], v[i])) return false;
+  }
+  return true;
+}
+
+// make, push, pop and sort a D-ary max-heap and min-heap
+template <size_t D>
+void test_dary_heap(std::mt19937& rng)
+{
+  for (int it = 0; it < 300; ++it)
+  {
+    const size_t n = rng() % 300;
+    const int range = 1 + static_cast<int>(rng() % 1000);
+    std::vector<int> v(n);
+    for (auto& x : v) x = static_cast<int>(rng() % range);
+
+    // make, then push half as many again
+    std::vector<int> h(v);
+    mystl::make_dary_heap<D>(h.data(), h.data() + h.size());
+    EXPECT((is_dary_heap<D>(h, std::less<int>())));
+    std::priority_queue<int> pq(v.begin(), v.end());
+    for (size_t i = 0; i < n / 2; ++i)
+    {
+      const int x = static_cast<int>(rng() % range);
+      h.push_back(x);
+      mystl::push_dary_heap<D>(h.data(), h.data() + h.size());
+      pq.push(x);
+    }
+    EXPECT((is_dary_heap<D>(h, std::less<int>())));
+
+    // pop everything in order
+    bool same = true;
+    while (!h.empty())
+    {
+      same = same && h.front() == pq.top();
+      mystl::pop_dary_heap<D>(h.data(), h.data() + h.size());
+      h.pop_back();
+      pq.pop();
+      if (!h.empty() && h.size() % 37 == 0)
+        EXPECT((is_dary_heap<D>(h, std::less<int>())));
+    }
+    EXPECT(same);
+
+    // min-heap through comp, and heap sort both ways
+    std::vector<int> g(v);
+    mystl::make_dary_heap<D>(g.data(), g.data() + g.size(), mystl::greater<int>());
+    EXPECT((is_dary_heap<D>(g, std::greater<int>())));
+    mystl::sort_dary_heap<D>(g.data(), g.data() + g.size(), mystl::greater<int>());
+    std::vector<int> expect(v);
+    std::sort(expect.begin(), expect.end(), std::greater<int>());
+    EXPECT(g == expect);
+
+    std::vector<int> s(v);
+    mystl::make_dary_heap<D>(s.data(), s.data() + s.size());
+    mystl::sort_dary_heap<D>(s.data(), s.data() + s.size());
+    std::sort(expect.begin(), expect.end());
+    EXPECT(s == expect);
+  }
+}
+
+// bottom-up pop_heap and Floyd make_heap, also on move-only elements
+struct ptr_less
+{
+  bool operator()(const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) const
+  {
+    return *a < *b;
+  }
+};
+
+void test_binary_heap(std::mt19937& rng)
+{
+  for (int it = 0; it < 1000; ++it)
+  {
+    const size_t n = rng() % 300;
+    const int range = 1 + static_cast<int>(rng() % 1000);
+    std::vector<int> v(n);
+    for (auto& x : v) x = static_cast<int>(rng() % range);
+
+    std::vector<int> h(v);
+    mystl::make_heap(h.data(), h.data() + h.size());
+    EXPECT(std::is_heap(h.begin(), h.end()));
+    std::priority_queue<int> pq(v.begin(), v.end());
+    for (size_t i = 0; i < n / 2; ++i)
+    {
+      const int x = static_cast<int>(rng() % range);
+      h.push_back(x);
+      mystl::push_heap(h.data(), h.data() + h.size());
+      pq.push(x);
+    }
+    EXPECT(std::is_heap(h.begin(), h.end()));
+    bool same = true;
+    while (!h.empty())
+    {
+      same = same && h.front() == pq.top();
+      mystl::pop_heap(h.data(), h.data() + h.size());
+      same = same && h.back() == pq.top();
+      h.pop_back();
+      pq.pop();
+      same = same && std::is_heap(h.begin(), h.end());
+    }
+    EXPECT(same);
+
+    std::vector<int> g(v);
+    mystl::make_heap(g.data(), g.data() + g.size(), mystl::greater<int>());
+    EXPECT(std::is_heap(g.begin(), g.end(), std::greater<int>()));
+    mystl::sort_heap(g.data(), g.data() + g.size(), mystl::greater<int>());
+    std::vector<int> expect(v);
+    std::sort(expect.begin(), expect.end(), std::greater<int>());
+    EXPECT(g == expect);
+
+    std::vector<std::unique_ptr<int>> p;
+    for (auto x : v) p.push_back(std::unique_ptr<int>(new int(x)));
+    mystl::make_heap(p.data(), p.data() + p.size(), ptr_less());
+    mystl::sort_heap(p.data(), p.data() + p.size(), ptr_less());
+    std::sort(expect.begin(), expect.end());
+    bool sorted = true;
+    for (size_t i = 0; i < n; ++i) sorted = sorted && p[i] && *p[i] == expect[i];
+    EXPECT(sorted);
+  }
+}
+
+// indexed_heap as a min-heap against a map from handle to (key, priority)
+void test_indexed_heap(std::mt19937& rng)
+{
+  mystl::indexed_heap<std::string, int, mystl::greater<int>> h;
+  std::map<size_t, std::pair<std::string, int>> ref;
+  for (int it = 0; it < 100000; ++it)
+  {
+    const int op = static_cast<int>(rng() % 7);
+    if (op < 2 || ref.empty())
+    {
+      const int p = static_cast<int>(rng() % 1000);
+      const std::string k = std::to_string(it);
+      const size_t hd = h.push(k, p);
+      EXPECT(ref.count(hd) == 0);
+      ref[hd] = std::make_pair(k, p);
+      continue;
+    }
+    auto e = std::next(ref.begin(), static_cast<long>(rng() % ref.size()));
+    const size_t hd = e->first;
+    EXPECT(h.contains(hd) && h.key(hd) == e->second.first);
+    switch (op)
+    {
+      case 2:
+      {
+        const int p = static_cast<int>(rng() % 1000);
+        h.update(hd, p);
+        e->second.second = p;
+        break;
+      }
+      case 3:
+        h.erase(hd);
+        ref.erase(e);
+        EXPECT(!h.contains(hd));
+        break;
+      case 4:
+      {
+        int best = 1 << 30;
+        for (auto& r : ref) best = std::min(best, r.second.second);
+        EXPECT(h.top_priority() == best);
+        const size_t th = h.top_handle();
+        EXPECT(ref[th].second == best);
+        h.pop();
+        ref.erase(th);
+        break;
+      }
+      case 5:
+        h.decrease_key(hd, e->second.second - 5);
+        e->second.second -= 5;
+        break;
+      default:
+        h.increase_key(hd, e->second.second + 5);
+        e->second.second += 5;
+        break;
+    }
+    EXPECT(h.size() == ref.size());
+  }
+  mystl::indexed_heap<std::string, int, mystl::greater<int>> h2(mystl::move(h));
+  EXPECT(h2.size() == ref.size() && h.empty());
+  std::vector<int> expect;
+  for (auto& r : ref) expect.push_back(r.second.second);
+  std::sort(expect.begin(), expect.end());
+  std::vector<int> got;
+  for (; !h2.empty(); h2.pop()) got.push_back(h2.top_priority());
+  EXPECT(got == expect);
+}
+
+// radix_heap with monotone pushes against a min priority_queue; elements with
+// equal keys may come out in any order, so the popped elements are compared
+// as sorted lists and the keys as a sequence
+template <class Key>
+void test_radix_heap(std::mt19937& rng, Key lowest)
+{
+  typedef std::pair<Key, int> elem;
+  for (int it = 0; it < 50; ++it)
+  {
+    mystl::radix_heap<Key, int> h;
+    std::priority_queue<elem, std::vector<elem>, std::greater<elem>> pq;
+    std::vector<elem> got, expect;
+    Key last = lowest;
+    bool keys_same = true;
+    for (int op = 0; op < 5000; ++op)
+    {
+      if (rng() % 3 != 0 || pq.empty())
+      {
+        const Key k = static_cast<Key>(last + static_cast<Key>(rng() % 1000));
+        const int v = static_cast<int>(rng());
+        h.push(k, v);
+        pq.push(elem(k, v));
+      }
+      else
+      {
+        keys_same = keys_same && h.top_key() == pq.top().first;
+        got.push_back(elem(h.top().first, h.top().second));
+        expect.push_back(pq.top());
+        last = pq.top().first;
+        h.pop();
+        pq.pop();
+      }
+      keys_same = keys_same && h.size() == pq.size();
+    }
+    for (; !pq.empty(); h.pop(), pq.pop())
+    {
+      keys_same = keys_same && h.top_key() == pq.top().first;
+      got.push_back(elem(h.top().first, h.top().second));
+      expect.push_back(pq.top());
+    }
+    EXPECT(keys_same && h.empty());
+    std::sort(got.begin(), got.end());
+    std::sort(expect.begin(), expect.end());
+    EXPECT(got == expect);
+  }
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937 rng(1);
+  test_binary_heap(rng);
+  test_dary_heap<2>(rng);
+  test_dary_heap<3>(rng);
+  test_dary_heap<4>(rng);
+  test_dary_heap<8>(rng);
+  test_indexed_heap(rng);
+  test_radix_heap<unsigned>(rng, 0);
+  test_radix_heap<long long>(rng, -1000000);
+  return test::result("test_heap");
+}
@@ -0,0 +1,442 @@
+// intrusive_list and intrusive_hash_set against std::list and std::set of the
+// same ids: random links and unlinks, splice, reverse and swap, lookups and
+// erases by id, erases while iterating after rehashes, one object in two
+// lists and a set at once, and mystl algorithms over both iterator types
+
+#include <algorithm>
+#include <list>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "algobase.h"
+#include "intrusive_hash_set.h"
+#include "intrusive_list.h"
+#include "iterator.h"
+
+#include "test.h"
+
+namespace
+{
+
+struct lru_tag {};
+struct free_tag {};
+
+// an object that can be in an lru list, a free list and an id index at once
+struct session
+  :public mystl::list_hook<lru_tag>,
+  public mystl::list_hook<free_tag>,
+  public mystl::hash_set_hook<>
+{
+  int id;
+
+  explicit session(int i = 0) :id(i) {}
+};
+
+// sessions hash and compare by id, and can be looked up by a bare id
+struct session_hash
+{
+  size_t operator()(const session& s) const { return (*this)(s.id); }
+  // a poor hash so that chains hold several elements
+  size_t operator()(int id) const { return static_cast<size_t>(id) * 0x9e3779b9u % 101; }
+};
+
+struct session_equal
+{
+  bool operator()(const session& a, const session& b) const { return a.id == b.id; }
+  bool operator()(int id, const session& b) const { return id == b.id; }
+};
+
+typedef mystl::intrusive_list<session, lru_tag>  lru_list;
+typedef mystl::intrusive_list<session, free_tag> free_list;
+typedef mystl::intrusive_hash_set<session, session_hash, session_equal> session_set;
+
+template <class List>
+bool same(const List& l, const std::list<int>& s)
+{
+  if (l.size() != s.size()) return false;
+  auto it = s.begin();
+  for (const auto& x : l)
+  {
+    if (x.id != *it++) return false;
+  }
+  // the links are consistent backwards as well
+  auto rit = s.rbegin();
+  for (auto p = l.end(); p != l.begin();)
+  {
+    --p;
+    if (p->id != *rit++) return false;
+  }
+  return true;
+}
+
+bool same(const session_set& h, const std::set<int>& s)
+{
+  if (h.size() != s.size()) return false;
+  std::vector<int> ids;
+  for (const auto& x : h) ids.push_back(x.id);
+  std::sort(ids.begin(), ids.end());
+  return std::equal(ids.begin(), ids.end(), s.begin());
+}
+
+// an element in a list of pool, chosen at random
+std::list<int>::iterator pick(std::mt19937& rng, std::list<int>& s)
+{
+  auto it = s.begin();
+  std::advance(it, rng() % s.size());
+  return it;
+}
+
+void test_list_random(std::mt19937& rng)
+{
+  std::vector<session> pool(64);
+  for (int i = 0; i < 64; ++i) pool[i].id = i;
+
+  // a and b hold disjoint elements, the rest of the pool is in neither
+  lru_list a, b;
+  std::list<int> sa, sb;
+  std::vector<int> out;
+  for (int i = 0; i < 64; ++i) out.push_back(i);
+
+  for (int it = 0; it < 20000; ++it)
+  {
+    const unsigned op = rng() % 11;
+    if (op <= 2 && !out.empty())
+    {
+      const size_t k = rng() % out.size();
+      const int id = out[k];
+      out[k] = out.back();
+      out.pop_back();
+      EXPECT(!static_cast<mystl::list_hook<lru_tag>&>(pool[id]).is_linked());
+      if (op == 0)
+      {
+        a.push_back(pool[id]);
+        sa.push_back(id);
+      }
+      else if (op == 1)
+      {
+        a.push_front(pool[id]);
+        sa.push_front(id);
+      }
+      else
+      {
+        // insert before a random element or at the end
+        if (sa.empty() || rng() % 4 == 0)
+        {
+          EXPECT(&*a.insert(a.end(), pool[id]) == &pool[id]);
+          sa.push_back(id);
+        }
+        else
+        {
+          auto sp = pick(rng, sa);
+          a.insert(lru_list::iterator_to(pool[*sp]), pool[id]);
+          sa.insert(sp, id);
+        }
+      }
+    }
+    else if (op == 3 && !sa.empty())
+    {
+      auto sp = pick(rng, sa);
+      const int id = *sp;
+      auto next = a.erase(lru_list::iterator_to(pool[id]));
+      auto snext = sa.erase(sp);
+      EXPECT(snext == sa.end() ? next == a.end() : next->id == *snext);
+      out.push_back(id);
+    }
+    else if (op == 4 && !sa.empty())
+    {
+      const int id = rng() % 2 ? sa.front() : sa.back();
+      if (id == sa.front())
+      {
+        a.pop_front();
+        sa.pop_front();
+      }
+      else
+      {
+        a.pop_back();
+        sa.pop_back();
+      }
+      out.push_back(id);
+    }
+    else if (op == 5 && !sa.empty())
+    {
+      // erase by reference, then a range
+      auto sp = pick(rng, sa);
+      a.erase(pool[*sp]);
+      out.push_back(*sp);
+      sa.erase(sp);
+      if (!sa.empty())
+      {
+        auto sfirst = pick(rng, sa);
+        auto slast = sfirst;
+        std::advance(slast, rng() % (std::distance(sfirst, sa.end()) + 1));
+        auto first = lru_list::iterator_to(pool[*sfirst]);
+        auto last = slast == sa.end() ? a.end() : lru_list::iterator_to(pool[*slast]);
+        out.insert(out.end(), sfirst, slast);
+        EXPECT(a.erase(first, last) == last);
+        sa.erase(sfirst, slast);
+      }
+    }
+    else if (op == 6)
+    {
+      // move one element of a into b, or within b
+      if (!sa.empty())
+      {
+        auto sp = pick(rng, sa);
+        auto bpos = sb.empty() ? sb.end() : pick(rng, sb);
+        b.splice(bpos == sb.end() ? b.end() : lru_list::iterator_to(pool[*bpos]),
+                 a, lru_list::iterator_to(pool[*sp]));
+        sb.splice(bpos, sa, sp);
+      }
+      if (!sb.empty())
+      {
+        auto from = pick(rng, sb);
+        auto to = pick(rng, sb);
+        b.splice(lru_list::iterator_to(pool[*to]), b, lru_list::iterator_to(pool[*from]));
+        sb.splice(to, sb, from);
+      }
+    }
+    else if (op == 7)
+    {
+      // all of b into a at a random position
+      auto sp = sa.empty() ? sa.end() : pick(rng, sa);
+      a.splice(sp == sa.end() ? a.end() : lru_list::iterator_to(pool[*sp]), b);
+      sa.splice(sp, sb);
+      EXPECT(b.empty());
+    }
+    else if (op == 8)
+    {
+      a.reverse();
+      sa.reverse();
+    }
+    else if (op == 9)
+    {
+      if (rng() % 2)
+        a.swap(b);
+      else
+        swap(a, b);
+      sa.swap(sb);
+    }
+    else if (op == 10 && rng() % 20 == 0)
+    {
+      // give everything in b back to the pool
+      std::vector<int> disposed;
+      b.clear_and_dispose([&disposed](session* s) { disposed.push_back(s->id); });
+      EXPECT(std::equal(disposed.begin(), disposed.end(), sb.begin()) &&
+             disposed.size() == sb.size());
+      out.insert(out.end(), sb.begin(), sb.end());
+      sb.clear();
+      EXPECT(b.empty() && b.begin() == b.end());
+    }
+    EXPECT(same(a, sa) && same(b, sb));
+    if (!same(a, sa) || !same(b, sb)) return;
+  }
+
+  // a moved list keeps the elements, a moved-from one is empty
+  lru_list c(mystl::move(a));
+  EXPECT(same(c, sa) && a.empty());
+  a = mystl::move(c);
+  EXPECT(same(a, sa) && c.empty());
+  for (auto& s : sa)
+  {
+    EXPECT(static_cast<mystl::list_hook<lru_tag>&>(pool[s]).is_linked());
+  }
+}
+
+// elements erased through a disposer are recycled into a pool
+void test_list_dispose()
+{
+  std::vector<session> pool(10);
+  lru_list live;
+  free_list spare;
+  for (int i = 0; i < 10; ++i)
+  {
+    pool[i].id = i;
+    live.push_back(pool[i]);
+  }
+  auto it = live.begin();
+  while (it != live.end())
+  {
+    if (it->id % 3 == 0)
+      it = live.erase_and_dispose(it, [&spare](session* s) { spare.push_back(*s); });
+    else
+      ++it;
+  }
+  EXPECT(live.size() == 6 && spare.size() == 4 && spare.front().id == 0 && spare.back().id == 9);
+  live.clear_and_dispose([&spare](session* s) { spare.push_front(*s); });
+  EXPECT(live.empty() && spare.size() == 10 && spare.front().id == 8);
+}
+
+void test_set_random(std::mt19937& rng)
+{
+  std::vector<session> pool(500);
+  for (int i = 0; i < 500; ++i) pool[i].id = i;
+  session_set h;
+  std::set<int> s;
+  EXPECT(h.find(3) == h.end() && h.count(3) == 0 && h.erase(3) == 0 && h.begin() == h.end());
+
+  for (int it = 0; it < 20000; ++it)
+  {
+    const int id = static_cast<int>(rng() % 500);
+    switch (rng() % 4)
+    {
+      case 0:
+      case 1:
+      {
+        if (s.count(id)) break;
+        auto r = h.insert(pool[id]);
+        EXPECT(r.second && &*r.first == &pool[id]);
+        s.insert(id);
+        // an equal element that is not linked is refused
+        session twin(id);
+        auto r2 = h.insert(twin);
+        EXPECT(!r2.second && &*r2.first == &pool[id]);
+        break;
+      }
+      case 2:
+        EXPECT(h.erase(id) == s.erase(id));
+        break;
+      default:
+      {
+        auto f = h.find(id);
+        EXPECT(s.count(id) ? (f != h.end() && &*f == &pool[id]) : f == h.end());
+        EXPECT(h.count(id) == s.count(id));
+        if (s.count(id) && rng() % 2)
+        {
+          h.erase(pool[id]);
+          s.erase(id);
+        }
+        break;
+      }
+    }
+    EXPECT(h.load_factor() <= h.max_load_factor());
+  }
+  EXPECT(same(h, s));
+}
+
+// erase every other element while walking, after the bucket array has grown
+// several times and after an explicit rehash
+void test_set_erase_while_iterating()
+{
+  std::vector<session> pool(1000);
+  session_set h;
+  for (int i = 0; i < 1000; ++i)
+  {
+    pool[i].id = i;
+    h.insert(pool[i]);
+  }
+  EXPECT(h.bucket_count() >= 1000);
+  std::set<int> s;
+  for (int i = 0; i < 1000; ++i) s.insert(i);
+
+  for (int round = 0; round < 3; ++round)
+  {
+    bool drop = false;
+    for (auto it = h.begin(); it != h.end();)
+    {
+      if (drop)
+      {
+        s.erase(it->id);
+        it = h.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+      drop = !drop;
+    }
+    EXPECT(same(h, s));
+    // relink into a larger and then a smaller array, the ids still resolve
+    h.rehash(h.bucket_count() * 4);
+    EXPECT(same(h, s));
+    h.rehash(0);
+    EXPECT(h.bucket_count() >= h.size() && same(h, s));
+    bool found = true;
+    for (auto id : s) found = found && h.find(id) != h.end() && h.find(id)->id == id;
+    EXPECT(found);
+  }
+
+  // the same through a const set and iterator_to
+  const session_set& ch = h;
+  size_t n = 0;
+  for (auto it = ch.begin(); it != ch.end(); ++it) ++n;
+  EXPECT(n == s.size());
+  auto at = h.iterator_to(pool[*s.begin()]);
+  EXPECT(&*at == &pool[*s.begin()]);
+  h.erase(at);
+  EXPECT(h.count(*s.begin()) == 0);
+  s.erase(s.begin());
+
+  session_set moved(mystl::move(h));
+  EXPECT(same(moved, s) && h.empty() && h.begin() == h.end());
+  size_t disposed = 0;
+  moved.clear_and_dispose([&disposed](session*) { ++disposed; });
+  EXPECT(disposed == s.size() && moved.empty() && moved.begin() == moved.end());
+}
+
+// one object in an lru list, a free list and the index at once: unlinking it
+// from one leaves the others alone
+void test_two_hooks()
+{
+  std::vector<session> pool(20);
+  lru_list lru;
+  free_list spare;
+  session_set index(20);
+  const size_t buckets = index.bucket_count();
+  for (int i = 0; i < 20; ++i)
+  {
+    pool[i].id = 100 + i;
+    lru.push_front(pool[i]);
+    index.insert(pool[i]);
+    if (i % 2) spare.push_back(pool[i]);
+  }
+  EXPECT(index.bucket_count() == buckets);  // reserved ahead, no growth
+
+  // touch a session found by id: move it to the front of the lru
+  session& s = *index.find(107);
+  lru.erase(s);
+  lru.push_front(s);
+  EXPECT(&lru.front() == &s && lru.size() == 20 && spare.size() == 10);
+
+  // evict the least recently used
+  session& victim = lru.back();
+  EXPECT(victim.id == 100);
+  lru.pop_back();
+  index.erase(victim);
+  EXPECT(index.count(100) == 0 && index.size() == 19 && lru.size() == 19);
+  EXPECT(spare.size() == 10 && spare.front().id == 101);
+
+  // mystl algorithms over both iterator types
+  EXPECT(mystl::distance(lru.begin(), lru.end()) == 19);
+  EXPECT(mystl::distance(index.begin(), index.end()) == 19);
+  EXPECT(mystl::distance(spare.cbegin(), spare.cend()) == 10);
+  std::vector<int> in_lru, in_index;
+  for (auto& x : lru) in_lru.push_back(x.id);
+  for (auto& x : index) in_index.push_back(x.id);
+  std::sort(in_lru.begin(), in_lru.end());
+  std::sort(in_index.begin(), in_index.end());
+  EXPECT(in_lru == in_index);
+
+  auto same_id = [](const session& x, const session& y) { return x.id == y.id; };
+  EXPECT(mystl::equal(lru.begin(), lru.end(), lru.cbegin(), same_id));
+  std::vector<session> copies;
+  for (auto& x : index) copies.push_back(x);
+  EXPECT(mystl::equal(index.begin(), index.end(), copies.data(), same_id));
+  copies[5].id = -1;
+  EXPECT(!mystl::equal(index.cbegin(), index.cend(), copies.data(), same_id));
+  // a copy of an element is linked nowhere
+  EXPECT(!static_cast<mystl::list_hook<lru_tag>&>(copies[0]).is_linked());
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937 rng(47);
+  test_list_random(rng);
+  test_list_dispose();
+  test_set_random(rng);
+  test_set_erase_while_iterating();
+  test_two_hooks();
+  return test::result("test_intrusive");
+}
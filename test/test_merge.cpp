@@ -0,0 +1,63 @@
+// merge, multiway_merge and multiway_set_union against std::merge and std::set_union
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "algo_merge.h"
+#include "functional.h"
+#include "util.h"
+
+#include "test.h"
+
+int main()
+{
+  std::mt19937 rng(1);
+  for (int it = 0; it < 3000; ++it)
+  {
+    const int k = static_cast<int>(rng() % 10);
+    std::vector<std::vector<int>> runs(k);
+    for (auto& r : runs)
+    {
+      const int n = static_cast<int>(rng() % 30);
+      for (int i = 0; i < n; ++i) r.push_back(static_cast<int>(rng() % 12));
+      std::sort(r.begin(), r.end());
+    }
+    std::vector<mystl::pair<const int*, const int*>> ranges;
+    std::vector<int> all;
+    std::vector<int> uni;
+    for (auto& r : runs)
+    {
+      ranges.push_back(mystl::pair<const int*, const int*>(r.data(), r.data() + r.size()));
+      all.insert(all.end(), r.begin(), r.end());
+      std::vector<int> t;
+      std::set_union(uni.begin(), uni.end(), r.begin(), r.end(), std::back_inserter(t));
+      uni.swap(t);
+    }
+    std::sort(all.begin(), all.end());
+
+    std::vector<int> out(all.size() + 1);
+    if (k >= 2)
+    {
+      std::vector<int> two;
+      std::merge(runs[0].begin(), runs[0].end(), runs[1].begin(), runs[1].end(),
+                 std::back_inserter(two));
+      int* e2 = mystl::merge(runs[0].data(), runs[0].data() + runs[0].size(),
+                             runs[1].data(), runs[1].data() + runs[1].size(), out.data());
+      EXPECT(std::vector<int>(out.data(), e2) == two);
+      e2 = mystl::merge(runs[0].data(), runs[0].data() + runs[0].size(),
+                        runs[1].data(), runs[1].data() + runs[1].size(), out.data(),
+                        mystl::less<int>());
+      EXPECT(std::vector<int>(out.data(), e2) == two);
+    }
+
+    int* e = mystl::multiway_merge(ranges.data(), ranges.data() + ranges.size(), out.data());
+    EXPECT(std::vector<int>(out.data(), e) == all);
+
+    e = mystl::multiway_set_union(ranges.data(), ranges.data() + ranges.size(), out.data(),
+                                  mystl::less<int>());
+    EXPECT(std::vector<int>(out.data(), e) == uni);
+  }
+  return test::result("test_merge");
+}
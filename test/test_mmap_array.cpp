@@ -0,0 +1,268 @@
+// mapped_file and mmap_array on temporary files: open failures, empty files,
+// offsets, the trailing partial element, read-only and private mappings,
+// move and swap, and which pages advise touches
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "algo_sort.h"
+#include "algobase.h"
+#include "mmap_array.h"
+#include "numeric.h"
+
+#include "test.h"
+
+namespace
+{
+
+// a temporary file holding the given bytes, removed with the object
+struct temp_file
+{
+  std::string path;
+
+  explicit temp_file(const std::vector<unsigned char>& bytes)
+  {
+    char name[] = "/tmp/litestl_mmap_XXXXXX";
+    const int fd = ::mkstemp(name);
+    if (fd < 0) std::abort();
+    path = name;
+    if (!bytes.empty() &&
+        ::write(fd, bytes.data(), bytes.size()) != static_cast<ssize_t>(bytes.size()))
+      std::abort();
+    ::close(fd);
+  }
+
+  ~temp_file() { std::remove(path.c_str()); }
+
+  // the bytes on disk now
+  std::vector<unsigned char> read() const
+  {
+    std::vector<unsigned char> bytes;
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    int c;
+    while ((c = std::fgetc(f)) != EOF) bytes.push_back(static_cast<unsigned char>(c));
+    std::fclose(f);
+    return bytes;
+  }
+};
+
+// n 32-bit values i * 3 followed by tail extra bytes
+std::vector<unsigned char> make_bytes(size_t n, size_t tail)
+{
+  std::vector<uint32_t> values(n);
+  for (size_t i = 0; i < n; ++i) values[i] = static_cast<uint32_t>(i * 3);
+  std::vector<unsigned char> bytes(n * sizeof(uint32_t) + tail, 0xee);
+  if (n != 0) std::memcpy(bytes.data(), values.data(), n * sizeof(uint32_t));
+  return bytes;
+}
+
+void test_open_failures()
+{
+  mystl::mmap_array<uint32_t> a;
+  EXPECT(!a.is_open() && a.empty() && a.begin() == a.end());
+
+  errno = 0;
+  EXPECT(!a.open("/nonexistent/litestl/file"));
+  EXPECT(errno == ENOENT && !a.is_open() && a.size() == 0);
+  mystl::mapped_file f;
+  EXPECT(!f.open("/nonexistent/litestl/file") && !f.is_open());
+
+  temp_file t(make_bytes(16, 0));
+  EXPECT(!a.open(t.path.c_str(), mystl::map_read, 2));  // misaligned
+  EXPECT(!a.is_open());
+  EXPECT(!a.open(t.path.c_str(), mystl::map_read, 68));  // past the end
+  EXPECT(!a.is_open() && !a.file().is_open());
+  // a failed open drops the previous mapping
+  EXPECT(a.open(t.path.c_str()) && a.size() == 16);
+  EXPECT(!a.open(t.path.c_str(), mystl::map_read, 3) && !a.is_open() && a.data() == nullptr);
+
+  // the offset may be the end of the file: no elements
+  EXPECT(a.open(t.path.c_str(), mystl::map_read, 64) && a.is_open() && a.empty());
+}
+
+void test_empty_file()
+{
+  temp_file t(std::vector<unsigned char>{});
+  mystl::mapped_file f;
+  EXPECT(f.open(t.path.c_str()) && f.is_open() && f.size() == 0 && f.data() == nullptr);
+  EXPECT(f.advise(mystl::advise_willneed));
+
+  mystl::mmap_array<uint32_t> a;
+  EXPECT(a.open(t.path.c_str()) && a.is_open() && a.empty() && a.begin() == a.end());
+  EXPECT(mystl::accumulate(a.begin(), a.end(), 0u) == 0u);
+  EXPECT(a.advise(mystl::advise_sequential) && a.view().empty());
+  EXPECT_THROW(a.at(0), std::out_of_range);
+  EXPECT(!a.open(t.path.c_str(), mystl::map_read, 4));
+}
+
+void test_read()
+{
+  for (size_t tail = 0; tail < 4; ++tail)
+  {
+    temp_file t(make_bytes(1000, tail));
+    mystl::mmap_array<uint32_t> a;
+    EXPECT(a.open(t.path.c_str()));
+    // the trailing partial element is not part of the array
+    EXPECT(a.size() == 1000 && a.file().size() == 4000 + tail);
+    EXPECT(a.front() == 0 && a.back() == 2997 && a[10] == 30 && a.at(999) == 2997);
+    EXPECT_THROW(a.at(1000), std::out_of_range);
+    EXPECT(mystl::accumulate(a.begin(), a.end(), 0ul) == 3ul * 999 * 1000 / 2);
+    EXPECT(*mystl::lower_bound(a.begin(), a.end(), 1500u) == 1500);
+    EXPECT(a.view().size() == 1000 && a.view().data() == a.data());
+
+    // the elements start at the offset
+    EXPECT(a.open(t.path.c_str(), mystl::map_read, 8));
+    EXPECT(a.size() == 998 && a.front() == 6 && a.back() == 2997);
+    EXPECT(a.open(t.path.c_str(), mystl::map_read, 3996));
+    EXPECT(a.size() == 1 && a.front() == 2997);
+    EXPECT(a.open(t.path.c_str(), mystl::map_read, 4000) && a.empty());
+  }
+}
+
+void test_writable()
+{
+  temp_file t(make_bytes(100, 2));
+  const auto original = t.read();
+
+  mystl::mmap_array<uint32_t> ro;
+  EXPECT(ro.open(t.path.c_str()));
+  EXPECT_THROW(ro.writable(), std::logic_error);
+  EXPECT_THROW(ro.file().writable_data(), std::logic_error);
+
+  // a private mapping can be written, the file and other mappings never see it
+  mystl::mmap_array<uint32_t> a;
+  EXPECT(a.open(t.path.c_str(), mystl::map_private, 4));
+  auto w = a.writable();
+  EXPECT(w.size() == 99 && w.data() == a.data());
+  for (auto& x : w) x = 7;
+  mystl::sort(w.begin(), w.end());
+  EXPECT(a[0] == 7 && a[98] == 7);
+  EXPECT(a.file().writable_data()[0] == 0);  // before the offset, untouched
+  EXPECT(ro[1] == 3 && ro[99] == 297);
+
+  mystl::mmap_array<uint32_t> again;
+  EXPECT(again.open(t.path.c_str()) && again[1] == 3);
+  a.close();
+  EXPECT(!a.is_open() && a.empty());
+  EXPECT(t.read() == original);
+}
+
+void test_move_swap()
+{
+  temp_file t1(make_bytes(10, 0));
+  temp_file t2(make_bytes(20, 1));
+  mystl::mmap_array<uint32_t> a, b;
+  EXPECT(a.open(t1.path.c_str()) && b.open(t2.path.c_str(), mystl::map_private));
+  const uint32_t* pa = a.data();
+  const uint32_t* pb = b.data();
+
+  a.swap(b);
+  EXPECT(a.data() == pb && a.size() == 20 && b.data() == pa && b.size() == 10);
+  EXPECT(a.file().mode() == mystl::map_private && b.file().mode() == mystl::map_read);
+  EXPECT_THROW(b.writable(), std::logic_error);
+  EXPECT(a.writable().size() == 20);
+  swap(a, b);
+  EXPECT(a.data() == pa && b.data() == pb);
+
+  mystl::mmap_array<uint32_t> c(mystl::move(a));
+  EXPECT(c.data() == pa && c.size() == 10 && c.is_open());
+  EXPECT(!a.is_open() && a.data() == nullptr && a.empty());
+
+  // assigning over an open array unmaps it first
+  c = mystl::move(b);
+  EXPECT(c.data() == pb && c.size() == 20 && c.back() == 57 && !b.is_open());
+  c = mystl::move(a);
+  EXPECT(!c.is_open() && c.empty());
+
+  mystl::mapped_file f, g;
+  EXPECT(f.open(t1.path.c_str()));
+  const unsigned char* pf = f.data();
+  f.swap(g);
+  EXPECT(g.data() == pf && g.size() == 40 && !f.is_open());
+  mystl::mapped_file h(mystl::move(g));
+  EXPECT(h.data() == pf && !g.is_open() && g.data() == nullptr);
+  swap(f, h);
+  EXPECT(f.data() == pf && f.is_open());
+}
+
+// advise_dontneed drops the changes of a private mapping, which shows which
+// pages a call covered
+void test_advise_range()
+{
+  const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  const size_t per_page = page / sizeof(uint32_t);
+  const size_t n = 3 * per_page + per_page / 2;
+  temp_file t(make_bytes(n, 3));
+
+  mystl::mmap_array<uint32_t> a;
+  EXPECT(a.open(t.path.c_str(), mystl::map_private));
+  EXPECT(a.size() == n);
+  auto w = a.writable();
+  // reverted[i]: element i holds its value from the file again
+  auto dirty = [&w]() { for (auto& x : w) x = 1; };
+  auto reverted = [&a](size_t i) { return a[i] == i * 3; };
+
+  // the elements of one page
+  dirty();
+  EXPECT(a.advise(mystl::advise_dontneed, per_page, per_page));
+  EXPECT(!reverted(per_page - 1) && reverted(per_page) && reverted(2 * per_page - 1) &&
+         !reverted(2 * per_page));
+
+  // a count past the end is clamped
+  dirty();
+  EXPECT(a.advise(mystl::advise_dontneed, 3 * per_page, static_cast<size_t>(-1) - 1));
+  EXPECT(!reverted(3 * per_page - 1) && reverted(3 * per_page) && reverted(n - 1));
+  dirty();
+  EXPECT(a.advise(mystl::advise_dontneed, 3 * per_page, 2 * n));
+  EXPECT(!reverted(3 * per_page - 1) && reverted(n - 1));
+
+  // from the end of the elements on there is nothing, also when the bytes of
+  // the partial element share the last page
+  dirty();
+  EXPECT(a.advise(mystl::advise_dontneed, n, 1));
+  EXPECT(a.advise(mystl::advise_dontneed, n + 100, static_cast<size_t>(-1)));
+  EXPECT(a.advise(mystl::advise_dontneed, n, 0));
+  EXPECT(!reverted(n - 1) && !reverted(0));
+
+  // nothing at all, and every hint on a whole array
+  dirty();
+  EXPECT(a.advise(mystl::advise_dontneed, 0, 0));
+  EXPECT(!reverted(0));
+  EXPECT(a.advise(mystl::advise_normal) && a.advise(mystl::advise_sequential) &&
+         a.advise(mystl::advise_random) && a.advise(mystl::advise_willneed));
+  EXPECT(a.advise(mystl::advise_dontneed));
+  EXPECT(reverted(0) && reverted(n / 2) && reverted(n - 1));
+
+  // with an offset the range is widened down to the page of its first byte
+  EXPECT(a.open(t.path.c_str(), mystl::map_private, 8));
+  auto w8 = a.writable();
+  // element k is at byte 8 + 4k, per_page - 2 is the first one of page 1
+  for (auto& x : w8) x = 1;
+  EXPECT(a.advise(mystl::advise_dontneed, per_page - 2, 1));
+  EXPECT(a[per_page - 3] == 1 && a[per_page - 2] == per_page * 3 &&
+         a[2 * per_page - 3] == (2 * per_page - 1) * 3 && a[2 * per_page - 2] == 1);
+  for (auto& x : w8) x = 1;
+  EXPECT(a.advise(mystl::advise_dontneed, per_page, 1));
+  EXPECT(a[per_page - 3] == 1 && a[per_page - 2] == per_page * 3);
+}
+
+} // namespace
+
+int main()
+{
+  test_open_failures();
+  test_empty_file();
+  test_read();
+  test_writable();
+  test_move_swap();
+  test_advise_range();
+  return test::result("test_mmap_array");
+}
@@ -0,0 +1,137 @@
+// accumulate and inner_product on contiguous integers, which take the simd
+// kernels, against the scalar loop: mixed widths and signedness of the
+// elements and the result, wrap-around, lengths that are not a multiple of
+// the lane count, and unaligned starts
+// the same file is built a second time with -mavx2 for the 256-bit kernels
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "numeric.h"
+
+#include "test.h"
+
+namespace
+{
+
+// a random value of the given bits: signed types get [-2^(bits-1), 2^(bits-1)),
+// unsigned ones [0, 2^bits), so the scalar loop never overflows a signed type
+template <class T>
+T random_value(std::mt19937_64& rng, int bits)
+{
+  const uint64_t r = rng();
+  if (std::is_signed<T>::value)
+    return static_cast<T>(static_cast<int64_t>(r) >> (64 - bits));
+  return static_cast<T>(r >> (64 - bits));
+}
+
+template <class T>
+std::vector<T> random_vector(std::mt19937_64& rng, size_t n, int bits)
+{
+  std::vector<T> v(n);
+  for (auto& x : v) x = random_value<T>(rng, bits);
+  return v;
+}
+
+template <class T, class U>
+U scalar_accumulate(const T* p, size_t n, U init)
+{
+  for (size_t i = 0; i < n; ++i) init += p[i];
+  return init;
+}
+
+template <class T1, class T2, class U>
+U scalar_inner_product(const T1* a, const T2* b, size_t n, U init)
+{
+  for (size_t i = 0; i < n; ++i) init += a[i] * b[i];
+  return init;
+}
+
+const size_t lengths[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 63, 64, 65, 1000, 1003};
+
+// bits bounds the elements and the initial value
+template <class T, class U>
+void check_accumulate(std::mt19937_64& rng, int bits)
+{
+  for (auto n : lengths)
+  {
+    // one extra element so the range can start off its natural alignment
+    std::vector<T> v = random_vector<T>(rng, n + 1, bits);
+    const U init = random_value<U>(rng, bits < 8 * static_cast<int>(sizeof(U)) ? bits : 8);
+    for (size_t off = 0; off < 2; ++off)
+    {
+      T* p = v.data() + off;
+      const T* cp = p;
+      const U expected = scalar_accumulate(cp, n, init);
+      EXPECT(mystl::accumulate(p, p + n, init) == expected);
+      EXPECT(mystl::accumulate(cp, cp + n, init) == expected);
+    }
+  }
+}
+
+template <class T1, class T2, class U>
+void check_inner_product(std::mt19937_64& rng, int bits)
+{
+  for (auto n : lengths)
+  {
+    std::vector<T1> a = random_vector<T1>(rng, n + 1, bits);
+    std::vector<T2> b = random_vector<T2>(rng, n + 1, bits);
+    const U init = random_value<U>(rng, 8);
+    for (size_t off = 0; off < 2; ++off)
+    {
+      const T1* pa = a.data() + off;
+      T2* pb = b.data() + 1 - off;
+      const U expected = scalar_inner_product(pa, pb, n, init);
+      EXPECT(mystl::inner_product(pa, pa + n, pb, pb + n, init) == expected);
+    }
+  }
+}
+
+} // namespace
+
+int main()
+{
+#if defined(__AVX2__) && defined(__GNUC__)
+  if (!__builtin_cpu_supports("avx2"))
+  {
+    std::printf("test_numeric_avx2: skipped, the cpu has no avx2\n");
+    return 0;
+  }
+#endif
+  std::mt19937_64 rng(48);
+
+  // 32-bit elements into 64-bit results: sign and zero extension
+  check_accumulate<int, long>(rng, 32);
+  check_accumulate<unsigned, long>(rng, 32);
+  check_accumulate<int, unsigned long>(rng, 32);
+  check_accumulate<unsigned, long long>(rng, 32);
+  // 64-bit elements into narrower results: truncation after every step
+  check_accumulate<long, int>(rng, 41);
+  check_accumulate<long, short>(rng, 41);
+  check_accumulate<unsigned long, unsigned char>(rng, 64);
+  check_accumulate<unsigned long, long>(rng, 64);
+  check_accumulate<long, long>(rng, 50);
+  // 32-bit elements into 32-bit or narrower results
+  check_accumulate<int, short>(rng, 30);
+  check_accumulate<int, int>(rng, 20);
+  check_accumulate<unsigned, int>(rng, 32);
+  check_accumulate<unsigned, unsigned>(rng, 32);
+  check_accumulate<int, signed char>(rng, 30);
+
+  check_inner_product<int, int, long>(rng, 15);
+  check_inner_product<int, int, int>(rng, 10);
+  check_inner_product<int, int, short>(rng, 10);
+  check_inner_product<unsigned, unsigned, unsigned long>(rng, 32);
+  check_inner_product<unsigned, unsigned, unsigned>(rng, 32);
+  check_inner_product<int, unsigned, long>(rng, 32);
+  check_inner_product<unsigned, int, short>(rng, 32);
+  check_inner_product<int, int, long long>(rng, 15);
+
+#if defined(__AVX2__)
+  return test::result("test_numeric_avx2");
+#else
+  return test::result("test_numeric");
+#endif
+}
@@ -0,0 +1,171 @@
+// parallel set operations, parallel_merge and parallel_sort against std
+// the inputs are longer than the grain, so on a machine with several threads
+// the ranges are split and every part runs on its own thread
+// exceptions thrown by tasks reach the thread that forked them
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "algo_parallel.h"
+#include "functional.h"
+#include "parallel.h"
+
+#include "test.h"
+
+namespace
+{
+
+std::vector<int> random_sorted(std::mt19937& rng, size_t n, int range)
+{
+  std::vector<int> v(n);
+  for (auto& x : v) x = static_cast<int>(rng() % range);
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+void test_set_operations(std::mt19937& rng, size_t n1, size_t n2, int range)
+{
+  const auto a = random_sorted(rng, n1, range);
+  const auto b = random_sorted(rng, n2, range);
+  std::vector<int> expect;
+  std::vector<int> out(n1 + n2);
+  int* e;
+
+  std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expect));
+  e = mystl::parallel_set_union(a.data(), a.data() + n1, b.data(), b.data() + n2, out.data());
+  EXPECT(std::vector<int>(out.data(), e) == expect);
+  e = mystl::parallel_set_union(a.data(), a.data() + n1, b.data(), b.data() + n2, out.data(),
+                                mystl::less<int>());
+  EXPECT(std::vector<int>(out.data(), e) == expect);
+
+  expect.clear();
+  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expect));
+  e = mystl::parallel_set_intersection(a.data(), a.data() + n1, b.data(), b.data() + n2,
+                                       out.data());
+  EXPECT(std::vector<int>(out.data(), e) == expect);
+
+  expect.clear();
+  std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expect));
+  e = mystl::parallel_set_difference(a.data(), a.data() + n1, b.data(), b.data() + n2,
+                                     out.data());
+  EXPECT(std::vector<int>(out.data(), e) == expect);
+
+  expect.clear();
+  std::set_symmetric_difference(a.begin(), a.end(), b.begin(), b.end(),
+                                std::back_inserter(expect));
+  e = mystl::parallel_set_symmetric_difference(a.data(), a.data() + n1, b.data(),
+                                               b.data() + n2, out.data());
+  EXPECT(std::vector<int>(out.data(), e) == expect);
+}
+
+void test_merge_and_sort(std::mt19937& rng, size_t n, int range)
+{
+  const auto a = random_sorted(rng, n, range);
+  const auto b = random_sorted(rng, n / 2, range);
+  std::vector<int> expect;
+  std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expect));
+  std::vector<int> out(a.size() + b.size());
+  int* e = mystl::parallel_merge(a.data(), a.data() + a.size(), b.data(),
+                                 b.data() + b.size(), out.data());
+  EXPECT(e == out.data() + out.size() && out == expect);
+  e = mystl::parallel_merge(a.data(), a.data() + a.size(), b.data(),
+                            b.data() + b.size(), out.data(), mystl::less<int>());
+  EXPECT(e == out.data() + out.size() && out == expect);
+
+  std::vector<int> v(n);
+  for (auto& x : v) x = static_cast<int>(rng() % range);
+  expect = v;
+  std::sort(expect.begin(), expect.end());
+  auto s = v;
+  mystl::parallel_sort(s.data(), s.data() + n);
+  EXPECT(s == expect);
+  s = v;
+  mystl::parallel_sort(s.data(), s.data() + n, mystl::greater<int>());
+  EXPECT(std::equal(s.begin(), s.end(), expect.rbegin()));
+
+  std::vector<std::string> str(n / 8);
+  for (auto& x : str) x = std::to_string(rng() % range);
+  auto sexpect = str;
+  std::sort(sexpect.begin(), sexpect.end());
+  mystl::parallel_sort(str.data(), str.data() + str.size());
+  EXPECT(str == sexpect);
+}
+
+// throws std::runtime_error on its calls-th call, from whichever thread
+struct throwing_less
+{
+  std::atomic<long>* calls;
+  bool operator()(int a, int b) const
+  {
+    if (calls->fetch_sub(1) == 1) throw std::runtime_error("comp");
+    return a < b;
+  }
+};
+
+void test_exceptions(std::mt19937& rng)
+{
+  // a task that throws, forked and joined on the scheduler directly, so that
+  // it runs as a task even on a single thread
+  bool ran = false;
+  auto f = [&] { ran = true; throw std::runtime_error("task"); };
+  mystl::parallel_task_of<decltype(f)> task(f);
+  mystl::task_scheduler::instance().fork(&task);
+  mystl::task_scheduler::instance().join(&task);
+  EXPECT(ran && task.done.load() && task.error);
+
+  // the forked and the calling side of parallel_invoke
+  int finished = 0;
+  EXPECT_THROW(mystl::parallel_invoke([&] { ++finished; },
+                                      [&] { throw std::runtime_error("g"); }),
+               std::runtime_error);
+  EXPECT(finished == 1);
+  EXPECT_THROW(mystl::parallel_invoke([&] { throw std::runtime_error("f"); },
+                                      [&] { ++finished; }),
+               std::runtime_error);
+  std::vector<int> hit(1000, 0);
+  EXPECT_THROW(mystl::parallel_invoke_n(hit.size(), [&](size_t i)
+  {
+    hit[i] = 1;
+    if (i == 500) throw std::runtime_error("n");
+  }), std::runtime_error);
+
+  // a comp that throws in the sampling, the distribution or a bucket sort
+  const size_t n = 1 << 20;
+  std::vector<int> v(n);
+  for (auto& x : v) x = static_cast<int>(rng());
+  const long when[] = { 1, static_cast<long>(n / 2), static_cast<long>(4 * n) };
+  for (auto w : when)
+  {
+    std::atomic<long> calls(w);
+    auto s = v;
+    EXPECT_THROW(mystl::parallel_sort(s.data(), s.data() + n, throwing_less{&calls}),
+                 std::runtime_error);
+  }
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937 rng(1);
+  for (int it = 0; it < 200; ++it)
+  {
+    test_set_operations(rng, rng() % 100, rng() % 100, 1 + static_cast<int>(rng() % 50));
+  }
+  // heavy duplicates, many distinct values and lopsided sizes above the grain
+  test_set_operations(rng, 1 << 20, 1 << 20, 16);
+  test_set_operations(rng, 1 << 20, 1 << 20, 1 << 30);
+  test_set_operations(rng, 1 << 20, 1000, 1 << 12);
+  for (int it = 0; it < 100; ++it)
+  {
+    test_merge_and_sort(rng, rng() % 1000, 1 + static_cast<int>(rng() % 100));
+  }
+  test_merge_and_sort(rng, 1 << 20, 16);
+  test_merge_and_sort(rng, 1 << 20, 1 << 30);
+  test_exceptions(rng);
+  return test::result("test_parallel");
+}
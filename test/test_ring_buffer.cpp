@@ -0,0 +1,235 @@
+// spsc_ring and mpmc_ring: FIFO order between one producer and one consumer,
+// every element delivered exactly once between several of each, partial
+// push_n and pop_n batches across the wrap, move-only elements, and the
+// elements left in a ring destroyed with it
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ring_buffer.h"
+
+#include "test.h"
+
+namespace
+{
+
+struct tracked
+{
+  static std::atomic<int> live;
+
+  int value;
+
+  explicit tracked(int v = 0) noexcept :value(v) { ++live; }
+  tracked(const tracked& rhs) noexcept :value(rhs.value) { ++live; }
+  tracked& operator=(const tracked& rhs) noexcept { value = rhs.value; return *this; }
+  ~tracked() { --live; }
+};
+
+std::atomic<int> tracked::live(0);
+
+// the producer pushes 0, 1, 2, ... one at a time and in batches of random
+// size, the consumer pops the same way and must see them in order
+void test_spsc_fifo()
+{
+  const int total = 200000;
+  mystl::spsc_ring<int, 64> ring;
+  std::thread producer([&ring]
+  {
+    std::mt19937 rng(1);
+    std::vector<int> batch;
+    int next = 0;
+    while (next < total)
+    {
+      if (rng() % 2)
+      {
+        if (ring.try_push(next)) ++next;
+        else std::this_thread::yield();
+        continue;
+      }
+      batch.clear();
+      const int n = std::min(total - next, static_cast<int>(rng() % 100));
+      for (int i = 0; i < n; ++i) batch.push_back(next + i);
+      const size_t pushed = ring.push_n(batch.data(), batch.size());
+      next += static_cast<int>(pushed);
+      if (pushed < batch.size()) std::this_thread::yield();
+    }
+  });
+
+  std::mt19937 rng(2);
+  std::vector<int> got;
+  std::vector<int> batch(100);
+  int x = 0;
+  while (got.size() < static_cast<size_t>(total))
+  {
+    if (rng() % 2)
+    {
+      if (ring.try_pop(x)) got.push_back(x);
+      else std::this_thread::yield();
+      continue;
+    }
+    const size_t n = ring.pop_n(batch.data(), rng() % 100);
+    got.insert(got.end(), batch.begin(), batch.begin() + n);
+    if (n == 0) std::this_thread::yield();
+  }
+  producer.join();
+
+  bool ordered = true;
+  for (int i = 0; i < total; ++i) ordered = ordered && got[i] == i;
+  EXPECT(ordered);
+  EXPECT(ring.empty() && !ring.try_pop(x));
+}
+
+// push_n and pop_n take what fits and report how much that was
+void test_spsc_batches()
+{
+  mystl::spsc_ring<int, 8> ring;
+  int in[20], out[20];
+  for (int i = 0; i < 20; ++i) in[i] = i;
+
+  EXPECT(ring.push_n(in, 5) == 5);
+  EXPECT(ring.push_n(in + 5, 5) == 3);  // only three slots left
+  EXPECT(ring.size() == 8 && !ring.try_push(99));
+  EXPECT(ring.push_n(in, 4) == 0);
+  EXPECT(ring.pop_n(out, 6) == 6);
+  EXPECT(ring.push_n(in + 8, 10) == 6);  // wraps around the end of the slots
+  EXPECT(ring.pop_n(out + 6, 20) == 8);  // only eight there
+  EXPECT(ring.pop_n(out, 3) == 0 && ring.empty());
+  EXPECT(ring.pop_n(out + 20, 0) == 0 && ring.push_n(in, 0) == 0);
+
+  bool ok = true;
+  for (int i = 0; i < 14; ++i) ok = ok && out[i] == i;
+  EXPECT(ok);
+}
+
+void test_move_only()
+{
+  {
+    mystl::spsc_ring<std::unique_ptr<int>, 4> ring;
+    for (int round = 0; round < 10; ++round)
+    {
+      for (int i = 0; i < 4; ++i) EXPECT(ring.try_push(std::unique_ptr<int>(new int(i))));
+      EXPECT(!ring.try_push(std::unique_ptr<int>(new int(4))));
+      std::unique_ptr<int> p;
+      for (int i = 0; i < 3; ++i) EXPECT(ring.try_pop(p) && *p == i);
+      std::unique_ptr<int> rest[4];
+      EXPECT(ring.pop_n(rest, 4) == 1 && *rest[0] == 3);
+    }
+    ring.try_emplace(new int(5));  // left in the ring
+  }
+  {
+    mystl::mpmc_ring<std::unique_ptr<int>> ring(3);
+    EXPECT(ring.capacity() == 4);
+    for (int round = 0; round < 10; ++round)
+    {
+      for (int i = 0; i < 4; ++i) EXPECT(ring.try_emplace(new int(i)));
+      EXPECT(!ring.try_push(std::unique_ptr<int>(new int(4))));
+      std::unique_ptr<int> p;
+      for (int i = 0; i < 4; ++i) EXPECT(ring.try_pop(p) && *p == i);
+      EXPECT(!ring.try_pop(p) && ring.empty());
+    }
+    ring.try_emplace(new int(5));
+  }
+}
+
+// the destructors destroy what was pushed and not popped, also after a wrap
+void test_leftovers()
+{
+  {
+    mystl::spsc_ring<tracked, 8> ring;
+    tracked x;
+    for (int i = 0; i < 6; ++i) ring.try_emplace(i);
+    for (int i = 0; i < 5; ++i) ring.try_pop(x);
+    for (int i = 0; i < 7; ++i) ring.try_emplace(i);
+    EXPECT(tracked::live == 1 + 8);
+  }
+  EXPECT(tracked::live == 0);
+  {
+    mystl::mpmc_ring<tracked> ring(8);
+    tracked x;
+    for (int i = 0; i < 6; ++i) ring.try_emplace(i);
+    for (int i = 0; i < 5; ++i) ring.try_pop(x);
+    for (int i = 0; i < 7; ++i) ring.try_emplace(i);
+    EXPECT(tracked::live == 1 + 8);
+  }
+  EXPECT(tracked::live == 0);
+}
+
+// every value pushed by several producers is popped by exactly one of
+// several consumers, and each consumer sees the values of one producer in
+// the order they were pushed
+void test_mpmc_exactly_once()
+{
+  const int producers = 3, consumers = 3, per_producer = 50000;
+  const int total = producers * per_producer;
+  mystl::mpmc_ring<int> ring(100);
+  EXPECT(ring.capacity() == 128);
+
+  std::atomic<int> popped(0);
+  std::vector<std::vector<int>> got(consumers);
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p)
+  {
+    threads.emplace_back([&ring, p]
+    {
+      for (int i = 0; i < per_producer; ++i)
+      {
+        while (!ring.try_push(p * per_producer + i)) std::this_thread::yield();
+      }
+    });
+  }
+  for (int c = 0; c < consumers; ++c)
+  {
+    threads.emplace_back([&ring, &popped, &got, c]
+    {
+      int x = 0;
+      while (popped.load() < total)
+      {
+        if (ring.try_pop(x))
+        {
+          got[c].push_back(x);
+          ++popped;
+        }
+        else
+        {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  std::vector<int> all;
+  bool in_order = true;
+  for (auto& g : got)
+  {
+    std::vector<int> last(producers, -1);
+    for (auto x : g)
+    {
+      in_order = in_order && x > last[x / per_producer];
+      last[x / per_producer] = x;
+    }
+    all.insert(all.end(), g.begin(), g.end());
+  }
+  EXPECT(in_order);
+  std::sort(all.begin(), all.end());
+  bool once = all.size() == static_cast<size_t>(total);
+  for (int i = 0; once && i < total; ++i) once = all[i] == i;
+  EXPECT(once);
+  EXPECT(ring.empty());
+}
+
+} // namespace
+
+int main()
+{
+  test_spsc_fifo();
+  test_spsc_batches();
+  test_move_only();
+  test_leftovers();
+  test_mpmc_exactly_once();
+  return test::result("test_ring_buffer");
+}
@@ -0,0 +1,140 @@
+// set_*_size and set_intersects against the sizes of the std set algorithms,
+// set_intersection against the output of std::set_intersection
+// covers the merge path, galloping in either range, the input iterator path
+// and a comparator between two different element types
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "algo_set.h"
+#include "functional.h"
+#include "iterator.h"
+
+#include "test.h"
+
+namespace
+{
+
+struct record
+{
+  int key;
+  int payload;
+};
+
+// only compares a record with an int, in both argument orders
+struct record_less
+{
+  bool operator()(const record& a, int b) const { return a.key < b; }
+  bool operator()(int a, const record& b) const { return a < b.key; }
+};
+
+// a pointer seen as an input iterator
+class input_ptr : public mystl::iterator<mystl::input_iterator_tag, int>
+{
+  const int* p_;
+public:
+  explicit input_ptr(const int* p) : p_(p) {}
+  const int& operator*() const { return *p_; }
+  input_ptr& operator++() { ++p_; return *this; }
+  bool operator==(const input_ptr& rhs) const { return p_ == rhs.p_; }
+  bool operator!=(const input_ptr& rhs) const { return p_ != rhs.p_; }
+};
+
+std::vector<int> random_sorted(std::mt19937& rng, size_t n, int range)
+{
+  std::vector<int> v(n);
+  for (auto& x : v) x = static_cast<int>(rng() % range);
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+template <class F>
+size_t std_size(const std::vector<int>& a, const std::vector<int>& b, F f)
+{
+  std::vector<int> out;
+  f(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+  return out.size();
+}
+
+typedef std::vector<int>::const_iterator citer;
+typedef std::back_insert_iterator<std::vector<int>> oiter;
+
+void test_sizes(const std::vector<int>& a, const std::vector<int>& b)
+{
+  const size_t inter = std_size(a, b, std::set_intersection<citer, citer, oiter>);
+  const size_t uni = std_size(a, b, std::set_union<citer, citer, oiter>);
+  const size_t diff = std_size(a, b, std::set_difference<citer, citer, oiter>);
+  const size_t sym = std_size(a, b, std::set_symmetric_difference<citer, citer, oiter>);
+
+  const int* a1 = a.data();
+  const int* a2 = a.data() + a.size();
+  const int* b1 = b.data();
+  const int* b2 = b.data() + b.size();
+  EXPECT(mystl::set_intersection_size(a1, a2, b1, b2) == inter);
+  EXPECT(mystl::set_intersection_size(a1, a2, b1, b2, mystl::less<int>()) == inter);
+  EXPECT(mystl::set_union_size(a1, a2, b1, b2) == uni);
+  EXPECT(mystl::set_difference_size(a1, a2, b1, b2) == diff);
+  EXPECT(mystl::set_symmetric_difference_size(a1, a2, b1, b2) == sym);
+  EXPECT(mystl::set_intersects(a1, a2, b1, b2) == (inter != 0));
+
+  std::vector<int> expect;
+  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expect));
+  std::vector<int> out(inter + 1, -1);
+  EXPECT(mystl::set_intersection(a1, a2, b1, b2, out.data()) == out.data() + inter);
+  EXPECT(std::equal(expect.begin(), expect.end(), out.begin()));
+  EXPECT(mystl::set_intersection(a1, a2, b1, b2, out.data(), mystl::less<int>()) ==
+         out.data() + inter);
+  EXPECT(std::equal(expect.begin(), expect.end(), out.begin()));
+
+  // input iterator paths
+  const input_ptr ia1(a1), ia2(a2), ib1(b1), ib2(b2);
+  EXPECT(mystl::set_intersection_size(ia1, ia2, ib1, ib2) == inter);
+  EXPECT(mystl::set_union_size(ia1, ia2, ib1, ib2) == uni);
+  EXPECT(mystl::set_difference_size(ia1, ia2, ib1, ib2) == diff);
+  EXPECT(mystl::set_symmetric_difference_size(ia1, ia2, ib1, ib2) == sym);
+  EXPECT(mystl::set_intersects(ia1, ia2, ib1, ib2) == (inter != 0));
+  out.assign(inter + 1, -1);
+  EXPECT(mystl::set_intersection(ia1, ia2, ib1, ib2, out.data()) == out.data() + inter);
+  EXPECT(std::equal(expect.begin(), expect.end(), out.begin()));
+
+  // records against ints
+  std::vector<record> ra;
+  for (size_t i = 0; i < a.size(); ++i) ra.push_back(record{a[i], static_cast<int>(i)});
+  const record* r1 = ra.data();
+  const record* r2 = ra.data() + ra.size();
+  EXPECT(mystl::set_intersection_size(r1, r2, b1, b2, record_less()) == inter);
+  EXPECT(mystl::set_intersects(r1, r2, b1, b2, record_less()) == (inter != 0));
+
+  // the output comes from the first range, equal keys in order of appearance
+  std::vector<record> rexpect;
+  std::set_intersection(ra.begin(), ra.end(), b.begin(), b.end(),
+                        std::back_inserter(rexpect), record_less());
+  std::vector<record> rout(inter + 1, record{-1, -1});
+  EXPECT(mystl::set_intersection(r1, r2, b1, b2, rout.data(), record_less()) ==
+         rout.data() + inter);
+  for (size_t i = 0; i < rexpect.size(); ++i)
+  {
+    EXPECT(rout[i].key == rexpect[i].key && rout[i].payload == rexpect[i].payload);
+  }
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937 rng(1);
+  for (int it = 0; it < 3000; ++it)
+  {
+    const int range = 1 + static_cast<int>(rng() % 200);
+    const size_t n1 = rng() % 60;
+    const size_t n2 = rng() % 60;
+    test_sizes(random_sorted(rng, n1, range), random_sorted(rng, n2, range));
+    // lopsided sizes take the gallop path, with either range the short one
+    const size_t big = 1000 + rng() % 3000;
+    test_sizes(random_sorted(rng, n1 % 8, range * 20), random_sorted(rng, big, range * 20));
+    test_sizes(random_sorted(rng, big, range * 20), random_sorted(rng, n2 % 8, range * 20));
+  }
+  return test::result("test_set");
+}
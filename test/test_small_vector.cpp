@@ -0,0 +1,255 @@
+// small_vector against std::vector: random inserts and erases that cross the
+// inline capacity both ways, empty ranges, swaps and moves between inline and
+// heap states, move-only elements, and no leak when a move throws while growing
+
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "small_vector.h"
+
+#include "test.h"
+
+namespace
+{
+
+// counts live objects; a move throws once the countdown reaches zero
+struct tracked
+{
+  static int live;
+  static int countdown;
+
+  int value;
+
+  explicit tracked(int v) :value(v) { ++live; }
+  tracked(const tracked& rhs) :value(rhs.value) { ++live; }
+  tracked(tracked&& rhs) :value(rhs.value)
+  {
+    if (countdown > 0 && --countdown == 0) throw std::runtime_error("move");
+    ++live;
+  }
+  tracked& operator=(const tracked& rhs) { value = rhs.value; return *this; }
+  tracked& operator=(tracked&& rhs) { value = rhs.value; return *this; }
+  ~tracked() { --live; }
+};
+
+int tracked::live = 0;
+int tracked::countdown = 0;
+
+template <class V, class S>
+bool same(const V& v, const S& s)
+{
+  if (v.size() != s.size()) return false;
+  for (size_t i = 0; i < s.size(); ++i)
+  {
+    if (!(v[i] == s[i])) return false;
+  }
+  return true;
+}
+
+template <class T, class Make>
+void random_ops(Make make)
+{
+  typedef mystl::small_vector<T, 4> small;
+  std::mt19937 rng(7);
+  small v;
+  std::vector<T> s;
+  bool went_heap = false, came_back = false;
+  for (int it = 0; it < 20000; ++it)
+  {
+    const size_t pos = s.empty() ? 0 : rng() % (s.size() + 1);
+    const T x = make(static_cast<int>(rng()));
+    switch (rng() % 8)
+    {
+      case 0:
+        v.insert(v.begin() + pos, x);
+        s.insert(s.begin() + pos, x);
+        break;
+      case 1:
+        v.emplace(v.begin() + pos, x);
+        s.emplace(s.begin() + pos, x);
+        break;
+      case 2:
+      {
+        const size_t n = rng() % 6;
+        v.insert(v.begin() + pos, n, x);
+        s.insert(s.begin() + pos, n, x);
+        break;
+      }
+      case 3:
+      {
+        std::vector<T> r(rng() % 6, x);
+        v.insert(v.begin() + pos, r.data(), r.data() + r.size());
+        s.insert(s.begin() + pos, r.begin(), r.end());
+        break;
+      }
+      case 4:
+        if (!s.empty())
+        {
+          // an argument aliasing an element that is about to move
+          v.insert(v.begin() + pos, v[s.size() - 1]);
+          s.insert(s.begin() + pos, T(s[s.size() - 1]));
+        }
+        break;
+      case 5:
+        v.push_back(x);
+        s.push_back(x);
+        break;
+      case 6:
+        // empty ranges included
+        if (pos <= s.size())
+        {
+          const size_t last = pos + rng() % (s.size() - pos + 1);
+          EXPECT(v.erase(v.begin() + pos, v.begin() + last) == v.begin() + pos);
+          s.erase(s.begin() + pos, s.begin() + last);
+        }
+        break;
+      default:
+        v.shrink_to_fit();
+        if (v.size() <= 4) EXPECT(v.is_inline());
+        break;
+    }
+    went_heap = went_heap || !v.is_inline();
+    came_back = came_back || (went_heap && v.is_inline());
+    EXPECT(same(v, s));
+    if (!same(v, s)) return;
+  }
+  EXPECT(went_heap && came_back);
+}
+
+// erase of an empty range is a no-op at every position, inline and on the heap
+void test_empty_erase()
+{
+  for (size_t n = 0; n < 10; ++n)
+  {
+    for (size_t pos = 0; pos <= n; ++pos)
+    {
+      mystl::small_vector<std::string, 4> v;
+      std::vector<std::string> s;
+      for (size_t i = 0; i < n; ++i)
+      {
+        v.push_back(std::string(20, static_cast<char>('a' + i)));
+        s.push_back(v.back());
+      }
+      EXPECT(v.erase(v.begin() + pos, v.begin() + pos) == v.begin() + pos);
+      v.insert(v.begin() + pos, s.data(), s.data());
+      v.insert(v.begin() + pos, 0, std::string("x"));
+      EXPECT(same(v, s));
+    }
+  }
+}
+
+// swap and move between every pair of inline and heap states
+void test_swap_and_move()
+{
+  const size_t sizes[] = {0, 2, 4, 5, 9};
+  for (auto na : sizes)
+  {
+    for (auto nb : sizes)
+    {
+      typedef mystl::small_vector<std::string, 4> small;
+      small a, b;
+      std::vector<std::string> sa, sb;
+      for (size_t i = 0; i < na; ++i) { a.push_back(std::to_string(i)); sa.push_back(a.back()); }
+      for (size_t i = 0; i < nb; ++i) { b.push_back(std::to_string(100 + i)); sb.push_back(b.back()); }
+      a.swap(b);
+      EXPECT(same(a, sb) && same(b, sa));
+      EXPECT(a.is_inline() == (nb <= 4) && b.is_inline() == (na <= 4));
+      swap(a, b);
+      EXPECT(same(a, sa) && same(b, sb));
+
+      small c(mystl::move(a));
+      EXPECT(same(c, sa) && a.empty());
+      c = mystl::move(b);
+      EXPECT(same(c, sb) && b.empty());
+      small d(c);
+      EXPECT(same(d, sb) && d == c);
+      d = small(sa.data(), sa.data() + sa.size());
+      EXPECT(same(d, sa));
+    }
+  }
+}
+
+void test_move_only()
+{
+  std::mt19937 rng(3);
+  mystl::small_vector<std::unique_ptr<int>, 4> v;
+  std::vector<int> s;
+  for (int it = 0; it < 5000; ++it)
+  {
+    const size_t pos = s.empty() ? 0 : rng() % (s.size() + 1);
+    const int x = static_cast<int>(rng());
+    if (rng() % 2)
+      v.insert(v.begin() + pos, std::unique_ptr<int>(new int(x)));
+    else
+      v.emplace(v.begin() + pos, new int(x));
+    s.insert(s.begin() + pos, x);
+    if (rng() % 2 == 0)
+    {
+      const size_t e = rng() % s.size();
+      v.erase(v.begin() + e);
+      s.erase(s.begin() + e);
+    }
+    if (rng() % 50 == 0)
+    {
+      v.shrink_to_fit();
+      auto w = mystl::move(v);
+      v.swap(w);
+    }
+  }
+  EXPECT(v.size() == s.size());
+  bool ok = true;
+  for (size_t i = 0; i < s.size(); ++i)
+  {
+    if (v[i] == nullptr || *v[i] != s[i]) ok = false;
+  }
+  EXPECT(ok);
+}
+
+// a move throwing while the elements move to a new block must not leak the
+// new block or the element built in it, and must leave the old ones in place
+void test_throwing_growth()
+{
+  for (int fail = 1; fail < 12; ++fail)
+  {
+    {
+      mystl::small_vector<tracked, 4> v;
+      for (int i = 0; i < 4; ++i) v.emplace_back(i);
+      for (int round = 0; round < 2; ++round)
+      {
+        tracked::countdown = fail;
+        try
+        {
+          // from inline to the heap, then from one heap block to a larger one
+          while (v.size() != v.capacity()) v.emplace_back(-1);
+          v.emplace_back(-2);
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+        tracked::countdown = 0;
+        EXPECT(tracked::live == static_cast<int>(v.size()));
+        bool ok = true;
+        for (int i = 0; i < 4; ++i) ok = ok && v[i].value == i;
+        EXPECT(ok);
+      }
+    }
+    EXPECT(tracked::live == 0);
+  }
+}
+
+} // namespace
+
+int main()
+{
+  random_ops<int>([](int x) { return x % 1000; });
+  random_ops<std::string>([](int x) { return std::string(static_cast<size_t>(x) % 40, 'a' + x % 26); });
+  test_empty_erase();
+  test_swap_and_move();
+  test_move_only();
+  test_throwing_growth();
+  return test::result("test_small_vector");
+}
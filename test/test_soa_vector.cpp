@@ -0,0 +1,263 @@
+// soa_vector against a std::vector of tuples: growth, erase, resize, copy,
+// move, swap and shrink_to_fit, every column aligned to a cache line after
+// each step, column spans feeding accumulate, and no element leaked
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "numeric.h"
+#include "soa_vector.h"
+
+#include "test.h"
+
+namespace
+{
+
+// counts live objects
+struct tracked
+{
+  static int live;
+
+  int value;
+
+  tracked() :value(0) { ++live; }
+  tracked(int v) :value(v) { ++live; }
+  tracked(const tracked& rhs) :value(rhs.value) { ++live; }
+  tracked& operator=(const tracked& rhs) { value = rhs.value; return *this; }
+  ~tracked() { --live; }
+
+  bool operator==(const tracked& rhs) const { return value == rhs.value; }
+};
+
+int tracked::live = 0;
+
+typedef mystl::soa_vector<int, std::string, char, tracked, double> soa;
+typedef std::tuple<int, std::string, char, tracked, double> row;
+
+bool aligned(const void* p)
+{
+  return reinterpret_cast<uintptr_t>(p) % mystl::soa_alignment == 0;
+}
+
+bool columns_aligned(const soa& v)
+{
+  if (v.capacity() == 0) return true;
+  return aligned(v.data<0>()) && aligned(v.data<1>()) && aligned(v.data<2>()) &&
+         aligned(v.data<3>()) && aligned(v.data<4>());
+}
+
+bool same(const soa& v, const std::vector<row>& s)
+{
+  if (v.size() != s.size() || v.capacity() < v.size()) return false;
+  for (size_t i = 0; i < s.size(); ++i)
+  {
+    if (row(v[i]) != s[i]) return false;
+  }
+  // the iterators and the columns see the same rows
+  size_t i = 0;
+  for (auto it = v.begin(); it != v.end(); ++it, ++i)
+  {
+    if (std::get<0>(*it) != std::get<0>(s[i])) return false;
+  }
+  auto ints = v.column<0>();
+  auto chars = v.column<2>();
+  return ints.size() == s.size() && chars.size() == s.size() &&
+         (s.empty() || (ints.data() == v.data<0>() && chars.back() == std::get<2>(s.back())));
+}
+
+row random_row(std::mt19937& rng)
+{
+  const int x = static_cast<int>(rng() % 1000);
+  return row(x, std::string(x % 30, 'a' + x % 26), static_cast<char>(x), tracked(x), x * 0.5);
+}
+
+void test_random_ops()
+{
+  std::mt19937 rng(48);
+  {
+    soa v;
+    std::vector<row> s;
+    EXPECT(v.empty() && v.capacity() == 0 && v.begin() == v.end());
+    for (int it = 0; it < 10000; ++it)
+    {
+      const size_t cap = v.capacity();
+      const int* col = v.data<0>();
+      switch (rng() % 9)
+      {
+        case 0:
+        case 1:
+        {
+          const row r = random_row(rng);
+          v.emplace_back(std::get<0>(r), std::get<1>(r), std::get<2>(r), std::get<3>(r),
+                         std::get<4>(r));
+          s.push_back(r);
+          // the columns move only when the capacity runs out, and then grow
+          // geometrically
+          EXPECT(cap > s.size() - 1 ? v.data<0>() == col && v.capacity() == cap
+                                    : v.capacity() >= 2 * cap);
+          break;
+        }
+        case 2:
+        {
+          const row r = random_row(rng);
+          if (rng() % 2)
+          {
+            v.push_back(r);
+          }
+          else
+          {
+            row tmp = r;
+            v.push_back(std::move(tmp));
+          }
+          s.push_back(r);
+          break;
+        }
+        case 3:
+          if (!s.empty())
+          {
+            // an argument that refers to the vector itself, also when it grows
+            v.emplace_back(std::get<0>(v.back()), std::get<1>(v.back()), std::get<2>(v.back()),
+                           std::get<3>(v.back()), std::get<4>(v.back()));
+            s.push_back(s.back());
+          }
+          break;
+        case 4:
+          if (!s.empty())
+          {
+            const size_t pos = rng() % s.size();
+            auto r = v.erase(v.begin() + pos);
+            EXPECT(r == v.begin() + pos);
+            s.erase(s.begin() + pos);
+          }
+          break;
+        case 5:
+        {
+          // empty ranges included
+          const size_t first = rng() % (s.size() + 1);
+          const size_t last = first + rng() % (s.size() - first + 1);
+          auto r = v.erase(v.cbegin() + first, v.cbegin() + last);
+          EXPECT(r - v.begin() == static_cast<ptrdiff_t>(first));
+          s.erase(s.begin() + first, s.begin() + last);
+          break;
+        }
+        case 6:
+          if (!s.empty())
+          {
+            v.pop_back();
+            s.pop_back();
+          }
+          break;
+        case 7:
+        {
+          const size_t n = rng() % 40;
+          v.resize(n);
+          s.resize(n, row(0, std::string(), '\0', tracked(), 0.0));
+          break;
+        }
+        default:
+          v.shrink_to_fit();
+          EXPECT(v.capacity() == s.size());
+          break;
+      }
+      EXPECT(columns_aligned(v));
+      EXPECT(same(v, s));
+      if (!same(v, s)) return;
+    }
+
+    int sum = 0;
+    for (auto& r : s) sum += std::get<0>(r);
+    auto ints = v.column<0>();
+    EXPECT(mystl::accumulate(ints.begin(), ints.end(), 0) == sum);
+    EXPECT(tracked::live == static_cast<int>(2 * s.size()));
+  }
+  EXPECT(tracked::live == 0);
+}
+
+void test_copy_move_swap()
+{
+  std::mt19937 rng(7);
+  for (size_t n : {0, 1, 5, 64, 100})
+  {
+    {
+      soa a;
+      std::vector<row> s;
+      for (size_t i = 0; i < n; ++i)
+      {
+        s.push_back(random_row(rng));
+        a.push_back(s.back());
+      }
+      a.reserve(n + 17);
+      const size_t reserved = a.capacity();
+      EXPECT(reserved >= n + 17 && columns_aligned(a));
+
+      // a copy holds the same rows in its own, exactly sized, aligned columns
+      soa b(a);
+      EXPECT(same(b, s) && columns_aligned(b) && b.capacity() == n);
+      EXPECT(n == 0 || (b.data<1>() != a.data<1>() && b.data<3>() != a.data<3>()));
+
+      soa c;
+      c.push_back(random_row(rng));
+      c = a;
+      EXPECT(same(c, s) && columns_aligned(c));
+      const soa& self = c;
+      c = self;
+      EXPECT(same(c, s));
+
+      // moves take the columns
+      const int* col = a.data<0>();
+      soa d(std::move(a));
+      EXPECT(same(d, s) && d.data<0>() == col && a.empty() && a.capacity() == 0);
+      a = std::move(d);
+      EXPECT(same(a, s) && a.data<0>() == col && d.empty());
+
+      std::vector<row> t(3, random_row(rng));
+      soa e;
+      for (auto& r : t) e.push_back(r);
+      a.swap(e);
+      EXPECT(same(a, t) && same(e, s));
+      swap(a, e);
+      EXPECT(same(a, s) && same(e, t));
+
+      a.clear();
+      EXPECT(a.empty() && a.capacity() == reserved);
+      a.shrink_to_fit();
+      EXPECT(a.capacity() == 0 && a.data<0>() == nullptr);
+      a.push_back(t[0]);
+      EXPECT(columns_aligned(a) && same(a, std::vector<row>(1, t[0])));
+    }
+    EXPECT(tracked::live == 0);
+  }
+}
+
+void test_access()
+{
+  soa v(3);
+  EXPECT(v.size() == 3 && std::get<0>(v.front()) == 0 && std::get<1>(v.back()).empty());
+  std::get<0>(v.at(2)) = 5;
+  std::get<3>(v[2]) = tracked(9);
+  const soa& cv = v;
+  EXPECT(std::get<0>(cv.at(2)) == 5 && std::get<3>(cv.back()).value == 9);
+  EXPECT_THROW(v.at(3), std::out_of_range);
+  EXPECT_THROW(cv.at(3), std::out_of_range);
+  EXPECT(cv.column<0>()[2] == 5 && cv.column<3>().size() == 3);
+  EXPECT(v.end() - v.begin() == 3 && v.cend() - v.cbegin() == 3);
+  EXPECT(std::get<0>(v.begin()[2]) == 5 && std::get<0>(*(2 + v.cbegin())) == 5);
+  EXPECT(soa::column_count == 5);
+  EXPECT_THROW(v.reserve(v.max_size() + 1), std::length_error);
+}
+
+} // namespace
+
+int main()
+{
+  test_random_ops();
+  test_copy_move_swap();
+  test_access();
+  EXPECT(tracked::live == 0);
+  return test::result("test_soa_vector");
+}
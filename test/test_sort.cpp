@@ -0,0 +1,354 @@
+// sorting algorithms against std::sort and std::stable_sort
+// includes the radix sorts, which are stable as well
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "algo_radix_sort.h"
+#include "algo_sort.h"
+#include "functional.h"
+#include "util.h"
+
+#include "test.h"
+
+namespace
+{
+
+// random input of one of the shapes the sorts treat specially
+std::vector<int> random_input(std::mt19937& rng, size_t n)
+{
+  std::vector<int> v(n);
+  const int range = 1 + static_cast<int>(rng() % (rng() % 2 == 0 ? 10 : 1000000));
+  for (auto& x : v) x = static_cast<int>(rng() % range);
+  switch (rng() % 5)
+  {
+    case 0:  std::sort(v.begin(), v.end()); break;
+    case 1:  std::sort(v.begin(), v.end(), std::greater<int>()); break;
+    case 2:  // sorted with a few elements out of place
+      std::sort(v.begin(), v.end());
+      for (size_t i = 0; i < n / 50 + 1 && n > 0; ++i) std::swap(v[rng() % n], v[rng() % n]);
+      break;
+    default: break;
+  }
+  return v;
+}
+
+size_t random_size(std::mt19937& rng)
+{
+  switch (rng() % 4)
+  {
+    case 0:  return rng() % 16;
+    case 1:  return rng() % 200;
+    case 2:  return rng() % 5000;
+    default: return rng() % 100000;
+  }
+}
+
+void test_selection(std::mt19937& rng)
+{
+  for (int it = 0; it < 300; ++it)
+  {
+    const auto v = random_input(rng, random_size(rng));
+    const size_t n = v.size();
+    const size_t k = n == 0 ? 0 : rng() % (n + 1);
+    auto sorted = v;
+    std::sort(sorted.begin(), sorted.end());
+
+    // partial_sort
+    auto a = v;
+    mystl::partial_sort(a.data(), a.data() + k, a.data() + n);
+    EXPECT(std::equal(a.begin(), a.begin() + k, sorted.begin()));
+    a = v;
+    mystl::partial_sort(a.data(), a.data() + k, a.data() + n, mystl::greater<int>());
+    EXPECT(std::equal(a.begin(), a.begin() + k, sorted.rbegin()));
+
+    // partial_sort_copy
+    std::vector<int> out(k);
+    int* e = mystl::partial_sort_copy(v.data(), v.data() + n, out.data(), out.data() + k);
+    EXPECT(e == out.data() + k && std::equal(out.begin(), out.end(), sorted.begin()));
+
+    // nth_element
+    if (n > 0)
+    {
+      const size_t nth = rng() % n;
+      a = v;
+      mystl::nth_element(a.data(), a.data() + nth, a.data() + n);
+      bool ok = a[nth] == sorted[nth];
+      for (size_t i = 0; i < nth; ++i) ok = ok && !(a[nth] < a[i]);
+      for (size_t i = nth; i < n; ++i) ok = ok && !(a[i] < a[nth]);
+      EXPECT(ok);
+      a = v;
+      mystl::nth_element(a.data(), a.data() + nth, a.data() + n, mystl::greater<int>());
+      EXPECT(a[nth] == sorted[n - 1 - nth]);
+    }
+
+    // top_k
+    std::vector<int> top(k + 1);
+    e = mystl::top_k(v.data(), v.data() + n, k, top.data());
+    EXPECT(e == top.data() + k && std::equal(top.begin(), top.begin() + k, sorted.begin()));
+    e = mystl::top_k(v.data(), v.data() + n, k, top.data(), mystl::greater<int>());
+    EXPECT(e == top.data() + k && std::equal(top.begin(), top.begin() + k, sorted.rbegin()));
+  }
+}
+
+// key and original position, to see whether a sort is stable
+struct record
+{
+  int    key;
+  size_t pos;
+};
+
+struct key_less
+{
+  bool operator()(const record& a, const record& b) const { return a.key < b.key; }
+};
+
+bool operator==(const record& a, const record& b)
+{
+  return a.key == b.key && a.pos == b.pos;
+}
+
+struct ptr_key_less
+{
+  bool operator()(const std::unique_ptr<record>& a,
+                  const std::unique_ptr<record>& b) const
+  {
+    return a->key < b->key;
+  }
+};
+
+// throws std::bad_alloc on its calls-th call
+struct throwing_less
+{
+  size_t* calls;
+  bool operator()(const record& a, const record& b) const
+  {
+    if (--*calls == 0) throw std::bad_alloc();
+    return a.key < b.key;
+  }
+};
+
+void test_sort(std::mt19937& rng)
+{
+  for (int it = 0; it < 300; ++it)
+  {
+    const auto v = random_input(rng, random_size(rng));
+    const size_t n = v.size();
+    auto expect = v;
+    std::sort(expect.begin(), expect.end());
+
+    auto a = v;
+    mystl::sort(a.data(), a.data() + n);
+    EXPECT(a == expect);
+    a = v;
+    mystl::stable_sort(a.data(), a.data() + n);
+    EXPECT(a == expect);
+    a = v;
+    mystl::sort(a.data(), a.data() + n, mystl::greater<int>());
+    EXPECT(std::equal(a.begin(), a.end(), expect.rbegin()));
+
+    // doubles take the branchless partition and merge
+    std::vector<double> d(v.begin(), v.end());
+    std::vector<double> dexpect(expect.begin(), expect.end());
+    mystl::sort(d.data(), d.data() + n);
+    EXPECT(d == dexpect);
+    d.assign(v.begin(), v.end());
+    mystl::stable_sort(d.data(), d.data() + n);
+    EXPECT(d == dexpect);
+
+    // stability, with the buffer and with the merges done by rotation
+    std::vector<record> r(n);
+    for (size_t i = 0; i < n; ++i) r[i] = record{v[i], i};
+    auto rexpect = r;
+    std::stable_sort(rexpect.begin(), rexpect.end(), key_less());
+    auto ra = r;
+    mystl::stable_sort(ra.data(), ra.data() + n, key_less());
+    EXPECT(ra == rexpect);
+    ra = r;
+    mystl::stable_sort_aux(ra.data(), ra.data() + n, static_cast<record*>(nullptr),
+                           static_cast<ptrdiff_t>(0), key_less(), std::false_type());
+    EXPECT(ra == rexpect);
+
+    // move-only elements
+    std::vector<std::unique_ptr<record>> p;
+    for (size_t i = 0; i < n; ++i) p.emplace_back(new record(r[i]));
+    mystl::stable_sort(p.data(), p.data() + n, ptr_key_less());
+    bool same = true;
+    for (size_t i = 0; i < n; ++i) same = same && *p[i] == rexpect[i];
+    EXPECT(same);
+
+    // an exception from comp leaves the sort, even a std::bad_alloc
+    if (n > 1)
+    {
+      size_t calls = 1 + rng() % (n - 1);  // a sort makes at least n - 1 calls
+      ra = r;
+      EXPECT_THROW(mystl::stable_sort(ra.data(), ra.data() + n, throwing_less{&calls}),
+                   std::bad_alloc);
+    }
+  }
+
+  // elements that are not trivially copyable
+  for (int it = 0; it < 50; ++it)
+  {
+    const auto v = random_input(rng, rng() % 3000);
+    std::vector<std::string> s;
+    for (auto x : v) s.push_back(std::to_string(x));
+    auto expect = s;
+    std::sort(expect.begin(), expect.end());
+    auto a = s;
+    mystl::sort(a.data(), a.data() + a.size());
+    EXPECT(a == expect);
+    a = s;
+    mystl::stable_sort(a.data(), a.data() + a.size());
+    EXPECT(a == expect);
+  }
+}
+
+template <class T>
+void check_radix(const std::vector<T>& v)
+{
+  auto expect = v;
+  std::stable_sort(expect.begin(), expect.end());
+  auto a = v;
+  mystl::radix_sort(a.data(), a.data() + a.size());
+  EXPECT(a == expect);
+  a = v;
+  mystl::parallel_radix_sort(a.data(), a.data() + a.size());
+  EXPECT(a == expect);
+}
+
+void test_radix_sort(std::mt19937& rng32)
+{
+  std::mt19937_64 rng(rng32());
+  const size_t sizes[] = {0, 1, 2, 63, 64, 65, 1000, 300000};
+  for (auto n : sizes)
+  {
+    std::vector<uint64_t> u(n);
+    for (auto& x : u) x = rng();
+    check_radix(u);
+    for (auto& x : u) x &= 0xff00;  // passes with one byte value are skipped
+    check_radix(u);
+    std::vector<int32_t> i32(n);
+    for (auto& x : i32) x = static_cast<int32_t>(rng());
+    check_radix(i32);
+    std::vector<int8_t> i8(n);
+    for (auto& x : i8) x = static_cast<int8_t>(rng());
+    check_radix(i8);
+    std::vector<float> f(n);
+    for (auto& x : f) x = static_cast<float>(static_cast<int32_t>(rng())) / 1000.f;
+    check_radix(f);
+
+    // doubles with both zeros and both infinities; -0.0 == 0.0, so the sign
+    // of the first zero is checked separately
+    std::vector<double> d(n);
+    for (auto& x : d)
+      x = static_cast<double>(static_cast<int64_t>(rng())) / 1e7 * (rng() % 2 ? 1e-200 : 1);
+    if (n > 3)
+    {
+      d[0] = -0.0;
+      d[1] = 0.0;
+      d[2] = std::numeric_limits<double>::infinity();
+      d[3] = -d[2];
+    }
+    check_radix(d);
+    if (n > 3)
+    {
+      mystl::radix_sort(d.data(), d.data() + n);
+      EXPECT(std::signbit(*std::find(d.begin(), d.end(), 0.0)));
+    }
+
+    // key extractor, stable on equal keys
+    typedef mystl::pair<int, size_t> elem;
+    std::vector<elem> p(n);
+    for (size_t i = 0; i < n; ++i) p[i] = elem(static_cast<int>(rng() % 100) - 50, i);
+    std::vector<std::pair<int, size_t>> pexpect;
+    for (auto& e : p) pexpect.push_back(std::make_pair(e.first, e.second));
+    std::stable_sort(pexpect.begin(), pexpect.end(),
+                     [](const std::pair<int, size_t>& a, const std::pair<int, size_t>& b)
+                     {
+                       return a.first < b.first;
+                     });
+    const auto same_pairs = [&](const std::vector<elem>& x)
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        if (x[i].first != pexpect[i].first || x[i].second != pexpect[i].second) return false;
+      }
+      return true;
+    };
+    auto pa = p;
+    mystl::radix_sort(pa.data(), pa.data() + n, mystl::select_first<elem>());
+    EXPECT(same_pairs(pa));
+    pa = p;
+    mystl::parallel_radix_sort(pa.data(), pa.data() + n, mystl::select_first<elem>());
+    EXPECT(same_pairs(pa));
+
+    // move-only elements, the buffer holds no copies
+    const auto ptr_key = [](const std::unique_ptr<elem>& e) { return e->first; };
+    for (int parallel = 0; parallel < 2; ++parallel)
+    {
+      std::vector<std::unique_ptr<elem>> up;
+      for (auto& e : p) up.emplace_back(new elem(e));
+      if (parallel)
+        mystl::parallel_radix_sort(up.data(), up.data() + n, ptr_key);
+      else
+        mystl::radix_sort(up.data(), up.data() + n, ptr_key);
+      bool same = true;
+      for (size_t i = 0; i < n; ++i) same = same && up[i]->second == pexpect[i].second;
+      EXPECT(same);
+    }
+
+    // byte strings, with embedded zeros and long common prefixes
+    std::vector<std::string> st(n);
+    for (auto& x : st)
+    {
+      const size_t len = rng() % 12;
+      for (size_t k = 0; k < len; ++k) x.push_back("ab\0\xff"[rng() % 4]);
+    }
+    if (n > 5)
+    {
+      st[0] = std::string(100, 'a');
+      st[1] = std::string(100, 'a') + "b";
+    }
+    auto sexpect = st;
+    std::sort(sexpect.begin(), sexpect.end());
+    mystl::msd_radix_sort(st.data(), st.data() + n);
+    EXPECT(st == sexpect);
+
+    std::vector<std::string> keep(n);
+    std::vector<const char*> cs(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      keep[i] = std::to_string(rng() % 100000);
+      cs[i] = keep[i].c_str();
+    }
+    auto cexpect = cs;
+    std::sort(cexpect.begin(), cexpect.end(),
+              [](const char* a, const char* b) { return std::strcmp(a, b) < 0; });
+    mystl::msd_radix_sort(cs.data(), cs.data() + n);
+    bool same = true;
+    for (size_t i = 0; i < n; ++i) same = same && std::strcmp(cs[i], cexpect[i]) == 0;
+    EXPECT(same);
+  }
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937 rng(1);
+  test_selection(rng);
+  test_sort(rng);
+  test_radix_sort(rng);
+  return test::result("test_sort");
+}
@@ -0,0 +1,215 @@
+// basic_string against std::string: random edits, including sources that alias
+// the string, and every search function at every position on random text over
+// a small alphabet, so that the short and the long paths all find matches
+
+#include <random>
+#include <string>
+
+#include "basic_string.h"
+
+#include "test.h"
+
+namespace
+{
+
+template <class CharT>
+bool same(const mystl::basic_string<CharT>& m, const std::basic_string<CharT>& s)
+{
+  return m.size() == s.size() && s.compare(0, s.size(), m.data(), m.size()) == 0 &&
+         m.c_str()[m.size()] == CharT();
+}
+
+int sign(int x)
+{
+  return x < 0 ? -1 : x > 0 ? 1 : 0;
+}
+
+std::string random_text(std::mt19937& rng, size_t n, const char* alphabet, size_t letters)
+{
+  std::string s(n, ' ');
+  for (auto& c : s) c = alphabet[rng() % letters];
+  return s;
+}
+
+void test_edits()
+{
+  std::mt19937 rng(1);
+  mystl::string m;
+  std::string s;
+  for (int it = 0; it < 60000; ++it)
+  {
+    if (s.size() > 3000)
+    {
+      const size_t keep = rng() % 100;
+      m.erase(keep);
+      s.erase(keep);
+    }
+    const size_t pos = rng() % (s.size() + 1);
+    const size_t n = rng() % 40;
+    const std::string t = random_text(rng, rng() % 50, "abcxyz", 6);
+    switch (rng() % 12)
+    {
+      case 0:
+        m.append(t.data(), t.size());
+        s.append(t);
+        break;
+      case 1:
+        m.append(n, 'q');
+        s.append(n, 'q');
+        break;
+      case 2:
+      {
+        // append part of itself
+        const size_t len = (s.size() - pos) / 2;
+        m.append(m.data() + pos, len);
+        s.append(std::string(s, pos, len));
+        break;
+      }
+      case 3:
+        m.insert(pos, t.data(), t.size());
+        s.insert(pos, t);
+        break;
+      case 4:
+        m.erase(pos, n);
+        s.erase(pos, n);
+        break;
+      case 5:
+        m.replace(pos, n, t.data(), t.size());
+        s.replace(pos, n, t);
+        break;
+      case 6:
+      {
+        // replace with part of itself
+        const size_t from = rng() % (s.size() + 1);
+        const size_t len = rng() % (s.size() - from + 1);
+        const std::string part(s, from, len);
+        m.replace(pos, n, m.data() + from, len);
+        s.replace(pos, n, part);
+        break;
+      }
+      case 7:
+        m.push_back('p');
+        s.push_back('p');
+        if (rng() % 2 && !s.empty())
+        {
+          m.pop_back();
+          s.pop_back();
+        }
+        break;
+      case 8:
+      {
+        const size_t len = rng() % 60;
+        m.resize(len, 'r');
+        s.resize(len, 'r');
+        break;
+      }
+      case 9:
+        if (rng() % 2) m.reserve(rng() % 200);
+        else           m.shrink_to_fit();
+        EXPECT(m.capacity() >= m.size());
+        break;
+      case 10:
+      {
+        mystl::string c(m);
+        mystl::string moved(mystl::move(c));
+        EXPECT(moved == m);
+        m = moved.substr(0);
+        const auto sub = m.substr(pos, n);
+        EXPECT(std::string(sub.data(), sub.size()) == s.substr(pos, n));
+        break;
+      }
+      default:
+        m.assign(t.data(), t.size());
+        s.assign(t);
+        break;
+    }
+    EXPECT(same(m, s));
+    if (!same(m, s)) return;
+  }
+}
+
+void test_short_strings()
+{
+  EXPECT(sizeof(mystl::string) == 24);
+  for (size_t n = 0; n <= 23; ++n)
+  {
+    mystl::string m(n, 'k');
+    EXPECT(m.capacity() == 23 && m.size() == n && m.c_str()[n] == '\0');
+  }
+  mystl::string m(24, 'k');
+  EXPECT(m.capacity() >= 24 && m.c_str()[24] == '\0');
+  EXPECT_THROW(m.at(24), std::out_of_range);
+}
+
+void test_search()
+{
+  std::mt19937 rng(2);
+  // 40 letters for sets larger than the 16 one SSE4.2 compare can take
+  const char* alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMN";
+  for (int it = 0; it < 1500; ++it)
+  {
+    const size_t letters = it % 3 == 0 ? 2 : it % 3 == 1 ? 4 : 40;
+    const std::string text = random_text(rng, rng() % 300, alphabet, letters);
+    const std::string pat = random_text(rng, rng() % (it % 2 ? 3 : 20), alphabet, letters);
+    const mystl::string m(text.data(), text.size());
+    const char c = alphabet[rng() % letters];
+    bool ok = true;
+    for (size_t pos = 0; pos <= text.size() + 1; ++pos)
+    {
+      const char* p = pat.c_str();
+      const size_t n = pat.size();
+      ok = ok && m.find(p, pos, n) == text.find(p, pos, n);
+      ok = ok && m.rfind(p, pos, n) == text.rfind(p, pos, n);
+      ok = ok && m.find(c, pos) == text.find(c, pos);
+      ok = ok && m.rfind(c, pos) == text.rfind(c, pos);
+      ok = ok && m.find_first_of(p, pos, n) == text.find_first_of(p, pos, n);
+      ok = ok && m.find_last_of(p, pos, n) == text.find_last_of(p, pos, n);
+      ok = ok && m.find_first_not_of(p, pos, n) == text.find_first_not_of(p, pos, n);
+      ok = ok && m.find_last_not_of(p, pos, n) == text.find_last_not_of(p, pos, n);
+    }
+    ok = ok && m.rfind(pat.c_str(), mystl::string::npos, pat.size()) == text.rfind(pat);
+    ok = ok && m.find_last_of(pat.c_str()) == text.find_last_of(pat);
+    EXPECT(ok);
+
+    const mystl::string other(pat.data(), pat.size());
+    EXPECT(sign(m.compare(other)) == sign(text.compare(pat)));
+    EXPECT((m < other) == (text < pat) && (m == other) == (text == pat));
+  }
+}
+
+// the generic loops written on Traits
+void test_wide()
+{
+  std::mt19937 rng(3);
+  for (int it = 0; it < 300; ++it)
+  {
+    std::u16string text(rng() % 100, u' ');
+    for (auto& c : text) c = static_cast<char16_t>(0x4e00 + rng() % 3);
+    std::u16string pat(rng() % 4, u' ');
+    for (auto& c : pat) c = static_cast<char16_t>(0x4e00 + rng() % 3);
+    const mystl::u16string m(text.data(), text.size());
+    bool ok = true;
+    for (size_t pos = 0; pos <= text.size(); ++pos)
+    {
+      ok = ok && m.find(pat.data(), pos, pat.size()) == text.find(pat.data(), pos, pat.size());
+      ok = ok && m.rfind(pat.data(), pos, pat.size()) == text.rfind(pat.data(), pos, pat.size());
+      ok = ok && m.find_first_of(pat.data(), pos, pat.size()) ==
+                 text.find_first_of(pat.data(), pos, pat.size());
+    }
+    EXPECT(ok);
+    mystl::u16string grown(m);
+    grown.append(m.data(), m.size());
+    EXPECT(grown.size() == 2 * m.size());
+  }
+}
+
+} // namespace
+
+int main()
+{
+  test_edits();
+  test_short_strings();
+  test_search();
+  test_wide();
+  return test::result("test_string");
+}
@@ -0,0 +1,161 @@
+// unordered_map against std::unordered_map: random inserts, lookups and erases,
+// with mystl::hash and with a hash that piles keys into a few groups, and
+// erase while iterating
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "basic_string.h"
+#include "unordered_map.h"
+
+#include "test.h"
+
+namespace
+{
+
+// 8 distinct values, so long probe runs and shifted erases are the norm
+struct crowded_hash
+{
+  size_t operator()(long long k) const
+  {
+    return static_cast<size_t>(k & 7) * 0x9e3779b97f4a7c15ull;
+  }
+};
+
+template <class Map, class Std>
+bool same(const Map& m, const Std& s)
+{
+  if (m.size() != s.size()) return false;
+  size_t n = 0;
+  for (auto it = m.begin(); it != m.end(); ++it, ++n)
+  {
+    auto p = s.find(it->first);
+    if (p == s.end() || !(p->second == it->second)) return false;
+  }
+  return n == s.size();
+}
+
+template <class Map>
+void random_ops(unsigned seed, long long key_range)
+{
+  std::mt19937_64 rng(seed);
+  Map m;
+  std::unordered_map<long long, int> s;
+  for (int it = 0; it < 100000; ++it)
+  {
+    const long long k = static_cast<long long>(rng() % key_range);
+    const int v = static_cast<int>(rng() % 1000);
+    switch (rng() % 6)
+    {
+      case 0:
+        EXPECT(m.insert(mystl::pair<const long long, int>(k, v)).second ==
+               s.insert(std::make_pair(k, v)).second);
+        break;
+      case 1:
+        m[k] = v;
+        s[k] = v;
+        break;
+      case 2:
+        EXPECT(m.try_emplace(k, v).second == s.emplace(k, v).second);
+        break;
+      case 3:
+        EXPECT(m.erase(k) == s.erase(k));
+        break;
+      case 4:
+      {
+        auto p = m.find(k);
+        auto q = s.find(k);
+        EXPECT((p == m.end()) == (q == s.end()));
+        if (p != m.end() && q != s.end()) EXPECT(p->second == q->second);
+        EXPECT(m.count(k) == s.count(k));
+        break;
+      }
+      default:
+        if (rng() % 500 == 0)
+        {
+          Map copy(m);
+          m = mystl::move(copy);
+          m.reserve(m.size() * 2);
+        }
+        break;
+    }
+    if (it % 1000 == 0)
+    {
+      EXPECT(same(m, s));
+    }
+  }
+  EXPECT(same(m, s));
+
+  // erase every odd value while walking the table
+  for (auto it = m.begin(); it != m.end();)
+  {
+    if (it->second % 2) it = m.erase(it);
+    else ++it;
+  }
+  for (auto it = s.begin(); it != s.end();)
+  {
+    if (it->second % 2) it = s.erase(it);
+    else ++it;
+  }
+  EXPECT(same(m, s));
+  m.clear();
+  EXPECT(m.empty() && m.begin() == m.end());
+}
+
+void test_string_keys()
+{
+  std::mt19937 rng(11);
+  mystl::unordered_map<mystl::string, int> m;
+  std::unordered_map<std::string, int> s;
+  for (int it = 0; it < 50000; ++it)
+  {
+    std::string k(rng() % 24, 'x');
+    for (auto& c : k) c = static_cast<char>('a' + rng() % 3);
+    const mystl::string mk(k.data(), k.size());
+    if (rng() % 4 == 0)
+    {
+      EXPECT(m.erase(mk) == s.erase(k));
+    }
+    else
+    {
+      m[mk] += 1;
+      s[k] += 1;
+    }
+  }
+  bool ok = m.size() == s.size();
+  for (const auto& kv : s)
+  {
+    auto p = m.find(mystl::string(kv.first.data(), kv.first.size()));
+    if (p == m.end() || p->second != kv.second) ok = false;
+  }
+  EXPECT(ok);
+}
+
+void test_hash()
+{
+  mystl::hash<double> hd;
+  EXPECT(hd(0.0) == hd(-0.0));
+  mystl::hash<unsigned> hu;
+  // every input bit moves both the 7 tag bits and the home slot bits above
+  bool spread = true;
+  for (unsigned b = 0; b < 32; ++b)
+  {
+    const size_t d = hu(0u) ^ hu(1u << b);
+    if ((d & 0x7f) == 0 || (d >> 7 & 0xffff) == 0) spread = false;
+  }
+  EXPECT(spread);
+}
+
+} // namespace
+
+int main()
+{
+  random_ops<mystl::unordered_map<long long, int>>(1, 5000);
+  random_ops<mystl::unordered_map<long long, int>>(2, 1 << 30);
+  random_ops<mystl::unordered_map<long long, int, crowded_hash>>(3, 600);
+  test_string_keys();
+  test_hash();
+  return test::result("test_unordered_map");
+}
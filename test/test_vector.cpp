@@ -0,0 +1,180 @@
+// vector against std::vector: random inserts, emplaces and erases in the middle,
+// move-only elements, and no leak when a move throws while growing
+
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vector.h"
+
+#include "test.h"
+
+namespace
+{
+
+// counts live objects; a move throws once the countdown reaches zero
+struct tracked
+{
+  static int live;
+  static int countdown;
+
+  int value;
+
+  explicit tracked(int v) :value(v) { ++live; }
+  tracked(const tracked& rhs) :value(rhs.value) { ++live; }
+  tracked(tracked&& rhs) :value(rhs.value)
+  {
+    if (countdown > 0 && --countdown == 0) throw std::runtime_error("move");
+    ++live;
+  }
+  tracked& operator=(const tracked& rhs) { value = rhs.value; return *this; }
+  tracked& operator=(tracked&& rhs) { value = rhs.value; return *this; }
+  ~tracked() { --live; }
+};
+
+int tracked::live = 0;
+int tracked::countdown = 0;
+
+template <class V, class S>
+bool same(const V& v, const S& s)
+{
+  if (v.size() != s.size()) return false;
+  for (size_t i = 0; i < s.size(); ++i)
+  {
+    if (!(v[i] == s[i])) return false;
+  }
+  return true;
+}
+
+template <class T, class Make>
+void random_ops(Make make)
+{
+  std::mt19937 rng(7);
+  mystl::vector<T> v;
+  std::vector<T> s;
+  for (int it = 0; it < 20000; ++it)
+  {
+    const size_t pos = s.empty() ? 0 : rng() % (s.size() + 1);
+    const T x = make(static_cast<int>(rng()));
+    switch (rng() % 6)
+    {
+      case 0:
+        v.insert(v.begin() + pos, x);
+        s.insert(s.begin() + pos, x);
+        break;
+      case 1:
+        v.emplace(v.begin() + pos, x);
+        s.emplace(s.begin() + pos, x);
+        break;
+      case 2:
+      {
+        const size_t n = rng() % 5;
+        v.insert(v.begin() + pos, n, x);
+        s.insert(s.begin() + pos, n, x);
+        break;
+      }
+      case 3:
+      {
+        std::vector<T> r(rng() % 5, x);
+        v.insert(v.begin() + pos, r.data(), r.data() + r.size());
+        s.insert(s.begin() + pos, r.begin(), r.end());
+        break;
+      }
+      case 4:
+        if (!s.empty())
+        {
+          // an argument aliasing an element that is about to move
+          v.insert(v.begin() + pos, v[s.size() - 1]);
+          s.insert(s.begin() + pos, T(s[s.size() - 1]));
+        }
+        break;
+      default:
+        if (pos < s.size())
+        {
+          const size_t last = pos + rng() % (s.size() - pos + 1);
+          v.erase(v.begin() + pos, v.begin() + last);
+          s.erase(s.begin() + pos, s.begin() + last);
+        }
+        break;
+    }
+    EXPECT(same(v, s));
+    if (!same(v, s)) return;
+  }
+}
+
+void test_move_only()
+{
+  std::mt19937 rng(3);
+  mystl::vector<std::unique_ptr<int>> v;
+  std::vector<int> s;
+  for (int it = 0; it < 5000; ++it)
+  {
+    const size_t pos = s.empty() ? 0 : rng() % (s.size() + 1);
+    const int x = static_cast<int>(rng());
+    if (rng() % 2)
+      v.insert(v.begin() + pos, std::unique_ptr<int>(new int(x)));
+    else
+      v.emplace(v.begin() + pos, new int(x));
+    s.insert(s.begin() + pos, x);
+    if (rng() % 3 == 0)
+    {
+      const size_t e = rng() % s.size();
+      v.erase(v.begin() + e);
+      s.erase(s.begin() + e);
+    }
+  }
+  EXPECT(v.size() == s.size());
+  bool ok = true;
+  for (size_t i = 0; i < s.size(); ++i)
+  {
+    if (v[i] == nullptr || *v[i] != s[i]) ok = false;
+  }
+  EXPECT(ok);
+}
+
+// a move throwing while the elements are relocated to a new block must not
+// leak the new block or any element built in it
+void test_throwing_relocation()
+{
+  for (int fail = 1; fail < 40; ++fail)
+  {
+    {
+      mystl::vector<tracked> v;
+      for (int i = 0; i < 16; ++i) v.emplace_back(i);
+      v.shrink_to_fit();
+      tracked::countdown = fail;
+      try
+      {
+        switch (fail % 3)
+        {
+          case 0:  v.emplace(v.begin() + 5, -1); break;
+          case 1:  v.insert(v.begin() + 5, 3, tracked(-1)); break;
+          default: v.insert(v.begin() + 5, {tracked(-1), tracked(-2)}); break;
+        }
+      }
+      catch (const std::runtime_error&)
+      {
+      }
+      tracked::countdown = 0;
+      EXPECT(tracked::live == static_cast<int>(v.size()));
+    }
+    EXPECT(tracked::live == 0);
+  }
+}
+
+} // namespace
+
+int main()
+{
+  random_ops<int>([](int x) { return x % 1000; });
+  random_ops<std::string>([](int x) { return std::string(static_cast<size_t>(x) % 40, 'a' + x % 26); });
+  test_move_only();
+  test_throwing_relocation();
+
+  const mystl::vector<int> c(3, 1);
+  mystl::vector<int>::allocator_type a = c.get_allocator();
+  (void)a;
+  return test::result("test_vector");
+}
@@ -0,0 +1,258 @@
+// span and string_view: span construction, subviews and bytes, string_view
+// search, compare and substr against std::string on random strings, and the
+// memcmp overload of equal for mixes of const and non-const pointers
+
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "algobase.h"
+#include "numeric.h"
+#include "span.h"
+#include "string_view.h"
+#include "vector.h"
+
+#include "test.h"
+
+namespace
+{
+
+int sign(int x)
+{
+  return x < 0 ? -1 : (x > 0 ? 1 : 0);
+}
+
+void test_span_construct()
+{
+  int arr[6] = {0, 1, 2, 3, 4, 5};
+
+  mystl::span<int> a(arr);
+  EXPECT(a.data() == arr && a.size() == 6 && a.size_bytes() == sizeof(arr));
+  mystl::span<int, 6> fixed(arr);
+  EXPECT(fixed.size() == 6 && fixed.data() == arr);
+  EXPECT(sizeof(fixed) == sizeof(int*));
+  mystl::span<const int> c(fixed);
+  EXPECT(c.data() == arr && c.size() == 6);
+
+  mystl::span<int> p(arr + 1, arr + 4);
+  EXPECT(p.size() == 3 && p.front() == 1 && p.back() == 3);
+  mystl::span<int> pn(arr + 2, 3);
+  EXPECT(pn.size() == 3 && pn[0] == 2);
+
+  std::vector<int> sv(arr, arr + 6);
+  mystl::span<int> from_std(sv);
+  EXPECT(from_std.data() == sv.data() && from_std.size() == 6);
+  const std::vector<int>& csv = sv;
+  mystl::span<const int> from_const(csv);
+  EXPECT(from_const.data() == sv.data() && from_const.size() == 6);
+
+  mystl::vector<int> mv(arr, arr + 6);
+  mystl::span<int> from_mystl(mv);
+  EXPECT(from_mystl.data() == mv.data() && from_mystl.size() == mv.size());
+  from_mystl[0] = 42;
+  EXPECT(mv[0] == 42);
+
+  mystl::span<int> e;
+  EXPECT(e.empty() && e.data() == nullptr && e.begin() == e.end());
+  EXPECT(mystl::span<int>(arr, arr).empty());
+}
+
+void test_span_subviews()
+{
+  int arr[8];
+  for (int i = 0; i < 8; ++i) arr[i] = i * 10;
+  mystl::span<int> s(arr);
+
+  auto f = s.first(3);
+  EXPECT(f.data() == arr && f.size() == 3);
+  auto l = s.last(2);
+  EXPECT(l.data() == arr + 6 && l.size() == 2 && l[1] == 70);
+  auto m = s.subspan(2, 4);
+  EXPECT(m.data() == arr + 2 && m.size() == 4 && m.back() == 50);
+  auto rest = s.subspan(5);
+  EXPECT(rest.data() == arr + 5 && rest.size() == 3);
+  EXPECT(s.subspan(8).empty() && s.first(0).empty() && s.last(0).empty());
+
+  auto f2 = s.first<2>();
+  EXPECT(f2.size() == 2 && f2[1] == 10 && decltype(f2)::extent == 2);
+  auto l3 = s.last<3>();
+  EXPECT(l3.size() == 3 && l3.data() == arr + 5);
+
+  // the pointer paths of the algorithms run on the iterators
+  mystl::fill_n(m.begin(), m.size(), 7);
+  EXPECT(arr[1] == 10 && arr[2] == 7 && arr[5] == 7 && arr[6] == 60);
+  int out[3] = {};
+  mystl::copy(l3.begin(), l3.end(), out);
+  EXPECT(out[0] == 7 && out[1] == 60 && out[2] == 70);
+  EXPECT(mystl::accumulate(s.begin(), s.end(), 0) == 0 + 10 + 7 * 4 + 60 + 70);
+}
+
+void test_span_bytes()
+{
+  unsigned int arr[3] = {0x01020304u, 0u, 0xffffffffu};
+  mystl::span<unsigned int> s(arr);
+  auto b = mystl::as_bytes(s);
+  EXPECT(b.size() == sizeof(arr));
+  EXPECT(static_cast<const void*>(b.data()) == static_cast<const void*>(arr));
+  EXPECT(std::memcmp(b.data(), arr, sizeof(arr)) == 0);
+
+  auto w = mystl::as_writable_bytes(s.subspan(1, 1));
+  EXPECT(w.size() == sizeof(unsigned int));
+  for (auto& x : w) x = 0xab;
+  EXPECT(arr[0] == 0x01020304u && arr[1] == 0xababababu && arr[2] == 0xffffffffu);
+
+  mystl::span<const unsigned int> cs(s);
+  EXPECT(mystl::as_bytes(cs).size() == sizeof(arr));
+}
+
+std::string random_string(std::mt19937& rng, size_t max_len)
+{
+  std::string s(rng() % (max_len + 1), 'a');
+  for (auto& c : s) c = static_cast<char>('a' + rng() % 3);
+  return s;
+}
+
+// every search, compare and substr call agrees with std::string; small
+// alphabets make the partial matches that exercise the search kernels
+void test_string_view_vs_std(std::mt19937& rng)
+{
+  const size_t npos = mystl::string_view::npos;
+  for (int it = 0; it < 3000; ++it)
+  {
+    const std::string a = random_string(rng, 30);
+    const std::string b = random_string(rng, 4);
+    const mystl::string_view va(a.data(), a.size());
+    const mystl::string_view vb(b.data(), b.size());
+    const size_t pos = rng() % (a.size() + 3);
+    const size_t rpos = rng() % 4 == 0 ? npos : pos;
+    const char c = static_cast<char>('a' + rng() % 4);
+
+    EXPECT(va.find(vb, pos) == a.find(b, pos));
+    EXPECT(va.find(c, pos) == a.find(c, pos));
+    EXPECT(va.rfind(vb, rpos) == a.rfind(b, rpos));
+    EXPECT(va.rfind(c, rpos) == a.rfind(c, rpos));
+    EXPECT(va.find_first_of(vb, pos) == a.find_first_of(b, pos));
+    EXPECT(va.find_last_of(vb, rpos) == a.find_last_of(b, rpos));
+    EXPECT(va.find_first_not_of(vb, pos) == a.find_first_not_of(b, pos));
+    EXPECT(va.find_last_not_of(vb, rpos) == a.find_last_not_of(b, rpos));
+    EXPECT(va.find_first_not_of(c, pos) == a.find_first_not_of(c, pos));
+    EXPECT(va.find_last_not_of(c, rpos) == a.find_last_not_of(c, rpos));
+
+    EXPECT(sign(va.compare(vb)) == sign(a.compare(b)));
+    EXPECT((va == vb) == (a == b) && (va < vb) == (a < b) && (va >= vb) == (a >= b));
+    if (pos <= a.size())
+    {
+      const size_t n = rng() % 10;
+      const mystl::string_view sub = va.substr(pos, n);
+      const std::string ssub = a.substr(pos, n);
+      EXPECT(std::string(sub.data(), sub.size()) == ssub);
+      EXPECT(sign(va.compare(pos, n, vb)) == sign(a.compare(pos, n, b)));
+      EXPECT(sign(va.compare(pos, n, b.c_str())) == sign(a.compare(pos, n, b.c_str())));
+    }
+    else
+    {
+      EXPECT_THROW(va.substr(pos), std::out_of_range);
+      EXPECT_THROW(va.compare(pos, 1, vb), std::out_of_range);
+    }
+
+    const bool starts = a.compare(0, b.size(), b) == 0 && a.size() >= b.size();
+    const bool ends = a.size() >= b.size() && a.compare(a.size() - b.size(), b.size(), b) == 0;
+    EXPECT(va.starts_with(vb) == starts && va.ends_with(vb) == ends);
+    EXPECT(va.starts_with(c) == (!a.empty() && a.front() == c));
+    EXPECT(va.ends_with(c) == (!a.empty() && a.back() == c));
+  }
+}
+
+void test_string_view_basics()
+{
+  const char text[] = "key=value;rest";
+  mystl::string_view v(text);
+  EXPECT(v.size() == 14 && v.data() == text);
+  EXPECT(v.starts_with("key") && v.ends_with("rest") && !v.starts_with("value"));
+  EXPECT(v.starts_with(mystl::string_view()) && mystl::string_view().ends_with(""));
+  EXPECT(v == "key=value;rest" && "key" < v && v != "key");
+
+  const size_t eq = v.find('=');
+  mystl::string_view key = v.substr(0, eq);
+  mystl::string_view val = v.substr(eq + 1, v.find(';') - eq - 1);
+  EXPECT(key == "key" && val == "value" && val.data() == text + 4);
+  EXPECT(v.substr(v.size()).empty());
+  EXPECT(v.substr(10, 100) == "rest");
+  EXPECT_THROW(v.at(14), std::out_of_range);
+  EXPECT(v.at(13) == 't');
+
+  char buf[8] = {};
+  EXPECT(v.copy(buf, 5, 4) == 5 && std::string(buf) == "value");
+  EXPECT_THROW(v.copy(buf, 1, 15), std::out_of_range);
+
+  mystl::string_view w = v;
+  w.remove_prefix(4);
+  w.remove_suffix(5);
+  EXPECT(w == val);
+
+  // a view of characters that are not terminated
+  mystl::string_view part(text, 3);
+  EXPECT(part == "key" && part.compare("key=") < 0 && part.find("y=") == mystl::string_view::npos);
+
+  EXPECT(mystl::hash<mystl::string_view>()(key) ==
+         mystl::hash<mystl::string_view>()(mystl::string_view("key")));
+}
+
+// equal on pointers compares the bytes, with any const mix of the two ranges
+void test_equal_pointers(std::mt19937& rng)
+{
+  for (int it = 0; it < 500; ++it)
+  {
+    const size_t n = rng() % 40;
+    std::vector<int> a(n), b;
+    for (auto& x : a) x = static_cast<int>(rng() % 4);
+    b = a;
+    const bool differ = n != 0 && rng() % 2;
+    if (differ) b[rng() % n] += 1;
+
+    int* pa = a.data();
+    int* pb = b.data();
+    const int* ca = pa;
+    const int* cb = pb;
+    EXPECT(mystl::equal(pa, pa + n, pb) == !differ);
+    EXPECT(mystl::equal(ca, ca + n, pb) == !differ);
+    EXPECT(mystl::equal(pa, pa + n, cb) == !differ);
+    EXPECT(mystl::equal(ca, ca + n, cb) == !differ);
+  }
+
+  // pointer elements
+  int x = 0, y = 0;
+  int* p1[3] = {&x, &y, nullptr};
+  int* const p2[3] = {&x, &y, nullptr};
+  EXPECT(mystl::equal(p1, p1 + 3, p2));
+  p1[2] = &x;
+  EXPECT(!mystl::equal(p2, p2 + 3, p1));
+
+  // empty ranges, also through null pointers
+  int* null = nullptr;
+  EXPECT(mystl::equal(null, null, null));
+
+  // through span and string_view iterators
+  char s1[] = "abcdef";
+  const char s2[] = "abcdeg";
+  mystl::span<char> sp(s1, 6);
+  mystl::string_view sv(s2);
+  EXPECT(mystl::equal(sp.begin(), sp.begin() + 5, sv.begin()));
+  EXPECT(!mystl::equal(sv.begin(), sv.end(), sp.begin()));
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937 rng(46);
+  test_span_construct();
+  test_span_subviews();
+  test_span_bytes();
+  test_string_view_basics();
+  test_string_view_vs_std(rng);
+  test_equal_pointers(rng);
+  return test::result("test_views");
+}